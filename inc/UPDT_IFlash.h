@@ -0,0 +1,109 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef UPDT_IFLASH_H
+#define UPDT_IFLASH_H
+/** \brief Flash Update Flash Device Header File
+ **
+ ** This files shall be included by modules using the interfaces provided by
+ ** the Flash Update Flash Device
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Flash
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_string.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+
+/*==================[typedef]================================================*/
+struct UPDT_IFlashStruct;
+typedef struct UPDT_IFlashStruct UPDT_IFlashType;
+
+/** Erases size bytes from address, both multiple of the sector size.
+ ** Returns 0 on success and -1 on error */
+typedef int32_t (*UPDT_IFlashErase)(UPDT_IFlashType* flash, uint32_t address, size_t size);
+/** Programs size bytes at address, which must be erased. Any range inside a
+ ** page may be programmed, once. Returns 0 on success and -1 on error */
+typedef int32_t (*UPDT_IFlashProgram)(UPDT_IFlashType* flash, uint32_t address, const void* data, size_t size);
+/** Reads size bytes from address. Returns 0 on success and -1 on error */
+typedef int32_t (*UPDT_IFlashRead)(UPDT_IFlashType* flash, uint32_t address, void* data, size_t size);
+
+typedef struct UPDT_IFlashStruct
+{
+   UPDT_IFlashErase erase;
+   UPDT_IFlashProgram program;
+   UPDT_IFlashRead read;
+   /** Erase unit in bytes, a power of two */
+   uint32_t sector_size;
+   /** Program unit in bytes, a power of two dividing the sector size */
+   uint32_t page_size;
+} UPDT_IFlashType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef UPDT_IFLASH_H */
@@ -2,6 +2,7 @@
  * Copyright 2015, Esteban Volentini
  * Copyright 2015, Matias Giori
  * Copyright 2015, Franco Salinas
+ * Copyright 2026, agent
  *
  * This file is part of CIAA Firmware.
  *
@@ -54,17 +55,26 @@
  * EV           Esteban Volentini
  * MG           Matias Giori
  * FS           Franco Salinas
+ * AG           agent
  */
 
 /*
  * modification history (new versions first)
  * -----------------------------------------------------------
+ * 20261017 v0.0.9  AG  add the interface initialization
+ * 20261017 v0.0.8  AG  add the counting decorator
+ * 20261017 v0.0.7  AG  add the read-ahead decorator
+ * 20261017 v0.0.6  AG  add the send batching decorator
+ * 20261017 v0.0.5  AG  add deadline aware calls and the deadline decorator
+ * 20261017 v0.0.4  AG  add zero copy receive
+ * 20261017 v0.0.3  AG  add vectored send and receive
  * 20150419 v0.0.2  FS  change prefixes
  * 20150408 v0.0.1  FS  first initial version
  */
 
 /*==================[inclusions]=============================================*/
 #include "ciaaPOSIX_string.h"
+#include "ciaaLibs_CircBuf.h"
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -77,18 +87,298 @@ extern "C" {
 struct UPDT_ITransportStruct;
 typedef struct UPDT_ITransportStruct UPDT_ITransportType;
 
+/** \brief Scatter/gather element, like the POSIX struct iovec */
+typedef struct
+{
+   /** Start of the block */
+   void *base;
+   /** Size of the block in bytes */
+   size_t size;
+} UPDT_ITransportIoVecType;
+
 typedef ssize_t (*UPDT_ITransportRecv)(UPDT_ITransportType* transport, void* data, size_t size);
 typedef ssize_t (*UPDT_ITransportSend)(UPDT_ITransportType* transport, const void* data, size_t size);
+/** Optional. Fills the blocks in order, like readv */
+typedef ssize_t (*UPDT_ITransportRecvv)(UPDT_ITransportType* transport, const UPDT_ITransportIoVecType* iov, size_t count);
+/** Optional. Sends the blocks in order, like writev */
+typedef ssize_t (*UPDT_ITransportSendv)(UPDT_ITransportType* transport, const UPDT_ITransportIoVecType* iov, size_t count);
+/** Optional. Waits like recv, then lends up to size received bytes stored
+ ** contiguously in the transport. Returns the number of bytes lent */
+typedef ssize_t (*UPDT_ITransportRecvAcquire)(UPDT_ITransportType* transport, const void** data, size_t size);
+/** Gives back the first size bytes lent by the last recv_acquire, they are
+ ** consumed. Mandatory if recv_acquire is provided */
+typedef void (*UPDT_ITransportRecvRelease)(UPDT_ITransportType* transport, size_t size);
+/** Optional. Like recv but returns 0 if nothing arrives before the deadline,
+ ** a UPDT_timeNow value */
+typedef ssize_t (*UPDT_ITransportRecvUntil)(UPDT_ITransportType* transport, void* data, size_t size, uint32_t deadline);
+/** Optional. Like send but returns 0 if nothing can be sent before the
+ ** deadline */
+typedef ssize_t (*UPDT_ITransportSendUntil)(UPDT_ITransportType* transport, const void* data, size_t size, uint32_t deadline);
+/** Optional. Like recv_acquire but returns 0 if nothing arrives before the
+ ** deadline */
+typedef ssize_t (*UPDT_ITransportRecvAcquireUntil)(UPDT_ITransportType* transport, const void** data, size_t size, uint32_t deadline);
 
 typedef struct UPDT_ITransportStruct
 {
    UPDT_ITransportRecv recv;
    UPDT_ITransportSend send;
+   /** NULL if the transport has no vectored receive */
+   UPDT_ITransportRecvv recvv;
+   /** NULL if the transport has no vectored send */
+   UPDT_ITransportSendv sendv;
+   /** NULL if the transport does not lend its buffers */
+   UPDT_ITransportRecvAcquire recv_acquire;
+   UPDT_ITransportRecvRelease recv_release;
+   /** NULL if the transport can not bound its waits */
+   UPDT_ITransportRecvUntil recv_until;
+   UPDT_ITransportSendUntil send_until;
+   UPDT_ITransportRecvAcquireUntil recv_acquire_until;
 } UPDT_ITransportType;
 
+/** \brief Deadline decorator type.
+ **
+ ** Wraps a transport so every recv and send made through it waits until the
+ ** deadline at most, using the deadline aware entries of the wrapped
+ ** transport. Code written for the plain interface, like the protocol
+ ** helpers, gets the deadlines without knowing about them: a call which
+ ** expires returns 0.
+ **/
+typedef struct
+{
+   /** Transport interface. It must be the first field */
+   UPDT_ITransportType transport;
+   /** Wrapped transport */
+   UPDT_ITransportType *inner;
+   /** Deadline of the calls, a UPDT_timeNow value */
+   uint32_t deadline;
+   /** Non-zero if the deadline applies, the calls block otherwise */
+   uint8_t armed;
+} UPDT_ITransportDeadlineType;
+
+/** \brief Batching decorator type.
+ **
+ ** Wraps a transport so the bytes sent through it are staged in a buffer
+ ** and leave in one send of the wrapped transport. The buffer is flushed
+ ** when it reaches the threshold, when the next block does not fit, on
+ ** UPDT_ITransportBatchFlush and before every receive, so a peer waiting
+ ** for an answer never waits for bytes still staged. Blocks larger than the
+ ** buffer are sent directly after flushing it.
+ **/
+typedef struct
+{
+   /** Transport interface. It must be the first field */
+   UPDT_ITransportType transport;
+   /** Wrapped transport */
+   UPDT_ITransportType *inner;
+   /** Staging buffer */
+   uint8_t *buffer;
+   /** Size of the staging buffer */
+   size_t capacity;
+   /** Bytes staged */
+   size_t fill;
+   /** Number of staged bytes flushed without waiting for a receive */
+   size_t threshold;
+   /** Number of sends made on the wrapped transport */
+   uint32_t writes;
+} UPDT_ITransportBatchType;
+
+/** \brief Read-ahead decorator type.
+ **
+ ** Wraps a transport so each receive made through it, once the bytes
+ ** already read are used, asks the wrapped transport for as many bytes as
+ ** the ring buffer holds. Header, payload and trailer of the frames are then
+ ** served from memory, with a single read of the wrapped transport for
+ ** several of them. The wrapped recv must return the bytes available, like
+ ** read, instead of waiting for all the requested ones. The sends are
+ ** forwarded as they are.
+ **/
+typedef struct
+{
+   /** Transport interface. It must be the first field */
+   UPDT_ITransportType transport;
+   /** Wrapped transport */
+   UPDT_ITransportType *inner;
+   /** Bytes read and not received yet */
+   ciaaLibs_CircBufType cbuf;
+   /** Memory of the ring buffer */
+   uint8_t *buffer;
+   /** Size of the ring buffer */
+   size_t size;
+   /** Number of receives made on the wrapped transport */
+   uint32_t reads;
+} UPDT_ITransportReadAheadType;
+
+/** \brief Transport statistics type.
+ **
+ ** Only uint32_t fields, the counters wrap around.
+ **/
+typedef struct
+{
+   /** Number of receives, plain, vectored or acquired */
+   uint32_t reads;
+   /** Receives which returned less bytes than requested */
+   uint32_t partial_reads;
+   /** Bytes received, the acquired ones when released */
+   uint32_t bytes_received;
+   /** Number of sends, plain or vectored */
+   uint32_t writes;
+   /** Sends which took less bytes than given */
+   uint32_t partial_writes;
+   /** Bytes sent */
+   uint32_t bytes_sent;
+   /** Receives and sends which failed */
+   uint32_t errors;
+   /** Receives and sends which returned 0, usually because the deadline
+    ** passed */
+   uint32_t expired;
+   /** Time blocked in the receives, in milliseconds */
+   uint32_t recv_time;
+   /** Time blocked in the sends, in milliseconds */
+   uint32_t send_time;
+} UPDT_ITransportStatsType;
+
+/** \brief Counting decorator type.
+ **
+ ** Wraps a transport so every call made through it is accounted in a
+ ** statistics structure, with the time it blocked. The calls are forwarded
+ ** as they are, the decorator provides the same optional entries as the
+ ** wrapped transport.
+ **/
+typedef struct
+{
+   /** Transport interface. It must be the first field */
+   UPDT_ITransportType transport;
+   /** Wrapped transport */
+   UPDT_ITransportType *inner;
+   /** Statistics updated by the calls */
+   UPDT_ITransportStatsType *stats;
+} UPDT_ITransportCounterType;
+
 /*==================[external data declaration]==============================*/
 
 /*==================[external functions declaration]=========================*/
+/** \brief Initializes a transport interface.
+ **
+ ** Sets the mandatory entries and clears the optional ones, so a transport
+ ** only sets the optional entries it provides. Entries added to the
+ ** interface later are cleared here as well.
+ **
+ ** \param transport Transport interface.
+ ** \param recv Receive entry, NULL for a closed transport.
+ ** \param send Send entry, NULL for a closed transport.
+ **/
+void UPDT_ITransportInit(
+   UPDT_ITransportType *transport,
+   UPDT_ITransportRecv recv,
+   UPDT_ITransportSend send);
+
+/** \brief Receives into several blocks.
+ **
+ ** Uses the recvv entry of the transport. If the transport does not provide
+ ** it, the blocks are received one by one with recv until one of them is
+ ** not filled completely.
+ **
+ ** \param transport Transport layer.
+ ** \param iov Blocks to fill.
+ ** \param count Number of blocks.
+ ** \return Number of bytes received. -1 on error.
+ **/
+ssize_t UPDT_ITransportRecvVector(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count);
+
+/** \brief Sends several blocks.
+ **
+ ** Uses the sendv entry of the transport. If the transport does not provide
+ ** it, the blocks are sent one by one with send until one of them is not
+ ** sent completely.
+ **
+ ** \param transport Transport layer.
+ ** \param iov Blocks to send.
+ ** \param count Number of blocks.
+ ** \return Number of bytes sent. -1 on error.
+ **/
+ssize_t UPDT_ITransportSendVector(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count);
+
+/** \brief Initializes a deadline decorator.
+ **
+ ** The decorator starts disarmed, forwarding the calls as they are.
+ **
+ ** \param deadline Decorator structure.
+ ** \param inner Wrapped transport.
+ **/
+void UPDT_ITransportDeadlineInit(
+   UPDT_ITransportDeadlineType *deadline,
+   UPDT_ITransportType *inner);
+
+/** \brief Sets the deadline of the next calls.
+ **
+ ** \param deadline Decorator structure.
+ ** \param time Deadline, a UPDT_timeNow value.
+ **/
+void UPDT_ITransportDeadlineSet(UPDT_ITransportDeadlineType *deadline, uint32_t time);
+
+/** \brief Removes the deadline, the next calls block.
+ **
+ ** \param deadline Decorator structure.
+ **/
+void UPDT_ITransportDeadlineCancel(UPDT_ITransportDeadlineType *deadline);
+
+/** \brief Initializes a batching decorator.
+ **
+ ** \param batch Decorator structure.
+ ** \param inner Wrapped transport.
+ ** \param buffer Staging buffer, usually room for a window of frames.
+ ** \param capacity Size of the staging buffer.
+ ** \param threshold Staged bytes sent at once, at most capacity. With
+ ** capacity the bytes only leave when the buffer is full or flushed.
+ **/
+void UPDT_ITransportBatchInit(
+   UPDT_ITransportBatchType *batch,
+   UPDT_ITransportType *inner,
+   uint8_t *buffer,
+   size_t capacity,
+   size_t threshold);
+
+/** \brief Sends the staged bytes.
+ **
+ ** \param batch Decorator structure.
+ ** \return 0 on success, -1 if the wrapped transport failed or did not
+ ** take every byte. The bytes not sent stay staged.
+ **/
+int32_t UPDT_ITransportBatchFlush(UPDT_ITransportBatchType *batch);
+
+/** \brief Initializes a read-ahead decorator.
+ **
+ ** \param readahead Decorator structure.
+ ** \param inner Wrapped transport.
+ ** \param buffer Memory of the ring buffer.
+ ** \param size Size of the ring buffer, a power of two. Room for a few
+ ** frames is usually enough.
+ ** \return 0 on success, -1 if the ring buffer can not be initialized.
+ **/
+int32_t UPDT_ITransportReadAheadInit(
+   UPDT_ITransportReadAheadType *readahead,
+   UPDT_ITransportType *inner,
+   uint8_t *buffer,
+   size_t size);
+
+/** \brief Initializes a counting decorator.
+ **
+ ** The statistics are not cleared, several decorators may share them.
+ **
+ ** \param counter Decorator structure.
+ ** \param inner Wrapped transport.
+ ** \param stats Statistics updated by the calls.
+ **/
+void UPDT_ITransportCounterInit(
+   UPDT_ITransportCounterType *counter,
+   UPDT_ITransportType *inner,
+   UPDT_ITransportStatsType *stats);
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
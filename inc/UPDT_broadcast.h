@@ -0,0 +1,315 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef UPDT_BROADCAST_H
+#define UPDT_BROADCAST_H
+/** \brief Flash Update Broadcast Header File
+ **
+ ** This files shall be included by modules using the interfaces provided by
+ ** the Flash Update Broadcast
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Broadcast
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "UPDT_protocol.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** largest number of DAT frames of a broadcast, their number is 16 bits */
+#define UPDT_BROADCAST_BLOCKS_MAX        65535u
+/** size of the bitmap of a broadcast of the specified number of frames */
+#define UPDT_BROADCAST_BITMAP_SIZE(blocks)   (((blocks) + 7u) / 8u)
+/** repair rounds of the master before it gives up on the slaves left */
+#define UPDT_BROADCAST_ROUNDS_MAX        32
+
+/* ANN kinds, in the reserved header byte */
+/** the DAT frames of the announced transfer follow */
+#define UPDT_BROADCAST_ANN_START         0x00u
+/** the master is done, no more DAT frames nor polls will follow */
+#define UPDT_BROADCAST_ANN_END           0x01u
+
+/* NAK answer payload */
+/** offset of the transfer id the slave knows */
+#define UPDT_BROADCAST_NAK_ID_OFFSET         0
+/** offset of the number of missing DAT frames */
+#define UPDT_BROADCAST_NAK_MISSING_OFFSET    4
+/** offset of the first range of missing DAT frames. Each range is the
+ ** number of its first frame and its number of frames, 16 bits each, a
+ ** range of 0 frames ends the list */
+#define UPDT_BROADCAST_NAK_RANGES_OFFSET     8
+/** ranges of missing DAT frames in a NAK answer */
+#define UPDT_BROADCAST_NAK_RANGES                                              \
+   ((UPDT_PROTOCOL_PACKET_NAK_PAYLOAD_SIZE - UPDT_BROADCAST_NAK_RANGES_OFFSET) / 4)
+/** missing frames of a slave which did not get the announcement */
+#define UPDT_BROADCAST_MISSING_UNKNOWN   0xFFFFFFFFu
+/** missing frames of a slave which can not hold the announced transfer */
+#define UPDT_BROADCAST_MISSING_REFUSED   0xFFFFFFFEu
+
+/* slave states, as seen by the master */
+/** the slave still misses DAT frames */
+#define UPDT_BROADCAST_SLAVE_PENDING     0
+/** the slave has every DAT frame */
+#define UPDT_BROADCAST_SLAVE_DONE        1
+/** the slave did not answer its polls */
+#define UPDT_BROADCAST_SLAVE_SILENT      2
+/** the slave can not hold the transfer */
+#define UPDT_BROADCAST_SLAVE_REFUSED     3
+
+/*==================[typedef]================================================*/
+/** \brief Broadcast master type.
+ **
+ ** Sends an image once to every slave of a shared bus. The transfer is
+ ** announced with an ANN frame and its DAT frames are numbered from 0 in
+ ** the reserved and sequence number header bytes, low byte first. They are
+ ** neither acknowledged nor retransmitted one by one: the master then polls
+ ** each slave with an empty NAK frame carrying its address in the reserved
+ ** header byte, and the slave answers with the frames it misses. The union
+ ** of the missing frames is broadcast again, and the rounds go on until
+ ** every slave is done. The time of an update grows with the image size
+ ** and the losses, not with the number of slaves.
+ **
+ ** Every frame is protected with a CRC32C trailer.
+ **/
+typedef struct
+{
+   /** Shared transport, its deadline bounds the wait for an answer */
+   UPDT_ITransportDeadlineType deadline;
+   /** Image to send */
+   const uint8_t *image;
+   /** Size of the image */
+   uint32_t image_size;
+   /** CRC32C of the image */
+   uint32_t image_crc;
+   /** Identifies the transfer, slaves drop the frames of any other one */
+   uint32_t id;
+   /** DAT payload size, the image bytes of each frame */
+   uint16_t payload_size;
+   /** Number of DAT frames of the image */
+   uint16_t blocks;
+   /** Frames to send in the next round, a bit per frame */
+   uint8_t *missing;
+   /** Maximum wait for the answer of a slave in milliseconds, 0 waits
+    ** forever */
+   uint32_t timeout;
+   /** DAT frames sent, the first round included */
+   uint32_t sent;
+   /** Repair rounds done */
+   uint32_t rounds;
+   /** Polls sent, retries included */
+   uint32_t polls;
+} UPDT_broadcastMasterType;
+
+/** \brief Broadcast slave type.
+ **
+ ** Receives the DAT frames of a broadcast in any order and keeps a bit for
+ ** each one, so that it can tell the master which ones it misses. Frames
+ ** received twice are only written once.
+ **/
+typedef struct
+{
+   /** Shared transport */
+   UPDT_ITransportType *transport;
+   /** Address polled by the master */
+   uint8_t address;
+   /** Memory of a frame */
+   uint8_t *frame;
+   /** Size of the frame memory, it limits the DAT payload size */
+   size_t frame_size;
+   /** Frames received, a bit per frame */
+   uint8_t *received;
+   /** Size of the bitmap, it limits the number of frames */
+   size_t received_size;
+   /** Consumer of the image, it gets image offsets */
+   UPDT_protocolConsumerType consumer;
+   /** Context of the consumer */
+   void *context;
+   /** Non-zero once a transfer was announced */
+   uint8_t announced;
+   /** Non-zero if the announced transfer can not be held */
+   uint8_t refused;
+   /** Non-zero once the master ended the transfer */
+   uint8_t ended;
+   /** Transfer id of the announcement */
+   uint32_t id;
+   /** Image size of the announcement */
+   uint32_t image_size;
+   /** Image CRC32C of the announcement, to check the image once it is
+    ** complete */
+   uint32_t image_crc;
+   /** DAT payload size of the announcement */
+   uint16_t payload_size;
+   /** Number of DAT frames of the transfer */
+   uint16_t blocks;
+   /** DAT frames still missing */
+   uint32_t missing;
+} UPDT_broadcastSlaveType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief Initializes a broadcast master.
+ **
+ ** \param master Master structure.
+ ** \param transport Transport of the shared bus.
+ ** \param image Image to send.
+ ** \param image_size Size of the image, at most UPDT_BROADCAST_BLOCKS_MAX
+ ** frames.
+ ** \param payload_size DAT payload size, multiple of 8 up to
+ ** UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE. Every slave must accept it.
+ ** \param missing Memory of the bitmap, UPDT_BROADCAST_BITMAP_SIZE bytes
+ ** for the frames of the image.
+ ** \param missing_size Size of the bitmap memory.
+ ** \param id Identifies the transfer, for example the CRC32C of the image
+ ** and its version. A new update must not reuse it.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success. UPDT_PROTOCOL_ERROR_PACKET
+ ** if the payload size is not valid or the image has too many frames for
+ ** the bitmap.
+ **/
+int32_t UPDT_broadcastMasterInit(
+   UPDT_broadcastMasterType *master,
+   UPDT_ITransportType *transport,
+   const uint8_t *image,
+   uint32_t image_size,
+   uint16_t payload_size,
+   uint8_t *missing,
+   size_t missing_size,
+   uint32_t id);
+
+/** \brief Sets the wait for the answer of a slave.
+ **
+ ** A slave which does not answer UPDT_PROTOCOL_RETRIES_MAX consecutive
+ ** polls is left out of the next rounds. The transport must implement the
+ ** deadline aware entries, otherwise it blocks.
+ **
+ ** \param master Master structure.
+ ** \param timeout Timeout in milliseconds, 0 waits forever.
+ **/
+void UPDT_broadcastMasterSetTimeout(UPDT_broadcastMasterType *master, uint32_t timeout);
+
+/** \brief Updates every slave of the bus.
+ **
+ ** Broadcasts the image, polls the slaves and broadcasts again the frames
+ ** any of them misses, up to UPDT_BROADCAST_ROUNDS_MAX rounds. At the end
+ ** the transfer is closed with an ANN frame, also when some slaves are not
+ ** done.
+ **
+ ** \param master Master structure.
+ ** \param slaves Addresses of the slaves.
+ ** \param status State of each slave at the end, a UPDT_BROADCAST_SLAVE
+ ** value.
+ ** \param count Number of slaves.
+ ** \return UPDT_PROTOCOL_ERROR_NONE if every slave is done.
+ ** UPDT_PROTOCOL_ERROR_TIMEOUT if some are not, their status tells why.
+ ** UPDT_PROTOCOL_ERROR_TRANSPORT if the bus failed.
+ **/
+int32_t UPDT_broadcastMasterRun(
+   UPDT_broadcastMasterType *master,
+   const uint8_t *slaves,
+   uint8_t *status,
+   size_t count);
+
+/** \brief Initializes a broadcast slave.
+ **
+ ** \param slave Slave structure.
+ ** \param transport Transport of the shared bus.
+ ** \param address Address polled by the master, unique on the bus.
+ ** \param frame Memory of a frame, UPDT_PROTOCOL_FRAME_SIZE of the largest
+ ** DAT payload accepted and at least of the ANN payload.
+ ** \param frame_size Size of the frame memory.
+ ** \param received Memory of the bitmap, UPDT_BROADCAST_BITMAP_SIZE bytes
+ ** for the frames of the largest image accepted.
+ ** \param received_size Size of the bitmap memory.
+ ** \param consumer Consumer of the image, the flash writer. It gets image
+ ** offsets in any order and only bytes inside the image.
+ ** \param context Context of the consumer.
+ **/
+void UPDT_broadcastSlaveInit(
+   UPDT_broadcastSlaveType *slave,
+   UPDT_ITransportType *transport,
+   uint8_t address,
+   uint8_t *frame,
+   size_t frame_size,
+   uint8_t *received,
+   size_t received_size,
+   UPDT_protocolConsumerType consumer,
+   void *context);
+
+/** \brief Receives and processes the next frame of the bus.
+ **
+ ** Writes the DAT frames of the announced transfer not received yet and
+ ** answers the polls addressed to the slave. Frames of other types, the
+ ** polls of other slaves and the answers are dropped, so the bus must not
+ ** carry a point to point session at the same time. The slave calls it
+ ** until slave->ended, then it checks its image against image_crc if
+ ** slave->missing is 0.
+ **
+ ** \param slave Slave structure.
+ ** \return UPDT_PROTOCOL_ERROR_NONE if a frame was processed or dropped.
+ ** UPDT_PROTOCOL_ERROR_CRC if it was corrupted, the bus may need some
+ ** silence to find the next frame. Transport and consumer errors otherwise.
+ **/
+int32_t UPDT_broadcastSlaveRecv(UPDT_broadcastSlaveType *slave);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef UPDT_BROADCAST_H */
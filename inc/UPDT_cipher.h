@@ -0,0 +1,276 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef UPDT_CIPHER_H
+#define UPDT_CIPHER_H
+/** \brief Flash Update Cipher Header File
+ **
+ ** This files shall be included by modules using the interfaces provided by
+ ** the Flash Update Cipher
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Cipher
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "UPDT_protocol.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** size of a key in bytes */
+#define UPDT_CIPHER_KEY_SIZE             32
+/** size of a ChaCha20 nonce: the frame number and the session nonce */
+#define UPDT_CIPHER_NONCE_SIZE           12
+/** size of the session nonce */
+#define UPDT_CIPHER_SESSION_NONCE_SIZE   8
+/** size of an authentication tag */
+#define UPDT_CIPHER_TAG_SIZE             UPDT_PROTOCOL_TAG_SIZE
+/** size of a ChaCha20 block */
+#define UPDT_CIPHER_BLOCK_SIZE           64
+
+/** UPDT_CIPHER_SIMD is defined when the target has 128 bit vectors, the
+ ** ChaCha20 kernel then computes four blocks at once */
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define UPDT_CIPHER_SIMD
+#endif
+
+/*==================[typedef]================================================*/
+/** \brief ChaCha20 kernel type.
+ **
+ ** Xors data with the key stream starting at block counter. The key and
+ ** the nonce are little endian words.
+ **/
+typedef void (*UPDT_cipherKernelType)(
+   const uint32_t *key,
+   const uint32_t *nonce,
+   uint32_t counter,
+   uint8_t *data,
+   size_t size);
+
+/** \brief Cipher type.
+ **
+ ** ChaCha20-Poly1305 (RFC 8439) of the DAT payloads. The nonce of a frame
+ ** is its number in the session followed by the session nonce, which is
+ ** derived from the INF and ALW payloads, so a key is never used twice
+ ** with the same nonce as long as the slave nonce of the ALW payload is
+ ** not repeated. The cipher plugs into a session:
+ **
+ **    UPDT_cipherInit(&cipher, key, inf_payload, alw_payload);
+ **    UPDT_protocolSessionSetCipher(&session, UPDT_cipherSeal, &cipher);
+ **
+ ** and UPDT_cipherOpen on the slave. Both work in place, the master inside
+ ** its window slot and the slave inside its receive buffer.
+ **/
+typedef struct
+{
+   /** Key as little endian words */
+   uint32_t key[UPDT_CIPHER_KEY_SIZE / 4];
+   /** Nonce as little endian words, the first one is the frame number */
+   uint32_t nonce[UPDT_CIPHER_NONCE_SIZE / 4];
+} UPDT_cipherType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief Initializes a cipher for a session.
+ **
+ ** The session nonce is the start of the SHA-256 of the INF payload
+ ** followed by the ALW payload.
+ **
+ ** \param cipher Cipher structure.
+ ** \param key Key shared by the master and the slave,
+ ** UPDT_CIPHER_KEY_SIZE bytes.
+ ** \param inf INF payload of the session.
+ ** \param alw ALW payload of the session, with the slave nonce at
+ ** UPDT_PROTOCOL_ALW_NONCE_OFFSET.
+ **/
+void UPDT_cipherInit(
+   UPDT_cipherType *cipher,
+   const uint8_t *key,
+   const uint8_t *inf,
+   const uint8_t *alw);
+
+/** \brief Sets the session nonce.
+ **
+ ** For masters and slaves that agree on it by other means.
+ **
+ ** \param cipher Cipher structure, its key already set.
+ ** \param nonce Session nonce, UPDT_CIPHER_SESSION_NONCE_SIZE bytes.
+ **/
+void UPDT_cipherSetNonce(UPDT_cipherType *cipher, const uint8_t *nonce);
+
+/** \brief Encrypts data in place and computes its tag.
+ **
+ ** \param cipher Cipher structure.
+ ** \param number Number of the frame, it must not be repeated.
+ ** \param aad Data authenticated but not encrypted, the frame header.
+ ** \param aad_size Size of aad.
+ ** \param data Data to encrypt.
+ ** \param size Size of data.
+ ** \param tag Buffer of UPDT_CIPHER_TAG_SIZE bytes for the tag.
+ **/
+void UPDT_cipherEncrypt(
+   const UPDT_cipherType *cipher,
+   uint32_t number,
+   const uint8_t *aad,
+   size_t aad_size,
+   uint8_t *data,
+   size_t size,
+   uint8_t *tag);
+
+/** \brief Checks the tag of data and decrypts it in place.
+ **
+ ** The data is only decrypted if it is authentic.
+ **
+ ** \param cipher Cipher structure.
+ ** \param number Number of the frame.
+ ** \param aad Data authenticated but not encrypted, the frame header.
+ ** \param aad_size Size of aad.
+ ** \param data Data to decrypt.
+ ** \param size Size of data.
+ ** \param tag Tag received with the data.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success, UPDT_PROTOCOL_ERROR_DENIED
+ ** if the data is not authentic.
+ **/
+int32_t UPDT_cipherDecrypt(
+   const UPDT_cipherType *cipher,
+   uint32_t number,
+   const uint8_t *aad,
+   size_t aad_size,
+   uint8_t *data,
+   size_t size,
+   const uint8_t *tag);
+
+/** \brief Encrypts the payload of a DAT frame.
+ **
+ ** It is a UPDT_protocolCipherType for the sender. The tag takes the last
+ ** UPDT_CIPHER_TAG_SIZE bytes of the payload.
+ **/
+int32_t UPDT_cipherSeal(
+   void *cipher,
+   const uint8_t *header,
+   uint8_t *payload,
+   uint32_t number);
+
+/** \brief Authenticates and decrypts the payload of a DAT frame.
+ **
+ ** It is a UPDT_protocolCipherType for the receiver.
+ **/
+int32_t UPDT_cipherOpen(
+   void *cipher,
+   const uint8_t *header,
+   uint8_t *payload,
+   uint32_t number);
+
+/** \brief Xors data with the ChaCha20 key stream.
+ **
+ ** Uses the fastest kernel available for the target, it is a
+ ** UPDT_cipherKernelType.
+ **/
+void UPDT_cipherChaCha20(
+   const uint32_t *key,
+   const uint32_t *nonce,
+   uint32_t counter,
+   uint8_t *data,
+   size_t size);
+
+/** \brief ChaCha20 kernel computing one block at a time.
+ **
+ ** Same interface as UPDT_cipherChaCha20.
+ **/
+void UPDT_cipherChaCha20Scalar(
+   const uint32_t *key,
+   const uint32_t *nonce,
+   uint32_t counter,
+   uint8_t *data,
+   size_t size);
+
+#ifdef UPDT_CIPHER_SIMD
+/** \brief ChaCha20 kernel computing four blocks at a time.
+ **
+ ** Same interface as UPDT_cipherChaCha20. Only available if
+ ** UPDT_CIPHER_SIMD is defined.
+ **/
+void UPDT_cipherChaCha20Simd(
+   const uint32_t *key,
+   const uint32_t *nonce,
+   uint32_t counter,
+   uint8_t *data,
+   size_t size);
+#endif
+
+/** \brief Computes the Poly1305 tag of a message.
+ **
+ ** \param key One time key, 32 bytes.
+ ** \param message Message.
+ ** \param size Size of the message.
+ ** \param tag Buffer of UPDT_CIPHER_TAG_SIZE bytes for the tag.
+ **/
+void UPDT_cipherPoly1305(
+   const uint8_t *key,
+   const uint8_t *message,
+   size_t size,
+   uint8_t *tag);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef UPDT_CIPHER_H */
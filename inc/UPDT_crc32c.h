@@ -0,0 +1,145 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef UPDT_CRC32C_H
+#define UPDT_CRC32C_H
+/** \brief Flash Update CRC32C Header File
+ **
+ ** This files shall be included by modules using the interfaces provided by
+ ** the Flash Update CRC32C
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update CRC32C
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_string.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** size of an encoded CRC32C in bytes */
+#define UPDT_CRC32C_SIZE                  4
+
+/** UPDT_CRC32C_HARDWARE is defined when the target has CRC32C instructions */
+#if defined(__SSE4_2__) || defined(__ARM_FEATURE_CRC32)
+#define UPDT_CRC32C_HARDWARE
+#endif
+
+/*==================[typedef]================================================*/
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief Updates a CRC32C (Castagnoli) with a block of data.
+ **
+ ** Uses the fastest kernel available for the target. The CRC of a stream
+ ** is computed incrementally starting with 0 and passing the previous
+ ** result on every call:
+ **
+ **    crc = UPDT_crc32cUpdate(0, block1, size1);
+ **    crc = UPDT_crc32cUpdate(crc, block2, size2);
+ **
+ ** \param crc CRC of the previous data, 0 for the first block.
+ ** \param data Data block.
+ ** \param size Size of the data block in bytes.
+ ** \return CRC of the previous data followed by the data block.
+ **/
+uint32_t UPDT_crc32cUpdate(uint32_t crc, const void *data, size_t size);
+
+/** \brief Updates a CRC32C using one table lookup per byte.
+ **
+ ** Same interface as UPDT_crc32cUpdate. It uses 1 KB of tables.
+ **/
+uint32_t UPDT_crc32cUpdateBytewise(uint32_t crc, const void *data, size_t size);
+
+/** \brief Updates a CRC32C using the slice-by-8 algorithm.
+ **
+ ** Same interface as UPDT_crc32cUpdate. It processes 8 bytes per iteration
+ ** using 8 KB of tables.
+ **/
+uint32_t UPDT_crc32cUpdateSlice8(uint32_t crc, const void *data, size_t size);
+
+#ifdef UPDT_CRC32C_HARDWARE
+/** \brief Updates a CRC32C using the CRC32C instructions of the target.
+ **
+ ** Same interface as UPDT_crc32cUpdate. Only available if
+ ** UPDT_CRC32C_HARDWARE is defined.
+ **/
+uint32_t UPDT_crc32cUpdateHardware(uint32_t crc, const void *data, size_t size);
+#endif
+
+/** \brief Encodes a CRC32C in little endian byte order.
+ **
+ ** \param buffer Buffer of UPDT_CRC32C_SIZE bytes.
+ ** \param crc CRC to encode.
+ **/
+void UPDT_crc32cSet(uint8_t *buffer, uint32_t crc);
+
+/** \brief Decodes a CRC32C stored in little endian byte order.
+ **
+ ** \param buffer Buffer of UPDT_CRC32C_SIZE bytes.
+ ** \return The decoded CRC.
+ **/
+uint32_t UPDT_crc32cGet(const uint8_t *buffer);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef UPDT_CRC32C_H */
@@ -0,0 +1,201 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef UPDT_DELTA_H
+#define UPDT_DELTA_H
+/** \brief Flash Update Delta Header File
+ **
+ ** This files shall be included by modules using the interfaces provided by
+ ** the Flash Update Delta
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Delta
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "UPDT_protocol.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** first bytes of a patch, "UDP1" */
+#define UPDT_DELTA_MAGIC                 0x31504455u
+/** size of the patch header: magic, source size, source CRC32C, target
+ ** size and target CRC32C, little endian */
+#define UPDT_DELTA_HEADER_SIZE           20
+/** size of a record header: diff size, extra size and source seek */
+#define UPDT_DELTA_RECORD_SIZE           12
+/** bytes of the installed image read at once */
+#ifndef UPDT_DELTA_SOURCE_BUFFER_SIZE
+#define UPDT_DELTA_SOURCE_BUFFER_SIZE    64
+#endif
+
+/*==================[typedef]================================================*/
+/** \brief Reads bytes of the installed image.
+ **
+ ** \param context Context given to UPDT_deltaPatcherInit.
+ ** \param offset Position in the installed image.
+ ** \param data Buffer for the bytes.
+ ** \param size Number of bytes to read.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success, any other value aborts the
+ ** patch and is returned to the caller.
+ **/
+typedef int32_t (*UPDT_deltaReaderType)(void *context, size_t offset, uint8_t *data, size_t size);
+
+/** \brief Delta patcher type.
+ **
+ ** A patch rebuilds the new image from the installed one, bsdiff style. It
+ ** is a header followed by records. Each record moves the source position
+ ** by a signed seek, then holds diff bytes, added byte by byte to the source
+ ** bytes at that position, and extra bytes, copied as they are. Code that
+ ** only moved gives diff bytes which are mostly zero, so the patch
+ ** compresses well with UPDT_lzss.
+ **
+ ** The patcher keeps a record header and UPDT_DELTA_SOURCE_BUFFER_SIZE
+ ** bytes of the source, whatever the image size. The installed image is
+ ** read while the new one is written, so they must live in different
+ ** flash areas.
+ **/
+typedef struct
+{
+   /** Header being received */
+   uint8_t header[UPDT_DELTA_HEADER_SIZE];
+   /** Bytes of the installed image and sums of the diff */
+   uint8_t source[UPDT_DELTA_SOURCE_BUFFER_SIZE];
+   /** Bytes of header received */
+   uint8_t fill;
+   /** Part of the patch expected next */
+   uint8_t state;
+   /** Diff bytes left in the current record */
+   uint32_t diff_left;
+   /** Extra bytes left in the current record */
+   uint32_t extra_left;
+   /** Position in the installed image */
+   size_t position;
+   /** Size of the installed image */
+   size_t source_size;
+   /** Size of the new image, from the patch header */
+   size_t target_size;
+   /** CRC32C of the new image, from the patch header */
+   uint32_t target_crc;
+   /** CRC32C of the bytes produced so far */
+   uint32_t crc;
+   /** Bytes of the new image produced so far */
+   size_t produced;
+   /** Reader of the installed image */
+   UPDT_deltaReaderType reader;
+   /** Context of the reader */
+   void *reader_context;
+   /** Consumer of the new image */
+   UPDT_protocolConsumerType consumer;
+   /** Context of the consumer */
+   void *context;
+} UPDT_deltaPatcherType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief Initializes a patcher.
+ **
+ ** \param patcher Patcher structure.
+ ** \param source_size Size of the installed image.
+ ** \param reader Reader of the installed image.
+ ** \param reader_context Context of the reader.
+ ** \param consumer Consumer of the new image, the flash writer.
+ ** \param context Context of the consumer.
+ **/
+void UPDT_deltaPatcherInit(
+   UPDT_deltaPatcherType *patcher,
+   size_t source_size,
+   UPDT_deltaReaderType reader,
+   void *reader_context,
+   UPDT_protocolConsumerType consumer,
+   void *context);
+
+/** \brief Applies a piece of a patch.
+ **
+ ** It is a UPDT_protocolConsumerType, so it can be chained after the
+ ** protocol or after UPDT_lzssDecoderConsume. The patch may be cut anywhere.
+ ** When the header is complete the whole installed image is read once to
+ ** check that the patch was made for it. The bytes after the end of the
+ ** patch are ignored.
+ **
+ ** \param patcher Patcher structure.
+ ** \param offset Position of the piece in the patch, unused.
+ ** \param data Piece of the patch.
+ ** \param size Size of the piece.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success.
+ ** UPDT_PROTOCOL_ERROR_DENIED if the patch was made for another image.
+ ** UPDT_PROTOCOL_ERROR_PACKET if the patch is malformed.
+ ** UPDT_PROTOCOL_ERROR_CRC if the new image does not match the patch.
+ ** The reader or consumer error if one of them failed.
+ **/
+int32_t UPDT_deltaPatcherConsume(
+   void *patcher,
+   size_t offset,
+   const uint8_t *data,
+   size_t size);
+
+/** \brief Returns non-zero when the new image was rebuilt and checked. */
+uint8_t UPDT_deltaPatcherDone(const UPDT_deltaPatcherType *patcher);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef UPDT_DELTA_H */
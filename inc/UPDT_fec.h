@@ -0,0 +1,201 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef UPDT_FEC_H
+#define UPDT_FEC_H
+/** \brief Flash Update Forward Error Correction Header File
+ **
+ ** This files shall be included by modules using the interfaces provided by
+ ** the Flash Update Forward Error Correction
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Forward Error Correction
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** largest number of data blocks of a group */
+#define UPDT_FEC_DATA_MAX                16
+/** largest number of parity blocks of a group */
+#define UPDT_FEC_PARITY_MAX              4
+
+/** size of the memory of a group of data and parity blocks */
+#define UPDT_FEC_BUFFER_SIZE(data, parity, block_size)                        \
+   ((size_t) ((data) + (parity)) * (block_size))
+
+/*==================[typedef]================================================*/
+/** \brief Forward error correction type.
+ **
+ ** Systematic Reed-Solomon code over GF(2^8) for groups of up to
+ ** UPDT_FEC_DATA_MAX data blocks protected by up to UPDT_FEC_PARITY_MAX
+ ** parity blocks. Parity block j is the sum of the data blocks i
+ ** multiplied by the coefficient of a Cauchy matrix, so any parity blocks
+ ** rebuild as many lost data blocks. The columns of the matrix are scaled
+ ** so that parity block 0 is the plain xor of the data blocks, a group
+ ** with one parity block costs no multiplication.
+ **
+ ** The sender adds each data block to the parity blocks as it is sent,
+ ** it only keeps the parity blocks. The receiver keeps the whole group
+ ** until the missing data blocks are rebuilt.
+ **/
+typedef struct
+{
+   /** Data blocks followed by the parity blocks */
+   uint8_t *blocks;
+   /** Size of each block in bytes */
+   uint16_t block_size;
+   /** Number of data blocks of a group */
+   uint8_t data;
+   /** Number of parity blocks of a group */
+   uint8_t parity;
+   /** Blocks of the group stored, bit i for data block i and bit data + j
+    ** for parity block j */
+   uint32_t present;
+} UPDT_fecType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief Initializes a forward error correction group.
+ **
+ ** \param fec Structure to initialize.
+ ** \param buffer Memory for the blocks, UPDT_FEC_BUFFER_SIZE bytes.
+ ** \param size Size of the memory.
+ ** \param data Number of data blocks, from 1 to UPDT_FEC_DATA_MAX.
+ ** \param parity Number of parity blocks, from 1 to UPDT_FEC_PARITY_MAX.
+ ** \param block_size Size of a block.
+ ** \return 0 on success, -1 if the geometry is not valid or the memory is
+ ** too small.
+ **/
+int32_t UPDT_fecInit(
+   UPDT_fecType *fec,
+   uint8_t *buffer,
+   size_t size,
+   uint8_t data,
+   uint8_t parity,
+   uint16_t block_size);
+
+/** \brief Starts a new group, every block is missing and the parity
+ ** blocks are cleared. */
+void UPDT_fecReset(UPDT_fecType *fec);
+
+/** \brief Returns a block of the group.
+ **
+ ** \param fec Group structure.
+ ** \param index Data block index, data + j for parity block j.
+ **/
+uint8_t *UPDT_fecBlock(UPDT_fecType *fec, uint8_t index);
+
+/** \brief Adds a piece of a data block to the parity blocks.
+ **
+ ** Used by the sender, the pieces of a block may be added in any order and
+ ** the bytes never added count as zeros. The data block is marked present.
+ **
+ ** \param fec Group structure.
+ ** \param index Data block index.
+ ** \param offset Position of the piece inside the block.
+ ** \param data Piece of the data block.
+ ** \param size Size of the piece.
+ **/
+void UPDT_fecEncode(
+   UPDT_fecType *fec,
+   uint8_t index,
+   size_t offset,
+   const uint8_t *data,
+   size_t size);
+
+/** \brief Marks a block written in place with UPDT_fecBlock as present.
+ **
+ ** Used by the receiver, the bytes after size are cleared.
+ **
+ ** \param fec Group structure.
+ ** \param index Block index, data + j for parity block j.
+ ** \param size Bytes of the block written.
+ **/
+void UPDT_fecAdd(UPDT_fecType *fec, uint8_t index, size_t size);
+
+/** \brief Returns non-zero if a block of the group is present. */
+uint8_t UPDT_fecIsPresent(const UPDT_fecType *fec, uint8_t index);
+
+/** \brief Returns the number of data blocks among the first count which
+ ** are missing. */
+uint8_t UPDT_fecMissing(const UPDT_fecType *fec, uint8_t count);
+
+/** \brief Returns the number of parity blocks present. */
+uint8_t UPDT_fecParity(const UPDT_fecType *fec);
+
+/** \brief Rebuilds the missing data blocks.
+ **
+ ** The parity blocks used are consumed and marked missing.
+ **
+ ** \param fec Group structure.
+ ** \param count Number of data blocks of the group, the sender may close a
+ ** group before it has data blocks.
+ ** \return 0 if the first count data blocks are present, -1 if there are
+ ** fewer parity blocks than missing data blocks.
+ **/
+int32_t UPDT_fecDecode(UPDT_fecType *fec, uint8_t count);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef UPDT_FEC_H */
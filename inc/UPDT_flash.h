@@ -0,0 +1,374 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef UPDT_FLASH_H
+#define UPDT_FLASH_H
+/** \brief Flash Update Flash Sink Header File
+ **
+ ** This files shall be included by modules using the interfaces provided by
+ ** the Flash Update Flash Sink
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Flash
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.4  AG  report the operations saved in the session statistics
+ * 20261017 v0.0.3  AG  stage the payload of a frame until it is committed
+ * 20261017 v0.0.2  AG  add erase planning and unchanged pages skipping
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "os.h"
+#include "ciaaPOSIX_stdint.h"
+#include "UPDT_IFlash.h"
+#include "UPDT_protocol.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** largest number of page buffers of a sink */
+#define UPDT_FLASH_BUFFERS_MAX           4
+/** program jobs queued at once: one per buffer and a partial page */
+#define UPDT_FLASH_JOBS_MAX              (UPDT_FLASH_BUFFERS_MAX + 1)
+/** frames waiting for their payload to be programmed */
+#define UPDT_FLASH_TAGS_MAX              16
+
+/*==================[typedef]================================================*/
+/** \brief Program job, a range of a page buffer. */
+typedef struct
+{
+   /** Flash address of the range */
+   uint32_t address;
+   /** Start of the range in the buffer */
+   uint16_t start;
+   /** Size of the range */
+   uint16_t size;
+   /** Buffer holding the range */
+   uint8_t buffer;
+} UPDT_flashJobType;
+
+/** \brief Frame waiting for its payload to be programmed. */
+typedef struct
+{
+   /** Image offset after the payload */
+   uint32_t end;
+   /** Caller value, usually the sequence number */
+   uint8_t tag;
+} UPDT_flashTagType;
+
+/** \brief Flash operations counters, written by the worker. */
+typedef struct
+{
+   /** Sectors erased */
+   uint32_t erases;
+   /** Program operations */
+   uint32_t programs;
+   /** Sectors left as they were because the image did not change them */
+   uint32_t erases_saved;
+   /** Program operations not needed because the data was already there */
+   uint32_t programs_saved;
+} UPDT_flashStatsType;
+
+/** \brief Flash sink type.
+ **
+ ** Writes the image to flash through page sized buffers. One buffer fills
+ ** with the incoming payloads while the full ones are erased and programmed
+ ** by a worker task, so the slave keeps receiving during the flash
+ ** operations. Without a worker the jobs run in the caller.
+ **
+ ** The payload of a frame stays in the buffers until UPDT_flashSinkCommit,
+ ** so a frame failing its CRC is never programmed and its retransmission
+ ** overwrites it. The buffers after the committed part of the current page
+ ** must hold the largest payload: count - 1 buffers at least when the
+ ** payloads do not line up with the pages.
+ **
+ ** The producer side (Consume, Commit, Durable, Flush and Close) runs in
+ ** one task, the worker in another. Each shared counter has one writer, so
+ ** no resource is needed.
+ **
+ ** A slave acknowledging only durable data defers the acknowledgements of
+ ** its session and, after each frame:
+ **
+ **    UPDT_flashSinkCommit(&sink, UPDT_protocolGetSequenceNumber(header));
+ **    if(UPDT_protocolSessionUnacked(&session) >= session.window_size)
+ **    {
+ **       UPDT_flashSinkFlush(&sink);
+ **    }
+ **    if(UPDT_flashSinkDurable(&sink, &sequence_number))
+ **    {
+ **       UPDT_protocolSessionAck(&session, sequence_number);
+ **    }
+ **/
+typedef struct
+{
+   /** Flash device */
+   UPDT_IFlashType *flash;
+   /** count page buffers of flash->page_size bytes */
+   uint8_t *buffers;
+   /** Number of page buffers */
+   uint8_t count;
+   /** Flash address of the image */
+   uint32_t base;
+   /** Buffer being filled */
+   uint8_t current;
+   /** First byte of the current buffer not queued yet */
+   uint16_t start;
+   /** Committed bytes in the current buffer */
+   uint16_t fill;
+   /** Flash address of the current buffer */
+   uint32_t address;
+   /** Image bytes committed */
+   uint32_t written;
+   /** Bytes of the frame being received, placed after the committed ones */
+   uint32_t staged;
+   /** Number of jobs queued when each buffer was last queued */
+   uint32_t release[UPDT_FLASH_BUFFERS_MAX];
+   /** Queued jobs */
+   UPDT_flashJobType jobs[UPDT_FLASH_JOBS_MAX];
+   /** Jobs queued, written by the producer */
+   volatile uint32_t queued;
+   /** Jobs done, written by the worker */
+   volatile uint32_t done;
+   /** Image bytes programmed, written by the worker */
+   volatile uint32_t durable;
+   /** First flash address not erased, or not verified unchanged in skip
+    ** mode, used by the worker */
+   uint32_t erased;
+   /** Flash address after the image if it is known, the worker erases up to
+    ** it while idle */
+   volatile uint32_t end;
+   /** One sector of memory enabling the skip mode, NULL otherwise */
+   uint8_t *scratch;
+   /** Programs skipped in the sector being verified unchanged */
+   uint32_t skipped;
+   /** Operations counters */
+   UPDT_flashStatsType stats;
+   /** First error of the worker */
+   volatile int32_t error;
+   /** Non-zero when the worker must return, written by the producer */
+   volatile uint8_t closing;
+   /** Non-zero once the worker returned, written by the worker */
+   volatile uint8_t closed;
+   /** Frames waiting for their payload to be programmed */
+   UPDT_flashTagType tags[UPDT_FLASH_TAGS_MAX];
+   /** Oldest tag */
+   uint8_t tag_first;
+   /** Number of tags */
+   uint8_t tag_count;
+   /** Non-zero if a worker task runs the jobs */
+   uint8_t threaded;
+   /** Worker task */
+   TaskType worker;
+   /** Event set to the worker when a job is queued */
+   EventMaskType work_event;
+   /** Producer task */
+   TaskType owner;
+   /** Event set to the producer when a job is done */
+   EventMaskType done_event;
+} UPDT_flashSinkType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief Initializes a sink without worker, the jobs run in the caller.
+ **
+ ** \param sink Sink structure.
+ ** \param flash Flash device.
+ ** \param buffers Memory for count buffers of flash->page_size bytes.
+ ** \param count Number of buffers, 1 to UPDT_FLASH_BUFFERS_MAX.
+ ** \param base Flash address of the image, aligned to a sector.
+ **/
+void UPDT_flashSinkInit(
+   UPDT_flashSinkType *sink,
+   UPDT_IFlashType *flash,
+   uint8_t *buffers,
+   uint8_t count,
+   uint32_t base);
+
+/** \brief Hands the jobs to a worker task.
+ **
+ ** The worker task calls UPDT_flashSinkWork. Both tasks must be extended
+ ** tasks owning their events.
+ **
+ ** \param sink Sink structure.
+ ** \param worker Worker task.
+ ** \param work_event Event of the worker task.
+ ** \param owner Task calling the producer side functions.
+ ** \param done_event Event of the producer task.
+ **/
+void UPDT_flashSinkSetWorker(
+   UPDT_flashSinkType *sink,
+   TaskType worker,
+   EventMaskType work_event,
+   TaskType owner,
+   EventMaskType done_event);
+
+/** \brief Sets the size of the image.
+ **
+ ** With a worker, the sectors the image needs are erased ahead of the
+ ** write cursor whenever the worker has no page to program. It is usually
+ ** called with the data_size of the INF payload, see
+ ** UPDT_PROTOCOL_INF_DATA_SIZE_OFFSET. Ignored in skip mode, where the
+ ** erases depend on the data.
+ **
+ ** \param sink Sink structure.
+ ** \param size Size of the image in bytes.
+ **/
+void UPDT_flashSinkPlan(UPDT_flashSinkType *sink, uint32_t size);
+
+/** \brief Enables the skip mode.
+ **
+ ** Each range to program is compared, byte by byte, with the installed
+ ** one. A sector is only erased when a range differs, so the sectors the
+ ** image leaves unchanged are neither erased nor programmed. The unchanged
+ ** data before the first difference of a sector is copied to scratch and
+ ** programmed back after the erase. In a sector left unchanged the bytes
+ ** after the end of the image keep their old content.
+ **
+ ** The flash must implement read. It must be called before the first
+ ** piece is written.
+ **
+ ** \param sink Sink structure.
+ ** \param scratch Memory for flash->sector_size bytes.
+ **/
+void UPDT_flashSinkSetSkip(UPDT_flashSinkType *sink, uint8_t *scratch);
+
+/** \brief Writes a piece of the image.
+ **
+ ** It is a UPDT_protocolConsumerType. The piece is placed at offset after
+ ** the data committed up to now and is only programmed once the frame is
+ ** committed, a payload consumed again from offset 0 replaces the previous
+ ** one. It only waits for a buffer still being programmed.
+ **
+ ** \param sink Sink structure.
+ ** \param offset Position of the piece in its payload.
+ ** \param data Piece of the image.
+ ** \param size Size of the piece.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success, UPDT_PROTOCOL_ERROR_FLASH
+ ** if an erase or a program failed.
+ **/
+int32_t UPDT_flashSinkConsume(
+   void *sink,
+   size_t offset,
+   const uint8_t *data,
+   size_t size);
+
+/** \brief Marks the end of a frame.
+ **
+ ** The payload consumed since the last commit becomes part of the image and
+ ** its full pages are queued. It must only be called once the frame passed
+ ** its CRC check.
+ **
+ ** \param sink Sink structure.
+ ** \param tag Value returned by UPDT_flashSinkDurable once everything
+ ** written up to now is programmed. With UPDT_FLASH_TAGS_MAX tags waiting,
+ ** it replaces the newest one.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success, UPDT_PROTOCOL_ERROR_FLASH
+ ** if an erase or a program failed.
+ **/
+int32_t UPDT_flashSinkCommit(UPDT_flashSinkType *sink, uint8_t tag);
+
+/** \brief Returns the last tag whose data is programmed.
+ **
+ ** \param sink Sink structure.
+ ** \param tag Set to the last tag whose data is programmed.
+ ** \return Non-zero if a tag became durable since the last call.
+ **/
+uint8_t UPDT_flashSinkDurable(UPDT_flashSinkType *sink, uint8_t *tag);
+
+/** \brief Copies the flash counters of a sink to the session statistics.
+ **
+ ** A slave calls it before UPDT_protocolSessionSendStats, so the master
+ ** sees the flash operations made and how many the skip mode saved. Only
+ ** the flash counters of stats are written.
+ **
+ ** \param sink Sink structure.
+ ** \param stats Statistics given to UPDT_protocolSessionSetStats.
+ **/
+void UPDT_flashSinkGetStats(const UPDT_flashSinkType *sink, UPDT_protocolStatsType *stats);
+
+/** \brief Programs everything committed and waits for it.
+ **
+ ** A partial page is programmed as it is, the rest of it is programmed
+ ** when it fills. A payload not committed yet is not programmed.
+ **
+ ** \param sink Sink structure.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success, UPDT_PROTOCOL_ERROR_FLASH
+ ** on error.
+ **/
+int32_t UPDT_flashSinkFlush(UPDT_flashSinkType *sink);
+
+/** \brief Flushes the sink and waits for the worker to return.
+ **
+ ** Once it returns the worker task may be activated again for another sink.
+ **
+ ** \param sink Sink structure.
+ ** \return Same as UPDT_flashSinkFlush.
+ **/
+int32_t UPDT_flashSinkClose(UPDT_flashSinkType *sink);
+
+/** \brief Body of the worker task.
+ **
+ ** Runs the jobs as they are queued and returns when the sink is closed.
+ **
+ ** \param sink Sink structure.
+ **/
+void UPDT_flashSinkWork(UPDT_flashSinkType *sink);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef UPDT_FLASH_H */
@@ -0,0 +1,199 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef UPDT_LZSS_H
+#define UPDT_LZSS_H
+/** \brief Flash Update LZSS Header File
+ **
+ ** This files shall be included by modules using the interfaces provided by
+ ** the Flash Update LZSS
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update LZSS
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "UPDT_protocol.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** bits of the distance of a match */
+#define UPDT_LZSS_DISTANCE_BITS          10
+/** bits of the length of a match */
+#define UPDT_LZSS_LENGTH_BITS            6
+/** size of the decoder window, the farthest a match can reach */
+#define UPDT_LZSS_WINDOW_SIZE            (1u << UPDT_LZSS_DISTANCE_BITS)
+/** shortest match, shorter ones are encoded as literals */
+#define UPDT_LZSS_MATCH_MIN              3
+/** longest match */
+#define UPDT_LZSS_MATCH_MAX              (UPDT_LZSS_MATCH_MIN + (1u << UPDT_LZSS_LENGTH_BITS) - 1)
+/** largest encoding of size bytes: every byte a literal plus the flags */
+#define UPDT_LZSS_BOUND(size)            ((size) + ((size) + 7) / 8)
+
+/*==================[typedef]================================================*/
+/** \brief LZSS streaming decoder type.
+ **
+ ** The compressed stream is a sequence of groups. Each group starts with a
+ ** flag byte describing up to 8 items, least significant bit first: 1 is a
+ ** literal byte, 0 is a match. A match takes 2 bytes, big endian: the
+ ** distance minus 1 in the upper UPDT_LZSS_DISTANCE_BITS bits and the
+ ** length minus UPDT_LZSS_MATCH_MIN in the lower UPDT_LZSS_LENGTH_BITS
+ ** bits. A match may overlap the bytes it produces.
+ **
+ ** The decoder keeps the last UPDT_LZSS_WINDOW_SIZE bytes produced, it
+ ** needs no other memory. The input may be cut anywhere, so the frames of a
+ ** compressed image are fed in order as they arrive.
+ **/
+typedef struct
+{
+   /** Last bytes produced */
+   uint8_t window[UPDT_LZSS_WINDOW_SIZE];
+   /** Position of the next byte produced in the window */
+   uint16_t position;
+   /** First byte of the window not given to the consumer yet */
+   uint16_t flushed;
+   /** Flags of the current group, shifted as the items are decoded */
+   uint8_t flags;
+   /** Items left in the current group */
+   uint8_t flag_count;
+   /** First byte of a match cut by the end of the input */
+   uint8_t pending;
+   /** Non-zero if pending holds a byte */
+   uint8_t has_pending;
+   /** Bytes produced so far */
+   size_t produced;
+   /** Bytes given to the consumer so far */
+   size_t output;
+   /** Decompressed size, the input after it is padding */
+   size_t size;
+   /** Consumer of the decompressed bytes */
+   UPDT_protocolConsumerType consumer;
+   /** Context of the consumer */
+   void *context;
+} UPDT_lzssDecoderType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief Initializes a decoder.
+ **
+ ** \param decoder Decoder structure.
+ ** \param size Decompressed size. The frames are padded to a multiple of 8
+ ** bytes, the bytes decoded after this size are ignored.
+ ** \param consumer Consumer of the decompressed bytes, the flash writer.
+ ** \param context Context of the consumer.
+ **/
+void UPDT_lzssDecoderInit(
+   UPDT_lzssDecoderType *decoder,
+   size_t size,
+   UPDT_protocolConsumerType consumer,
+   void *context);
+
+/** \brief Decodes a piece of the compressed stream.
+ **
+ ** It is a UPDT_protocolConsumerType, so it can be chained after the
+ ** protocol. The decompressed bytes are given to the decoder consumer
+ ** straight from the window.
+ **
+ ** Frames are only fed once they are known to be good: the slave receives a
+ ** DAT frame flagged UPDT_PROTOCOL_FLAG_COMPRESSED with
+ ** UPDT_protocolSessionRecv and hands its payload to this function, whose
+ ** consumer writes the flash.
+ **
+ ** \param decoder Decoder structure.
+ ** \param offset Position of the piece in the compressed stream, unused.
+ ** \param data Piece of the compressed stream.
+ ** \param size Size of the piece.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success. UPDT_PROTOCOL_ERROR_PACKET
+ ** if a match reaches before the start of the stream. The consumer error if
+ ** it failed.
+ **/
+int32_t UPDT_lzssDecoderConsume(
+   void *decoder,
+   size_t offset,
+   const uint8_t *data,
+   size_t size);
+
+/** \brief Returns non-zero when the whole decompressed size was produced. */
+uint8_t UPDT_lzssDecoderDone(const UPDT_lzssDecoderType *decoder);
+
+/** \brief Compresses a buffer.
+ **
+ ** Greedy encoder searching the whole window. It uses no memory besides
+ ** the buffers, so a master can compress on the target, but it is slow:
+ ** images are better compressed on the host with tools/updt_lzss.py, which
+ ** writes the same format.
+ **
+ ** \param input Data to compress.
+ ** \param size Size of the data.
+ ** \param output Buffer for the compressed stream.
+ ** \param capacity Size of the buffer, UPDT_LZSS_BOUND(size) always fits.
+ ** \return Size of the compressed stream. 0 if it does not fit.
+ **/
+size_t UPDT_lzssEncode(
+   const uint8_t *input,
+   size_t size,
+   uint8_t *output,
+   size_t capacity);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef UPDT_LZSS_H */
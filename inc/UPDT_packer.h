@@ -0,0 +1,237 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef UPDT_PACKER_H
+#define UPDT_PACKER_H
+/** \brief Flash Update Packer Header File
+ **
+ ** This files shall be included by modules using the interfaces provided by
+ ** the Flash Update Packer
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Packer
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "UPDT_protocol.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** the format is detected from the first bytes of the image */
+#define UPDT_PACKER_FORMAT_AUTO          0
+/** raw binary, loaded at the address given to UPDT_packerInit */
+#define UPDT_PACKER_FORMAT_RAW           1
+/** 32 bit ELF, its PT_LOAD segments at their physical address */
+#define UPDT_PACKER_FORMAT_ELF           2
+/** Motorola S-records, S1, S2 and S3 data records */
+#define UPDT_PACKER_FORMAT_S19           3
+/** Intel HEX, with extended segment and linear addresses */
+#define UPDT_PACKER_FORMAT_IHEX          4
+
+/** value of the bytes filling the gaps between segments, the one of erased
+ ** flash */
+#define UPDT_PACKER_FILL                 0xFFu
+
+/*==================[typedef]================================================*/
+/** \brief Address-contiguous piece of an image. */
+typedef struct
+{
+   /** Address of the first byte */
+   uint32_t address;
+   /** Size in bytes */
+   uint32_t size;
+   /** The bytes, or the first record of the piece in the text formats */
+   const uint8_t *data;
+} UPDT_packerSegmentType;
+
+/** \brief Packer type.
+ **
+ ** Turns an image file, mapped or loaded in memory, into the stream of DAT
+ ** payloads the slave writes from its base address. The segments of the
+ ** image are sorted by address and the stream covers them from the first
+ ** to the last, the gaps between them and the start and end up to the page
+ ** boundaries filled with UPDT_PACKER_FILL, so the slave only writes whole
+ ** pages.
+ **
+ ** Nothing is copied at initialization: the segments point into the image.
+ ** The payloads of the binary formats are given straight from the image
+ ** unless they cross a gap, those of the text formats are decoded from the
+ ** records into the caller buffer as the stream advances.
+ **
+ ** A master sends the image with:
+ **
+ **    UPDT_crc32cSet(inf + UPDT_PROTOCOL_INF_DATA_SIZE_OFFSET, UPDT_packerGetSize(&packer));
+ **    ...
+ **    while(0 < (size = UPDT_packerGet(&packer, buffer, payload_size, &payload)))
+ **    {
+ **       UPDT_protocolSessionSend(&session, UPDT_PROTOCOL_PACKET_DAT, payload, size);
+ **    }
+ **/
+typedef struct
+{
+   /** Image file */
+   const uint8_t *image;
+   /** Size of the image file */
+   size_t image_size;
+   /** Format of the image file */
+   uint8_t format;
+   /** Segments, sorted by address */
+   UPDT_packerSegmentType *segments;
+   /** Number of segments */
+   uint16_t count;
+   /** Address of the first byte of the stream */
+   uint32_t address;
+   /** Size of the stream */
+   uint32_t size;
+   /** Offset in the stream of the next byte */
+   uint32_t position;
+   /** Segment holding or following the next byte */
+   uint16_t segment;
+   /** Text formats: record after the current one, NULL before the first
+    ** record of the segment */
+   const uint8_t *text;
+   /** Text formats: next data byte of the current record */
+   const uint8_t *record;
+   /** Text formats: data bytes left in the current record */
+   uint8_t left;
+} UPDT_packerType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief Returns the format of an image from its first bytes.
+ **
+ ** \param image Image file.
+ ** \param size Size of the image file.
+ ** \return UPDT_PACKER_FORMAT_ELF, UPDT_PACKER_FORMAT_S19,
+ ** UPDT_PACKER_FORMAT_IHEX or UPDT_PACKER_FORMAT_RAW.
+ **/
+uint8_t UPDT_packerDetect(const uint8_t *image, size_t size);
+
+/** \brief Initializes a packer.
+ **
+ ** Finds the segments of the image. Adjacent records and sections are
+ ** merged in a single segment. The checksums of the text records are
+ ** verified here, so UPDT_packerGet can not fail later.
+ **
+ ** \param packer Packer structure.
+ ** \param image Image file, it must stay in memory while the packer is used.
+ ** \param size Size of the image file.
+ ** \param format Format of the image file, UPDT_PACKER_FORMAT_AUTO detects it.
+ ** \param address Address of a raw image, ignored in the other formats.
+ ** \param page_size The stream starts and ends at multiples of it, 1 keeps
+ ** the first and last bytes of the image.
+ ** \param segments Memory for the segments.
+ ** \param segments_max Number of segments it holds.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success. UPDT_PROTOCOL_ERROR_PACKET
+ ** if the image is malformed, empty, has overlapping segments or more than
+ ** segments_max of them. UPDT_PROTOCOL_ERROR_CRC if a record checksum is
+ ** wrong.
+ **/
+int32_t UPDT_packerInit(
+   UPDT_packerType *packer,
+   const uint8_t *image,
+   size_t size,
+   uint8_t format,
+   uint32_t address,
+   uint32_t page_size,
+   UPDT_packerSegmentType *segments,
+   uint16_t segments_max);
+
+/** \brief Returns the address of the first byte of the stream. */
+uint32_t UPDT_packerGetAddress(const UPDT_packerType *packer);
+
+/** \brief Returns the size of the stream, the data_size of the INF payload. */
+uint32_t UPDT_packerGetSize(const UPDT_packerType *packer);
+
+/** \brief Returns the next payload of the stream.
+ **
+ ** \param packer Packer structure.
+ ** \param buffer Memory for size bytes, used when the payload can not be
+ ** given straight from the image.
+ ** \param size Payload size.
+ ** \param payload Set to the payload, buffer or a pointer into the image.
+ ** \return Size of the payload, smaller than size only at the end of the
+ ** stream. 0 once the whole stream was given.
+ **/
+int32_t UPDT_packerGet(
+   UPDT_packerType *packer,
+   uint8_t *buffer,
+   size_t size,
+   const uint8_t **payload);
+
+/** \brief Moves to an offset of the stream.
+ **
+ ** Moving forward decodes the skipped records of the text formats, moving
+ ** backward starts again from the first segment. It is used to resume a
+ ** transfer, see UPDT_resumeStart.
+ **
+ ** \param packer Packer structure.
+ ** \param offset New offset in the stream.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success. UPDT_PROTOCOL_ERROR_PACKET
+ ** if offset is beyond the end of the stream.
+ **/
+int32_t UPDT_packerSeek(UPDT_packerType *packer, uint32_t offset);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef UPDT_PACKER_H */
@@ -2,6 +2,7 @@
  * Copyright 2014, Esteban Volentini
  * Copyright 2014, Matias Giori
  * Copyright 2014, Franco Salinas
+ * Copyright 2026, agent
  *
  * This file is part of CIAA Firmware.
  *
@@ -54,11 +55,33 @@
  * EV           Esteban Volentini
  * MG           Matias Giori
  * FS           Franco Salinas
+ * AG           agent
  */
 
 /*
  * modification history (new versions first)
  * -----------------------------------------------------------
+ * 20261017 v0.0.24 AG  end the wait of a frame body at half of the timeout
+ * 20261017 v0.0.23 AG  add the flash operations to the statistics
+ * 20261017 v0.0.22 AG  add the flash operations saved to the statistics
+ * 20261017 v0.0.21 AG  add the retransmission timer of the session
+ * 20261017 v0.0.20 AG  add the ANN and NAK packets of the broadcast update
+ * 20261017 v0.0.19 AG  add the forward error correction and the PAR packet
+ * 20261017 v0.0.18 AG  add the encryption of the DAT payloads
+ * 20261017 v0.0.17 AG  add the SIG packet
+ * 20261017 v0.0.16 AG  add the session statistics and the STA packet
+ * 20261017 v0.0.15 AG  add the baud rate negotiation
+ * 20261017 v0.0.14 AG  add deferred acknowledgements
+ * 20261017 v0.0.13 AG  add the resume point
+ * 20261017 v0.0.12 AG  add the delta update mode
+ * 20261017 v0.0.11 AG  add the compressed frame flag
+ * 20261017 v0.0.10 AG  add the session timeouts
+ * 20261017 v0.0.9  AG  add the non-blocking stream
+ * 20261017 v0.0.8  AG  add zero copy receive
+ * 20261017 v0.0.7  AG  add vectored send and receive
+ * 20261017 v0.0.6  AG  add frame and image CRC32C
+ * 20261017 v0.0.5  AG  add payload size negotiation
+ * 20261017 v0.0.4  AG  add sliding window sessions
  * 20150419 v0.0.3  FS  change prefixes
  * 20150408 v0.0.2  FS  first operating version
  * 20141010 v0.0.1  EV  first initial version
@@ -66,6 +89,8 @@
 
 /*==================[inclusions]=============================================*/
 #include "UPDT_ITransport.h"
+#include "UPDT_crc32c.h"
+#include "UPDT_fec.h"
 
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
@@ -77,6 +102,12 @@ extern "C" {
 #define UPDT_PROTOCOL_ERROR_NONE                0
 #define UPDT_PROTOCOL_ERROR_UNKNOWN_VERSION     1
 #define UPDT_PROTOCOL_ERROR_TRANSPORT           2
+#define UPDT_PROTOCOL_ERROR_PACKET              3
+#define UPDT_PROTOCOL_ERROR_DENIED              4
+#define UPDT_PROTOCOL_ERROR_CRC                 5
+#define UPDT_PROTOCOL_ERROR_AGAIN               6
+#define UPDT_PROTOCOL_ERROR_TIMEOUT             7
+#define UPDT_PROTOCOL_ERROR_FLASH               8
 
 #define UPDT_PROTOCOL_VERSION                0x00u
 
@@ -87,29 +118,409 @@ extern "C" {
 #define UPDT_PROTOCOL_PACKET_INF             0x02u
 #define UPDT_PROTOCOL_PACKET_ALW             0x03u
 #define UPDT_PROTOCOL_PACKET_DNY             0x04u
+/** session statistics, see UPDT_protocolSessionQueryStats */
+#define UPDT_PROTOCOL_PACKET_STA             0x05u
+/** image signature, sent after the last DAT frame, see UPDT_signature.h */
+#define UPDT_PROTOCOL_PACKET_SIG             0x06u
+/** parity of a group of DAT frames, see UPDT_protocolSessionSetFec */
+#define UPDT_PROTOCOL_PACKET_PAR             0x07u
+/** announcement of a broadcast update, see UPDT_broadcast.h */
+#define UPDT_PROTOCOL_PACKET_ANN             0x08u
+/** missing frames of a broadcast update: an empty poll from the master or
+ ** the answer of the slave, see UPDT_broadcast.h */
+#define UPDT_PROTOCOL_PACKET_NAK             0x09u
 
-#define UPDT_PROTOCOL_PACKET_VALID(t)  ((t) <= 4)
+#define UPDT_PROTOCOL_PACKET_VALID(t)  ((t) <= 9)
+/** number of packet types, the size of the per type statistics */
+#define UPDT_PROTOCOL_PACKET_TYPES           10
 
 /* header */
 #define UPDT_PROTOCOL_HEADER_SIZE            4
 
+/* frame flags, upper nibble of the first header byte */
+/** the payload is followed by the CRC32C of the header and the payload */
+#define UPDT_PROTOCOL_FLAG_CRC               0x10u
+/** the DAT payload is a piece of an LZSS stream, see UPDT_lzss.h */
+#define UPDT_PROTOCOL_FLAG_COMPRESSED        0x20u
+/** the DAT payload is encrypted and ends with its authentication tag, see
+ ** UPDT_protocolSessionSetCipher */
+#define UPDT_PROTOCOL_FLAG_ENCRYPTED         0x40u
+
+/** size of the authentication tag that ends an encrypted DAT payload */
+#define UPDT_PROTOCOL_TAG_SIZE               16
+
+/* trailer */
+#define UPDT_PROTOCOL_CRC_SIZE               UPDT_CRC32C_SIZE
+
+/** maximum number of blocks of a vectored transfer: header, payload, trailer
+ ** and one spare */
+#define UPDT_PROTOCOL_IOV_MAX                4
+
+/** consecutive timeouts a session recovers from before it gives up */
+#define UPDT_PROTOCOL_RETRIES_MAX            5
+
+/** size of the stack buffer used to feed consumers from transports without
+ ** recv_acquire */
+#define UPDT_PROTOCOL_BOUNCE_SIZE            32
+
 /* payload */
 /* payload sizes in bytes */
 #define UPDT_PROTOCOL_PACKET_ACK_PAYLOAD_SIZE    0
-#define UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE    224 /* <= maximum */
+#define UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE    224 /* <= default, unless negotiated */
 #define UPDT_PROTOCOL_PACKET_INF_PAYLOAD_SIZE    32
+#define UPDT_PROTOCOL_PACKET_ALW_PAYLOAD_SIZE    16
+/** the STA request is empty, the answer carries the UPDT_protocolStatsType
+ ** fields as little endian 32 bit words: four per type counters, six
+ ** session counters, four flash counters and the ten of
+ ** UPDT_ITransportStatsType */
+#define UPDT_PROTOCOL_PACKET_STA_PAYLOAD_SIZE    (4 * (4 * UPDT_PROTOCOL_PACKET_TYPES + 6 + 4 + 10))
+/** the Ed25519 signature of the SHA-256 digest of the image */
+#define UPDT_PROTOCOL_PACKET_SIG_PAYLOAD_SIZE    64
+/** a parity block, as large as the DAT payloads of the session */
+#define UPDT_PROTOCOL_PACKET_PAR_PAYLOAD_SIZE    UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE
+/** transfer id, image size, image CRC32C and DAT payload size */
+#define UPDT_PROTOCOL_PACKET_ANN_PAYLOAD_SIZE    16
+/** the answer of a slave, the poll of the master is empty */
+#define UPDT_PROTOCOL_PACKET_NAK_PAYLOAD_SIZE    64
 
 #define UPDT_PROTOCOL_PAYLOAD_MAX_SIZE UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE
 
+/** largest payload the header can describe */
+#define UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE         2040
+
+/** size of a frame carrying up to payload_size bytes of payload, with room
+ ** for the optional trailer */
+#define UPDT_PROTOCOL_FRAME_SIZE(payload_size)                                \
+   ((payload_size) + UPDT_PROTOCOL_HEADER_SIZE + UPDT_PROTOCOL_CRC_SIZE)
+
+/* update mode */
+/** offset of the update mode flags inside the INF payload, formerly the
+ ** first reserved byte */
+#define UPDT_PROTOCOL_INF_MODE_OFFSET            0
+/** the DAT frames carry a UPDT_delta patch against the installed image
+ ** instead of the whole image. A slave without UPDT_PROTOCOL_CAPABILITY_DELTA
+ ** answers DNY and the master sends the whole image */
+#define UPDT_PROTOCOL_INF_MODE_DELTA             0x01u
+
+/* forward error correction */
+/** offset of the FEC geometry inside the INF payload, formerly the third
+ ** reserved byte, see UPDT_PROTOCOL_FEC_GEOMETRY */
+#define UPDT_PROTOCOL_INF_FEC_OFFSET             8
+/** FEC geometry byte: parity frames in the upper nibble and DAT frames of
+ ** a group minus one in the lower nibble */
+#define UPDT_PROTOCOL_FEC_GEOMETRY(data, parity)                              \
+   ((uint8_t) (((parity) << 4) | (((data) - 1) & 0x0F)))
+/** DAT frames of a group of a FEC geometry byte */
+#define UPDT_PROTOCOL_FEC_DATA(geometry)         (((geometry) & 0x0F) + 1)
+/** parity frames of a group of a FEC geometry byte */
+#define UPDT_PROTOCOL_FEC_PARITY(geometry)       ((geometry) >> 4)
+/** bytes before the payload of a DAT frame inside its FEC block: the first
+ ** and the last header bytes, zero padded. The DAT payloads of a FEC
+ ** session are that much smaller than the session payload size, so that
+ ** the PAR frames fit in it */
+#define UPDT_PROTOCOL_FEC_PREFIX_SIZE            8
+
+/** offset of the image size inside the INF payload, the data_size field,
+ ** used by the slave to plan the flash erases */
+#define UPDT_PROTOCOL_INF_DATA_SIZE_OFFSET       24
+
+/* capabilities */
+/** offset of the capabilities inside the INF payload */
+#define UPDT_PROTOCOL_INF_CAPABILITIES_OFFSET    28
+/** offset of the capabilities inside the ALW payload */
+#define UPDT_PROTOCOL_ALW_CAPABILITIES_OFFSET    0
+/** size of the encoded capabilities */
+#define UPDT_PROTOCOL_CAPABILITIES_SIZE          4
+
+/* resume point */
+/** offset of the resume point inside the ALW payload */
+#define UPDT_PROTOCOL_ALW_RESUME_OFFSET          4
+/** size of the encoded resume point: image offset and CRC32C of the image
+ ** up to it */
+#define UPDT_PROTOCOL_RESUME_SIZE                8
+
+/* session nonce */
+/** offset of the slave nonce inside the ALW payload. The slave never
+ ** repeats it under the same key, a boot counter or a random number, so
+ ** that the session nonce derived from the INF and ALW payloads is unique */
+#define UPDT_PROTOCOL_ALW_NONCE_OFFSET           12
+/** size of the slave nonce */
+#define UPDT_PROTOCOL_NONCE_SIZE                 4
+
+/* capability flags */
+/** frames are protected with a CRC32C trailer */
+#define UPDT_PROTOCOL_CAPABILITY_CRC             0x01u
+/** the image may be sent LZSS compressed */
+#define UPDT_PROTOCOL_CAPABILITY_LZSS            0x02u
+/** the slave applies delta patches */
+#define UPDT_PROTOCOL_CAPABILITY_DELTA           0x04u
+/** the slave reports a resume point in the ALW payload */
+#define UPDT_PROTOCOL_CAPABILITY_RESUME          0x08u
+/** the master sends a SIG frame after the image and the slave only
+ ** activates it if the signature is good */
+#define UPDT_PROTOCOL_CAPABILITY_SIGNATURE       0x10u
+/** the DAT payloads are encrypted with the key of the slave */
+#define UPDT_PROTOCOL_CAPABILITY_ENCRYPTION      0x20u
+/** the master sends PAR frames with the geometry of the INF payload, the
+ ** slave rebuilds lost DAT frames without a retransmission */
+#define UPDT_PROTOCOL_CAPABILITY_FEC             0x40u
+
+/* baud rate codes, in increasing order of speed */
+/** the connection keeps its baud rate */
+#define UPDT_PROTOCOL_BAUD_KEEP                  0
+#define UPDT_PROTOCOL_BAUD_115200                1
+#define UPDT_PROTOCOL_BAUD_230400                2
+#define UPDT_PROTOCOL_BAUD_460800                3
+#define UPDT_PROTOCOL_BAUD_921600                4
+#define UPDT_PROTOCOL_BAUD_1000000               5
+#define UPDT_PROTOCOL_BAUD_2000000               6
+#define UPDT_PROTOCOL_BAUD_3000000               7
+#define UPDT_PROTOCOL_BAUD_4000000               8
+
 #define UPDT_PROTOCOL_PAYLOAD_SIZE(t) (                                       \
    UPDT_PROTOCOL_PACKET_ACK == (t) ? UPDT_PROTOCOL_PACKET_ACK_PAYLOAD_SIZE : (\
    UPDT_PROTOCOL_PACKET_DAT == (t) ? UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE : (\
-   UPDT_PROTOCOL_PACKET_INF == (t) ? UPDT_PROTOCOL_PACKET_INF_PAYLOAD_SIZE :  \
-   UPDT_PROTOCOL_PACKET_INV)))
+   UPDT_PROTOCOL_PACKET_INF == (t) ? UPDT_PROTOCOL_PACKET_INF_PAYLOAD_SIZE : (\
+   UPDT_PROTOCOL_PACKET_ALW == (t) ? UPDT_PROTOCOL_PACKET_ALW_PAYLOAD_SIZE : (\
+   UPDT_PROTOCOL_PACKET_STA == (t) ? UPDT_PROTOCOL_PACKET_STA_PAYLOAD_SIZE : (\
+   UPDT_PROTOCOL_PACKET_SIG == (t) ? UPDT_PROTOCOL_PACKET_SIG_PAYLOAD_SIZE : (\
+   UPDT_PROTOCOL_PACKET_PAR == (t) ? UPDT_PROTOCOL_PACKET_PAR_PAYLOAD_SIZE : (\
+   UPDT_PROTOCOL_PACKET_ANN == (t) ? UPDT_PROTOCOL_PACKET_ANN_PAYLOAD_SIZE : (\
+   UPDT_PROTOCOL_PACKET_NAK == (t) ? UPDT_PROTOCOL_PACKET_NAK_PAYLOAD_SIZE :  \
+   UPDT_PROTOCOL_PACKET_INV)))))))))
 
 
 #define UPDT_PROTOCOL_PACKET_MAX_SIZE    (UPDT_PROTOCOL_PAYLOAD_MAX_SIZE + UPDT_PROTOCOL_HEADER_SIZE)
+
+/* sliding window */
+/** maximum number of unacknowledged frames. It must be smaller than the
+ ** sequence number space so that go-back-N can tell new frames from old ones */
+#define UPDT_PROTOCOL_WINDOW_MAX_SIZE        128u
+
+/** distance from sequence number b to sequence number a, modulo 256 */
+#define UPDT_PROTOCOL_SEQUENCE_DISTANCE(a, b) ((uint8_t) ((uint8_t) (a) - (uint8_t) (b)))
 /*==================[typedef]================================================*/
+/** \brief Payload consumer.
+ **
+ ** Receives a payload in pieces, without copying it out of the transport
+ ** when the transport implements recv_acquire. The data is only valid
+ ** during the call.
+ **
+ ** \param context Consumer context.
+ ** \param offset Position of the piece inside the payload.
+ ** \param data Piece of the payload.
+ ** \param size Size of the piece.
+ ** \return UPDT_PROTOCOL_ERROR_NONE to continue, any other value aborts the
+ ** reception and is returned to the caller.
+ **/
+typedef int32_t (*UPDT_protocolConsumerType)(
+   void *context,
+   size_t offset,
+   const uint8_t *data,
+   size_t size);
+
+/** \brief Frame cipher.
+ **
+ ** Encrypts or decrypts in place the payload of a DAT frame. The payload
+ ** size of the header includes the UPDT_PROTOCOL_TAG_SIZE bytes of the
+ ** authentication tag at the end of the payload, the header itself is
+ ** authenticated too. UPDT_cipherSeal and UPDT_cipherOpen are the software
+ ** ones, a target with a crypto engine may provide its own.
+ **
+ ** \param context Cipher context.
+ ** \param header Header of the frame, UPDT_PROTOCOL_HEADER_SIZE bytes.
+ ** \param payload Payload of the frame.
+ ** \param number Number of the DAT frame in the session, from 0. It is
+ ** never repeated, unlike the sequence number.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success, UPDT_PROTOCOL_ERROR_DENIED
+ ** if the frame is not authentic.
+ **/
+typedef int32_t (*UPDT_protocolCipherType)(
+   void *context,
+   const uint8_t *header,
+   uint8_t *payload,
+   uint32_t number);
+
+/** \brief Protocol capabilities type.
+ **
+ ** The master sends its capabilities in the INF payload and the slave
+ ** answers with the agreed ones in the ALW payload. A zero field means the
+ ** peer does not know about it and the protocol default is used.
+ **/
+typedef struct
+{
+   /** Maximum DAT payload size in bytes, multiple of 8 up to 2040 */
+   uint16_t payload_size;
+   /** Maximum number of unacknowledged frames */
+   uint8_t window_size;
+   /** Capability flags */
+   uint8_t flags;
+   /** Fastest baud rate, a UPDT_PROTOCOL_BAUD code. Once the ALW frame is
+    ** sent the slave switches to the agreed one, the master once it is
+    ** received, see UPDT_serialSetBaudRate */
+   uint8_t baud_rate;
+} UPDT_protocolCapabilitiesType;
+
+/** \brief Session statistics type.
+ **
+ ** Only uint32_t fields, in the order they are sent in the STA payload. The
+ ** counters wrap around.
+ **/
+typedef struct
+{
+   /** Frames sent, by packet type, retransmissions included */
+   uint32_t frames_sent[UPDT_PROTOCOL_PACKET_TYPES];
+   /** Valid frames received, by packet type, discarded ones included */
+   uint32_t frames_received[UPDT_PROTOCOL_PACKET_TYPES];
+   /** Bytes of the frames sent, by packet type */
+   uint32_t bytes_sent[UPDT_PROTOCOL_PACKET_TYPES];
+   /** Bytes of the valid frames received, by packet type */
+   uint32_t bytes_received[UPDT_PROTOCOL_PACKET_TYPES];
+   /** Frames sent again by go-back-N */
+   uint32_t retransmissions;
+   /** Waits for a frame which expired */
+   uint32_t timeouts;
+   /** Frames dropped because of a bad CRC, a bad size or a cut */
+   uint32_t corrupted;
+   /** Valid frames dropped because they were out of order or duplicated */
+   uint32_t discarded;
+   /** DAT frames kept out of order for forward error correction */
+   uint32_t kept;
+   /** DAT frames rebuilt from PAR frames */
+   uint32_t rebuilt;
+   /** Sectors erased by the flash sink, see UPDT_flashSinkGetStats */
+   uint32_t erases;
+   /** Program operations of the flash sink */
+   uint32_t programs;
+   /** Sectors the flash sink left unchanged */
+   uint32_t erases_saved;
+   /** Program operations the flash sink did not need */
+   uint32_t programs_saved;
+   /** Calls made on the transport */
+   UPDT_ITransportStatsType transport;
+} UPDT_protocolStatsType;
+
+/** \brief Protocol session type.
+ **
+ ** A session keeps the state of a sliding window connection. On the sender
+ ** side up to window_size frames are sent without waiting for their
+ ** acknowledgement. Acknowledgements are cumulative: an ACK carrying the
+ ** sequence number n acknowledges every frame up to and including n. Lost
+ ** or out of order frames are recovered with go-back-N, the receiver never
+ ** buffers frames out of order, unless they belong to a group of DAT frames
+ ** protected by forward error correction.
+ **/
+typedef struct
+{
+   /** Transport used to send and receive the frames */
+   UPDT_ITransportType *transport;
+   /** Memory for the unacknowledged frames, window_size * frame_size bytes */
+   uint8_t *frames;
+   /** Size of each frame slot in bytes */
+   size_t frame_size;
+   /** Maximum DAT payload size agreed for the session */
+   uint16_t payload_size;
+   /** Maximum number of unacknowledged frames */
+   uint8_t window_size;
+   /** Slot of the oldest unacknowledged frame */
+   uint8_t base_slot;
+   /** Sequence number of the oldest unacknowledged frame */
+   uint8_t base;
+   /** Sequence number of the next frame to send */
+   uint8_t next;
+   /** Frames sent before this sequence number are being retransmitted */
+   uint8_t recover;
+   /** Non-zero while a go-back-N retransmission is being recovered */
+   uint8_t recovering;
+   /** Sequence number expected by the receiver */
+   uint8_t expected;
+   /** Flags of the frames sent, UPDT_PROTOCOL_FLAG_CRC adds a trailer */
+   uint8_t flags;
+   /** Running CRC32C of the DAT payloads sent or received in order */
+   uint32_t image_crc;
+   /** Maximum wait for a frame in milliseconds, 0 waits forever */
+   uint32_t timeout;
+   /** Consecutive timeouts */
+   uint8_t retries;
+   /** When the sender gives up waiting for the acknowledgement of the
+    ** oldest frame and goes back to it, a UPDT_timeNow value. Only sliding
+    ** the window and retransmitting restart it, so repeated or old
+    ** acknowledgements do not hold it back */
+   uint32_t expiry;
+   /** Last sequence number acknowledged by the receiver */
+   uint8_t acked;
+   /** Non-zero if the receiver acknowledges with UPDT_protocolSessionAck */
+   uint8_t defer_ack;
+   /** Bounds the transport calls when there is a timeout */
+   UPDT_ITransportDeadlineType deadline;
+   /** Statistics of the session, NULL if they are not kept */
+   UPDT_protocolStatsType *stats;
+   /** Accounts the transport calls when there are statistics */
+   UPDT_ITransportCounterType counter;
+   /** Statistics waited for by UPDT_protocolSessionQueryStats */
+   UPDT_protocolStatsType *query;
+   /** Encrypts or decrypts the DAT payloads, NULL if they are plain */
+   UPDT_protocolCipherType cipher;
+   /** Context of the cipher */
+   void *cipher_context;
+   /** Number of the next DAT frame to encrypt or decrypt */
+   uint32_t ciphered;
+   /** Current group of DAT frames and its PAR frames, NULL without forward
+    ** error correction */
+   UPDT_fecType *fec;
+   /** Sequence number of the first DAT frame of the current group */
+   uint8_t fec_first;
+} UPDT_protocolSessionType;
+
+/** \brief Frame callback of a protocol stream.
+ **
+ ** \param context Callback context.
+ ** \param frame Frame received: header, payload and trailer. It is only
+ ** valid during the call.
+ ** \param error UPDT_PROTOCOL_ERROR_NONE for a good frame.
+ ** UPDT_PROTOCOL_ERROR_CRC if it is corrupted. UPDT_PROTOCOL_ERROR_PACKET
+ ** if it does not fit in the stream buffer, then only its header is given
+ ** and the rest is dropped.
+ ** \return UPDT_PROTOCOL_ERROR_NONE to continue, any other value is returned
+ ** by the function which received the frame.
+ **/
+typedef int32_t (*UPDT_protocolFrameCallbackType)(
+   void *context,
+   const uint8_t *frame,
+   int32_t error);
+
+/** \brief Protocol stream type.
+ **
+ ** Incremental framing state machine. Unlike UPDT_protocolRecv and
+ ** UPDT_protocolSend it never waits: bytes are accepted in pieces of any
+ ** size and every complete frame is given to the callback, so the update
+ ** can share a task with other work. Used with UPDT_protocolPoll the
+ ** transport must not block: recv and send return 0 when they can not move
+ ** any byte.
+ **/
+typedef struct
+{
+   /** Transport polled by UPDT_protocolPoll, may be NULL if only fed */
+   UPDT_ITransportType *transport;
+   /** Memory for the frame being received */
+   uint8_t *buffer;
+   /** Size of the buffer, frames larger than it are dropped */
+   size_t buffer_size;
+   /** Bytes of the current frame received so far */
+   size_t count;
+   /** Bytes of a dropped frame still to be skipped */
+   size_t skip;
+   /** Frames given to the callback since the initialization */
+   uint32_t frames;
+   /** Frame callback */
+   UPDT_protocolFrameCallbackType callback;
+   /** Context of the callback */
+   void *context;
+   /** Frame being sent */
+   const uint8_t *tx_data;
+   /** Bytes of the frame still to be sent */
+   size_t tx_size;
+} UPDT_protocolStreamType;
 
 /*==================[external data declaration]==============================*/
 
@@ -118,6 +529,9 @@ extern "C" {
 int8_t   UPDT_protocolGetPacketType(const uint8_t *header);
 uint16_t UPDT_protocolGetPayloadSize(const uint8_t *header);
 uint8_t  UPDT_protocolGetSequenceNumber(const uint8_t *header);
+uint8_t  UPDT_protocolGetFlags(const uint8_t *header);
+/** header, payload and trailer size */
+uint16_t UPDT_protocolGetFrameSize(const uint8_t *header);
 
 /** If size = 0 returns immediately */
 int32_t UPDT_protocolRecv(UPDT_ITransportType *transport, uint8_t *buffer, size_t size);
@@ -125,11 +539,489 @@ int32_t UPDT_protocolRecv(UPDT_ITransportType *transport, uint8_t *buffer, size_
 /** If size = 0 returns immediately */
 int32_t UPDT_protocolSend(UPDT_ITransportType *transport, const uint8_t *buffer, size_t size);
 
+/** \brief Receives size bytes and hands them to a consumer.
+ **
+ ** Uses recv_acquire and recv_release when the transport provides them, so
+ ** the bytes are read in place. Otherwise they go through a small buffer.
+ **
+ ** \param transport Transport layer.
+ ** \param size Number of bytes to receive.
+ ** \param consumer Consumer of the bytes, NULL to discard them.
+ ** \param context Context of the consumer.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success, the consumer error if it
+ ** aborted the reception.
+ **/
+int32_t UPDT_protocolRecvConsume(
+   UPDT_ITransportType *transport,
+   size_t size,
+   UPDT_protocolConsumerType consumer,
+   void *context);
+
+/** Fills every block. At most UPDT_PROTOCOL_IOV_MAX blocks */
+int32_t UPDT_protocolRecvv(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count);
+
+/** Sends every block. At most UPDT_PROTOCOL_IOV_MAX blocks */
+int32_t UPDT_protocolSendv(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count);
+
+/** \brief Sends a frame from a separate header and payload.
+ **
+ ** Header, payload and, if UPDT_PROTOCOL_FLAG_CRC is set in the header, the
+ ** CRC32C trailer are handed to the transport in a single vectored send, so
+ ** the caller needs no contiguous frame buffer.
+ **
+ ** \param transport Transport layer.
+ ** \param header Header built with UPDT_protocolSetHeader.
+ ** \param payload Payload, as many bytes as the header says.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success.
+ **/
+int32_t UPDT_protocolSendFrame(
+   UPDT_ITransportType *transport,
+   const uint8_t *header,
+   const uint8_t *payload);
+
 void UPDT_protocolSetHeader(
    uint8_t *header,
    uint8_t packet_type,
    uint8_t sequence_number,
    uint16_t payload_size);
+
+/** \brief Sets the frame flags, the packet type is kept. */
+void UPDT_protocolSetFlags(uint8_t *header, uint8_t flags);
+
+/** \brief Protects a frame with a CRC32C trailer.
+ **
+ ** Sets UPDT_PROTOCOL_FLAG_CRC and writes the CRC32C of the header and the
+ ** payload right after the payload. The frame must have room for
+ ** UPDT_PROTOCOL_CRC_SIZE more bytes.
+ **
+ ** \param frame Frame with a valid header.
+ **/
+void UPDT_protocolSetCrc(uint8_t *frame);
+
+/** \brief Checks the CRC32C trailer of a frame.
+ **
+ ** \param frame Whole frame, header included.
+ ** \return UPDT_PROTOCOL_ERROR_NONE if the frame has no trailer or the
+ ** trailer matches. UPDT_PROTOCOL_ERROR_CRC otherwise.
+ **/
+int32_t UPDT_protocolCheckCrc(const uint8_t *frame);
+
+/** \brief Returns the baud rate of a UPDT_PROTOCOL_BAUD code.
+ **
+ ** \param code Baud rate code.
+ ** \return Baud rate in bits per second, 0 for UPDT_PROTOCOL_BAUD_KEEP and
+ ** unknown codes.
+ **/
+uint32_t UPDT_protocolGetBaudRate(uint8_t code);
+
+/** \brief Encodes the capabilities.
+ **
+ ** \param payload Buffer of UPDT_PROTOCOL_CAPABILITIES_SIZE bytes, usually
+ ** at UPDT_PROTOCOL_INF_CAPABILITIES_OFFSET of an INF payload or at
+ ** UPDT_PROTOCOL_ALW_CAPABILITIES_OFFSET of an ALW payload.
+ ** \param capabilities Capabilities to encode.
+ **/
+void UPDT_protocolSetCapabilities(
+   uint8_t *payload,
+   const UPDT_protocolCapabilitiesType *capabilities);
+
+/** \brief Decodes the capabilities.
+ **
+ ** Fields left at zero by the peer are replaced by the protocol defaults.
+ **
+ ** \param payload Buffer of UPDT_PROTOCOL_CAPABILITIES_SIZE bytes.
+ ** \param capabilities Decoded capabilities.
+ **/
+void UPDT_protocolGetCapabilities(
+   const uint8_t *payload,
+   UPDT_protocolCapabilitiesType *capabilities);
+
+/** \brief Computes the capabilities supported by both peers.
+ **
+ ** \param local Own capabilities.
+ ** \param remote Capabilities received from the peer.
+ ** \param agreed Capabilities to use in the session.
+ **/
+void UPDT_protocolNegotiate(
+   const UPDT_protocolCapabilitiesType *local,
+   const UPDT_protocolCapabilitiesType *remote,
+   UPDT_protocolCapabilitiesType *agreed);
+
+/** \brief Encodes a resume point.
+ **
+ ** The slave sends in the ALW payload the image bytes it has already
+ ** written, 0 to start from the beginning.
+ **
+ ** \param payload Buffer of UPDT_PROTOCOL_RESUME_SIZE bytes, usually at
+ ** UPDT_PROTOCOL_ALW_RESUME_OFFSET of an ALW payload.
+ ** \param offset Image bytes already written.
+ ** \param image_crc CRC32C of those bytes.
+ **/
+void UPDT_protocolSetResume(uint8_t *payload, uint32_t offset, uint32_t image_crc);
+
+/** \brief Decodes a resume point and checks it against the image.
+ **
+ ** The master skips the bytes the slave already has only if their CRC32C
+ ** matches its own image, so a slave holding part of another image starts
+ ** again from the beginning.
+ **
+ ** \param payload Buffer of UPDT_PROTOCOL_RESUME_SIZE bytes.
+ ** \param image Image being sent.
+ ** \param size Size of the image.
+ ** \param image_crc Set to the CRC32C of the skipped bytes, to continue the
+ ** session image_crc from it.
+ ** \return The offset to continue from, 0 if the resume point does not
+ ** match the image.
+ **/
+uint32_t UPDT_protocolGetResume(
+   const uint8_t *payload,
+   const uint8_t *image,
+   size_t size,
+   uint32_t *image_crc);
+
+/** \brief Encodes session statistics.
+ **
+ ** \param payload Buffer of UPDT_PROTOCOL_PACKET_STA_PAYLOAD_SIZE bytes.
+ ** \param stats Statistics to encode.
+ **/
+void UPDT_protocolSetStats(uint8_t *payload, const UPDT_protocolStatsType *stats);
+
+/** \brief Decodes session statistics.
+ **
+ ** \param payload Buffer of UPDT_PROTOCOL_PACKET_STA_PAYLOAD_SIZE bytes.
+ ** \param stats Decoded statistics.
+ **/
+void UPDT_protocolGetStats(const uint8_t *payload, UPDT_protocolStatsType *stats);
+
+/** \brief Initializes a protocol session.
+ **
+ ** \param session Session structure to initialize.
+ ** \param transport Transport layer used by the session.
+ ** \param frames Memory used to store the unacknowledged frames. It must be
+ ** at least window_size * frame_size bytes long. May be NULL on a session
+ ** which only receives.
+ ** \param frame_size Size of a frame slot, header included. It limits the
+ ** DAT payload size that may be negotiated for the session.
+ ** \param window_size Maximum number of unacknowledged frames, from 1 (stop
+ ** and wait) to UPDT_PROTOCOL_WINDOW_MAX_SIZE.
+ ** \param sequence_number Sequence number of the first frame sent and of the
+ ** first frame expected.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success.
+ **/
+int32_t UPDT_protocolSessionInit(
+   UPDT_protocolSessionType *session,
+   UPDT_ITransportType *transport,
+   uint8_t *frames,
+   size_t frame_size,
+   uint8_t window_size,
+   uint8_t sequence_number);
+
+/** \brief Applies the negotiated capabilities to a session.
+ **
+ ** It must be called before sending the first DAT frame. The payload size and
+ ** the window size can only shrink.
+ **
+ ** \param session Session structure.
+ ** \param agreed Capabilities computed by UPDT_protocolNegotiate.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success.
+ **/
+int32_t UPDT_protocolSessionSetCapabilities(
+   UPDT_protocolSessionType *session,
+   const UPDT_protocolCapabilitiesType *agreed);
+
+/** \brief Encrypts the DAT payloads of a session.
+ **
+ ** It must be called before sending or receiving the first DAT frame, when
+ ** both peers agreed on UPDT_PROTOCOL_CAPABILITY_ENCRYPTION. The sender
+ ** encrypts each DAT payload once, inside its window slot, so the
+ ** retransmissions are not encrypted again. The receiver authenticates and
+ ** decrypts the payload inside the caller buffer before acknowledging it,
+ ** so it must use UPDT_protocolSessionRecv: the payload never reaches the
+ ** caller before it is authenticated. Once a cipher is set a DAT frame
+ ** without UPDT_PROTOCOL_FLAG_ENCRYPTED is rejected like a forged one.
+ **
+ ** \param session Session structure.
+ ** \param cipher Seals on the sender, opens on the receiver. NULL sends and
+ ** receives plain payloads again.
+ ** \param context Context of the cipher.
+ **/
+void UPDT_protocolSessionSetCipher(
+   UPDT_protocolSessionType *session,
+   UPDT_protocolCipherType cipher,
+   void *context);
+
+/** \brief Protects the DAT frames of a session with forward error
+ ** correction.
+ **
+ ** It must be called after UPDT_protocolSessionSetCapabilities and before
+ ** sending or receiving the first DAT frame, when both peers agreed on
+ ** UPDT_PROTOCOL_CAPABILITY_FEC. The group geometry is the one of the INF
+ ** payload and the blocks are as large as the session payload size.
+ **
+ ** The sender numbers the DAT frames of a group in the reserved header
+ ** byte and sends the PAR frames once the group is complete, before a
+ ** frame of another type and when the session is flushed. PAR frames are
+ ** not sequenced nor stored in the window: the reserved header byte holds
+ ** the parity block number in the upper nibble and the DAT frames of the
+ ** group minus one in the lower one, the sequence number is the one of the
+ ** first DAT frame of the group. Each DAT frame is part of a FEC block:
+ ** UPDT_PROTOCOL_FEC_PREFIX_SIZE bytes from its header followed by the
+ ** payload as sent, encrypted if there is a cipher.
+ **
+ ** The receiver keeps the DAT frames of the group which arrive after a lost
+ ** or corrupted one without acknowledging them again, and rebuilds the
+ ** missing ones once enough PAR frames arrived. If they can not be rebuilt
+ ** it acknowledges again its last in order frame, like without forward
+ ** error correction, so that the sender goes back to the first missing
+ ** frame. A frame the PAR frames do not cover is only recovered when the
+ ** session timeout expires, so a session timeout is needed. The receiver
+ ** must use UPDT_protocolSessionRecv.
+ **
+ ** \param session Session structure.
+ ** \param fec Group structure initialized with the agreed geometry and the
+ ** session payload size as block size, it is owned by the session until
+ ** it is released. NULL stops the forward error correction.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success. UPDT_PROTOCOL_ERROR_PACKET
+ ** if there are frames in flight, if the block size is not the session
+ ** payload size or if a sender window can not hold a group.
+ **/
+int32_t UPDT_protocolSessionSetFec(UPDT_protocolSessionType *session, UPDT_fecType *fec);
+
+/** \brief Sets the timeout of a session.
+ **
+ ** With a timeout a lost frame or byte does not hang the session. The sender
+ ** retransmits the unacknowledged frames when the oldest one is not
+ ** acknowledged in time, repeated acknowledgements do not delay it. The
+ ** receiver acknowledges again its last in order frame when no
+ ** frame arrives in time. The body of a frame must follow its header
+ ** within half of the timeout, a longer wait is taken for a corrupted
+ ** payload size, so the timeout must exceed twice the time a frame takes
+ ** on the line. After UPDT_PROTOCOL_RETRIES_MAX consecutive
+ ** timeouts the call returns UPDT_PROTOCOL_ERROR_TIMEOUT. The transport
+ ** must implement the deadline aware entries, otherwise it blocks as before.
+ **
+ ** \param session Session structure.
+ ** \param timeout Timeout in milliseconds, 0 waits forever.
+ **/
+void UPDT_protocolSessionSetTimeout(UPDT_protocolSessionType *session, uint32_t timeout);
+
+/** \brief Defers the acknowledgements of a receiving session.
+ **
+ ** In order frames are then only acknowledged by UPDT_protocolSessionAck,
+ ** so a slave can wait until their payload is written to flash. Lost and
+ ** corrupted frames are still answered with the last acknowledgement sent.
+ ** The sender stops when it has window_size unacknowledged frames, so the
+ ** receiver must acknowledge before UPDT_protocolSessionUnacked reaches it.
+ **
+ ** \param session Session structure.
+ ** \param defer Non-zero to defer the acknowledgements.
+ **/
+void UPDT_protocolSessionSetDeferredAck(UPDT_protocolSessionType *session, uint8_t defer);
+
+/** \brief Acknowledges every frame received up to a sequence number.
+ **
+ ** \param session Session structure.
+ ** \param sequence_number Sequence number of a frame already received.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success.
+ **/
+int32_t UPDT_protocolSessionAck(UPDT_protocolSessionType *session, uint8_t sequence_number);
+
+/** \brief Keeps statistics of a session.
+ **
+ ** The statistics are cleared and updated by every later call on the
+ ** session, transport calls included. It may be called at any time, also
+ ** after UPDT_protocolSessionSetTimeout.
+ **
+ ** \param session Session structure.
+ ** \param stats Statistics to update, NULL stops keeping them.
+ **/
+void UPDT_protocolSessionSetStats(UPDT_protocolSessionType *session, UPDT_protocolStatsType *stats);
+
+/** \brief Returns a copy of the statistics of a session.
+ **
+ ** \param session Session structure.
+ ** \param stats Copy of the statistics, all zero if the session does not
+ ** keep them.
+ **/
+void UPDT_protocolSessionGetStats(const UPDT_protocolSessionType *session, UPDT_protocolStatsType *stats);
+
+/** \brief Answers an STA request with the statistics of the session.
+ **
+ ** The receiver calls it when UPDT_protocolSessionRecv returns an STA frame.
+ ** The answer is not sequenced, like an acknowledgement.
+ **
+ ** \param session Session structure.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success.
+ **/
+int32_t UPDT_protocolSessionSendStats(UPDT_protocolSessionType *session);
+
+/** \brief Asks the peer for the statistics of its session.
+ **
+ ** Sends an STA request through the window and waits until the answer
+ ** arrives, the frames sent before are acknowledged on the way.
+ **
+ ** \param session Session structure.
+ ** \param remote Statistics of the peer.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success.
+ **/
+int32_t UPDT_protocolSessionQueryStats(UPDT_protocolSessionType *session, UPDT_protocolStatsType *remote);
+
+/** \brief Returns the number of frames received and not acknowledged. */
+uint8_t UPDT_protocolSessionUnacked(const UPDT_protocolSessionType *session);
+
+/** \brief Sends a frame through the session.
+ **
+ ** The frame is stored in the window and sent immediately. If the window is
+ ** full the function first waits for the acknowledgements needed to free a
+ ** slot.
+ **
+ ** \param session Session structure.
+ ** \param packet_type Packet type of the frame. Frame flags, such as
+ ** UPDT_PROTOCOL_FLAG_COMPRESSED, may be or'ed in the upper nibble.
+ ** \param payload Payload of the frame. May be NULL if payload_size is 0.
+ ** \param payload_size Payload size, multiple of 8 and not larger than the
+ ** session payload size. With a cipher the DAT frames carry
+ ** UPDT_PROTOCOL_TAG_SIZE more bytes, which must fit too. With forward
+ ** error correction a DAT payload is limited to the session payload size
+ ** minus UPDT_PROTOCOL_FEC_PREFIX_SIZE.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success.
+ **/
+int32_t UPDT_protocolSessionSend(
+   UPDT_protocolSessionType *session,
+   uint8_t packet_type,
+   const uint8_t *payload,
+   uint16_t payload_size);
+
+/** \brief Waits until every frame sent has been acknowledged.
+ **
+ ** \param session Session structure.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success.
+ **/
+int32_t UPDT_protocolSessionFlush(UPDT_protocolSessionType *session);
+
+/** \brief Receives the next in order frame of the session.
+ **
+ ** Every frame received in order is acknowledged. Out of order and
+ ** corrupted frames are discarded and the last in order frame is
+ ** acknowledged again, so that the sender goes back to the first missing
+ ** frame. The payload of in order DAT frames updates image_crc.
+ **
+ ** With a cipher the DAT payload is decrypted in the payload buffer and
+ ** the header describes the plain payload, without the tag and without
+ ** UPDT_PROTOCOL_FLAG_ENCRYPTED. A frame that is not authentic is not
+ ** acknowledged.
+ **
+ ** With forward error correction PAR frames are never returned, the DAT
+ ** frames they rebuild are returned in order as if they had arrived.
+ **
+ ** \param session Session structure.
+ ** \param header Buffer of UPDT_PROTOCOL_HEADER_SIZE bytes for the header.
+ ** \param payload Buffer for the payload.
+ ** \param size Size of the payload buffer.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success, UPDT_PROTOCOL_ERROR_DENIED
+ ** if a DAT frame is not authentic.
+ **/
+int32_t UPDT_protocolSessionRecv(
+   UPDT_protocolSessionType *session,
+   uint8_t *header,
+   uint8_t *payload,
+   size_t size);
+
+/** \brief Receives the next in order frame handing its payload to a consumer.
+ **
+ ** Same as UPDT_protocolSessionRecv, but the payload goes to the consumer.
+ ** With transports implementing recv_acquire, a DAT payload can be copied
+ ** from the transport buffer straight to its final place, for example a
+ ** flash page buffer. The CRC is checked on the fly, so the consumer must
+ ** only commit the payload when the function returns
+ ** UPDT_PROTOCOL_ERROR_NONE. Out of order frames never reach the consumer.
+ ** It can not be used with a cipher nor with forward error correction.
+ **
+ ** \param session Session structure.
+ ** \param header Buffer of UPDT_PROTOCOL_HEADER_SIZE bytes for the header.
+ ** \param size Largest payload accepted.
+ ** \param consumer Payload consumer.
+ ** \param context Context of the consumer.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success.
+ **/
+int32_t UPDT_protocolSessionRecvConsume(
+   UPDT_protocolSessionType *session,
+   uint8_t *header,
+   size_t size,
+   UPDT_protocolConsumerType consumer,
+   void *context);
+
+/** \brief Initializes a protocol stream.
+ **
+ ** \param stream Stream structure.
+ ** \param transport Non-blocking transport, NULL if the stream is only fed.
+ ** \param buffer Memory for one frame, at least UPDT_PROTOCOL_HEADER_SIZE
+ ** bytes.
+ ** \param size Size of the buffer.
+ ** \param callback Frame callback.
+ ** \param context Context of the callback.
+ **/
+void UPDT_protocolStreamInit(
+   UPDT_protocolStreamType *stream,
+   UPDT_ITransportType *transport,
+   uint8_t *buffer,
+   size_t size,
+   UPDT_protocolFrameCallbackType callback,
+   void *context);
+
+/** \brief Feeds received bytes to a stream.
+ **
+ ** Completed frames are given to the callback before returning.
+ **
+ ** \param stream Stream structure.
+ ** \param data Bytes received.
+ ** \param size Number of bytes, any number.
+ ** \return UPDT_PROTOCOL_ERROR_NONE if the bytes end at a frame boundary.
+ ** UPDT_PROTOCOL_ERROR_AGAIN if a frame is incomplete. The callback error if
+ ** it failed, the bytes after that frame are not processed.
+ **/
+int32_t UPDT_protocolFeed(
+   UPDT_protocolStreamType *stream,
+   const uint8_t *data,
+   size_t size);
+
+/** \brief Moves the bytes the transport can move without waiting.
+ **
+ ** Continues the pending send and reads until a frame is completed or the
+ ** transport has nothing else. Receiving is done in the stream buffer, no
+ ** byte is copied.
+ **
+ ** \param stream Stream structure.
+ ** \return UPDT_PROTOCOL_ERROR_NONE if a frame was given to the callback,
+ ** there may be more. UPDT_PROTOCOL_ERROR_AGAIN if no frame is complete yet.
+ ** UPDT_PROTOCOL_ERROR_TRANSPORT or the callback error on failure.
+ **/
+int32_t UPDT_protocolPoll(UPDT_protocolStreamType *stream);
+
+/** \brief Starts sending a frame through a stream.
+ **
+ ** \param stream Stream structure.
+ ** \param frame Frame to send. Only a reference is kept, it must remain
+ ** valid while UPDT_protocolStreamPending is non-zero.
+ ** \param size Frame size.
+ ** \return UPDT_PROTOCOL_ERROR_NONE if it was sent at once.
+ ** UPDT_PROTOCOL_ERROR_AGAIN if the rest is sent by UPDT_protocolPoll, or if
+ ** another frame is still pending and this one was not taken.
+ ** UPDT_PROTOCOL_ERROR_TRANSPORT on error.
+ **/
+int32_t UPDT_protocolStreamSend(
+   UPDT_protocolStreamType *stream,
+   const uint8_t *frame,
+   size_t size);
+
+/** \brief Returns the number of bytes of the frame still to be sent. */
+size_t UPDT_protocolStreamPending(const UPDT_protocolStreamType *stream);
 /*==================[cplusplus]==============================================*/
 #ifdef __cplusplus
 }
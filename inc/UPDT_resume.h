@@ -0,0 +1,216 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef UPDT_RESUME_H
+#define UPDT_RESUME_H
+/** \brief Flash Update Resume Header File
+ **
+ ** This files shall be included by modules using the interfaces provided by
+ ** the Flash Update Resume
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Resume
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "UPDT_protocol.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** size of a stored checkpoint: image id, image size, offset, image CRC32C
+ ** and the CRC32C of the record, little endian */
+#define UPDT_RESUME_RECORD_SIZE          20
+
+/*==================[typedef]================================================*/
+/** \brief Loads the stored checkpoint.
+ **
+ ** \param context Context given to UPDT_resumeInit.
+ ** \param record Buffer of UPDT_RESUME_RECORD_SIZE bytes.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success. On any other value the
+ ** transfer starts from the beginning.
+ **/
+typedef int32_t (*UPDT_resumeLoadType)(void *context, uint8_t *record);
+
+/** \brief Stores a checkpoint, it must survive a reset.
+ **
+ ** \param context Context given to UPDT_resumeInit.
+ ** \param record Record of UPDT_RESUME_RECORD_SIZE bytes.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success.
+ **/
+typedef int32_t (*UPDT_resumeSaveType)(void *context, const uint8_t *record);
+
+/** \brief Resume tracker type.
+ **
+ ** Sits on the slave between the session and the flash writer. It places
+ ** the payloads at their image offset and, every period bytes, stores the
+ ** offset of the image written and the CRC32C up to it. After a reset the
+ ** slave loads it and reports it in the ALW payload, so the master only
+ ** sends the missing tail.
+ **
+ ** Only plain images can be resumed: the LZSS and delta decoders keep state
+ ** that is not stored.
+ **/
+typedef struct
+{
+   /** Loads the stored checkpoint */
+   UPDT_resumeLoadType load;
+   /** Stores a checkpoint */
+   UPDT_resumeSaveType save;
+   /** Context of load and save */
+   void *store;
+   /** Identifies the update the checkpoint belongs to */
+   uint32_t image_id;
+   /** Size of the image */
+   uint32_t image_size;
+   /** Image bytes written and committed */
+   uint32_t offset;
+   /** CRC32C of the committed bytes */
+   uint32_t image_crc;
+   /** CRC32C including the frame being received */
+   uint32_t pending_crc;
+   /** Offset of the last checkpoint stored */
+   uint32_t saved;
+   /** Bytes committed between checkpoints */
+   uint32_t period;
+   /** Consumer of the image, the flash writer */
+   UPDT_protocolConsumerType consumer;
+   /** Context of the consumer */
+   void *context;
+} UPDT_resumeType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief Initializes a resume tracker.
+ **
+ ** \param resume Resume tracker structure.
+ ** \param load Loads the stored checkpoint.
+ ** \param save Stores a checkpoint.
+ ** \param store Context of load and save.
+ ** \param period Image bytes written between checkpoints. Each checkpoint
+ ** costs a write of the store, 0 stores one after every frame.
+ ** \param consumer Consumer of the image, it gets image offsets.
+ ** \param context Context of the consumer.
+ **/
+void UPDT_resumeInit(
+   UPDT_resumeType *resume,
+   UPDT_resumeLoadType load,
+   UPDT_resumeSaveType save,
+   void *store,
+   uint32_t period,
+   UPDT_protocolConsumerType consumer,
+   void *context);
+
+/** \brief Starts the transfer of an image.
+ **
+ ** Loads the stored checkpoint and keeps it if it belongs to the same
+ ** update. The slave then sends resume->offset and resume->image_crc with
+ ** UPDT_protocolSetResume.
+ **
+ ** \param resume Resume tracker structure.
+ ** \param image_id Identifies the update, for example the CRC32C of the
+ ** INF payload: a checkpoint of another update is discarded.
+ ** \param image_size Size of the image, the padding of the last frame is
+ ** not written.
+ ** \return The offset to resume from, 0 to start from the beginning.
+ **/
+uint32_t UPDT_resumeStart(UPDT_resumeType *resume, uint32_t image_id, uint32_t image_size);
+
+/** \brief Writes a piece of a DAT payload.
+ **
+ ** It is a UPDT_protocolConsumerType for UPDT_protocolSessionRecvConsume.
+ ** The bytes are given to the consumer at their image offset, but they only
+ ** count as written once UPDT_resumeCommit is called.
+ **
+ ** \param resume Resume tracker structure.
+ ** \param offset Position of the piece in the payload.
+ ** \param data Piece of the payload.
+ ** \param size Size of the piece.
+ ** \return The consumer result.
+ **/
+int32_t UPDT_resumeConsume(
+   void *resume,
+   size_t offset,
+   const uint8_t *data,
+   size_t size);
+
+/** \brief Commits a DAT payload.
+ **
+ ** To be called when the session accepted the frame. Stores a checkpoint
+ ** when period bytes were written since the last one or the image is
+ ** complete.
+ **
+ ** \param resume Resume tracker structure.
+ ** \param size Payload size of the frame.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success, the save result otherwise.
+ **/
+int32_t UPDT_resumeCommit(UPDT_resumeType *resume, size_t size);
+
+/** \brief Forgets the checkpoint once the image is verified and installed.
+ **
+ ** \param resume Resume tracker structure.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success, the save result otherwise.
+ **/
+int32_t UPDT_resumeClear(UPDT_resumeType *resume);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef UPDT_RESUME_H */
@@ -2,6 +2,7 @@
  * Copyright 2015, Esteban Volentini
  * Copyright 2015, Matias Giori
  * Copyright 2015, Franco Salinas
+ * Copyright 2026, agent
  *
  * This file is part of CIAA Firmware.
  *
@@ -54,11 +55,16 @@
  * EV           Esteban Volentini
  * MG           Matias Giori
  * FS           Franco Salinas
+ * AG           agent
  */
 
 /*
  * modification history (new versions first)
  * -----------------------------------------------------------
+ * 20261017 v0.0.6  AG  add the configuration. modify API
+ * 20261017 v0.0.5  AG  add deadline aware calls
+ * 20261017 v0.0.4  AG  add zero copy receive
+ * 20261017 v0.0.3  AG  embed the transport interface. add vectored IO
  * 20150419 v0.0.2  FS  change prefixes. modify API
  * 20150408 v0.0.1  FS  first initial version
  */
@@ -71,17 +77,58 @@ extern "C" {
 #endif
 
 /*==================[macros]=================================================*/
+/** Size of the buffer used to gather a vectored send into a single write */
+#define UPDT_SERIAL_TX_BUFFER_SIZE     256
+/** Size of the buffer lent by the zero copy receive */
+#define UPDT_SERIAL_RX_BUFFER_SIZE     256
+/** Sleep between the polls of a read or write with a deadline */
+#define UPDT_SERIAL_POLL_PERIOD_US     1000
+/** Baud rate assumed when the configuration keeps the device default */
+#define UPDT_SERIAL_DEFAULT_BAUD_RATE  115200
+/** Bytes the driver may still hold for transmission when the baud rate
+ ** changes, the change waits for them to leave */
+#define UPDT_SERIAL_TX_DRAIN_SIZE      64
 
 /*==================[typedef]================================================*/
+/** \brief Serial configuration type.
+ **
+ ** A zero field keeps the device default.
+ **/
+typedef struct
+{
+   /** Baud rate in bits per second, up to several Mbaud if the UART can */
+   uint32_t baud_rate;
+   /** Non-zero for RTS/CTS hardware flow control. Only available if the
+    ** driver defines ciaaPOSIX_IOCTL_SET_FLOW_CONTROL */
+   uint8_t flow_control;
+   /** Receive FIFO trigger level, a ciaaFIFO_TRIGGER_LEVEL value plus one */
+   uint8_t fifo_level;
+   /** Like VMIN, a receive returning fewer bytes keeps reading until it has
+    ** min_bytes, the buffer is full or the line is idle for gap_ms */
+   uint16_t min_bytes;
+   /** Like VTIME, idle time ending a receive in milliseconds */
+   uint16_t gap_ms;
+} UPDT_serialConfigType;
+
 /** \brief Serial transport layer type. */
 typedef struct
 {
-   /** Receive non-blocking callback. */
-   UPDT_ITransportRecv recv;
-   /** Send non-blocking callback. */
-   UPDT_ITransportSend send;
+   /** Transport interface. It must be the first field */
+   UPDT_ITransportType transport;
    /** UART file descriptor */
    int32_t fd;
+   /** Gathers small vectored sends into a single write */
+   uint8_t tx_buffer[UPDT_SERIAL_TX_BUFFER_SIZE];
+   /** Bytes read by recv_acquire and not released yet */
+   uint8_t rx_buffer[UPDT_SERIAL_RX_BUFFER_SIZE];
+   /** First byte not released */
+   size_t rx_head;
+   /** End of the bytes read */
+   size_t rx_tail;
+   /** Non-zero while the device is in non-blocking mode */
+   uint8_t non_blocking;
+   /** Current configuration */
+   UPDT_serialConfigType config;
 } UPDT_serialType;
 /*==================[external data declaration]==============================*/
 
@@ -93,9 +140,27 @@ typedef struct
  **
  ** \param serial Serial structure to initialize.
  ** \param device Device path.
- ** \return 0 on success. Non-zero on error.
+ ** \param config Configuration, NULL to keep the device defaults.
+ ** \return 0 on success. Non-zero on error, like a configuration the
+ ** driver does not support.
+ **/
+int32_t UPDT_serialInit(
+   UPDT_serialType *serial,
+   const char *device,
+   const UPDT_serialConfigType *config);
+
+/** \brief Changes the baud rate.
+ **
+ ** Used after the INF/ALW handshake agreed a faster rate, see
+ ** UPDT_protocolCapabilitiesType. The slave changes it once the ALW frame is
+ ** sent, the master once it is received. The bytes still being transmitted
+ ** leave at the old rate first.
+ **
+ ** \param serial Serial structure.
+ ** \param baud_rate Baud rate in bits per second.
+ ** \return 0 on success. Non-zero if the driver refuses it.
  **/
-int32_t UPDT_serialInit(UPDT_serialType *serial, const char *device);
+int32_t UPDT_serialSetBaudRate(UPDT_serialType *serial, uint32_t baud_rate);
 
 /** \brief Clears a serial structure.
  **
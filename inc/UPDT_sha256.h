@@ -0,0 +1,128 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef UPDT_SHA256_H
+#define UPDT_SHA256_H
+/** \brief Flash Update SHA-256 Header File
+ **
+ ** This files shall be included by modules using the interfaces provided by
+ ** the Flash Update SHA-256
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update SHA-256
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** size of a digest in bytes */
+#define UPDT_SHA256_SIZE                 32
+/** size of the blocks the compression function takes */
+#define UPDT_SHA256_BLOCK_SIZE           64
+
+/*==================[typedef]================================================*/
+/** \brief SHA-256 hash type.
+ **
+ ** Hashes a stream given in pieces of any size. The pieces are compressed
+ ** straight from the caller memory, only the bytes of an incomplete block
+ ** are kept, so the memory used does not depend on the stream size.
+ **/
+typedef struct
+{
+   /** Chaining value */
+   uint32_t state[8];
+   /** Bytes hashed so far */
+   uint64_t length;
+   /** Incomplete block */
+   uint8_t block[UPDT_SHA256_BLOCK_SIZE];
+} UPDT_sha256Type;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief Starts a hash.
+ **
+ ** \param sha Hash structure.
+ **/
+void UPDT_sha256Init(UPDT_sha256Type *sha);
+
+/** \brief Hashes a piece of the stream.
+ **
+ ** \param sha Hash structure.
+ ** \param data Piece of the stream.
+ ** \param size Size of the piece.
+ **/
+void UPDT_sha256Update(UPDT_sha256Type *sha, const void *data, size_t size);
+
+/** \brief Ends a hash.
+ **
+ ** The structure must be initialized again to hash another stream.
+ **
+ ** \param sha Hash structure.
+ ** \param digest Buffer of UPDT_SHA256_SIZE bytes for the digest.
+ **/
+void UPDT_sha256Final(UPDT_sha256Type *sha, uint8_t *digest);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef UPDT_SHA256_H */
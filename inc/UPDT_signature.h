@@ -0,0 +1,213 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef UPDT_SIGNATURE_H
+#define UPDT_SIGNATURE_H
+/** \brief Flash Update Signature Header File
+ **
+ ** This files shall be included by modules using the interfaces provided by
+ ** the Flash Update Signature
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Signature
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "UPDT_protocol.h"
+#include "UPDT_sha256.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** size of an Ed25519 signature, the SIG payload */
+#define UPDT_SIGNATURE_SIZE              64
+/** size of an Ed25519 public key */
+#define UPDT_SIGNATURE_KEY_SIZE          32
+/** size of the secret seed an Ed25519 key pair is derived from */
+#define UPDT_SIGNATURE_SEED_SIZE         32
+
+/*==================[typedef]================================================*/
+/** \brief Image verifier type.
+ **
+ ** The image signature is the Ed25519 signature of the SHA-256 digest of
+ ** the first data_size bytes of the DAT stream, the data_size of the INF
+ ** payload. The verifier hashes the payloads as they arrive and passes them
+ ** on to its consumer, the flash writer, so the image is read once and
+ ** never read back from flash. After the last DAT frame the master sends
+ ** the signature in a SIG frame:
+ **
+ **    UPDT_signatureVerifierInit(&verifier, public_key, data_size,
+ **       UPDT_flashSinkConsume, &sink);
+ **    ...
+ **    if(UPDT_PROTOCOL_PACKET_DAT == UPDT_protocolGetPacketType(header))
+ **    {
+ **       UPDT_signatureVerifierConsume(&verifier, 0, payload, size);
+ **    }
+ **    else if(UPDT_PROTOCOL_PACKET_SIG == UPDT_protocolGetPacketType(header))
+ **    {
+ **       activate = UPDT_PROTOCOL_ERROR_NONE == UPDT_signatureVerifierCheck(&verifier, payload);
+ **    }
+ **/
+typedef struct
+{
+   /** Hash of the image */
+   UPDT_sha256Type sha;
+   /** Bytes to hash, the padding after them is not signed */
+   size_t size;
+   /** Bytes given so far */
+   size_t offset;
+   /** Key of the signer */
+   const uint8_t *public_key;
+   /** Consumer of the payloads, NULL if none */
+   UPDT_protocolConsumerType consumer;
+   /** Context of the consumer */
+   void *context;
+} UPDT_signatureVerifierType;
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief Verifies an Ed25519 signature.
+ **
+ ** Takes about 3 KB of stack and no other memory.
+ **
+ ** \param public_key Key of the signer, UPDT_SIGNATURE_KEY_SIZE bytes.
+ ** \param message Signed message.
+ ** \param size Size of the message.
+ ** \param signature Signature, UPDT_SIGNATURE_SIZE bytes.
+ ** \return UPDT_PROTOCOL_ERROR_NONE if the signature is good,
+ ** UPDT_PROTOCOL_ERROR_DENIED otherwise.
+ **/
+int32_t UPDT_signatureVerify(
+   const uint8_t *public_key,
+   const uint8_t *message,
+   size_t size,
+   const uint8_t *signature);
+
+/** \brief Derives the public key of a secret seed.
+ **
+ ** \param seed Secret seed, UPDT_SIGNATURE_SEED_SIZE bytes.
+ ** \param public_key Buffer of UPDT_SIGNATURE_KEY_SIZE bytes for the key.
+ **/
+void UPDT_signaturePublicKey(const uint8_t *seed, uint8_t *public_key);
+
+/** \brief Signs a message with Ed25519.
+ **
+ ** Used by masters holding the secret seed, usually on the host.
+ **
+ ** \param seed Secret seed, UPDT_SIGNATURE_SEED_SIZE bytes.
+ ** \param message Message to sign, the image digest.
+ ** \param size Size of the message.
+ ** \param signature Buffer of UPDT_SIGNATURE_SIZE bytes for the signature.
+ **/
+void UPDT_signatureSign(
+   const uint8_t *seed,
+   const uint8_t *message,
+   size_t size,
+   uint8_t *signature);
+
+/** \brief Initializes a verifier.
+ **
+ ** \param verifier Verifier structure.
+ ** \param public_key Key of the signer, it must stay in memory.
+ ** \param size Size of the image, the data_size of the INF payload.
+ ** \param consumer Consumer of the payloads, NULL if none.
+ ** \param context Context of the consumer.
+ **/
+void UPDT_signatureVerifierInit(
+   UPDT_signatureVerifierType *verifier,
+   const uint8_t *public_key,
+   size_t size,
+   UPDT_protocolConsumerType consumer,
+   void *context);
+
+/** \brief Hashes a piece of the image and passes it on.
+ **
+ ** It is a UPDT_protocolConsumerType, the pieces are given in order.
+ **
+ ** \param verifier Verifier structure.
+ ** \param offset Position of the piece in its payload, given to the consumer.
+ ** \param data Piece of the image.
+ ** \param size Size of the piece.
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success, the consumer error
+ ** otherwise.
+ **/
+int32_t UPDT_signatureVerifierConsume(
+   void *verifier,
+   size_t offset,
+   const uint8_t *data,
+   size_t size);
+
+/** \brief Checks the signature of the image.
+ **
+ ** \param verifier Verifier structure, it must be initialized again before
+ ** another image.
+ ** \param signature SIG payload.
+ ** \return UPDT_PROTOCOL_ERROR_NONE if the whole image was given and the
+ ** signature is good, UPDT_PROTOCOL_ERROR_DENIED otherwise.
+ **/
+int32_t UPDT_signatureVerifierCheck(
+   UPDT_signatureVerifierType *verifier,
+   const uint8_t *signature);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef UPDT_SIGNATURE_H */
@@ -0,0 +1,120 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef UPDT_TIME_H
+#define UPDT_TIME_H
+/** \brief Flash Update Time Header File
+ **
+ ** This files shall be included by modules using the interfaces provided by
+ ** the Flash Update Time
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Time
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/** returns non-zero if the time a is before the time b. The times wrap
+ ** around, they must be less than 2^31 ms apart */
+#define UPDT_TIME_BEFORE(a, b)      ((int32_t) ((uint32_t) (a) - (uint32_t) (b)) < 0)
+
+/*==================[typedef]================================================*/
+/** \brief Time source type.
+ **
+ ** Returns a monotonic time in milliseconds. It may wrap around.
+ **/
+typedef uint32_t (*UPDT_timeSourceType)(void);
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief Replaces the time source.
+ **
+ ** Tests inject a simulated clock with this function.
+ **
+ ** \param source New time source, NULL restores the default one.
+ **/
+void UPDT_timeSetSource(UPDT_timeSourceType source);
+
+/** \brief Returns the current time in milliseconds. */
+uint32_t UPDT_timeNow(void);
+
+/** \brief Advances the default time source of targets without a clock.
+ **
+ ** It is meant to be called from a periodic alarm or interrupt. On posix the
+ ** default source is CLOCK_MONOTONIC and this function has no effect.
+ **
+ ** \param milliseconds Time elapsed since the last call.
+ **/
+void UPDT_timeTick(uint32_t milliseconds);
+
+/** \brief Returns the time left until a deadline.
+ **
+ ** \param deadline Deadline in milliseconds.
+ ** \return Milliseconds left, 0 if the deadline passed.
+ **/
+uint32_t UPDT_timeRemaining(uint32_t deadline);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef UPDT_TIME_H */
@@ -0,0 +1,210 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef UPDT_TRACE_H
+#define UPDT_TRACE_H
+/** \brief Flash Update Trace Header File
+ **
+ ** This files shall be included by modules using the interfaces provided by
+ ** the Flash Update Trace
+ **
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Trace
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.2  AG  add the cipher event
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_string.h"
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==================[macros]=================================================*/
+/* events */
+/** UPDT_protocolRecv and vectored receives, arg: bytes requested, blocks
+ ** for vectored ones, then bytes received */
+#define UPDT_TRACE_EVENT_RECV                1
+/** UPDT_protocolSend and vectored sends, arg: bytes given, blocks for
+ ** vectored ones, then bytes sent */
+#define UPDT_TRACE_EVENT_SEND                2
+/** read of the serial device, arg: bytes requested, then the result */
+#define UPDT_TRACE_EVENT_TRANSPORT_RECV      3
+/** write of the serial device, arg: bytes given, then the result */
+#define UPDT_TRACE_EVENT_TRANSPORT_SEND      4
+/** UPDT_crc32cUpdate, arg: bytes */
+#define UPDT_TRACE_EVENT_CRC                 5
+/** sector erase of the flash sink, arg: address */
+#define UPDT_TRACE_EVENT_FLASH_ERASE         6
+/** program of the flash sink, arg: address, then bytes */
+#define UPDT_TRACE_EVENT_FLASH_PROGRAM       7
+/** UPDT_cipherEncrypt and UPDT_cipherDecrypt, arg: bytes */
+#define UPDT_TRACE_EVENT_CIPHER              8
+
+/* phases */
+#define UPDT_TRACE_PHASE_BEGIN               0
+#define UPDT_TRACE_PHASE_END                 1
+#define UPDT_TRACE_PHASE_INSTANT             2
+
+/** size of an encoded record: time, arg, event, phase, track and a reserved
+ ** byte, little endian */
+#define UPDT_TRACE_RECORD_SIZE               12
+/** size of the header of UPDT_traceDump: "UTRC" and the number of records
+ ** lost because the ring wrapped around */
+#define UPDT_TRACE_HEADER_SIZE               8
+
+/* trace points, they vanish unless UPDT_TRACE is defined */
+#ifdef UPDT_TRACE
+#define UPDT_TRACE_BEGIN(event, arg)                                          \
+   UPDT_traceRecord((event), UPDT_TRACE_PHASE_BEGIN, (uint32_t) (arg))
+#define UPDT_TRACE_END(event, arg)                                            \
+   UPDT_traceRecord((event), UPDT_TRACE_PHASE_END, (uint32_t) (arg))
+#define UPDT_TRACE_INSTANT(event, arg)                                        \
+   UPDT_traceRecord((event), UPDT_TRACE_PHASE_INSTANT, (uint32_t) (arg))
+#else
+#define UPDT_TRACE_BEGIN(event, arg)         ((void) 0)
+#define UPDT_TRACE_END(event, arg)           ((void) 0)
+#define UPDT_TRACE_INSTANT(event, arg)       ((void) 0)
+#endif
+
+/*==================[typedef]================================================*/
+/** \brief Trace record type. */
+typedef struct
+{
+   /** Time of the event in microseconds, see UPDT_traceSetClock */
+   uint32_t time;
+   /** Argument, its meaning depends on the event */
+   uint32_t arg;
+   /** A UPDT_TRACE_EVENT value */
+   uint8_t event;
+   /** A UPDT_TRACE_PHASE value */
+   uint8_t phase;
+   /** Task or thread which recorded the event, see
+    ** UPDT_traceSetTrackSource */
+   uint8_t track;
+   /** Reserved, 0 */
+   uint8_t reserved;
+} UPDT_traceRecordType;
+
+/** \brief Trace clock type.
+ **
+ ** Returns a time in microseconds. It may wrap around.
+ **/
+typedef uint32_t (*UPDT_traceClockType)(void);
+
+/** \brief Trace track source type.
+ **
+ ** Returns the track of the caller, usually derived from the task or thread
+ ** identifier, so the decoder keeps the events of each one apart.
+ **/
+typedef uint8_t (*UPDT_traceTrackSourceType)(void);
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/** \brief Starts recording into a ring of records.
+ **
+ ** When the ring is full the newest records replace the oldest ones.
+ **
+ ** \param records Memory of the ring, NULL stops recording.
+ ** \param count Number of records, a power of two.
+ **/
+void UPDT_traceInit(UPDT_traceRecordType *records, uint32_t count);
+
+/** \brief Replaces the trace clock.
+ **
+ ** \param clock New clock, NULL restores the default one: CLOCK_MONOTONIC on
+ ** posix, UPDT_timeNow in microseconds on targets, where a cycle counter
+ ** gives a finer resolution.
+ **/
+void UPDT_traceSetClock(UPDT_traceClockType clock);
+
+/** \brief Replaces the track source.
+ **
+ ** \param source New source, NULL records every event on track 0.
+ **/
+void UPDT_traceSetTrackSource(UPDT_traceTrackSourceType source);
+
+/** \brief Records an event.
+ **
+ ** Used by the trace point macros. It does not lock: concurrent callers
+ ** claim different slots, a reader may only see a record being written as
+ ** the one it replaces.
+ **
+ ** \param event A UPDT_TRACE_EVENT value.
+ ** \param phase A UPDT_TRACE_PHASE value.
+ ** \param arg Argument of the event.
+ **/
+void UPDT_traceRecord(uint8_t event, uint8_t phase, uint32_t arg);
+
+/** \brief Encodes the recorded events, oldest first.
+ **
+ ** The output is the format read by tools/updt_trace.py: a header of
+ ** UPDT_TRACE_HEADER_SIZE bytes followed by records of
+ ** UPDT_TRACE_RECORD_SIZE bytes. The ring is not cleared.
+ **
+ ** \param buffer Output buffer.
+ ** \param size Size of the output buffer, only the newest records which fit
+ ** are encoded.
+ ** \return Number of bytes encoded.
+ **/
+size_t UPDT_traceDump(uint8_t *buffer, size_t size);
+
+/*==================[cplusplus]==============================================*/
+#ifdef __cplusplus
+}
+#endif
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef UPDT_TRACE_H */
@@ -0,0 +1,972 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the helpers of the Flash Update transport
+ ** interface
+ **
+ ** Transports only have to provide recv and send. The vectored entries are
+ ** optional and emulated here when they are missing.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Transport
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.6  AG  add the interface initialization
+ * 20261017 v0.0.5  AG  add the counting decorator
+ * 20261017 v0.0.4  AG  add the read-ahead decorator
+ * 20261017 v0.0.3  AG  add the send batching decorator
+ * 20261017 v0.0.2  AG  add the deadline decorator
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_assert.h"
+#include "ciaaPOSIX_string.h"
+#include "UPDT_ITransport.h"
+#include "UPDT_time.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Receives the blocks one by one until one is not filled. */
+static ssize_t UPDT_ITransportRecvBlocks(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count)
+{
+   ssize_t ret;
+   ssize_t total = 0;
+   size_t i;
+
+   for(i = 0; i < count; i++)
+   {
+      if(0 == iov[i].size)
+      {
+         continue;
+      }
+      ret = transport->recv(transport, iov[i].base, iov[i].size);
+      if(ret < 0)
+      {
+         /* report the bytes already received, the error repeats next call */
+         return 0 < total ? total : ret;
+      }
+      total += ret;
+      if((size_t) ret < iov[i].size)
+      {
+         break;
+      }
+   }
+   return total;
+}
+
+/** \brief Sends the blocks one by one until one is not sent completely. */
+static ssize_t UPDT_ITransportSendBlocks(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count)
+{
+   ssize_t ret;
+   ssize_t total = 0;
+   size_t i;
+
+   for(i = 0; i < count; i++)
+   {
+      if(0 == iov[i].size)
+      {
+         continue;
+      }
+      ret = transport->send(transport, iov[i].base, iov[i].size);
+      if(ret < 0)
+      {
+         /* report the bytes already sent, the error repeats next call */
+         return 0 < total ? total : ret;
+      }
+      total += ret;
+      if((size_t) ret < iov[i].size)
+      {
+         break;
+      }
+   }
+   return total;
+}
+
+/** \brief Receives through the deadline decorator. */
+static ssize_t UPDT_ITransportDeadlineRecv(UPDT_ITransportType *transport, void *data, size_t size)
+{
+   UPDT_ITransportDeadlineType *deadline = (UPDT_ITransportDeadlineType *) transport;
+   UPDT_ITransportType *inner = deadline->inner;
+
+   if(deadline->armed && NULL != inner->recv_until)
+   {
+      return inner->recv_until(inner, data, size, deadline->deadline);
+   }
+   return inner->recv(inner, data, size);
+}
+
+/** \brief Sends through the deadline decorator. */
+static ssize_t UPDT_ITransportDeadlineSend(UPDT_ITransportType *transport, const void *data, size_t size)
+{
+   UPDT_ITransportDeadlineType *deadline = (UPDT_ITransportDeadlineType *) transport;
+   UPDT_ITransportType *inner = deadline->inner;
+
+   if(deadline->armed && NULL != inner->send_until)
+   {
+      return inner->send_until(inner, data, size, deadline->deadline);
+   }
+   return inner->send(inner, data, size);
+}
+
+/** \brief Receives several blocks through the deadline decorator. */
+static ssize_t UPDT_ITransportDeadlineRecvv(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count)
+{
+   UPDT_ITransportDeadlineType *deadline = (UPDT_ITransportDeadlineType *) transport;
+
+   if(deadline->armed)
+   {
+      /* the vectored entries do not take a deadline */
+      return UPDT_ITransportRecvBlocks(transport, iov, count);
+   }
+   return UPDT_ITransportRecvVector(deadline->inner, iov, count);
+}
+
+/** \brief Sends several blocks through the deadline decorator. */
+static ssize_t UPDT_ITransportDeadlineSendv(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count)
+{
+   UPDT_ITransportDeadlineType *deadline = (UPDT_ITransportDeadlineType *) transport;
+
+   if(deadline->armed)
+   {
+      return UPDT_ITransportSendBlocks(transport, iov, count);
+   }
+   return UPDT_ITransportSendVector(deadline->inner, iov, count);
+}
+
+/** \brief Lends received bytes through the deadline decorator. */
+static ssize_t UPDT_ITransportDeadlineRecvAcquire(
+   UPDT_ITransportType *transport,
+   const void **data,
+   size_t size)
+{
+   UPDT_ITransportDeadlineType *deadline = (UPDT_ITransportDeadlineType *) transport;
+   UPDT_ITransportType *inner = deadline->inner;
+
+   if(deadline->armed && NULL != inner->recv_acquire_until)
+   {
+      return inner->recv_acquire_until(inner, data, size, deadline->deadline);
+   }
+   return inner->recv_acquire(inner, data, size);
+}
+
+/** \brief Releases lent bytes through the deadline decorator. */
+static void UPDT_ITransportDeadlineRecvRelease(UPDT_ITransportType *transport, size_t size)
+{
+   UPDT_ITransportDeadlineType *deadline = (UPDT_ITransportDeadlineType *) transport;
+
+   deadline->inner->recv_release(deadline->inner, size);
+}
+
+/** \brief Stages a block, sending the buffer first if it does not fit. */
+static ssize_t UPDT_ITransportBatchStage(UPDT_ITransportBatchType *batch, const void *data, size_t size)
+{
+   UPDT_ITransportType *inner = batch->inner;
+
+   if(batch->fill + size > batch->capacity && 0 != UPDT_ITransportBatchFlush(batch))
+   {
+      return -1;
+   }
+   if(size > batch->capacity)
+   {
+      batch->writes++;
+      return inner->send(inner, data, size);
+   }
+   ciaaPOSIX_memcpy(batch->buffer + batch->fill, data, size);
+   batch->fill += size;
+   return size;
+}
+
+/** \brief Sends through the batching decorator. */
+static ssize_t UPDT_ITransportBatchSend(UPDT_ITransportType *transport, const void *data, size_t size)
+{
+   UPDT_ITransportBatchType *batch = (UPDT_ITransportBatchType *) transport;
+   ssize_t ret;
+
+   ret = UPDT_ITransportBatchStage(batch, data, size);
+   if(0 <= ret && batch->fill >= batch->threshold)
+   {
+      /* the block is staged anyway, an error repeats on the next call */
+      (void) UPDT_ITransportBatchFlush(batch);
+   }
+   return ret;
+}
+
+/** \brief Sends several blocks through the batching decorator, they are
+ ** gathered in the buffer. */
+static ssize_t UPDT_ITransportBatchSendv(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count)
+{
+   UPDT_ITransportBatchType *batch = (UPDT_ITransportBatchType *) transport;
+   ssize_t ret;
+   ssize_t total = 0;
+   size_t i;
+
+   for(i = 0; i < count; i++)
+   {
+      ret = UPDT_ITransportBatchStage(batch, iov[i].base, iov[i].size);
+      if(ret < 0)
+      {
+         return 0 < total ? total : ret;
+      }
+      total += ret;
+      if((size_t) ret < iov[i].size)
+      {
+         return total;
+      }
+   }
+   if(batch->fill >= batch->threshold)
+   {
+      (void) UPDT_ITransportBatchFlush(batch);
+   }
+   return total;
+}
+
+/** \brief Receives through the batching decorator. */
+static ssize_t UPDT_ITransportBatchRecv(UPDT_ITransportType *transport, void *data, size_t size)
+{
+   UPDT_ITransportBatchType *batch = (UPDT_ITransportBatchType *) transport;
+
+   if(0 != UPDT_ITransportBatchFlush(batch))
+   {
+      return -1;
+   }
+   return batch->inner->recv(batch->inner, data, size);
+}
+
+/** \brief Receives several blocks through the batching decorator. */
+static ssize_t UPDT_ITransportBatchRecvv(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count)
+{
+   UPDT_ITransportBatchType *batch = (UPDT_ITransportBatchType *) transport;
+
+   if(0 != UPDT_ITransportBatchFlush(batch))
+   {
+      return -1;
+   }
+   return UPDT_ITransportRecvVector(batch->inner, iov, count);
+}
+
+/** \brief Lends received bytes through the batching decorator. */
+static ssize_t UPDT_ITransportBatchRecvAcquire(
+   UPDT_ITransportType *transport,
+   const void **data,
+   size_t size)
+{
+   UPDT_ITransportBatchType *batch = (UPDT_ITransportBatchType *) transport;
+
+   if(0 != UPDT_ITransportBatchFlush(batch))
+   {
+      return -1;
+   }
+   return batch->inner->recv_acquire(batch->inner, data, size);
+}
+
+/** \brief Releases lent bytes through the batching decorator. */
+static void UPDT_ITransportBatchRecvRelease(UPDT_ITransportType *transport, size_t size)
+{
+   UPDT_ITransportBatchType *batch = (UPDT_ITransportBatchType *) transport;
+
+   batch->inner->recv_release(batch->inner, size);
+}
+
+/** \brief Receives until a deadline through the batching decorator. */
+static ssize_t UPDT_ITransportBatchRecvUntil(
+   UPDT_ITransportType *transport,
+   void *data,
+   size_t size,
+   uint32_t deadline)
+{
+   UPDT_ITransportBatchType *batch = (UPDT_ITransportBatchType *) transport;
+
+   if(0 != UPDT_ITransportBatchFlush(batch))
+   {
+      return -1;
+   }
+   return batch->inner->recv_until(batch->inner, data, size, deadline);
+}
+
+/** \brief Sends until a deadline through the batching decorator. Staging
+ ** never waits, only the flushes do. */
+static ssize_t UPDT_ITransportBatchSendUntil(
+   UPDT_ITransportType *transport,
+   const void *data,
+   size_t size,
+   uint32_t deadline)
+{
+   (void) deadline;
+   return UPDT_ITransportBatchSend(transport, data, size);
+}
+
+/** \brief Lends received bytes until a deadline through the batching
+ ** decorator. */
+static ssize_t UPDT_ITransportBatchRecvAcquireUntil(
+   UPDT_ITransportType *transport,
+   const void **data,
+   size_t size,
+   uint32_t deadline)
+{
+   UPDT_ITransportBatchType *batch = (UPDT_ITransportBatchType *) transport;
+
+   if(0 != UPDT_ITransportBatchFlush(batch))
+   {
+      return -1;
+   }
+   return batch->inner->recv_acquire_until(batch->inner, data, size, deadline);
+}
+
+/** \brief Reads as many bytes as the ring holds with one receive of the
+ ** wrapped transport. The ring must be empty. */
+static ssize_t UPDT_ITransportReadAheadFill(
+   UPDT_ITransportReadAheadType *readahead,
+   const uint32_t *deadline)
+{
+   UPDT_ITransportType *inner = readahead->inner;
+   ciaaLibs_CircBufType *cbuf = &readahead->cbuf;
+   void *data;
+   size_t space;
+   ssize_t ret;
+
+   /* starts from the beginning of the memory, so the space is contiguous */
+   ciaaLibs_circBufInit(cbuf, readahead->buffer, readahead->size);
+   data = ciaaLibs_circBufWritePos(cbuf);
+   space = ciaaLibs_circBufRawSpace(cbuf, cbuf->head);
+
+   readahead->reads++;
+   if(NULL != deadline)
+   {
+      ret = inner->recv_until(inner, data, space, *deadline);
+   }
+   else
+   {
+      ret = inner->recv(inner, data, space);
+   }
+   if(0 < ret)
+   {
+      ciaaLibs_circBufUpdateTail(cbuf, ret);
+   }
+   return ret;
+}
+
+/** \brief Receives from the ring, until the deadline if not NULL. */
+static ssize_t UPDT_ITransportReadAheadRecvFrom(
+   UPDT_ITransportReadAheadType *readahead,
+   void *data,
+   size_t size,
+   const uint32_t *deadline)
+{
+   UPDT_ITransportType *inner = readahead->inner;
+   ssize_t ret;
+
+   if(ciaaLibs_circBufEmpty(&readahead->cbuf))
+   {
+      if(size >= readahead->size)
+      {
+         /* larger than the ring, nothing to gain by copying it */
+         readahead->reads++;
+         return NULL != deadline ? inner->recv_until(inner, data, size, *deadline) :
+            inner->recv(inner, data, size);
+      }
+      ret = UPDT_ITransportReadAheadFill(readahead, deadline);
+      if(ret <= 0)
+      {
+         return ret;
+      }
+   }
+   return ciaaLibs_circBufGet(&readahead->cbuf, data, size);
+}
+
+/** \brief Lends bytes of the ring, until the deadline if not NULL. */
+static ssize_t UPDT_ITransportReadAheadAcquireFrom(
+   UPDT_ITransportReadAheadType *readahead,
+   const void **data,
+   size_t size,
+   const uint32_t *deadline)
+{
+   ciaaLibs_CircBufType *cbuf = &readahead->cbuf;
+   size_t count;
+   ssize_t ret;
+
+   if(ciaaLibs_circBufEmpty(cbuf))
+   {
+      ret = UPDT_ITransportReadAheadFill(readahead, deadline);
+      if(ret <= 0)
+      {
+         return ret;
+      }
+   }
+   count = ciaaLibs_circBufRawCount(cbuf, cbuf->tail);
+   *data = ciaaLibs_circBufReadPos(cbuf);
+   return count < size ? count : size;
+}
+
+/** \brief Receives through the read-ahead decorator. */
+static ssize_t UPDT_ITransportReadAheadRecv(UPDT_ITransportType *transport, void *data, size_t size)
+{
+   return UPDT_ITransportReadAheadRecvFrom((UPDT_ITransportReadAheadType *) transport,
+      data, size, NULL);
+}
+
+/** \brief Receives until a deadline through the read-ahead decorator. */
+static ssize_t UPDT_ITransportReadAheadRecvUntil(
+   UPDT_ITransportType *transport,
+   void *data,
+   size_t size,
+   uint32_t deadline)
+{
+   return UPDT_ITransportReadAheadRecvFrom((UPDT_ITransportReadAheadType *) transport,
+      data, size, &deadline);
+}
+
+/** \brief Lends received bytes through the read-ahead decorator. */
+static ssize_t UPDT_ITransportReadAheadRecvAcquire(
+   UPDT_ITransportType *transport,
+   const void **data,
+   size_t size)
+{
+   return UPDT_ITransportReadAheadAcquireFrom((UPDT_ITransportReadAheadType *) transport,
+      data, size, NULL);
+}
+
+/** \brief Lends received bytes until a deadline through the read-ahead
+ ** decorator. */
+static ssize_t UPDT_ITransportReadAheadRecvAcquireUntil(
+   UPDT_ITransportType *transport,
+   const void **data,
+   size_t size,
+   uint32_t deadline)
+{
+   return UPDT_ITransportReadAheadAcquireFrom((UPDT_ITransportReadAheadType *) transport,
+      data, size, &deadline);
+}
+
+/** \brief Releases lent bytes through the read-ahead decorator. */
+static void UPDT_ITransportReadAheadRecvRelease(UPDT_ITransportType *transport, size_t size)
+{
+   UPDT_ITransportReadAheadType *readahead = (UPDT_ITransportReadAheadType *) transport;
+
+   ciaaLibs_circBufUpdateHead(&readahead->cbuf, size);
+}
+
+/** \brief Sends through the read-ahead decorator. */
+static ssize_t UPDT_ITransportReadAheadSend(UPDT_ITransportType *transport, const void *data, size_t size)
+{
+   UPDT_ITransportType *inner = ((UPDT_ITransportReadAheadType *) transport)->inner;
+
+   return inner->send(inner, data, size);
+}
+
+/** \brief Sends several blocks through the read-ahead decorator. */
+static ssize_t UPDT_ITransportReadAheadSendv(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count)
+{
+   return UPDT_ITransportSendVector(((UPDT_ITransportReadAheadType *) transport)->inner, iov, count);
+}
+
+/** \brief Sends until a deadline through the read-ahead decorator. */
+static ssize_t UPDT_ITransportReadAheadSendUntil(
+   UPDT_ITransportType *transport,
+   const void *data,
+   size_t size,
+   uint32_t deadline)
+{
+   UPDT_ITransportType *inner = ((UPDT_ITransportReadAheadType *) transport)->inner;
+
+   return inner->send_until(inner, data, size, deadline);
+}
+
+/** \brief Accounts a receive of the counting decorator.
+ **
+ ** \param counter Decorator structure.
+ ** \param size Bytes requested.
+ ** \param ret Result of the receive.
+ ** \param start Time the receive started.
+ ** \return ret.
+ **/
+static ssize_t UPDT_ITransportCounterRecvDone(
+   UPDT_ITransportCounterType *counter,
+   size_t size,
+   ssize_t ret,
+   uint32_t start)
+{
+   UPDT_ITransportStatsType *stats = counter->stats;
+
+   stats->reads++;
+   stats->recv_time += UPDT_timeNow() - start;
+   if(ret < 0)
+   {
+      stats->errors++;
+   }
+   else if(0 == ret && 0 < size)
+   {
+      stats->expired++;
+   }
+   else if((size_t) ret < size)
+   {
+      stats->partial_reads++;
+   }
+   return ret;
+}
+
+/** \brief Accounts a send of the counting decorator, like
+ ** UPDT_ITransportCounterRecvDone. */
+static ssize_t UPDT_ITransportCounterSendDone(
+   UPDT_ITransportCounterType *counter,
+   size_t size,
+   ssize_t ret,
+   uint32_t start)
+{
+   UPDT_ITransportStatsType *stats = counter->stats;
+
+   stats->writes++;
+   stats->send_time += UPDT_timeNow() - start;
+   if(ret < 0)
+   {
+      stats->errors++;
+   }
+   else if(0 == ret && 0 < size)
+   {
+      stats->expired++;
+   }
+   else
+   {
+      stats->bytes_sent += ret;
+      if((size_t) ret < size)
+      {
+         stats->partial_writes++;
+      }
+   }
+   return ret;
+}
+
+/** \brief Returns the total size of several blocks. */
+static size_t UPDT_ITransportCounterVectorSize(const UPDT_ITransportIoVecType *iov, size_t count)
+{
+   size_t size = 0;
+   size_t i;
+
+   for(i = 0; i < count; i++)
+   {
+      size += iov[i].size;
+   }
+   return size;
+}
+
+/** \brief Receives through the counting decorator. */
+static ssize_t UPDT_ITransportCounterRecv(UPDT_ITransportType *transport, void *data, size_t size)
+{
+   UPDT_ITransportCounterType *counter = (UPDT_ITransportCounterType *) transport;
+   uint32_t start = UPDT_timeNow();
+   ssize_t ret;
+
+   ret = counter->inner->recv(counter->inner, data, size);
+   if(0 < ret)
+   {
+      counter->stats->bytes_received += ret;
+   }
+   return UPDT_ITransportCounterRecvDone(counter, size, ret, start);
+}
+
+/** \brief Sends through the counting decorator. */
+static ssize_t UPDT_ITransportCounterSend(UPDT_ITransportType *transport, const void *data, size_t size)
+{
+   UPDT_ITransportCounterType *counter = (UPDT_ITransportCounterType *) transport;
+   uint32_t start = UPDT_timeNow();
+
+   return UPDT_ITransportCounterSendDone(counter, size, counter->inner->send(counter->inner, data, size), start);
+}
+
+/** \brief Receives several blocks through the counting decorator. */
+static ssize_t UPDT_ITransportCounterRecvv(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count)
+{
+   UPDT_ITransportCounterType *counter = (UPDT_ITransportCounterType *) transport;
+   uint32_t start = UPDT_timeNow();
+   ssize_t ret;
+
+   ret = counter->inner->recvv(counter->inner, iov, count);
+   if(0 < ret)
+   {
+      counter->stats->bytes_received += ret;
+   }
+   return UPDT_ITransportCounterRecvDone(counter, UPDT_ITransportCounterVectorSize(iov, count), ret, start);
+}
+
+/** \brief Sends several blocks through the counting decorator. */
+static ssize_t UPDT_ITransportCounterSendv(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count)
+{
+   UPDT_ITransportCounterType *counter = (UPDT_ITransportCounterType *) transport;
+   uint32_t start = UPDT_timeNow();
+
+   return UPDT_ITransportCounterSendDone(
+      counter,
+      UPDT_ITransportCounterVectorSize(iov, count),
+      counter->inner->sendv(counter->inner, iov, count),
+      start);
+}
+
+/** \brief Lends received bytes through the counting decorator. They are
+ ** accounted when released. */
+static ssize_t UPDT_ITransportCounterRecvAcquire(
+   UPDT_ITransportType *transport,
+   const void **data,
+   size_t size)
+{
+   UPDT_ITransportCounterType *counter = (UPDT_ITransportCounterType *) transport;
+   uint32_t start = UPDT_timeNow();
+
+   return UPDT_ITransportCounterRecvDone(counter, size, counter->inner->recv_acquire(counter->inner, data, size), start);
+}
+
+/** \brief Releases lent bytes through the counting decorator. */
+static void UPDT_ITransportCounterRecvRelease(UPDT_ITransportType *transport, size_t size)
+{
+   UPDT_ITransportCounterType *counter = (UPDT_ITransportCounterType *) transport;
+
+   counter->stats->bytes_received += size;
+   counter->inner->recv_release(counter->inner, size);
+}
+
+/** \brief Receives until a deadline through the counting decorator. */
+static ssize_t UPDT_ITransportCounterRecvUntil(
+   UPDT_ITransportType *transport,
+   void *data,
+   size_t size,
+   uint32_t deadline)
+{
+   UPDT_ITransportCounterType *counter = (UPDT_ITransportCounterType *) transport;
+   uint32_t start = UPDT_timeNow();
+   ssize_t ret;
+
+   ret = counter->inner->recv_until(counter->inner, data, size, deadline);
+   if(0 < ret)
+   {
+      counter->stats->bytes_received += ret;
+   }
+   return UPDT_ITransportCounterRecvDone(counter, size, ret, start);
+}
+
+/** \brief Sends until a deadline through the counting decorator. */
+static ssize_t UPDT_ITransportCounterSendUntil(
+   UPDT_ITransportType *transport,
+   const void *data,
+   size_t size,
+   uint32_t deadline)
+{
+   UPDT_ITransportCounterType *counter = (UPDT_ITransportCounterType *) transport;
+   uint32_t start = UPDT_timeNow();
+
+   return UPDT_ITransportCounterSendDone(
+      counter,
+      size,
+      counter->inner->send_until(counter->inner, data, size, deadline),
+      start);
+}
+
+/** \brief Lends received bytes until a deadline through the counting
+ ** decorator. */
+static ssize_t UPDT_ITransportCounterRecvAcquireUntil(
+   UPDT_ITransportType *transport,
+   const void **data,
+   size_t size,
+   uint32_t deadline)
+{
+   UPDT_ITransportCounterType *counter = (UPDT_ITransportCounterType *) transport;
+   uint32_t start = UPDT_timeNow();
+
+   return UPDT_ITransportCounterRecvDone(
+      counter,
+      size,
+      counter->inner->recv_acquire_until(counter->inner, data, size, deadline),
+      start);
+}
+
+/*==================[external functions definition]==========================*/
+void UPDT_ITransportInit(
+   UPDT_ITransportType *transport,
+   UPDT_ITransportRecv recv,
+   UPDT_ITransportSend send)
+{
+   ciaaPOSIX_assert(NULL != transport);
+
+   transport->recv = recv;
+   transport->send = send;
+   transport->recvv = NULL;
+   transport->sendv = NULL;
+   transport->recv_acquire = NULL;
+   transport->recv_release = NULL;
+   transport->recv_until = NULL;
+   transport->send_until = NULL;
+   transport->recv_acquire_until = NULL;
+}
+
+ssize_t UPDT_ITransportRecvVector(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count)
+{
+   ciaaPOSIX_assert(NULL != transport);
+   ciaaPOSIX_assert(NULL != iov || 0 == count);
+
+   if(NULL != transport->recvv)
+   {
+      return transport->recvv(transport, iov, count);
+   }
+   return UPDT_ITransportRecvBlocks(transport, iov, count);
+}
+
+ssize_t UPDT_ITransportSendVector(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count)
+{
+   ciaaPOSIX_assert(NULL != transport);
+   ciaaPOSIX_assert(NULL != iov || 0 == count);
+
+   if(NULL != transport->sendv)
+   {
+      return transport->sendv(transport, iov, count);
+   }
+   return UPDT_ITransportSendBlocks(transport, iov, count);
+}
+
+void UPDT_ITransportDeadlineInit(
+   UPDT_ITransportDeadlineType *deadline,
+   UPDT_ITransportType *inner)
+{
+   ciaaPOSIX_assert(NULL != deadline);
+   ciaaPOSIX_assert(NULL != inner);
+
+   /* the decorator applies the deadline itself, it has no deadline entries */
+   UPDT_ITransportInit(&deadline->transport, UPDT_ITransportDeadlineRecv, UPDT_ITransportDeadlineSend);
+   deadline->transport.recvv = UPDT_ITransportDeadlineRecvv;
+   deadline->transport.sendv = UPDT_ITransportDeadlineSendv;
+   if(NULL != inner->recv_acquire)
+   {
+      deadline->transport.recv_acquire = UPDT_ITransportDeadlineRecvAcquire;
+      deadline->transport.recv_release = UPDT_ITransportDeadlineRecvRelease;
+   }
+   deadline->inner = inner;
+   deadline->deadline = 0;
+   deadline->armed = 0;
+}
+
+void UPDT_ITransportDeadlineSet(UPDT_ITransportDeadlineType *deadline, uint32_t time)
+{
+   ciaaPOSIX_assert(NULL != deadline);
+
+   deadline->deadline = time;
+   deadline->armed = 1;
+}
+
+void UPDT_ITransportDeadlineCancel(UPDT_ITransportDeadlineType *deadline)
+{
+   ciaaPOSIX_assert(NULL != deadline);
+
+   deadline->armed = 0;
+}
+
+void UPDT_ITransportBatchInit(
+   UPDT_ITransportBatchType *batch,
+   UPDT_ITransportType *inner,
+   uint8_t *buffer,
+   size_t capacity,
+   size_t threshold)
+{
+   ciaaPOSIX_assert(NULL != batch);
+   ciaaPOSIX_assert(NULL != inner);
+   ciaaPOSIX_assert(NULL != buffer);
+   ciaaPOSIX_assert(0 < threshold && threshold <= capacity);
+
+   UPDT_ITransportInit(&batch->transport, UPDT_ITransportBatchRecv, UPDT_ITransportBatchSend);
+   batch->transport.recvv = UPDT_ITransportBatchRecvv;
+   batch->transport.sendv = UPDT_ITransportBatchSendv;
+   if(NULL != inner->recv_acquire)
+   {
+      batch->transport.recv_acquire = UPDT_ITransportBatchRecvAcquire;
+      batch->transport.recv_release = UPDT_ITransportBatchRecvRelease;
+   }
+   if(NULL != inner->recv_until)
+   {
+      batch->transport.recv_until = UPDT_ITransportBatchRecvUntil;
+      batch->transport.send_until = UPDT_ITransportBatchSendUntil;
+   }
+   if(NULL != inner->recv_acquire_until)
+   {
+      batch->transport.recv_acquire_until = UPDT_ITransportBatchRecvAcquireUntil;
+   }
+   batch->inner = inner;
+   batch->buffer = buffer;
+   batch->capacity = capacity;
+   batch->fill = 0;
+   batch->threshold = threshold;
+   batch->writes = 0;
+}
+
+int32_t UPDT_ITransportBatchFlush(UPDT_ITransportBatchType *batch)
+{
+   UPDT_ITransportType *inner;
+   ssize_t ret;
+   size_t sent = 0;
+   size_t i;
+
+   ciaaPOSIX_assert(NULL != batch);
+
+   inner = batch->inner;
+   while(sent < batch->fill)
+   {
+      batch->writes++;
+      ret = inner->send(inner, batch->buffer + sent, batch->fill - sent);
+      if(ret <= 0)
+      {
+         break;
+      }
+      sent += ret;
+   }
+   if(0 < sent)
+   {
+      /* keeps what the wrapped transport did not take */
+      batch->fill -= sent;
+      for(i = 0; i < batch->fill; i++)
+      {
+         batch->buffer[i] = batch->buffer[sent + i];
+      }
+   }
+   return 0 == batch->fill ? 0 : -1;
+}
+
+int32_t UPDT_ITransportReadAheadInit(
+   UPDT_ITransportReadAheadType *readahead,
+   UPDT_ITransportType *inner,
+   uint8_t *buffer,
+   size_t size)
+{
+   ciaaPOSIX_assert(NULL != readahead);
+   ciaaPOSIX_assert(NULL != inner);
+   ciaaPOSIX_assert(NULL != buffer);
+
+   /* the blocks are received one by one, from memory, without recvv */
+   UPDT_ITransportInit(&readahead->transport, UPDT_ITransportReadAheadRecv, UPDT_ITransportReadAheadSend);
+   readahead->transport.sendv = UPDT_ITransportReadAheadSendv;
+   readahead->transport.recv_acquire = UPDT_ITransportReadAheadRecvAcquire;
+   readahead->transport.recv_release = UPDT_ITransportReadAheadRecvRelease;
+   if(NULL != inner->recv_until)
+   {
+      readahead->transport.recv_until = UPDT_ITransportReadAheadRecvUntil;
+      readahead->transport.recv_acquire_until = UPDT_ITransportReadAheadRecvAcquireUntil;
+   }
+   if(NULL != inner->send_until)
+   {
+      readahead->transport.send_until = UPDT_ITransportReadAheadSendUntil;
+   }
+   readahead->inner = inner;
+   readahead->buffer = buffer;
+   readahead->size = size;
+   readahead->reads = 0;
+   return ciaaLibs_circBufInit(&readahead->cbuf, buffer, size);
+}
+
+void UPDT_ITransportCounterInit(
+   UPDT_ITransportCounterType *counter,
+   UPDT_ITransportType *inner,
+   UPDT_ITransportStatsType *stats)
+{
+   ciaaPOSIX_assert(NULL != counter);
+   ciaaPOSIX_assert(NULL != inner);
+   ciaaPOSIX_assert(NULL != stats);
+
+   UPDT_ITransportInit(&counter->transport, UPDT_ITransportCounterRecv, UPDT_ITransportCounterSend);
+   counter->transport.recvv = NULL == inner->recvv ? NULL : UPDT_ITransportCounterRecvv;
+   counter->transport.sendv = NULL == inner->sendv ? NULL : UPDT_ITransportCounterSendv;
+   if(NULL != inner->recv_acquire)
+   {
+      counter->transport.recv_acquire = UPDT_ITransportCounterRecvAcquire;
+      counter->transport.recv_release = UPDT_ITransportCounterRecvRelease;
+   }
+   counter->transport.recv_until = NULL == inner->recv_until ? NULL : UPDT_ITransportCounterRecvUntil;
+   counter->transport.send_until = NULL == inner->send_until ? NULL : UPDT_ITransportCounterSendUntil;
+   counter->transport.recv_acquire_until =
+      NULL == inner->recv_acquire_until ? NULL : UPDT_ITransportCounterRecvAcquireUntil;
+   counter->inner = inner;
+   counter->stats = stats;
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
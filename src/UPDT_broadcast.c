@@ -0,0 +1,637 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the Flash Update Broadcast
+ **
+ ** Sends an image once to many slaves of a shared bus and repairs the
+ ** frames each of them lost in a few rounds.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Broadcast
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_assert.h"
+#include "ciaaPOSIX_string.h"
+#include "UPDT_broadcast.h"
+#include "UPDT_crc32c.h"
+#include "UPDT_time.h"
+
+/*==================[macros and definitions]=================================*/
+/** size of an ANN frame */
+#define UPDT_BROADCAST_ANN_FRAME_SIZE                                         \
+   UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PACKET_ANN_PAYLOAD_SIZE)
+/** size of a NAK answer */
+#define UPDT_BROADCAST_NAK_FRAME_SIZE                                         \
+   UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PACKET_NAK_PAYLOAD_SIZE)
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** padding of the last DAT frame */
+static const uint8_t UPDT_broadcastZero[8] = {0};
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Returns non-zero if the bit of a frame is set. */
+static uint8_t UPDT_broadcastIsSet(const uint8_t *bitmap, uint32_t block)
+{
+   return (bitmap[block >> 3] >> (block & 7)) & 1;
+}
+
+/** \brief Sets the bits of a range of frames. */
+static void UPDT_broadcastMark(uint8_t *bitmap, uint32_t first, uint32_t count)
+{
+   for(; count > 0; first++, count--)
+   {
+      bitmap[first >> 3] |= (uint8_t) (1u << (first & 7));
+   }
+}
+
+/** \brief Writes a 16 bit number, little endian. */
+static void UPDT_broadcastSet16(uint8_t *buffer, uint16_t value)
+{
+   buffer[0] = (uint8_t) value;
+   buffer[1] = (uint8_t) (value >> 8);
+}
+
+/** \brief Reads a 16 bit number, little endian. */
+static uint16_t UPDT_broadcastGet16(const uint8_t *buffer)
+{
+   return (uint16_t) (buffer[0] | (buffer[1] << 8));
+}
+
+/** \brief Returns the number of frames of an image. */
+static uint32_t UPDT_broadcastBlocks(uint32_t image_size, uint16_t payload_size)
+{
+   return (uint32_t) (((uint64_t) image_size + payload_size - 1) / payload_size);
+}
+
+/** \brief Sends an ANN frame of the transfer.
+ **
+ ** \param kind UPDT_BROADCAST_ANN_START or UPDT_BROADCAST_ANN_END.
+ **/
+static int32_t UPDT_broadcastMasterAnnounce(UPDT_broadcastMasterType *master, uint8_t kind)
+{
+   uint8_t frame[UPDT_BROADCAST_ANN_FRAME_SIZE] = {0};
+   uint8_t *payload = frame + UPDT_PROTOCOL_HEADER_SIZE;
+
+   UPDT_protocolSetHeader(frame, UPDT_PROTOCOL_PACKET_ANN, 0, UPDT_PROTOCOL_PACKET_ANN_PAYLOAD_SIZE);
+   frame[1] = kind;
+   UPDT_crc32cSet(payload, master->id);
+   UPDT_crc32cSet(payload + 4, master->image_size);
+   UPDT_crc32cSet(payload + 8, master->image_crc);
+   UPDT_broadcastSet16(payload + 12, master->payload_size);
+   UPDT_protocolSetCrc(frame);
+   return UPDT_protocolSend(master->deadline.inner, frame, UPDT_BROADCAST_ANN_FRAME_SIZE);
+}
+
+/** \brief Sends a DAT frame straight from the image.
+ **
+ ** The last frame is padded to a multiple of 8 with zeros.
+ **/
+static int32_t UPDT_broadcastMasterSendBlock(UPDT_broadcastMasterType *master, uint16_t block)
+{
+   uint8_t header[UPDT_PROTOCOL_HEADER_SIZE] = {0};
+   uint8_t trailer[UPDT_PROTOCOL_CRC_SIZE];
+   UPDT_ITransportIoVecType iov[UPDT_PROTOCOL_IOV_MAX];
+   uint32_t offset = (uint32_t) block * master->payload_size;
+   uint32_t size = master->image_size - offset;
+   uint32_t crc;
+
+   if(size > master->payload_size)
+   {
+      size = master->payload_size;
+   }
+   UPDT_protocolSetHeader(header, UPDT_PROTOCOL_PACKET_DAT, (uint8_t) (block >> 8), (size + 7u) & ~7u);
+   header[1] = (uint8_t) block;
+   UPDT_protocolSetFlags(header, UPDT_PROTOCOL_FLAG_CRC);
+
+   iov[0].base = header;
+   iov[0].size = UPDT_PROTOCOL_HEADER_SIZE;
+   iov[1].base = (uint8_t *) master->image + offset;
+   iov[1].size = size;
+   iov[2].base = (uint8_t *) UPDT_broadcastZero;
+   iov[2].size = ((size + 7u) & ~7u) - size;
+   iov[3].base = trailer;
+   iov[3].size = UPDT_PROTOCOL_CRC_SIZE;
+   crc = UPDT_crc32cUpdate(0, header, UPDT_PROTOCOL_HEADER_SIZE);
+   crc = UPDT_crc32cUpdate(crc, iov[1].base, iov[1].size);
+   UPDT_crc32cSet(trailer, UPDT_crc32cUpdate(crc, UPDT_broadcastZero, iov[2].size));
+   master->sent++;
+   return UPDT_protocolSendv(master->deadline.inner, iov, UPDT_PROTOCOL_IOV_MAX);
+}
+
+/** \brief Polls a slave once and waits for its answer.
+ **
+ ** Frames which are not the answer, like a late answer of another slave,
+ ** are dropped.
+ **
+ ** \param frame Buffer of UPDT_BROADCAST_NAK_FRAME_SIZE bytes for the
+ ** answer.
+ ** \return UPDT_PROTOCOL_ERROR_NONE if the answer arrived.
+ ** UPDT_PROTOCOL_ERROR_TIMEOUT if it did not arrive in time,
+ ** UPDT_PROTOCOL_ERROR_CRC if it is corrupted.
+ **/
+static int32_t UPDT_broadcastMasterAsk(
+   UPDT_broadcastMasterType *master,
+   uint8_t address,
+   uint8_t *frame)
+{
+   UPDT_ITransportType *transport = &master->deadline.transport;
+   uint8_t header[UPDT_PROTOCOL_HEADER_SIZE] = {0};
+   int32_t ret;
+
+   UPDT_protocolSetHeader(header, UPDT_PROTOCOL_PACKET_NAK, 0, 0);
+   header[1] = address;
+   UPDT_protocolSetFlags(header, UPDT_PROTOCOL_FLAG_CRC);
+   if(0 != master->timeout)
+   {
+      UPDT_ITransportDeadlineSet(&master->deadline, UPDT_timeNow() + master->timeout);
+   }
+   master->polls++;
+   ret = UPDT_protocolSendFrame(transport, header, NULL);
+   while(UPDT_PROTOCOL_ERROR_NONE == ret)
+   {
+      ret = UPDT_protocolRecv(transport, frame, UPDT_PROTOCOL_HEADER_SIZE);
+      if(UPDT_PROTOCOL_ERROR_NONE != ret)
+      {
+         break;
+      }
+      if(UPDT_PROTOCOL_PACKET_NAK == UPDT_protocolGetPacketType(frame) && address == frame[1] &&
+         UPDT_BROADCAST_NAK_FRAME_SIZE == UPDT_protocolGetFrameSize(frame))
+      {
+         ret = UPDT_protocolRecv(transport, frame + UPDT_PROTOCOL_HEADER_SIZE,
+            UPDT_BROADCAST_NAK_FRAME_SIZE - UPDT_PROTOCOL_HEADER_SIZE);
+         if(UPDT_PROTOCOL_ERROR_NONE == ret)
+         {
+            ret = UPDT_protocolCheckCrc(frame);
+         }
+         break;
+      }
+      ret = UPDT_protocolRecvConsume(transport,
+         UPDT_protocolGetFrameSize(frame) - UPDT_PROTOCOL_HEADER_SIZE, NULL, NULL);
+   }
+   UPDT_ITransportDeadlineCancel(&master->deadline);
+   return ret;
+}
+
+/** \brief Polls a slave and adds the frames it misses to the next round.
+ **
+ ** \param status State of the slave, updated.
+ ** \return UPDT_PROTOCOL_ERROR_NONE unless the bus failed.
+ **/
+static int32_t UPDT_broadcastMasterPoll(
+   UPDT_broadcastMasterType *master,
+   uint8_t address,
+   uint8_t *status)
+{
+   uint8_t frame[UPDT_BROADCAST_NAK_FRAME_SIZE];
+   const uint8_t *payload = frame + UPDT_PROTOCOL_HEADER_SIZE;
+   const uint8_t *range;
+   uint32_t missing;
+   uint32_t first;
+   uint32_t count;
+   uint8_t retries;
+   int32_t ret = UPDT_PROTOCOL_ERROR_TIMEOUT;
+
+   /* timeouts and corrupted answers are asked again */
+   for(retries = 0; retries < UPDT_PROTOCOL_RETRIES_MAX && UPDT_PROTOCOL_ERROR_NONE != ret; retries++)
+   {
+      ret = UPDT_broadcastMasterAsk(master, address, frame);
+      if(UPDT_PROTOCOL_ERROR_TRANSPORT == ret)
+      {
+         return ret;
+      }
+   }
+   if(UPDT_PROTOCOL_ERROR_NONE != ret)
+   {
+      *status = UPDT_BROADCAST_SLAVE_SILENT;
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+
+   missing = UPDT_crc32cGet(payload + UPDT_BROADCAST_NAK_MISSING_OFFSET);
+   if(UPDT_BROADCAST_MISSING_REFUSED == missing)
+   {
+      *status = UPDT_BROADCAST_SLAVE_REFUSED;
+   }
+   else if(UPDT_BROADCAST_MISSING_UNKNOWN == missing ||
+      master->id != UPDT_crc32cGet(payload + UPDT_BROADCAST_NAK_ID_OFFSET))
+   {
+      /* it missed the announcement, it gets the whole image again */
+      UPDT_broadcastMark(master->missing, 0, master->blocks);
+   }
+   else if(0 == missing)
+   {
+      *status = UPDT_BROADCAST_SLAVE_DONE;
+   }
+   else
+   {
+      for(range = payload + UPDT_BROADCAST_NAK_RANGES_OFFSET;
+         range < payload + UPDT_PROTOCOL_PACKET_NAK_PAYLOAD_SIZE; range += 4)
+      {
+         first = UPDT_broadcastGet16(range);
+         count = UPDT_broadcastGet16(range + 2);
+         if(0 == count || first >= master->blocks)
+         {
+            break;
+         }
+         if(count > master->blocks - first)
+         {
+            count = master->blocks - first;
+         }
+         UPDT_broadcastMark(master->missing, first, count);
+      }
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Processes an ANN frame. */
+static void UPDT_broadcastSlaveAnnounce(UPDT_broadcastSlaveType *slave, const uint8_t *frame)
+{
+   const uint8_t *payload = frame + UPDT_PROTOCOL_HEADER_SIZE;
+   uint32_t id = UPDT_crc32cGet(payload);
+   uint32_t blocks;
+
+   if(UPDT_BROADCAST_ANN_END == frame[1])
+   {
+      /* a slave which missed the whole transfer stops too */
+      if(0 == slave->announced || id == slave->id)
+      {
+         slave->ended = 1;
+      }
+      return;
+   }
+   if(UPDT_BROADCAST_ANN_START != frame[1] || (0 != slave->announced && id == slave->id))
+   {
+      /* announced again at every round */
+      return;
+   }
+
+   slave->announced = 1;
+   slave->refused = 0;
+   slave->ended = 0;
+   slave->id = id;
+   slave->image_size = UPDT_crc32cGet(payload + 4);
+   slave->image_crc = UPDT_crc32cGet(payload + 8);
+   slave->payload_size = UPDT_broadcastGet16(payload + 12);
+   slave->blocks = 0;
+   slave->missing = 0;
+   if(0 == slave->payload_size || 0 != (slave->payload_size & 7u) ||
+      (size_t) UPDT_PROTOCOL_FRAME_SIZE(slave->payload_size) > slave->frame_size)
+   {
+      slave->refused = 1;
+      return;
+   }
+   blocks = UPDT_broadcastBlocks(slave->image_size, slave->payload_size);
+   if(blocks > UPDT_BROADCAST_BLOCKS_MAX || UPDT_BROADCAST_BITMAP_SIZE(blocks) > slave->received_size)
+   {
+      slave->refused = 1;
+      return;
+   }
+   slave->blocks = (uint16_t) blocks;
+   slave->missing = blocks;
+   ciaaPOSIX_memset(slave->received, 0, UPDT_BROADCAST_BITMAP_SIZE(blocks));
+}
+
+/** \brief Writes a DAT frame of the transfer if it was not received yet. */
+static int32_t UPDT_broadcastSlaveWrite(UPDT_broadcastSlaveType *slave, const uint8_t *frame)
+{
+   uint16_t block = (uint16_t) (frame[1] | (frame[2] << 8));
+   uint32_t offset;
+   uint32_t size;
+   int32_t ret;
+
+   if(0 == slave->announced || 0 != slave->refused || block >= slave->blocks ||
+      UPDT_broadcastIsSet(slave->received, block))
+   {
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   offset = (uint32_t) block * slave->payload_size;
+   size = slave->image_size - offset;
+   if(size > slave->payload_size)
+   {
+      size = slave->payload_size;
+   }
+   if(UPDT_protocolGetPayloadSize(frame) < size)
+   {
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   ret = slave->consumer(slave->context, offset, frame + UPDT_PROTOCOL_HEADER_SIZE, size);
+   if(UPDT_PROTOCOL_ERROR_NONE == ret)
+   {
+      UPDT_broadcastMark(slave->received, block, 1);
+      slave->missing--;
+   }
+   return ret;
+}
+
+/** \brief Answers a poll with the first ranges of missing frames. */
+static int32_t UPDT_broadcastSlaveAnswer(UPDT_broadcastSlaveType *slave)
+{
+   uint8_t frame[UPDT_BROADCAST_NAK_FRAME_SIZE] = {0};
+   uint8_t *payload = frame + UPDT_PROTOCOL_HEADER_SIZE;
+   uint8_t *range = payload + UPDT_BROADCAST_NAK_RANGES_OFFSET;
+   uint32_t missing = slave->missing;
+   uint32_t block = 0;
+   uint32_t first;
+
+   if(0 == slave->announced)
+   {
+      missing = UPDT_BROADCAST_MISSING_UNKNOWN;
+   }
+   else if(0 != slave->refused)
+   {
+      missing = UPDT_BROADCAST_MISSING_REFUSED;
+   }
+   else
+   {
+      while(range < payload + UPDT_PROTOCOL_PACKET_NAK_PAYLOAD_SIZE && block < slave->blocks)
+      {
+         if(UPDT_broadcastIsSet(slave->received, block))
+         {
+            block++;
+            continue;
+         }
+         first = block;
+         while(block < slave->blocks && 0 == UPDT_broadcastIsSet(slave->received, block))
+         {
+            block++;
+         }
+         UPDT_broadcastSet16(range, (uint16_t) first);
+         UPDT_broadcastSet16(range + 2, (uint16_t) (block - first));
+         range += 4;
+      }
+   }
+
+   UPDT_protocolSetHeader(frame, UPDT_PROTOCOL_PACKET_NAK, 0, UPDT_PROTOCOL_PACKET_NAK_PAYLOAD_SIZE);
+   frame[1] = slave->address;
+   UPDT_crc32cSet(payload + UPDT_BROADCAST_NAK_ID_OFFSET, slave->id);
+   UPDT_crc32cSet(payload + UPDT_BROADCAST_NAK_MISSING_OFFSET, missing);
+   UPDT_protocolSetCrc(frame);
+   return UPDT_protocolSend(slave->transport, frame, UPDT_BROADCAST_NAK_FRAME_SIZE);
+}
+
+/*==================[external functions definition]==========================*/
+int32_t UPDT_broadcastMasterInit(
+   UPDT_broadcastMasterType *master,
+   UPDT_ITransportType *transport,
+   const uint8_t *image,
+   uint32_t image_size,
+   uint16_t payload_size,
+   uint8_t *missing,
+   size_t missing_size,
+   uint32_t id)
+{
+   uint32_t blocks;
+
+   ciaaPOSIX_assert(NULL != master);
+   ciaaPOSIX_assert(NULL != transport);
+   ciaaPOSIX_assert(NULL != image || 0 == image_size);
+   ciaaPOSIX_assert(NULL != missing);
+
+   if(0 == payload_size || 0 != (payload_size & 7u) || payload_size > UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE)
+   {
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+   blocks = UPDT_broadcastBlocks(image_size, payload_size);
+   if(blocks > UPDT_BROADCAST_BLOCKS_MAX || UPDT_BROADCAST_BITMAP_SIZE(blocks) > missing_size)
+   {
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+
+   UPDT_ITransportDeadlineInit(&master->deadline, transport);
+   master->image = image;
+   master->image_size = image_size;
+   master->image_crc = UPDT_crc32cUpdate(0, image, image_size);
+   master->id = id;
+   master->payload_size = payload_size;
+   master->blocks = (uint16_t) blocks;
+   master->missing = missing;
+   master->timeout = 0;
+   master->sent = 0;
+   master->rounds = 0;
+   master->polls = 0;
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+void UPDT_broadcastMasterSetTimeout(UPDT_broadcastMasterType *master, uint32_t timeout)
+{
+   ciaaPOSIX_assert(NULL != master);
+
+   master->timeout = timeout;
+}
+
+int32_t UPDT_broadcastMasterRun(
+   UPDT_broadcastMasterType *master,
+   const uint8_t *slaves,
+   uint8_t *status,
+   size_t count)
+{
+   uint32_t block;
+   size_t pending;
+   size_t i;
+   int32_t ret;
+
+   ciaaPOSIX_assert(NULL != master);
+   ciaaPOSIX_assert(NULL != slaves || 0 == count);
+   ciaaPOSIX_assert(NULL != status || 0 == count);
+
+   for(i = 0; i < count; i++)
+   {
+      status[i] = UPDT_BROADCAST_SLAVE_PENDING;
+   }
+   ciaaPOSIX_memset(master->missing, 0, UPDT_BROADCAST_BITMAP_SIZE(master->blocks));
+   UPDT_broadcastMark(master->missing, 0, master->blocks);
+
+   for(;;)
+   {
+      /* the announcement is repeated for the slaves which missed it */
+      ret = UPDT_broadcastMasterAnnounce(master, UPDT_BROADCAST_ANN_START);
+      for(block = 0; block < master->blocks && UPDT_PROTOCOL_ERROR_NONE == ret; block++)
+      {
+         if(UPDT_broadcastIsSet(master->missing, block))
+         {
+            master->missing[block >> 3] &= (uint8_t) ~(1u << (block & 7));
+            ret = UPDT_broadcastMasterSendBlock(master, (uint16_t) block);
+         }
+      }
+
+      pending = 0;
+      for(i = 0; i < count && UPDT_PROTOCOL_ERROR_NONE == ret; i++)
+      {
+         if(UPDT_BROADCAST_SLAVE_PENDING == status[i])
+         {
+            ret = UPDT_broadcastMasterPoll(master, slaves[i], &status[i]);
+            pending += UPDT_BROADCAST_SLAVE_PENDING == status[i];
+         }
+      }
+      if(UPDT_PROTOCOL_ERROR_NONE != ret)
+      {
+         return ret;
+      }
+      if(0 == pending || UPDT_BROADCAST_ROUNDS_MAX == master->rounds)
+      {
+         break;
+      }
+      master->rounds++;
+   }
+
+   /* not acknowledged, so it is repeated */
+   for(i = 0; i < UPDT_PROTOCOL_RETRIES_MAX && UPDT_PROTOCOL_ERROR_NONE == ret; i++)
+   {
+      ret = UPDT_broadcastMasterAnnounce(master, UPDT_BROADCAST_ANN_END);
+   }
+   if(UPDT_PROTOCOL_ERROR_NONE != ret)
+   {
+      return ret;
+   }
+   for(i = 0; i < count; i++)
+   {
+      if(UPDT_BROADCAST_SLAVE_DONE != status[i])
+      {
+         return UPDT_PROTOCOL_ERROR_TIMEOUT;
+      }
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+void UPDT_broadcastSlaveInit(
+   UPDT_broadcastSlaveType *slave,
+   UPDT_ITransportType *transport,
+   uint8_t address,
+   uint8_t *frame,
+   size_t frame_size,
+   uint8_t *received,
+   size_t received_size,
+   UPDT_protocolConsumerType consumer,
+   void *context)
+{
+   ciaaPOSIX_assert(NULL != slave);
+   ciaaPOSIX_assert(NULL != transport);
+   ciaaPOSIX_assert(NULL != frame);
+   ciaaPOSIX_assert(frame_size >= UPDT_BROADCAST_ANN_FRAME_SIZE);
+   ciaaPOSIX_assert(NULL != received);
+   ciaaPOSIX_assert(NULL != consumer);
+
+   slave->transport = transport;
+   slave->address = address;
+   slave->frame = frame;
+   slave->frame_size = frame_size;
+   slave->received = received;
+   slave->received_size = received_size;
+   slave->consumer = consumer;
+   slave->context = context;
+   slave->announced = 0;
+   slave->refused = 0;
+   slave->ended = 0;
+   slave->id = 0;
+   slave->image_size = 0;
+   slave->image_crc = 0;
+   slave->payload_size = 0;
+   slave->blocks = 0;
+   slave->missing = 0;
+}
+
+int32_t UPDT_broadcastSlaveRecv(UPDT_broadcastSlaveType *slave)
+{
+   uint8_t *frame;
+   uint16_t frame_size;
+   int8_t packet_type;
+   int32_t ret;
+
+   ciaaPOSIX_assert(NULL != slave);
+
+   frame = slave->frame;
+   ret = UPDT_protocolRecv(slave->transport, frame, UPDT_PROTOCOL_HEADER_SIZE);
+   if(UPDT_PROTOCOL_ERROR_NONE != ret)
+   {
+      return ret;
+   }
+   frame_size = UPDT_protocolGetFrameSize(frame);
+   if(frame_size > slave->frame_size || 0 == (UPDT_protocolGetFlags(frame) & UPDT_PROTOCOL_FLAG_CRC))
+   {
+      return UPDT_protocolRecvConsume(slave->transport, frame_size - UPDT_PROTOCOL_HEADER_SIZE, NULL, NULL);
+   }
+   ret = UPDT_protocolRecv(slave->transport, frame + UPDT_PROTOCOL_HEADER_SIZE,
+      frame_size - UPDT_PROTOCOL_HEADER_SIZE);
+   if(UPDT_PROTOCOL_ERROR_NONE == ret)
+   {
+      ret = UPDT_protocolCheckCrc(frame);
+   }
+   if(UPDT_PROTOCOL_ERROR_NONE != ret)
+   {
+      return ret;
+   }
+
+   packet_type = UPDT_protocolGetPacketType(frame);
+   if(UPDT_PROTOCOL_PACKET_ANN == packet_type &&
+      UPDT_PROTOCOL_PACKET_ANN_PAYLOAD_SIZE == UPDT_protocolGetPayloadSize(frame))
+   {
+      UPDT_broadcastSlaveAnnounce(slave, frame);
+   }
+   else if(UPDT_PROTOCOL_PACKET_DAT == packet_type)
+   {
+      ret = UPDT_broadcastSlaveWrite(slave, frame);
+   }
+   else if(UPDT_PROTOCOL_PACKET_NAK == packet_type && slave->address == frame[1] &&
+      0 == UPDT_protocolGetPayloadSize(frame))
+   {
+      ret = UPDT_broadcastSlaveAnswer(slave);
+   }
+   return ret;
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,684 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+
+/** \brief This file implements the Flash Update Cipher
+ **
+ ** ChaCha20-Poly1305 (RFC 8439) of the DAT payloads. ChaCha20 only needs
+ ** 32 bit additions, rotations and xors, so the software kernel keeps up
+ ** with the serial port on targets without a crypto engine, and Poly1305
+ ** uses 26 bit limbs so its products fit the 32x32->64 multiplier.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Cipher
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_assert.h"
+#include "ciaaPOSIX_string.h"
+#include "UPDT_cipher.h"
+#include "UPDT_sha256.h"
+#include "UPDT_trace.h"
+
+/*==================[macros and definitions]=================================*/
+/** reads 4 bytes in little endian order, regardless of the alignment */
+#define UPDT_CIPHER_LOAD32(p)                                                 \
+   ((uint32_t) (p)[0] | ((uint32_t) (p)[1] << 8) |                            \
+   ((uint32_t) (p)[2] << 16) | ((uint32_t) (p)[3] << 24))
+
+#define UPDT_CIPHER_ROL(x, n)            (((x) << (n)) | ((x) >> (32 - (n))))
+
+/** ChaCha20 quarter round, it works on words and on vectors of words */
+#define UPDT_CIPHER_QUARTER(a, b, c, d)                                       \
+   do                                                                         \
+   {                                                                          \
+      a += b; d ^= a; d = UPDT_CIPHER_ROL(d, 16);                             \
+      c += d; b ^= c; b = UPDT_CIPHER_ROL(b, 12);                             \
+      a += b; d ^= a; d = UPDT_CIPHER_ROL(d, 8);                              \
+      c += d; b ^= c; b = UPDT_CIPHER_ROL(b, 7);                              \
+   } while(0)
+
+/** ChaCha20 double round: a column round and a diagonal round */
+#define UPDT_CIPHER_DOUBLE_ROUND(x)                                           \
+   do                                                                         \
+   {                                                                          \
+      UPDT_CIPHER_QUARTER(x[0], x[4], x[8], x[12]);                           \
+      UPDT_CIPHER_QUARTER(x[1], x[5], x[9], x[13]);                           \
+      UPDT_CIPHER_QUARTER(x[2], x[6], x[10], x[14]);                          \
+      UPDT_CIPHER_QUARTER(x[3], x[7], x[11], x[15]);                          \
+      UPDT_CIPHER_QUARTER(x[0], x[5], x[10], x[15]);                          \
+      UPDT_CIPHER_QUARTER(x[1], x[6], x[11], x[12]);                          \
+      UPDT_CIPHER_QUARTER(x[2], x[7], x[8], x[13]);                           \
+      UPDT_CIPHER_QUARTER(x[3], x[4], x[9], x[14]);                           \
+   } while(0)
+
+/** mask of a 26 bit Poly1305 limb */
+#define UPDT_CIPHER_LIMB                 0x3ffffffu
+
+/** \brief Poly1305 state type. */
+typedef struct
+{
+   /** Multiplier, clamped */
+   uint32_t r[5];
+   /** Accumulator */
+   uint32_t h[5];
+   /** Added to the accumulator at the end */
+   uint32_t pad[4];
+} UPDT_cipherPolyType;
+
+#ifdef UPDT_CIPHER_SIMD
+/** four lanes of 32 bits, one per block */
+typedef uint32_t UPDT_cipherVectorType __attribute__((vector_size(16)));
+#endif
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** "expand 32-byte k" */
+static const uint32_t UPDT_cipherSigma[4] =
+{
+   0x61707865, 0x3320646e, 0x79622d32, 0x6b206574
+};
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Writes a word in little endian order. */
+static void UPDT_cipherStore32(uint8_t *p, uint32_t v)
+{
+   p[0] = (uint8_t) v;
+   p[1] = (uint8_t) (v >> 8);
+   p[2] = (uint8_t) (v >> 16);
+   p[3] = (uint8_t) (v >> 24);
+}
+
+/** \brief Loads the initial ChaCha20 state. */
+static void UPDT_cipherSetup(
+   uint32_t *state,
+   const uint32_t *key,
+   const uint32_t *nonce,
+   uint32_t counter)
+{
+   uint8_t i;
+
+   for(i = 0; i < 4; i++)
+   {
+      state[i] = UPDT_cipherSigma[i];
+   }
+   for(i = 0; i < 8; i++)
+   {
+      state[4 + i] = key[i];
+   }
+   state[12] = counter;
+   state[13] = nonce[0];
+   state[14] = nonce[1];
+   state[15] = nonce[2];
+}
+
+/** \brief Computes one ChaCha20 block into words. */
+static void UPDT_cipherBlock(const uint32_t *state, uint32_t *block)
+{
+   uint32_t x[16];
+   uint8_t i;
+
+   for(i = 0; i < 16; i++)
+   {
+      x[i] = state[i];
+   }
+   for(i = 0; i < 10; i++)
+   {
+      UPDT_CIPHER_DOUBLE_ROUND(x);
+   }
+   for(i = 0; i < 16; i++)
+   {
+      block[i] = x[i] + state[i];
+   }
+}
+
+/** \brief Xors up to one block of data with the key stream words. */
+static void UPDT_cipherXor(uint8_t *data, const uint32_t *block, size_t size)
+{
+   size_t i;
+
+   for(i = 0; i + 4 <= size; i += 4)
+   {
+      UPDT_cipherStore32(data + i, UPDT_CIPHER_LOAD32(data + i) ^ block[i / 4]);
+   }
+   for(; i < size; i++)
+   {
+      data[i] ^= (uint8_t) (block[i / 4] >> (8 * (i % 4)));
+   }
+}
+
+/** \brief Starts a Poly1305 computation with a one time key. */
+static void UPDT_cipherPolyInit(UPDT_cipherPolyType *poly, const uint8_t *key)
+{
+   uint8_t i;
+
+   /* r is clamped as it is split in limbs */
+   poly->r[0] = UPDT_CIPHER_LOAD32(key) & 0x3ffffff;
+   poly->r[1] = (UPDT_CIPHER_LOAD32(key + 3) >> 2) & 0x3ffff03;
+   poly->r[2] = (UPDT_CIPHER_LOAD32(key + 6) >> 4) & 0x3ffc0ff;
+   poly->r[3] = (UPDT_CIPHER_LOAD32(key + 9) >> 6) & 0x3f03fff;
+   poly->r[4] = (UPDT_CIPHER_LOAD32(key + 12) >> 8) & 0x00fffff;
+   for(i = 0; i < 5; i++)
+   {
+      poly->h[i] = 0;
+   }
+   for(i = 0; i < 4; i++)
+   {
+      poly->pad[i] = UPDT_CIPHER_LOAD32(key + 16 + 4 * i);
+   }
+}
+
+/** \brief Adds count blocks of 16 bytes to the accumulator.
+ **
+ ** \param hibit 1 << 24 for whole blocks, 0 for the padded last block of
+ ** a plain Poly1305 message.
+ **/
+static void UPDT_cipherPolyBlocks(
+   UPDT_cipherPolyType *poly,
+   const uint8_t *data,
+   size_t count,
+   uint32_t hibit)
+{
+   const uint32_t r0 = poly->r[0], r1 = poly->r[1], r2 = poly->r[2];
+   const uint32_t r3 = poly->r[3], r4 = poly->r[4];
+   const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+   uint32_t h0 = poly->h[0], h1 = poly->h[1], h2 = poly->h[2];
+   uint32_t h3 = poly->h[3], h4 = poly->h[4];
+   uint64_t d0, d1, d2, d3, d4;
+   uint32_t c;
+
+   while(count-- > 0)
+   {
+      h0 += UPDT_CIPHER_LOAD32(data) & UPDT_CIPHER_LIMB;
+      h1 += (UPDT_CIPHER_LOAD32(data + 3) >> 2) & UPDT_CIPHER_LIMB;
+      h2 += (UPDT_CIPHER_LOAD32(data + 6) >> 4) & UPDT_CIPHER_LIMB;
+      h3 += (UPDT_CIPHER_LOAD32(data + 9) >> 6) & UPDT_CIPHER_LIMB;
+      h4 += (UPDT_CIPHER_LOAD32(data + 12) >> 8) | hibit;
+
+      /* h * r modulo 2^130 - 5, the limbs above 2^130 wrap multiplied by 5 */
+      d0 = (uint64_t) h0 * r0 + (uint64_t) h1 * s4 + (uint64_t) h2 * s3 +
+         (uint64_t) h3 * s2 + (uint64_t) h4 * s1;
+      d1 = (uint64_t) h0 * r1 + (uint64_t) h1 * r0 + (uint64_t) h2 * s4 +
+         (uint64_t) h3 * s3 + (uint64_t) h4 * s2;
+      d2 = (uint64_t) h0 * r2 + (uint64_t) h1 * r1 + (uint64_t) h2 * r0 +
+         (uint64_t) h3 * s4 + (uint64_t) h4 * s3;
+      d3 = (uint64_t) h0 * r3 + (uint64_t) h1 * r2 + (uint64_t) h2 * r1 +
+         (uint64_t) h3 * r0 + (uint64_t) h4 * s4;
+      d4 = (uint64_t) h0 * r4 + (uint64_t) h1 * r3 + (uint64_t) h2 * r2 +
+         (uint64_t) h3 * r1 + (uint64_t) h4 * r0;
+
+      c = (uint32_t) (d0 >> 26);
+      h0 = (uint32_t) d0 & UPDT_CIPHER_LIMB;
+      d1 += c;
+      c = (uint32_t) (d1 >> 26);
+      h1 = (uint32_t) d1 & UPDT_CIPHER_LIMB;
+      d2 += c;
+      c = (uint32_t) (d2 >> 26);
+      h2 = (uint32_t) d2 & UPDT_CIPHER_LIMB;
+      d3 += c;
+      c = (uint32_t) (d3 >> 26);
+      h3 = (uint32_t) d3 & UPDT_CIPHER_LIMB;
+      d4 += c;
+      c = (uint32_t) (d4 >> 26);
+      h4 = (uint32_t) d4 & UPDT_CIPHER_LIMB;
+      h0 += c * 5;
+      c = h0 >> 26;
+      h0 &= UPDT_CIPHER_LIMB;
+      h1 += c;
+
+      data += 16;
+   }
+
+   poly->h[0] = h0;
+   poly->h[1] = h1;
+   poly->h[2] = h2;
+   poly->h[3] = h3;
+   poly->h[4] = h4;
+}
+
+/** \brief Adds data to the accumulator, the last piece padded to a block.
+ **
+ ** \param last Non-zero if the data ends a plain Poly1305 message, its
+ ** last piece is then padded with a one and zeros. Otherwise it is padded
+ ** with zeros, as the AEAD construction does.
+ **/
+static void UPDT_cipherPolyUpdate(
+   UPDT_cipherPolyType *poly,
+   const uint8_t *data,
+   size_t size,
+   uint8_t last)
+{
+   uint8_t block[16];
+   size_t rest = size % 16;
+
+   UPDT_cipherPolyBlocks(poly, data, size / 16, 1u << 24);
+   if(0 != rest)
+   {
+      ciaaPOSIX_memset(block, 0, sizeof(block));
+      ciaaPOSIX_memcpy(block, data + size - rest, rest);
+      if(last)
+      {
+         block[rest] = 1;
+      }
+      UPDT_cipherPolyBlocks(poly, block, 1, last ? 0 : 1u << 24);
+   }
+}
+
+/** \brief Computes the tag, h + pad modulo 2^128. */
+static void UPDT_cipherPolyFinish(UPDT_cipherPolyType *poly, uint8_t *tag)
+{
+   uint32_t h0 = poly->h[0], h1 = poly->h[1], h2 = poly->h[2];
+   uint32_t h3 = poly->h[3], h4 = poly->h[4];
+   uint32_t g0, g1, g2, g3, g4;
+   uint32_t c, mask;
+   uint64_t f;
+
+   /* full carry */
+   c = h1 >> 26;
+   h1 &= UPDT_CIPHER_LIMB;
+   h2 += c;
+   c = h2 >> 26;
+   h2 &= UPDT_CIPHER_LIMB;
+   h3 += c;
+   c = h3 >> 26;
+   h3 &= UPDT_CIPHER_LIMB;
+   h4 += c;
+   c = h4 >> 26;
+   h4 &= UPDT_CIPHER_LIMB;
+   h0 += c * 5;
+   c = h0 >> 26;
+   h0 &= UPDT_CIPHER_LIMB;
+   h1 += c;
+
+   /* g = h - (2^130 - 5), chosen without branches if it is not negative */
+   g0 = h0 + 5;
+   c = g0 >> 26;
+   g0 &= UPDT_CIPHER_LIMB;
+   g1 = h1 + c;
+   c = g1 >> 26;
+   g1 &= UPDT_CIPHER_LIMB;
+   g2 = h2 + c;
+   c = g2 >> 26;
+   g2 &= UPDT_CIPHER_LIMB;
+   g3 = h3 + c;
+   c = g3 >> 26;
+   g3 &= UPDT_CIPHER_LIMB;
+   g4 = h4 + c - (1u << 26);
+
+   mask = (g4 >> 31) - 1;
+   h0 = (h0 & ~mask) | (g0 & mask);
+   h1 = (h1 & ~mask) | (g1 & mask);
+   h2 = (h2 & ~mask) | (g2 & mask);
+   h3 = (h3 & ~mask) | (g3 & mask);
+   h4 = (h4 & ~mask) | (g4 & mask);
+
+   /* back to 32 bit words, the bits above 2^128 are dropped */
+   h0 = h0 | (h1 << 26);
+   h1 = (h1 >> 6) | (h2 << 20);
+   h2 = (h2 >> 12) | (h3 << 14);
+   h3 = (h3 >> 18) | (h4 << 8);
+
+   f = (uint64_t) h0 + poly->pad[0];
+   UPDT_cipherStore32(tag, (uint32_t) f);
+   f = (uint64_t) h1 + poly->pad[1] + (f >> 32);
+   UPDT_cipherStore32(tag + 4, (uint32_t) f);
+   f = (uint64_t) h2 + poly->pad[2] + (f >> 32);
+   UPDT_cipherStore32(tag + 8, (uint32_t) f);
+   f = (uint64_t) h3 + poly->pad[3] + (f >> 32);
+   UPDT_cipherStore32(tag + 12, (uint32_t) f);
+}
+
+/** \brief Computes the AEAD tag of the aad and the encrypted data. */
+static void UPDT_cipherTag(
+   const UPDT_cipherType *cipher,
+   const uint32_t *nonce,
+   const uint8_t *aad,
+   size_t aad_size,
+   const uint8_t *data,
+   size_t size,
+   uint8_t *tag)
+{
+   UPDT_cipherPolyType poly;
+   uint32_t state[16];
+   uint32_t block[16];
+   uint8_t key[32];
+   uint8_t lengths[16];
+   uint8_t i;
+
+   /* the one time key is the start of the block 0 */
+   UPDT_cipherSetup(state, cipher->key, nonce, 0);
+   UPDT_cipherBlock(state, block);
+   for(i = 0; i < 8; i++)
+   {
+      UPDT_cipherStore32(key + 4 * i, block[i]);
+   }
+   UPDT_cipherPolyInit(&poly, key);
+
+   UPDT_cipherPolyUpdate(&poly, aad, aad_size, 0);
+   UPDT_cipherPolyUpdate(&poly, data, size, 0);
+   UPDT_cipherStore32(lengths, (uint32_t) aad_size);
+   UPDT_cipherStore32(lengths + 4, 0);
+   UPDT_cipherStore32(lengths + 8, (uint32_t) size);
+   UPDT_cipherStore32(lengths + 12, 0);
+   UPDT_cipherPolyBlocks(&poly, lengths, 1, 1u << 24);
+   UPDT_cipherPolyFinish(&poly, tag);
+}
+
+/** \brief Compares two buffers in a time that does not depend on their
+ ** contents. */
+static uint8_t UPDT_cipherCompare(const uint8_t *a, const uint8_t *b, size_t size)
+{
+   uint8_t diff = 0;
+
+   while(size-- > 0)
+   {
+      diff |= a[size] ^ b[size];
+   }
+   return 0 != diff;
+}
+
+/*==================[external functions definition]==========================*/
+void UPDT_cipherInit(
+   UPDT_cipherType *cipher,
+   const uint8_t *key,
+   const uint8_t *inf,
+   const uint8_t *alw)
+{
+   UPDT_sha256Type sha;
+   uint8_t digest[UPDT_SHA256_SIZE];
+   uint8_t i;
+
+   ciaaPOSIX_assert(NULL != cipher);
+   ciaaPOSIX_assert(NULL != key);
+   ciaaPOSIX_assert(NULL != inf);
+   ciaaPOSIX_assert(NULL != alw);
+
+   for(i = 0; i < UPDT_CIPHER_KEY_SIZE / 4; i++)
+   {
+      cipher->key[i] = UPDT_CIPHER_LOAD32(key + 4 * i);
+   }
+   UPDT_sha256Init(&sha);
+   UPDT_sha256Update(&sha, inf, UPDT_PROTOCOL_PACKET_INF_PAYLOAD_SIZE);
+   UPDT_sha256Update(&sha, alw, UPDT_PROTOCOL_PACKET_ALW_PAYLOAD_SIZE);
+   UPDT_sha256Final(&sha, digest);
+   UPDT_cipherSetNonce(cipher, digest);
+}
+
+void UPDT_cipherSetNonce(UPDT_cipherType *cipher, const uint8_t *nonce)
+{
+   ciaaPOSIX_assert(NULL != cipher);
+   ciaaPOSIX_assert(NULL != nonce);
+
+   cipher->nonce[0] = 0;
+   cipher->nonce[1] = UPDT_CIPHER_LOAD32(nonce);
+   cipher->nonce[2] = UPDT_CIPHER_LOAD32(nonce + 4);
+}
+
+void UPDT_cipherEncrypt(
+   const UPDT_cipherType *cipher,
+   uint32_t number,
+   const uint8_t *aad,
+   size_t aad_size,
+   uint8_t *data,
+   size_t size,
+   uint8_t *tag)
+{
+   uint32_t nonce[UPDT_CIPHER_NONCE_SIZE / 4];
+
+   ciaaPOSIX_assert(NULL != cipher);
+   ciaaPOSIX_assert(NULL != aad || 0 == aad_size);
+   ciaaPOSIX_assert(NULL != data || 0 == size);
+   ciaaPOSIX_assert(NULL != tag);
+
+   UPDT_TRACE_BEGIN(UPDT_TRACE_EVENT_CIPHER, size);
+   nonce[0] = number;
+   nonce[1] = cipher->nonce[1];
+   nonce[2] = cipher->nonce[2];
+   UPDT_cipherChaCha20(cipher->key, nonce, 1, data, size);
+   UPDT_cipherTag(cipher, nonce, aad, aad_size, data, size, tag);
+   UPDT_TRACE_END(UPDT_TRACE_EVENT_CIPHER, size);
+}
+
+int32_t UPDT_cipherDecrypt(
+   const UPDT_cipherType *cipher,
+   uint32_t number,
+   const uint8_t *aad,
+   size_t aad_size,
+   uint8_t *data,
+   size_t size,
+   const uint8_t *tag)
+{
+   uint32_t nonce[UPDT_CIPHER_NONCE_SIZE / 4];
+   uint8_t expected[UPDT_CIPHER_TAG_SIZE];
+   int32_t ret = UPDT_PROTOCOL_ERROR_DENIED;
+
+   ciaaPOSIX_assert(NULL != cipher);
+   ciaaPOSIX_assert(NULL != aad || 0 == aad_size);
+   ciaaPOSIX_assert(NULL != data || 0 == size);
+   ciaaPOSIX_assert(NULL != tag);
+
+   UPDT_TRACE_BEGIN(UPDT_TRACE_EVENT_CIPHER, size);
+   nonce[0] = number;
+   nonce[1] = cipher->nonce[1];
+   nonce[2] = cipher->nonce[2];
+   UPDT_cipherTag(cipher, nonce, aad, aad_size, data, size, expected);
+   if(0 == UPDT_cipherCompare(expected, tag, UPDT_CIPHER_TAG_SIZE))
+   {
+      UPDT_cipherChaCha20(cipher->key, nonce, 1, data, size);
+      ret = UPDT_PROTOCOL_ERROR_NONE;
+   }
+   UPDT_TRACE_END(UPDT_TRACE_EVENT_CIPHER, size);
+   return ret;
+}
+
+int32_t UPDT_cipherSeal(
+   void *cipher,
+   const uint8_t *header,
+   uint8_t *payload,
+   uint32_t number)
+{
+   uint16_t size;
+
+   ciaaPOSIX_assert(NULL != header);
+
+   size = UPDT_protocolGetPayloadSize(header);
+   ciaaPOSIX_assert(UPDT_CIPHER_TAG_SIZE <= size);
+   size -= UPDT_CIPHER_TAG_SIZE;
+   UPDT_cipherEncrypt((const UPDT_cipherType *) cipher, number,
+      header, UPDT_PROTOCOL_HEADER_SIZE, payload, size, payload + size);
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+int32_t UPDT_cipherOpen(
+   void *cipher,
+   const uint8_t *header,
+   uint8_t *payload,
+   uint32_t number)
+{
+   uint16_t size;
+
+   ciaaPOSIX_assert(NULL != header);
+
+   size = UPDT_protocolGetPayloadSize(header);
+   if(UPDT_CIPHER_TAG_SIZE > size)
+   {
+      return UPDT_PROTOCOL_ERROR_DENIED;
+   }
+   size -= UPDT_CIPHER_TAG_SIZE;
+   return UPDT_cipherDecrypt((const UPDT_cipherType *) cipher, number,
+      header, UPDT_PROTOCOL_HEADER_SIZE, payload, size, payload + size);
+}
+
+void UPDT_cipherChaCha20(
+   const uint32_t *key,
+   const uint32_t *nonce,
+   uint32_t counter,
+   uint8_t *data,
+   size_t size)
+{
+#ifdef UPDT_CIPHER_SIMD
+   UPDT_cipherChaCha20Simd(key, nonce, counter, data, size);
+#else
+   UPDT_cipherChaCha20Scalar(key, nonce, counter, data, size);
+#endif
+}
+
+void UPDT_cipherChaCha20Scalar(
+   const uint32_t *key,
+   const uint32_t *nonce,
+   uint32_t counter,
+   uint8_t *data,
+   size_t size)
+{
+   uint32_t state[16];
+   uint32_t block[16];
+   size_t count;
+
+   ciaaPOSIX_assert(NULL != key);
+   ciaaPOSIX_assert(NULL != nonce);
+   ciaaPOSIX_assert(NULL != data || 0 == size);
+
+   UPDT_cipherSetup(state, key, nonce, counter);
+   while(0 < size)
+   {
+      UPDT_cipherBlock(state, block);
+      count = size < UPDT_CIPHER_BLOCK_SIZE ? size : UPDT_CIPHER_BLOCK_SIZE;
+      UPDT_cipherXor(data, block, count);
+      state[12]++;
+      data += count;
+      size -= count;
+   }
+}
+
+#ifdef UPDT_CIPHER_SIMD
+void UPDT_cipherChaCha20Simd(
+   const uint32_t *key,
+   const uint32_t *nonce,
+   uint32_t counter,
+   uint8_t *data,
+   size_t size)
+{
+   const UPDT_cipherVectorType lanes = { 0, 1, 2, 3 };
+   UPDT_cipherVectorType x[16];
+   UPDT_cipherVectorType s[16];
+   uint32_t state[16];
+   uint32_t stream[16][4];
+   uint32_t block[16];
+   uint8_t i, j;
+
+   ciaaPOSIX_assert(NULL != key);
+   ciaaPOSIX_assert(NULL != nonce);
+   ciaaPOSIX_assert(NULL != data || 0 == size);
+
+   UPDT_cipherSetup(state, key, nonce, counter);
+   /* each vector holds one word of four consecutive blocks */
+   for(i = 0; i < 16; i++)
+   {
+      s[i] = (UPDT_cipherVectorType) { state[i], state[i], state[i], state[i] };
+   }
+   while(size >= 4 * UPDT_CIPHER_BLOCK_SIZE)
+   {
+      s[12] = (UPDT_cipherVectorType) { state[12], state[12], state[12], state[12] } + lanes;
+      for(i = 0; i < 16; i++)
+      {
+         x[i] = s[i];
+      }
+      for(i = 0; i < 10; i++)
+      {
+         UPDT_CIPHER_DOUBLE_ROUND(x);
+      }
+      for(i = 0; i < 16; i++)
+      {
+         x[i] += s[i];
+         ciaaPOSIX_memcpy(stream[i], &x[i], sizeof(stream[i]));
+      }
+      for(j = 0; j < 4; j++)
+      {
+         for(i = 0; i < 16; i++)
+         {
+            block[i] = stream[i][j];
+         }
+         UPDT_cipherXor(data, block, UPDT_CIPHER_BLOCK_SIZE);
+         data += UPDT_CIPHER_BLOCK_SIZE;
+      }
+      state[12] += 4;
+      size -= 4 * UPDT_CIPHER_BLOCK_SIZE;
+   }
+   /* the tail one block at a time */
+   UPDT_cipherChaCha20Scalar(key, nonce, state[12], data, size);
+}
+#endif
+
+void UPDT_cipherPoly1305(
+   const uint8_t *key,
+   const uint8_t *message,
+   size_t size,
+   uint8_t *tag)
+{
+   UPDT_cipherPolyType poly;
+
+   ciaaPOSIX_assert(NULL != key);
+   ciaaPOSIX_assert(NULL != message || 0 == size);
+   ciaaPOSIX_assert(NULL != tag);
+
+   UPDT_cipherPolyInit(&poly, key);
+   UPDT_cipherPolyUpdate(&poly, message, size, 1);
+   UPDT_cipherPolyFinish(&poly, tag);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,307 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the Flash Update Delta
+ **
+ ** Streaming patcher rebuilding a new image from the installed one and a
+ ** bsdiff style patch, see tools/updt_delta.py for the generator.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Delta
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_assert.h"
+#include "ciaaPOSIX_string.h"
+#include "UPDT_delta.h"
+#include "UPDT_crc32c.h"
+
+/*==================[macros and definitions]=================================*/
+/* patcher states */
+#define UPDT_DELTA_STATE_HEADER          0
+#define UPDT_DELTA_STATE_RECORD          1
+#define UPDT_DELTA_STATE_DIFF            2
+#define UPDT_DELTA_STATE_EXTRA           3
+#define UPDT_DELTA_STATE_DONE            4
+#define UPDT_DELTA_STATE_FAILED          5
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Reads a little endian 32 bits value. */
+static uint32_t UPDT_deltaGetUint32(const uint8_t *buffer)
+{
+   return (uint32_t) buffer[0] | ((uint32_t) buffer[1] << 8) |
+      ((uint32_t) buffer[2] << 16) | ((uint32_t) buffer[3] << 24);
+}
+
+/** \brief Checks the header against the installed image. */
+static int32_t UPDT_deltaPatcherHeader(UPDT_deltaPatcherType *patcher)
+{
+   uint32_t crc = 0;
+   size_t offset;
+   size_t size;
+   int32_t ret;
+
+   if(UPDT_DELTA_MAGIC != UPDT_deltaGetUint32(patcher->header))
+   {
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+   if(patcher->source_size != UPDT_deltaGetUint32(patcher->header + 4))
+   {
+      return UPDT_PROTOCOL_ERROR_DENIED;
+   }
+   for(offset = 0; offset < patcher->source_size; offset += size)
+   {
+      size = patcher->source_size - offset;
+      if(size > UPDT_DELTA_SOURCE_BUFFER_SIZE)
+      {
+         size = UPDT_DELTA_SOURCE_BUFFER_SIZE;
+      }
+      ret = patcher->reader(patcher->reader_context, offset, patcher->source, size);
+      if(UPDT_PROTOCOL_ERROR_NONE != ret)
+      {
+         return ret;
+      }
+      crc = UPDT_crc32cUpdate(crc, patcher->source, size);
+   }
+   if(crc != UPDT_deltaGetUint32(patcher->header + 8))
+   {
+      return UPDT_PROTOCOL_ERROR_DENIED;
+   }
+   patcher->target_size = UPDT_deltaGetUint32(patcher->header + 12);
+   patcher->target_crc = UPDT_deltaGetUint32(patcher->header + 16);
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Checks a record header and starts the record. */
+static int32_t UPDT_deltaPatcherRecord(UPDT_deltaPatcherType *patcher)
+{
+   int32_t seek = (int32_t) UPDT_deltaGetUint32(patcher->header + 8);
+
+   patcher->diff_left = UPDT_deltaGetUint32(patcher->header);
+   patcher->extra_left = UPDT_deltaGetUint32(patcher->header + 4);
+   if((0 > seek && (size_t) -(int64_t) seek > patcher->position) ||
+      (0 <= seek && (size_t) seek > patcher->source_size - patcher->position))
+   {
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+   patcher->position += seek;
+   if(patcher->diff_left > patcher->source_size - patcher->position ||
+      patcher->diff_left > patcher->target_size - patcher->produced ||
+      patcher->extra_left > patcher->target_size - patcher->produced - patcher->diff_left)
+   {
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Skips the empty parts of the patch and checks the end. */
+static int32_t UPDT_deltaPatcherNext(UPDT_deltaPatcherType *patcher)
+{
+   if(UPDT_DELTA_STATE_DIFF == patcher->state && 0 == patcher->diff_left)
+   {
+      patcher->state = UPDT_DELTA_STATE_EXTRA;
+   }
+   if(UPDT_DELTA_STATE_EXTRA == patcher->state && 0 == patcher->extra_left)
+   {
+      patcher->state = UPDT_DELTA_STATE_RECORD;
+      patcher->fill = 0;
+   }
+   if(UPDT_DELTA_STATE_RECORD == patcher->state && patcher->produced == patcher->target_size)
+   {
+      if(patcher->crc != patcher->target_crc)
+      {
+         patcher->state = UPDT_DELTA_STATE_FAILED;
+         return UPDT_PROTOCOL_ERROR_CRC;
+      }
+      patcher->state = UPDT_DELTA_STATE_DONE;
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Gives bytes of the new image to the consumer. */
+static int32_t UPDT_deltaPatcherOutput(UPDT_deltaPatcherType *patcher, const uint8_t *data, size_t size)
+{
+   int32_t ret;
+
+   ret = patcher->consumer(patcher->context, patcher->produced, data, size);
+   patcher->crc = UPDT_crc32cUpdate(patcher->crc, data, size);
+   patcher->produced += size;
+   return ret;
+}
+
+/*==================[external functions definition]==========================*/
+void UPDT_deltaPatcherInit(
+   UPDT_deltaPatcherType *patcher,
+   size_t source_size,
+   UPDT_deltaReaderType reader,
+   void *reader_context,
+   UPDT_protocolConsumerType consumer,
+   void *context)
+{
+   ciaaPOSIX_assert(NULL != patcher);
+   ciaaPOSIX_assert(NULL != reader);
+   ciaaPOSIX_assert(NULL != consumer);
+
+   patcher->fill = 0;
+   patcher->state = UPDT_DELTA_STATE_HEADER;
+   patcher->diff_left = 0;
+   patcher->extra_left = 0;
+   patcher->position = 0;
+   patcher->source_size = source_size;
+   patcher->target_size = 0;
+   patcher->target_crc = 0;
+   patcher->crc = 0;
+   patcher->produced = 0;
+   patcher->reader = reader;
+   patcher->reader_context = reader_context;
+   patcher->consumer = consumer;
+   patcher->context = context;
+}
+
+int32_t UPDT_deltaPatcherConsume(
+   void *context,
+   size_t offset,
+   const uint8_t *data,
+   size_t size)
+{
+   UPDT_deltaPatcherType *patcher = (UPDT_deltaPatcherType *) context;
+   size_t needed;
+   size_t chunk;
+   size_t i;
+   int32_t ret = UPDT_PROTOCOL_ERROR_NONE;
+
+   ciaaPOSIX_assert(NULL != patcher);
+   ciaaPOSIX_assert(NULL != data || 0 == size);
+   (void) offset;
+
+   while(0 < size && UPDT_PROTOCOL_ERROR_NONE == ret &&
+      UPDT_DELTA_STATE_DONE > patcher->state)
+   {
+      switch(patcher->state)
+      {
+         case UPDT_DELTA_STATE_HEADER:
+         case UPDT_DELTA_STATE_RECORD:
+            needed = (UPDT_DELTA_STATE_HEADER == patcher->state ?
+               UPDT_DELTA_HEADER_SIZE : UPDT_DELTA_RECORD_SIZE) - patcher->fill;
+            chunk = size < needed ? size : needed;
+            ciaaPOSIX_memcpy(patcher->header + patcher->fill, data, chunk);
+            patcher->fill += chunk;
+            if(chunk < needed)
+            {
+               return UPDT_PROTOCOL_ERROR_NONE;
+            }
+            if(UPDT_DELTA_STATE_HEADER == patcher->state)
+            {
+               ret = UPDT_deltaPatcherHeader(patcher);
+               patcher->state = UPDT_DELTA_STATE_RECORD;
+               patcher->fill = 0;
+            }
+            else
+            {
+               ret = UPDT_deltaPatcherRecord(patcher);
+               patcher->state = UPDT_DELTA_STATE_DIFF;
+            }
+            break;
+
+         case UPDT_DELTA_STATE_DIFF:
+            chunk = size < patcher->diff_left ? size : patcher->diff_left;
+            if(chunk > UPDT_DELTA_SOURCE_BUFFER_SIZE)
+            {
+               chunk = UPDT_DELTA_SOURCE_BUFFER_SIZE;
+            }
+            ret = patcher->reader(patcher->reader_context, patcher->position,
+               patcher->source, chunk);
+            if(UPDT_PROTOCOL_ERROR_NONE != ret)
+            {
+               return ret;
+            }
+            for(i = 0; i < chunk; i++)
+            {
+               patcher->source[i] += data[i];
+            }
+            patcher->position += chunk;
+            patcher->diff_left -= chunk;
+            ret = UPDT_deltaPatcherOutput(patcher, patcher->source, chunk);
+            break;
+
+         default:
+            chunk = size < patcher->extra_left ? size : patcher->extra_left;
+            patcher->extra_left -= chunk;
+            ret = UPDT_deltaPatcherOutput(patcher, data, chunk);
+            break;
+      }
+      data += chunk;
+      size -= chunk;
+      if(UPDT_PROTOCOL_ERROR_NONE == ret && UPDT_DELTA_STATE_HEADER != patcher->state)
+      {
+         ret = UPDT_deltaPatcherNext(patcher);
+      }
+   }
+   return ret;
+}
+
+uint8_t UPDT_deltaPatcherDone(const UPDT_deltaPatcherType *patcher)
+{
+   ciaaPOSIX_assert(NULL != patcher);
+
+   return UPDT_DELTA_STATE_DONE == patcher->state;
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
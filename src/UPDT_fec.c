@@ -0,0 +1,467 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the Flash Update Forward Error Correction
+ **
+ ** Reed-Solomon erasure code over GF(2^8) with the polynomial
+ ** x^8 + x^4 + x^3 + x^2 + 1 (0x11D). The products are computed with
+ ** logarithm tables. Adding a block multiplied by a coefficient first
+ ** builds the 256 products of the coefficient, then costs one lookup per
+ ** byte.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Forward Error Correction
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_assert.h"
+#include "ciaaPOSIX_string.h"
+#include "UPDT_fec.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** Powers of the generator 2, twice so that the sum of two logarithms
+ ** needs no reduction */
+static const uint8_t UPDT_fecExp[512] =
+{
+   0x01u, 0x02u, 0x04u, 0x08u, 0x10u, 0x20u, 0x40u, 0x80u, 0x1Du, 0x3Au, 0x74u, 0xE8u,
+   0xCDu, 0x87u, 0x13u, 0x26u, 0x4Cu, 0x98u, 0x2Du, 0x5Au, 0xB4u, 0x75u, 0xEAu, 0xC9u,
+   0x8Fu, 0x03u, 0x06u, 0x0Cu, 0x18u, 0x30u, 0x60u, 0xC0u, 0x9Du, 0x27u, 0x4Eu, 0x9Cu,
+   0x25u, 0x4Au, 0x94u, 0x35u, 0x6Au, 0xD4u, 0xB5u, 0x77u, 0xEEu, 0xC1u, 0x9Fu, 0x23u,
+   0x46u, 0x8Cu, 0x05u, 0x0Au, 0x14u, 0x28u, 0x50u, 0xA0u, 0x5Du, 0xBAu, 0x69u, 0xD2u,
+   0xB9u, 0x6Fu, 0xDEu, 0xA1u, 0x5Fu, 0xBEu, 0x61u, 0xC2u, 0x99u, 0x2Fu, 0x5Eu, 0xBCu,
+   0x65u, 0xCAu, 0x89u, 0x0Fu, 0x1Eu, 0x3Cu, 0x78u, 0xF0u, 0xFDu, 0xE7u, 0xD3u, 0xBBu,
+   0x6Bu, 0xD6u, 0xB1u, 0x7Fu, 0xFEu, 0xE1u, 0xDFu, 0xA3u, 0x5Bu, 0xB6u, 0x71u, 0xE2u,
+   0xD9u, 0xAFu, 0x43u, 0x86u, 0x11u, 0x22u, 0x44u, 0x88u, 0x0Du, 0x1Au, 0x34u, 0x68u,
+   0xD0u, 0xBDu, 0x67u, 0xCEu, 0x81u, 0x1Fu, 0x3Eu, 0x7Cu, 0xF8u, 0xEDu, 0xC7u, 0x93u,
+   0x3Bu, 0x76u, 0xECu, 0xC5u, 0x97u, 0x33u, 0x66u, 0xCCu, 0x85u, 0x17u, 0x2Eu, 0x5Cu,
+   0xB8u, 0x6Du, 0xDAu, 0xA9u, 0x4Fu, 0x9Eu, 0x21u, 0x42u, 0x84u, 0x15u, 0x2Au, 0x54u,
+   0xA8u, 0x4Du, 0x9Au, 0x29u, 0x52u, 0xA4u, 0x55u, 0xAAu, 0x49u, 0x92u, 0x39u, 0x72u,
+   0xE4u, 0xD5u, 0xB7u, 0x73u, 0xE6u, 0xD1u, 0xBFu, 0x63u, 0xC6u, 0x91u, 0x3Fu, 0x7Eu,
+   0xFCu, 0xE5u, 0xD7u, 0xB3u, 0x7Bu, 0xF6u, 0xF1u, 0xFFu, 0xE3u, 0xDBu, 0xABu, 0x4Bu,
+   0x96u, 0x31u, 0x62u, 0xC4u, 0x95u, 0x37u, 0x6Eu, 0xDCu, 0xA5u, 0x57u, 0xAEu, 0x41u,
+   0x82u, 0x19u, 0x32u, 0x64u, 0xC8u, 0x8Du, 0x07u, 0x0Eu, 0x1Cu, 0x38u, 0x70u, 0xE0u,
+   0xDDu, 0xA7u, 0x53u, 0xA6u, 0x51u, 0xA2u, 0x59u, 0xB2u, 0x79u, 0xF2u, 0xF9u, 0xEFu,
+   0xC3u, 0x9Bu, 0x2Bu, 0x56u, 0xACu, 0x45u, 0x8Au, 0x09u, 0x12u, 0x24u, 0x48u, 0x90u,
+   0x3Du, 0x7Au, 0xF4u, 0xF5u, 0xF7u, 0xF3u, 0xFBu, 0xEBu, 0xCBu, 0x8Bu, 0x0Bu, 0x16u,
+   0x2Cu, 0x58u, 0xB0u, 0x7Du, 0xFAu, 0xE9u, 0xCFu, 0x83u, 0x1Bu, 0x36u, 0x6Cu, 0xD8u,
+   0xADu, 0x47u, 0x8Eu, 0x01u, 0x02u, 0x04u, 0x08u, 0x10u, 0x20u, 0x40u, 0x80u, 0x1Du,
+   0x3Au, 0x74u, 0xE8u, 0xCDu, 0x87u, 0x13u, 0x26u, 0x4Cu, 0x98u, 0x2Du, 0x5Au, 0xB4u,
+   0x75u, 0xEAu, 0xC9u, 0x8Fu, 0x03u, 0x06u, 0x0Cu, 0x18u, 0x30u, 0x60u, 0xC0u, 0x9Du,
+   0x27u, 0x4Eu, 0x9Cu, 0x25u, 0x4Au, 0x94u, 0x35u, 0x6Au, 0xD4u, 0xB5u, 0x77u, 0xEEu,
+   0xC1u, 0x9Fu, 0x23u, 0x46u, 0x8Cu, 0x05u, 0x0Au, 0x14u, 0x28u, 0x50u, 0xA0u, 0x5Du,
+   0xBAu, 0x69u, 0xD2u, 0xB9u, 0x6Fu, 0xDEu, 0xA1u, 0x5Fu, 0xBEu, 0x61u, 0xC2u, 0x99u,
+   0x2Fu, 0x5Eu, 0xBCu, 0x65u, 0xCAu, 0x89u, 0x0Fu, 0x1Eu, 0x3Cu, 0x78u, 0xF0u, 0xFDu,
+   0xE7u, 0xD3u, 0xBBu, 0x6Bu, 0xD6u, 0xB1u, 0x7Fu, 0xFEu, 0xE1u, 0xDFu, 0xA3u, 0x5Bu,
+   0xB6u, 0x71u, 0xE2u, 0xD9u, 0xAFu, 0x43u, 0x86u, 0x11u, 0x22u, 0x44u, 0x88u, 0x0Du,
+   0x1Au, 0x34u, 0x68u, 0xD0u, 0xBDu, 0x67u, 0xCEu, 0x81u, 0x1Fu, 0x3Eu, 0x7Cu, 0xF8u,
+   0xEDu, 0xC7u, 0x93u, 0x3Bu, 0x76u, 0xECu, 0xC5u, 0x97u, 0x33u, 0x66u, 0xCCu, 0x85u,
+   0x17u, 0x2Eu, 0x5Cu, 0xB8u, 0x6Du, 0xDAu, 0xA9u, 0x4Fu, 0x9Eu, 0x21u, 0x42u, 0x84u,
+   0x15u, 0x2Au, 0x54u, 0xA8u, 0x4Du, 0x9Au, 0x29u, 0x52u, 0xA4u, 0x55u, 0xAAu, 0x49u,
+   0x92u, 0x39u, 0x72u, 0xE4u, 0xD5u, 0xB7u, 0x73u, 0xE6u, 0xD1u, 0xBFu, 0x63u, 0xC6u,
+   0x91u, 0x3Fu, 0x7Eu, 0xFCu, 0xE5u, 0xD7u, 0xB3u, 0x7Bu, 0xF6u, 0xF1u, 0xFFu, 0xE3u,
+   0xDBu, 0xABu, 0x4Bu, 0x96u, 0x31u, 0x62u, 0xC4u, 0x95u, 0x37u, 0x6Eu, 0xDCu, 0xA5u,
+   0x57u, 0xAEu, 0x41u, 0x82u, 0x19u, 0x32u, 0x64u, 0xC8u, 0x8Du, 0x07u, 0x0Eu, 0x1Cu,
+   0x38u, 0x70u, 0xE0u, 0xDDu, 0xA7u, 0x53u, 0xA6u, 0x51u, 0xA2u, 0x59u, 0xB2u, 0x79u,
+   0xF2u, 0xF9u, 0xEFu, 0xC3u, 0x9Bu, 0x2Bu, 0x56u, 0xACu, 0x45u, 0x8Au, 0x09u, 0x12u,
+   0x24u, 0x48u, 0x90u, 0x3Du, 0x7Au, 0xF4u, 0xF5u, 0xF7u, 0xF3u, 0xFBu, 0xEBu, 0xCBu,
+   0x8Bu, 0x0Bu, 0x16u, 0x2Cu, 0x58u, 0xB0u, 0x7Du, 0xFAu, 0xE9u, 0xCFu, 0x83u, 0x1Bu,
+   0x36u, 0x6Cu, 0xD8u, 0xADu, 0x47u, 0x8Eu, 0x01u, 0x02u,
+};
+
+/** Logarithms in base 2, the one of 0 is not used */
+static const uint8_t UPDT_fecLog[256] =
+{
+   0x00u, 0x00u, 0x01u, 0x19u, 0x02u, 0x32u, 0x1Au, 0xC6u, 0x03u, 0xDFu, 0x33u, 0xEEu,
+   0x1Bu, 0x68u, 0xC7u, 0x4Bu, 0x04u, 0x64u, 0xE0u, 0x0Eu, 0x34u, 0x8Du, 0xEFu, 0x81u,
+   0x1Cu, 0xC1u, 0x69u, 0xF8u, 0xC8u, 0x08u, 0x4Cu, 0x71u, 0x05u, 0x8Au, 0x65u, 0x2Fu,
+   0xE1u, 0x24u, 0x0Fu, 0x21u, 0x35u, 0x93u, 0x8Eu, 0xDAu, 0xF0u, 0x12u, 0x82u, 0x45u,
+   0x1Du, 0xB5u, 0xC2u, 0x7Du, 0x6Au, 0x27u, 0xF9u, 0xB9u, 0xC9u, 0x9Au, 0x09u, 0x78u,
+   0x4Du, 0xE4u, 0x72u, 0xA6u, 0x06u, 0xBFu, 0x8Bu, 0x62u, 0x66u, 0xDDu, 0x30u, 0xFDu,
+   0xE2u, 0x98u, 0x25u, 0xB3u, 0x10u, 0x91u, 0x22u, 0x88u, 0x36u, 0xD0u, 0x94u, 0xCEu,
+   0x8Fu, 0x96u, 0xDBu, 0xBDu, 0xF1u, 0xD2u, 0x13u, 0x5Cu, 0x83u, 0x38u, 0x46u, 0x40u,
+   0x1Eu, 0x42u, 0xB6u, 0xA3u, 0xC3u, 0x48u, 0x7Eu, 0x6Eu, 0x6Bu, 0x3Au, 0x28u, 0x54u,
+   0xFAu, 0x85u, 0xBAu, 0x3Du, 0xCAu, 0x5Eu, 0x9Bu, 0x9Fu, 0x0Au, 0x15u, 0x79u, 0x2Bu,
+   0x4Eu, 0xD4u, 0xE5u, 0xACu, 0x73u, 0xF3u, 0xA7u, 0x57u, 0x07u, 0x70u, 0xC0u, 0xF7u,
+   0x8Cu, 0x80u, 0x63u, 0x0Du, 0x67u, 0x4Au, 0xDEu, 0xEDu, 0x31u, 0xC5u, 0xFEu, 0x18u,
+   0xE3u, 0xA5u, 0x99u, 0x77u, 0x26u, 0xB8u, 0xB4u, 0x7Cu, 0x11u, 0x44u, 0x92u, 0xD9u,
+   0x23u, 0x20u, 0x89u, 0x2Eu, 0x37u, 0x3Fu, 0xD1u, 0x5Bu, 0x95u, 0xBCu, 0xCFu, 0xCDu,
+   0x90u, 0x87u, 0x97u, 0xB2u, 0xDCu, 0xFCu, 0xBEu, 0x61u, 0xF2u, 0x56u, 0xD3u, 0xABu,
+   0x14u, 0x2Au, 0x5Du, 0x9Eu, 0x84u, 0x3Cu, 0x39u, 0x53u, 0x47u, 0x6Du, 0x41u, 0xA2u,
+   0x1Fu, 0x2Du, 0x43u, 0xD8u, 0xB7u, 0x7Bu, 0xA4u, 0x76u, 0xC4u, 0x17u, 0x49u, 0xECu,
+   0x7Fu, 0x0Cu, 0x6Fu, 0xF6u, 0x6Cu, 0xA1u, 0x3Bu, 0x52u, 0x29u, 0x9Du, 0x55u, 0xAAu,
+   0xFBu, 0x60u, 0x86u, 0xB1u, 0xBBu, 0xCCu, 0x3Eu, 0x5Au, 0xCBu, 0x59u, 0x5Fu, 0xB0u,
+   0x9Cu, 0xA9u, 0xA0u, 0x51u, 0x0Bu, 0xF5u, 0x16u, 0xEBu, 0x7Au, 0x75u, 0x2Cu, 0xD7u,
+   0x4Fu, 0xAEu, 0xD5u, 0xE9u, 0xE6u, 0xE7u, 0xADu, 0xE8u, 0x74u, 0xD6u, 0xF4u, 0xEAu,
+   0xA8u, 0x50u, 0x58u, 0xAFu,
+};
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Multiplies two elements of GF(2^8). */
+static uint8_t UPDT_fecMul(uint8_t a, uint8_t b)
+{
+   if(0 == a || 0 == b)
+   {
+      return 0;
+   }
+   return UPDT_fecExp[UPDT_fecLog[a] + UPDT_fecLog[b]];
+}
+
+/** \brief Returns the inverse of a non-zero element of GF(2^8). */
+static uint8_t UPDT_fecInverse(uint8_t a)
+{
+   ciaaPOSIX_assert(0 != a);
+
+   return UPDT_fecExp[255 - UPDT_fecLog[a]];
+}
+
+/** \brief Returns the coefficient of data block i in parity block j.
+ **
+ ** The Cauchy matrix 1 / (x_j + y_i), with x_j = j and
+ ** y_i = UPDT_FEC_PARITY_MAX + i, its columns divided by their first
+ ** element so that the first row is all ones.
+ **/
+static uint8_t UPDT_fecCoefficient(uint8_t j, uint8_t i)
+{
+   uint8_t y = UPDT_FEC_PARITY_MAX + i;
+
+   return UPDT_fecExp[UPDT_fecLog[y] + 255 - UPDT_fecLog[j ^ y]];
+}
+
+/** \brief Adds a block multiplied by a coefficient to another block. */
+static void UPDT_fecMulAdd(uint8_t *dst, const uint8_t *src, uint8_t coefficient, size_t size)
+{
+   uint8_t products[256];
+   size_t i;
+
+   if(1 == coefficient)
+   {
+      for(i = 0; i < size; i++)
+      {
+         dst[i] ^= src[i];
+      }
+      return;
+   }
+   products[0] = 0;
+   for(i = 1; i < 256; i++)
+   {
+      products[i] = UPDT_fecExp[UPDT_fecLog[i] + UPDT_fecLog[coefficient]];
+   }
+   for(i = 0; i < size; i++)
+   {
+      dst[i] ^= products[src[i]];
+   }
+}
+
+/** \brief Inverts in place a square matrix of GF(2^8) by Gauss-Jordan
+ ** elimination.
+ **
+ ** \return 0 on success, -1 if the matrix is singular.
+ **/
+static int32_t UPDT_fecInvert(uint8_t matrix[][UPDT_FEC_PARITY_MAX], uint8_t size)
+{
+   uint8_t inverse[UPDT_FEC_PARITY_MAX][UPDT_FEC_PARITY_MAX] = {{0}};
+   uint8_t swap;
+   uint8_t factor;
+   uint8_t row;
+   uint8_t pivot;
+   uint8_t k;
+   uint8_t col;
+
+   for(row = 0; row < size; row++)
+   {
+      inverse[row][row] = 1;
+   }
+   for(col = 0; col < size; col++)
+   {
+      for(pivot = col; pivot < size && 0 == matrix[pivot][col]; pivot++)
+      {
+      }
+      if(pivot == size)
+      {
+         return -1;
+      }
+      for(k = 0; k < size; k++)
+      {
+         swap = matrix[col][k];
+         matrix[col][k] = matrix[pivot][k];
+         matrix[pivot][k] = swap;
+         swap = inverse[col][k];
+         inverse[col][k] = inverse[pivot][k];
+         inverse[pivot][k] = swap;
+      }
+      factor = UPDT_fecInverse(matrix[col][col]);
+      for(k = 0; k < size; k++)
+      {
+         matrix[col][k] = UPDT_fecMul(matrix[col][k], factor);
+         inverse[col][k] = UPDT_fecMul(inverse[col][k], factor);
+      }
+      for(row = 0; row < size; row++)
+      {
+         factor = matrix[row][col];
+         if(row == col || 0 == factor)
+         {
+            continue;
+         }
+         for(k = 0; k < size; k++)
+         {
+            matrix[row][k] ^= UPDT_fecMul(matrix[col][k], factor);
+            inverse[row][k] ^= UPDT_fecMul(inverse[col][k], factor);
+         }
+      }
+   }
+   ciaaPOSIX_memcpy(matrix, inverse, sizeof(inverse));
+   return 0;
+}
+
+/*==================[external functions definition]==========================*/
+int32_t UPDT_fecInit(
+   UPDT_fecType *fec,
+   uint8_t *buffer,
+   size_t size,
+   uint8_t data,
+   uint8_t parity,
+   uint16_t block_size)
+{
+   ciaaPOSIX_assert(NULL != fec);
+
+   if(0 == data || data > UPDT_FEC_DATA_MAX || 0 == parity || parity > UPDT_FEC_PARITY_MAX ||
+      0 == block_size || NULL == buffer || size < UPDT_FEC_BUFFER_SIZE(data, parity, block_size))
+   {
+      return -1;
+   }
+   fec->blocks = buffer;
+   fec->block_size = block_size;
+   fec->data = data;
+   fec->parity = parity;
+   UPDT_fecReset(fec);
+   return 0;
+}
+
+void UPDT_fecReset(UPDT_fecType *fec)
+{
+   ciaaPOSIX_assert(NULL != fec);
+
+   fec->present = 0;
+   ciaaPOSIX_memset(UPDT_fecBlock(fec, fec->data), 0, (size_t) fec->parity * fec->block_size);
+}
+
+uint8_t *UPDT_fecBlock(UPDT_fecType *fec, uint8_t index)
+{
+   ciaaPOSIX_assert(NULL != fec);
+   ciaaPOSIX_assert(index < fec->data + fec->parity);
+
+   return fec->blocks + (size_t) index * fec->block_size;
+}
+
+void UPDT_fecEncode(
+   UPDT_fecType *fec,
+   uint8_t index,
+   size_t offset,
+   const uint8_t *data,
+   size_t size)
+{
+   uint8_t j;
+
+   ciaaPOSIX_assert(NULL != fec);
+   ciaaPOSIX_assert(index < fec->data);
+   ciaaPOSIX_assert(NULL != data || 0 == size);
+   ciaaPOSIX_assert(offset + size <= fec->block_size);
+
+   for(j = 0; j < fec->parity; j++)
+   {
+      UPDT_fecMulAdd(UPDT_fecBlock(fec, fec->data + j) + offset, data,
+         UPDT_fecCoefficient(j, index), size);
+   }
+   fec->present |= (uint32_t) 1 << index;
+}
+
+void UPDT_fecAdd(UPDT_fecType *fec, uint8_t index, size_t size)
+{
+   ciaaPOSIX_assert(NULL != fec);
+   ciaaPOSIX_assert(size <= fec->block_size);
+
+   ciaaPOSIX_memset(UPDT_fecBlock(fec, index) + size, 0, fec->block_size - size);
+   fec->present |= (uint32_t) 1 << index;
+}
+
+uint8_t UPDT_fecIsPresent(const UPDT_fecType *fec, uint8_t index)
+{
+   ciaaPOSIX_assert(NULL != fec);
+
+   return index < fec->data + fec->parity && 0 != (fec->present & ((uint32_t) 1 << index));
+}
+
+uint8_t UPDT_fecMissing(const UPDT_fecType *fec, uint8_t count)
+{
+   uint8_t missing = 0;
+   uint8_t i;
+
+   ciaaPOSIX_assert(NULL != fec);
+   ciaaPOSIX_assert(count <= fec->data);
+
+   for(i = 0; i < count; i++)
+   {
+      missing += !UPDT_fecIsPresent(fec, i);
+   }
+   return missing;
+}
+
+uint8_t UPDT_fecParity(const UPDT_fecType *fec)
+{
+   uint8_t present = 0;
+   uint8_t j;
+
+   ciaaPOSIX_assert(NULL != fec);
+
+   for(j = 0; j < fec->parity; j++)
+   {
+      present += UPDT_fecIsPresent(fec, fec->data + j);
+   }
+   return present;
+}
+
+int32_t UPDT_fecDecode(UPDT_fecType *fec, uint8_t count)
+{
+   uint8_t matrix[UPDT_FEC_PARITY_MAX][UPDT_FEC_PARITY_MAX];
+   /* missing data blocks and parity blocks used to rebuild them */
+   uint8_t missing[UPDT_FEC_PARITY_MAX];
+   uint8_t rows[UPDT_FEC_PARITY_MAX];
+   uint8_t size = 0;
+   uint8_t used = 0;
+   uint8_t *block;
+   uint8_t i;
+   uint8_t j;
+   uint8_t k;
+
+   ciaaPOSIX_assert(NULL != fec);
+   ciaaPOSIX_assert(count <= fec->data);
+
+   for(i = 0; i < count; i++)
+   {
+      if(!UPDT_fecIsPresent(fec, i))
+      {
+         if(size == UPDT_FEC_PARITY_MAX)
+         {
+            return -1;
+         }
+         missing[size++] = i;
+      }
+   }
+   for(j = 0; j < fec->parity && used < size; j++)
+   {
+      if(UPDT_fecIsPresent(fec, fec->data + j))
+      {
+         rows[used++] = j;
+      }
+   }
+   if(used < size)
+   {
+      return -1;
+   }
+   if(0 == size)
+   {
+      return 0;
+   }
+
+   /* what is left of the parity blocks once the data blocks present are
+    * removed is the sum of the missing ones */
+   for(k = 0; k < size; k++)
+   {
+      block = UPDT_fecBlock(fec, fec->data + rows[k]);
+      for(i = 0; i < count; i++)
+      {
+         if(UPDT_fecIsPresent(fec, i))
+         {
+            UPDT_fecMulAdd(block, UPDT_fecBlock(fec, i), UPDT_fecCoefficient(rows[k], i),
+               fec->block_size);
+         }
+      }
+      for(i = 0; i < size; i++)
+      {
+         matrix[k][i] = UPDT_fecCoefficient(rows[k], missing[i]);
+      }
+   }
+   /* every square submatrix of a Cauchy matrix can be inverted */
+   if(0 != UPDT_fecInvert(matrix, size))
+   {
+      return -1;
+   }
+   for(i = 0; i < size; i++)
+   {
+      block = UPDT_fecBlock(fec, missing[i]);
+      ciaaPOSIX_memset(block, 0, fec->block_size);
+      for(k = 0; k < size; k++)
+      {
+         UPDT_fecMulAdd(block, UPDT_fecBlock(fec, fec->data + rows[k]), matrix[i][k],
+            fec->block_size);
+      }
+   }
+   for(i = 0; i < size; i++)
+   {
+      fec->present |= (uint32_t) 1 << missing[i];
+   }
+   for(k = 0; k < size; k++)
+   {
+      fec->present &= ~((uint32_t) 1 << (fec->data + rows[k]));
+   }
+   return 0;
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
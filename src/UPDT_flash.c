@@ -0,0 +1,566 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the Flash Update Flash Sink
+ **
+ ** Double buffered flash writer. The pages are erased and programmed by a
+ ** worker task while the next one fills.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Flash
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.7  AG  report the flash operations made
+ * 20261017 v0.0.6  AG  report the operations saved in the session statistics
+ * 20261017 v0.0.5  AG  compare the installed data byte by byte
+ * 20261017 v0.0.4  AG  stage the payload of a frame until it is committed
+ * 20261017 v0.0.3  AG  add trace points
+ * 20261017 v0.0.2  AG  add erase planning and unchanged pages skipping
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_assert.h"
+#include "ciaaPOSIX_string.h"
+#include "UPDT_flash.h"
+#include "UPDT_trace.h"
+
+/*==================[macros and definitions]=================================*/
+/** size of the stack buffer used to read the installed data */
+#define UPDT_FLASH_COMPARE_SIZE          32
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Erases a sector. Worker side. */
+static int32_t UPDT_flashSinkErase(UPDT_flashSinkType *sink, uint32_t address)
+{
+   UPDT_IFlashType *flash = sink->flash;
+   int32_t ret;
+
+   UPDT_TRACE_BEGIN(UPDT_TRACE_EVENT_FLASH_ERASE, address);
+   ret = flash->erase(flash, address, flash->sector_size);
+   UPDT_TRACE_END(UPDT_TRACE_EVENT_FLASH_ERASE, address);
+   if(0 != ret)
+   {
+      sink->error = UPDT_PROTOCOL_ERROR_FLASH;
+      return sink->error;
+   }
+   sink->stats.erases++;
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Programs a range inside a page. Worker side. */
+static int32_t UPDT_flashSinkProgram(
+   UPDT_flashSinkType *sink,
+   uint32_t address,
+   const uint8_t *data,
+   size_t size)
+{
+   UPDT_IFlashType *flash = sink->flash;
+   int32_t ret;
+
+   UPDT_TRACE_BEGIN(UPDT_TRACE_EVENT_FLASH_PROGRAM, address);
+   ret = flash->program(flash, address, data, size);
+   UPDT_TRACE_END(UPDT_TRACE_EVENT_FLASH_PROGRAM, size);
+   if(0 != ret)
+   {
+      sink->error = UPDT_PROTOCOL_ERROR_FLASH;
+      return sink->error;
+   }
+   sink->stats.programs++;
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Returns non-zero if the flash holds the data already. Worker side. */
+static uint8_t UPDT_flashSinkSame(
+   UPDT_flashSinkType *sink,
+   uint32_t address,
+   const uint8_t *data,
+   size_t size)
+{
+   UPDT_IFlashType *flash = sink->flash;
+   uint8_t installed[UPDT_FLASH_COMPARE_SIZE];
+   size_t offset;
+   size_t piece;
+   size_t i;
+
+   for(offset = 0; offset < size; offset += piece)
+   {
+      piece = size - offset < sizeof(installed) ? size - offset : sizeof(installed);
+      if(0 != flash->read(flash, address + offset, installed, piece))
+      {
+         return 0;
+      }
+      /* byte by byte, a checksum could match different data */
+      for(i = 0; i < piece; i++)
+      {
+         if(installed[i] != data[offset + i])
+         {
+            return 0;
+         }
+      }
+   }
+   return 1;
+}
+
+/** \brief Accounts the sector being verified as unchanged. Worker side. */
+static void UPDT_flashSinkKeep(UPDT_flashSinkType *sink)
+{
+   sink->stats.erases_saved++;
+   sink->stats.programs_saved += sink->skipped;
+   sink->skipped = 0;
+   sink->erased += sink->flash->sector_size;
+}
+
+/** \brief Erases the sector being verified, keeping its data up to address.
+ ** Worker side. */
+static int32_t UPDT_flashSinkRewrite(UPDT_flashSinkType *sink, uint32_t address)
+{
+   UPDT_IFlashType *flash = sink->flash;
+   uint32_t sector = sink->erased;
+   size_t size = address - sector;
+   size_t offset;
+   size_t piece;
+
+   if(0 < size && 0 != flash->read(flash, sector, sink->scratch, size))
+   {
+      sink->error = UPDT_PROTOCOL_ERROR_FLASH;
+      return sink->error;
+   }
+   if(UPDT_PROTOCOL_ERROR_NONE != UPDT_flashSinkErase(sink, sector))
+   {
+      return sink->error;
+   }
+   for(offset = 0; offset < size; offset += piece)
+   {
+      piece = flash->page_size - (offset & (flash->page_size - 1));
+      if(piece > size - offset)
+      {
+         piece = size - offset;
+      }
+      if(UPDT_PROTOCOL_ERROR_NONE != UPDT_flashSinkProgram(sink, sector + offset,
+         sink->scratch + offset, piece))
+      {
+         return sink->error;
+      }
+   }
+   sink->skipped = 0;
+   sink->erased = sector + flash->sector_size;
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Erases the sectors a job needs and programs it. Worker side. */
+static void UPDT_flashSinkRun(UPDT_flashSinkType *sink, const UPDT_flashJobType *job)
+{
+   UPDT_IFlashType *flash = sink->flash;
+   const uint8_t *data = sink->buffers + job->buffer * flash->page_size + job->start;
+   uint32_t end = job->address + job->size;
+   uint32_t sector = job->address & ~(flash->sector_size - 1);
+
+   if(UPDT_PROTOCOL_ERROR_NONE != sink->error)
+   {
+      return;
+   }
+   if(NULL != sink->scratch && sink->erased <= sector)
+   {
+      /* every sector before this one was left unchanged */
+      while(sink->erased < sector)
+      {
+         UPDT_flashSinkKeep(sink);
+      }
+      if(UPDT_flashSinkSame(sink, job->address, data, job->size))
+      {
+         sink->skipped++;
+         sink->durable = end - sink->base;
+         return;
+      }
+      if(UPDT_PROTOCOL_ERROR_NONE != UPDT_flashSinkRewrite(sink, job->address))
+      {
+         return;
+      }
+   }
+   while(sink->erased < end)
+   {
+      if(UPDT_PROTOCOL_ERROR_NONE != UPDT_flashSinkErase(sink, sink->erased))
+      {
+         return;
+      }
+      sink->erased += flash->sector_size;
+   }
+   if(UPDT_PROTOCOL_ERROR_NONE != UPDT_flashSinkProgram(sink, job->address, data, job->size))
+   {
+      return;
+   }
+   sink->durable = end - sink->base;
+}
+
+/** \brief Waits until at least count jobs are done. Producer side. */
+static int32_t UPDT_flashSinkWait(UPDT_flashSinkType *sink, uint32_t count)
+{
+   if(sink->threaded)
+   {
+      /* cleared before testing, so a job done meanwhile is not missed */
+      ClearEvent(sink->done_event);
+      while((int32_t) (sink->done - count) < 0)
+      {
+         WaitEvent(sink->done_event);
+         ClearEvent(sink->done_event);
+      }
+   }
+   return sink->error;
+}
+
+/** \brief Queues the unqueued bytes of the current buffer. Producer side. */
+static void UPDT_flashSinkQueue(UPDT_flashSinkType *sink)
+{
+   UPDT_flashJobType *job = &sink->jobs[sink->queued % UPDT_FLASH_JOBS_MAX];
+
+   job->address = sink->address + sink->start;
+   job->start = sink->start;
+   job->size = sink->fill - sink->start;
+   job->buffer = sink->current;
+   sink->start = sink->fill;
+   sink->release[sink->current] = sink->queued + 1;
+
+   if(sink->threaded)
+   {
+      /* the job is complete before the worker can see it */
+      sink->queued++;
+      SetEvent(sink->worker, sink->work_event);
+   }
+   else
+   {
+      UPDT_flashSinkRun(sink, job);
+      sink->queued++;
+      sink->done++;
+   }
+}
+
+/*==================[external functions definition]==========================*/
+void UPDT_flashSinkInit(
+   UPDT_flashSinkType *sink,
+   UPDT_IFlashType *flash,
+   uint8_t *buffers,
+   uint8_t count,
+   uint32_t base)
+{
+   ciaaPOSIX_assert(NULL != sink);
+   ciaaPOSIX_assert(NULL != flash);
+   ciaaPOSIX_assert(NULL != buffers);
+   ciaaPOSIX_assert(0 < count && count <= UPDT_FLASH_BUFFERS_MAX);
+   ciaaPOSIX_assert(0 == (base & (flash->sector_size - 1)));
+
+   sink->flash = flash;
+   sink->buffers = buffers;
+   sink->count = count;
+   sink->base = base;
+   sink->current = 0;
+   sink->start = 0;
+   sink->fill = 0;
+   sink->address = base;
+   sink->written = 0;
+   sink->staged = 0;
+   ciaaPOSIX_memset(sink->release, 0, sizeof(sink->release));
+   sink->queued = 0;
+   sink->done = 0;
+   sink->durable = 0;
+   sink->erased = base;
+   sink->end = 0;
+   sink->scratch = NULL;
+   sink->skipped = 0;
+   ciaaPOSIX_memset(&sink->stats, 0, sizeof(sink->stats));
+   sink->error = UPDT_PROTOCOL_ERROR_NONE;
+   sink->closing = 0;
+   sink->closed = 0;
+   sink->tag_first = 0;
+   sink->tag_count = 0;
+   sink->threaded = 0;
+}
+
+void UPDT_flashSinkSetWorker(
+   UPDT_flashSinkType *sink,
+   TaskType worker,
+   EventMaskType work_event,
+   TaskType owner,
+   EventMaskType done_event)
+{
+   ciaaPOSIX_assert(NULL != sink);
+   ciaaPOSIX_assert(sink->queued == sink->done);
+
+   sink->worker = worker;
+   sink->work_event = work_event;
+   sink->owner = owner;
+   sink->done_event = done_event;
+   sink->threaded = 1;
+}
+
+void UPDT_flashSinkPlan(UPDT_flashSinkType *sink, uint32_t size)
+{
+   ciaaPOSIX_assert(NULL != sink);
+
+   sink->end = sink->base + size;
+   if(sink->threaded)
+   {
+      SetEvent(sink->worker, sink->work_event);
+   }
+}
+
+void UPDT_flashSinkSetSkip(UPDT_flashSinkType *sink, uint8_t *scratch)
+{
+   ciaaPOSIX_assert(NULL != sink);
+   ciaaPOSIX_assert(NULL != sink->flash->read || NULL == scratch);
+   ciaaPOSIX_assert(0 == sink->queued);
+
+   sink->scratch = scratch;
+}
+
+int32_t UPDT_flashSinkConsume(
+   void *context,
+   size_t offset,
+   const uint8_t *data,
+   size_t size)
+{
+   UPDT_flashSinkType *sink = (UPDT_flashSinkType *) context;
+   size_t page_size;
+   size_t position;
+   size_t chunk;
+   size_t page;
+   uint8_t buffer;
+   int32_t ret;
+
+   ciaaPOSIX_assert(NULL != sink);
+   ciaaPOSIX_assert(NULL != data || 0 == size);
+
+   page_size = sink->flash->page_size;
+   /* a payload received again starts at offset 0 and replaces the staged one */
+   position = sink->fill + offset;
+   sink->staged = offset + size;
+   while(0 < size)
+   {
+      page = position / page_size;
+      /* the committed part of the current buffer is never overwritten */
+      ciaaPOSIX_assert(page < sink->count);
+      buffer = (sink->current + page) % sink->count;
+      if(0 < page && 0 == position % page_size)
+      {
+         /* the next buffer may still be programmed */
+         ret = UPDT_flashSinkWait(sink, sink->release[buffer]);
+         if(UPDT_PROTOCOL_ERROR_NONE != ret)
+         {
+            return ret;
+         }
+      }
+      chunk = page_size - position % page_size;
+      if(chunk > size)
+      {
+         chunk = size;
+      }
+      ciaaPOSIX_memcpy(sink->buffers + buffer * page_size + position % page_size, data, chunk);
+      position += chunk;
+      data += chunk;
+      size -= chunk;
+   }
+   return sink->error;
+}
+
+int32_t UPDT_flashSinkCommit(UPDT_flashSinkType *sink, uint8_t tag)
+{
+   UPDT_flashTagType *entry;
+   size_t page_size;
+   uint32_t fill;
+   int32_t ret;
+
+   ciaaPOSIX_assert(NULL != sink);
+
+   page_size = sink->flash->page_size;
+   fill = sink->fill + sink->staged;
+   sink->written += sink->staged;
+   sink->staged = 0;
+   while(page_size <= fill)
+   {
+      sink->fill = page_size;
+      UPDT_flashSinkQueue(sink);
+      sink->current = (sink->current + 1) % sink->count;
+      sink->address += page_size;
+      sink->start = 0;
+      sink->fill = 0;
+      fill -= page_size;
+      /* with a single buffer it is the one just queued */
+      ret = UPDT_flashSinkWait(sink, sink->release[sink->current]);
+      if(UPDT_PROTOCOL_ERROR_NONE != ret)
+      {
+         return ret;
+      }
+   }
+   sink->fill = fill;
+
+   if(UPDT_FLASH_TAGS_MAX == sink->tag_count)
+   {
+      /* merged with the newest one, it is only acknowledged later */
+      entry = &sink->tags[(sink->tag_first + sink->tag_count - 1) % UPDT_FLASH_TAGS_MAX];
+   }
+   else
+   {
+      entry = &sink->tags[(sink->tag_first + sink->tag_count) % UPDT_FLASH_TAGS_MAX];
+      sink->tag_count++;
+   }
+   entry->end = sink->written;
+   entry->tag = tag;
+   return sink->error;
+}
+
+uint8_t UPDT_flashSinkDurable(UPDT_flashSinkType *sink, uint8_t *tag)
+{
+   uint32_t durable = sink->durable;
+   uint8_t found = 0;
+
+   ciaaPOSIX_assert(NULL != sink);
+   ciaaPOSIX_assert(NULL != tag);
+
+   while(0 < sink->tag_count && sink->tags[sink->tag_first].end <= durable)
+   {
+      *tag = sink->tags[sink->tag_first].tag;
+      sink->tag_first = (sink->tag_first + 1) % UPDT_FLASH_TAGS_MAX;
+      sink->tag_count--;
+      found = 1;
+   }
+   return found;
+}
+
+void UPDT_flashSinkGetStats(const UPDT_flashSinkType *sink, UPDT_protocolStatsType *stats)
+{
+   ciaaPOSIX_assert(NULL != sink);
+   ciaaPOSIX_assert(NULL != stats);
+
+   stats->erases = sink->stats.erases;
+   stats->programs = sink->stats.programs;
+   stats->erases_saved = sink->stats.erases_saved;
+   stats->programs_saved = sink->stats.programs_saved;
+}
+
+int32_t UPDT_flashSinkFlush(UPDT_flashSinkType *sink)
+{
+   ciaaPOSIX_assert(NULL != sink);
+
+   if(sink->fill > sink->start)
+   {
+      UPDT_flashSinkQueue(sink);
+   }
+   return UPDT_flashSinkWait(sink, sink->queued);
+}
+
+int32_t UPDT_flashSinkClose(UPDT_flashSinkType *sink)
+{
+   int32_t ret;
+
+   ciaaPOSIX_assert(NULL != sink);
+
+   ret = UPDT_flashSinkFlush(sink);
+   if(UPDT_PROTOCOL_ERROR_NONE == ret && NULL != sink->scratch &&
+      sink->erased < sink->base + sink->written)
+   {
+      /* the last sector was left unchanged, the worker is idle */
+      UPDT_flashSinkKeep(sink);
+   }
+   if(sink->threaded)
+   {
+      sink->closing = 1;
+      SetEvent(sink->worker, sink->work_event);
+      ClearEvent(sink->done_event);
+      while(!sink->closed)
+      {
+         WaitEvent(sink->done_event);
+         ClearEvent(sink->done_event);
+      }
+   }
+   return ret;
+}
+
+void UPDT_flashSinkWork(UPDT_flashSinkType *sink)
+{
+   ciaaPOSIX_assert(NULL != sink);
+
+   while(1)
+   {
+      ClearEvent(sink->work_event);
+      if(sink->done == sink->queued)
+      {
+         if(sink->closing)
+         {
+            sink->closed = 1;
+            SetEvent(sink->owner, sink->done_event);
+            return;
+         }
+         if(NULL == sink->scratch && sink->erased < sink->end &&
+            UPDT_PROTOCOL_ERROR_NONE == sink->error)
+         {
+            /* nothing to program, erases ahead of the write cursor */
+            if(UPDT_PROTOCOL_ERROR_NONE == UPDT_flashSinkErase(sink, sink->erased))
+            {
+               sink->erased += sink->flash->sector_size;
+            }
+            continue;
+         }
+         WaitEvent(sink->work_event);
+         continue;
+      }
+      UPDT_flashSinkRun(sink, &sink->jobs[sink->done % UPDT_FLASH_JOBS_MAX]);
+      sink->done++;
+      SetEvent(sink->owner, sink->done_event);
+   }
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
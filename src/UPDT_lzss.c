@@ -0,0 +1,305 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the Flash Update LZSS
+ **
+ ** Streaming LZSS decoder for compressed DAT payloads, and the matching
+ ** encoder. The decoder sits between the protocol and the flash writer, it
+ ** has a fixed window and allocates nothing.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update LZSS
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_assert.h"
+#include "UPDT_lzss.h"
+
+/*==================[macros and definitions]=================================*/
+/** mask of a position inside the window */
+#define UPDT_LZSS_WINDOW_MASK            (UPDT_LZSS_WINDOW_SIZE - 1)
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Gives the bytes produced since the last flush to the consumer. */
+static int32_t UPDT_lzssDecoderFlush(UPDT_lzssDecoderType *decoder)
+{
+   size_t size = decoder->position - decoder->flushed;
+   int32_t ret;
+
+   if(0 == size)
+   {
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   ret = decoder->consumer(decoder->context, decoder->output,
+      decoder->window + decoder->flushed, size);
+   decoder->output += size;
+   decoder->flushed = decoder->position;
+   return ret;
+}
+
+/** \brief Appends a byte to the window, flushing it when it wraps. */
+static int32_t UPDT_lzssDecoderPut(UPDT_lzssDecoderType *decoder, uint8_t byte)
+{
+   int32_t ret = UPDT_PROTOCOL_ERROR_NONE;
+
+   decoder->window[decoder->position++] = byte;
+   decoder->produced++;
+   if(UPDT_LZSS_WINDOW_SIZE == decoder->position)
+   {
+      ret = UPDT_lzssDecoderFlush(decoder);
+      decoder->position = 0;
+      decoder->flushed = 0;
+   }
+   return ret;
+}
+
+/** \brief Returns the length of the match between two positions. */
+static size_t UPDT_lzssMatchLength(const uint8_t *input, size_t size, size_t position, size_t distance)
+{
+   size_t length = 0;
+   size_t limit = size - position;
+
+   if(limit > UPDT_LZSS_MATCH_MAX)
+   {
+      limit = UPDT_LZSS_MATCH_MAX;
+   }
+   while(length < limit && input[position + length] == input[position + length - distance])
+   {
+      length++;
+   }
+   return length;
+}
+
+/*==================[external functions definition]==========================*/
+void UPDT_lzssDecoderInit(
+   UPDT_lzssDecoderType *decoder,
+   size_t size,
+   UPDT_protocolConsumerType consumer,
+   void *context)
+{
+   ciaaPOSIX_assert(NULL != decoder);
+   ciaaPOSIX_assert(NULL != consumer);
+
+   decoder->position = 0;
+   decoder->flushed = 0;
+   decoder->flags = 0;
+   decoder->flag_count = 0;
+   decoder->pending = 0;
+   decoder->has_pending = 0;
+   decoder->produced = 0;
+   decoder->output = 0;
+   decoder->size = size;
+   decoder->consumer = consumer;
+   decoder->context = context;
+}
+
+int32_t UPDT_lzssDecoderConsume(
+   void *context,
+   size_t offset,
+   const uint8_t *data,
+   size_t size)
+{
+   UPDT_lzssDecoderType *decoder = (UPDT_lzssDecoderType *) context;
+   const uint8_t *end = data + size;
+   uint16_t token;
+   size_t distance;
+   size_t length;
+   int32_t ret = UPDT_PROTOCOL_ERROR_NONE;
+
+   ciaaPOSIX_assert(NULL != decoder);
+   ciaaPOSIX_assert(NULL != data || 0 == size);
+   (void) offset;
+
+   while(data < end && decoder->produced < decoder->size &&
+      UPDT_PROTOCOL_ERROR_NONE == ret)
+   {
+      if(0 == decoder->flag_count)
+      {
+         decoder->flags = *data++;
+         decoder->flag_count = 8;
+         continue;
+      }
+      if(decoder->flags & 1)
+      {
+         ret = UPDT_lzssDecoderPut(decoder, *data++);
+      }
+      else if(!decoder->has_pending)
+      {
+         /* the second byte of the match may come in the next piece */
+         decoder->pending = *data++;
+         decoder->has_pending = 1;
+         continue;
+      }
+      else
+      {
+         token = ((uint16_t) decoder->pending << 8) | *data++;
+         decoder->has_pending = 0;
+         distance = (token >> UPDT_LZSS_LENGTH_BITS) + 1;
+         length = (token & ((1u << UPDT_LZSS_LENGTH_BITS) - 1)) + UPDT_LZSS_MATCH_MIN;
+         if(distance > decoder->produced)
+         {
+            return UPDT_PROTOCOL_ERROR_PACKET;
+         }
+         if(length > decoder->size - decoder->produced)
+         {
+            length = decoder->size - decoder->produced;
+         }
+         while(0 < length-- && UPDT_PROTOCOL_ERROR_NONE == ret)
+         {
+            ret = UPDT_lzssDecoderPut(decoder,
+               decoder->window[(decoder->position - distance) & UPDT_LZSS_WINDOW_MASK]);
+         }
+      }
+      decoder->flags >>= 1;
+      decoder->flag_count--;
+   }
+
+   if(UPDT_PROTOCOL_ERROR_NONE != ret)
+   {
+      return ret;
+   }
+   return UPDT_lzssDecoderFlush(decoder);
+}
+
+uint8_t UPDT_lzssDecoderDone(const UPDT_lzssDecoderType *decoder)
+{
+   ciaaPOSIX_assert(NULL != decoder);
+
+   return decoder->produced == decoder->size;
+}
+
+size_t UPDT_lzssEncode(
+   const uint8_t *input,
+   size_t size,
+   uint8_t *output,
+   size_t capacity)
+{
+   size_t position = 0;
+   size_t out = 0;
+   size_t flags_at = 0;
+   size_t distance;
+   size_t length;
+   size_t best_distance;
+   size_t best_length;
+   size_t farthest;
+   uint8_t items = 8;
+   uint16_t token;
+
+   ciaaPOSIX_assert(NULL != input || 0 == size);
+   ciaaPOSIX_assert(NULL != output || 0 == capacity);
+
+   while(position < size)
+   {
+      if(8 == items)
+      {
+         if(out >= capacity)
+         {
+            return 0;
+         }
+         flags_at = out++;
+         output[flags_at] = 0;
+         items = 0;
+      }
+
+      /* the nearest of the longest matches */
+      best_length = 0;
+      best_distance = 0;
+      farthest = position < UPDT_LZSS_WINDOW_SIZE ? position : UPDT_LZSS_WINDOW_SIZE;
+      for(distance = 1; distance <= farthest && best_length < UPDT_LZSS_MATCH_MAX; distance++)
+      {
+         if(input[position] != input[position - distance])
+         {
+            continue;
+         }
+         length = UPDT_lzssMatchLength(input, size, position, distance);
+         if(length > best_length)
+         {
+            best_length = length;
+            best_distance = distance;
+         }
+      }
+
+      if(best_length >= UPDT_LZSS_MATCH_MIN)
+      {
+         if(out + 2 > capacity)
+         {
+            return 0;
+         }
+         token = (uint16_t) (((best_distance - 1) << UPDT_LZSS_LENGTH_BITS) |
+            (best_length - UPDT_LZSS_MATCH_MIN));
+         output[out++] = (uint8_t) (token >> 8);
+         output[out++] = (uint8_t) token;
+         position += best_length;
+      }
+      else
+      {
+         if(out >= capacity)
+         {
+            return 0;
+         }
+         output[flags_at] |= (uint8_t) (1u << items);
+         output[out++] = input[position++];
+      }
+      items++;
+   }
+   return out;
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
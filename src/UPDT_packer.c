@@ -0,0 +1,681 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/** \brief This file implements the Flash Update Packer
+ **
+ ** Master side source of the DAT payloads. It reads raw, ELF, S-record and
+ ** Intel HEX images in place and gives the payloads of the address
+ ** contiguous stream the slave writes, the gaps filled.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Packer
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_assert.h"
+#include "ciaaPOSIX_string.h"
+#include "UPDT_packer.h"
+
+/*==================[macros and definitions]=================================*/
+/* kinds of text records */
+#define UPDT_PACKER_RECORD_DATA          0
+#define UPDT_PACKER_RECORD_ADDRESS       1
+#define UPDT_PACKER_RECORD_END           2
+#define UPDT_PACKER_RECORD_OTHER         3
+
+/** size of the ELF identification */
+#define UPDT_PACKER_ELF_IDENT_SIZE       16
+/** size of a 32 bit ELF header */
+#define UPDT_PACKER_ELF_HEADER_SIZE      52
+/** size of a 32 bit ELF program header */
+#define UPDT_PACKER_ELF_PHDR_SIZE        32
+/** ELF class of 32 bit files */
+#define UPDT_PACKER_ELF_CLASS32          1
+/** ELF data encoding of big endian files */
+#define UPDT_PACKER_ELF_DATA_MSB         2
+/** type of the loadable program segments */
+#define UPDT_PACKER_ELF_PT_LOAD          1
+
+/** \brief Text record. */
+typedef struct
+{
+   /** One of UPDT_PACKER_RECORD_xxx */
+   uint8_t kind;
+   /** Number of data bytes */
+   uint8_t size;
+   /** Data: its address, the 16 bit offset in Intel HEX. Address: the new
+    ** base address */
+   uint32_t address;
+   /** First data byte */
+   const uint8_t *data;
+   /** Text after the record */
+   const uint8_t *next;
+} UPDT_packerRecordType;
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Returns the value of a hexadecimal digit, 0xFF if it is not one. */
+static uint8_t UPDT_packerDigit(uint8_t c)
+{
+   if(c >= '0' && c <= '9')
+   {
+      return c - '0';
+   }
+   if(c >= 'A' && c <= 'F')
+   {
+      return c - 'A' + 10;
+   }
+   if(c >= 'a' && c <= 'f')
+   {
+      return c - 'a' + 10;
+   }
+   return 0xFFu;
+}
+
+/** \brief Returns the byte written by two hexadecimal digits, they must be
+ ** valid. */
+static uint8_t UPDT_packerByte(const uint8_t *text)
+{
+   return (uint8_t) ((UPDT_packerDigit(text[0]) << 4) | UPDT_packerDigit(text[1]));
+}
+
+/** \brief Reads count big endian bytes written in hexadecimal. */
+static uint32_t UPDT_packerBytes(const uint8_t *text, uint8_t count)
+{
+   uint32_t value = 0;
+
+   while(count-- > 0)
+   {
+      value = (value << 8) | UPDT_packerByte(text);
+      text += 2;
+   }
+   return value;
+}
+
+/** \brief Checks the hexadecimal digits of a record and adds its bytes.
+ **
+ ** \return The sum of the bytes in the lower 8 bits, -1 if a character is
+ ** not a digit.
+ **/
+static int32_t UPDT_packerSum(const uint8_t *text, size_t count)
+{
+   uint32_t sum = 0;
+
+   while(count-- > 0)
+   {
+      if(0xFFu == UPDT_packerDigit(text[0]) || 0xFFu == UPDT_packerDigit(text[1]))
+      {
+         return -1;
+      }
+      sum += UPDT_packerByte(text);
+      text += 2;
+   }
+   return (int32_t) (sum & 0xFFu);
+}
+
+/** \brief Parses the text record at text.
+ **
+ ** Blank characters before the record are skipped, the end of the image is
+ ** an end record.
+ **
+ ** \return UPDT_PROTOCOL_ERROR_NONE on success, UPDT_PROTOCOL_ERROR_PACKET if
+ ** the record is malformed, UPDT_PROTOCOL_ERROR_CRC if its checksum is
+ ** wrong.
+ **/
+static int32_t UPDT_packerParse(
+   uint8_t format,
+   const uint8_t *text,
+   const uint8_t *end,
+   UPDT_packerRecordType *record)
+{
+   uint8_t type;
+   uint8_t count;
+   uint8_t address_size;
+   int32_t sum;
+
+   while(text < end && (' ' == *text || '\t' == *text || '\r' == *text || '\n' == *text))
+   {
+      text++;
+   }
+   record->next = text;
+   if(text == end)
+   {
+      record->kind = UPDT_PACKER_RECORD_END;
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+
+   if(UPDT_PACKER_FORMAT_S19 == format)
+   {
+      /* Stccaaaa...dd...ss: the count covers the address, data and checksum,
+       * the checksum is the ones complement of the sum of the others */
+      if(end - text < 4 || 'S' != text[0] || 0xFFu == UPDT_packerDigit(text[1]) ||
+         0 > UPDT_packerSum(text + 2, 1))
+      {
+         return UPDT_PROTOCOL_ERROR_PACKET;
+      }
+      type = text[1] - '0';
+      count = UPDT_packerByte(text + 2);
+      address_size = (2 == type || 6 == type || 8 == type) ? 3 : (3 == type || 7 == type) ? 4 : 2;
+      if(4 == type || count < address_size + 1 || (size_t) (end - text) < 4 + 2 * (size_t) count)
+      {
+         return UPDT_PROTOCOL_ERROR_PACKET;
+      }
+      sum = UPDT_packerSum(text + 2, count + 1);
+      if(0 > sum)
+      {
+         return UPDT_PROTOCOL_ERROR_PACKET;
+      }
+      if(0xFF != sum)
+      {
+         return UPDT_PROTOCOL_ERROR_CRC;
+      }
+      record->kind = (1 <= type && type <= 3) ? UPDT_PACKER_RECORD_DATA :
+         (7 <= type) ? UPDT_PACKER_RECORD_END : UPDT_PACKER_RECORD_OTHER;
+      record->size = count - address_size - 1;
+      record->address = UPDT_packerBytes(text + 4, address_size);
+      record->data = text + 4 + 2 * address_size;
+      record->next = text + 4 + 2 * (size_t) count;
+   }
+   else
+   {
+      /* :ccaaaatt...dd...ss: the bytes add up to 0 */
+      if(end - text < 11 || ':' != text[0] || 0 > UPDT_packerSum(text + 1, 1))
+      {
+         return UPDT_PROTOCOL_ERROR_PACKET;
+      }
+      count = UPDT_packerByte(text + 1);
+      if((size_t) (end - text) < 11 + 2 * (size_t) count)
+      {
+         return UPDT_PROTOCOL_ERROR_PACKET;
+      }
+      sum = UPDT_packerSum(text + 1, count + 5);
+      if(0 > sum)
+      {
+         return UPDT_PROTOCOL_ERROR_PACKET;
+      }
+      if(0 != sum)
+      {
+         return UPDT_PROTOCOL_ERROR_CRC;
+      }
+      type = UPDT_packerByte(text + 7);
+      record->size = count;
+      record->address = UPDT_packerBytes(text + 3, 2);
+      record->data = text + 9;
+      record->next = text + 11 + 2 * (size_t) count;
+      switch(type)
+      {
+         case 0:
+            record->kind = UPDT_PACKER_RECORD_DATA;
+            break;
+         case 1:
+            record->kind = UPDT_PACKER_RECORD_END;
+            break;
+         case 2:
+         case 4:
+            if(2 != count)
+            {
+               return UPDT_PROTOCOL_ERROR_PACKET;
+            }
+            record->kind = UPDT_PACKER_RECORD_ADDRESS;
+            record->address = UPDT_packerBytes(record->data, 2) << (2 == type ? 4 : 16);
+            break;
+         default:
+            record->kind = UPDT_PACKER_RECORD_OTHER;
+            break;
+      }
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Adds a piece of the image, merging it with the last segment when
+ ** it follows it. */
+static int32_t UPDT_packerAdd(
+   UPDT_packerType *packer,
+   uint16_t segments_max,
+   uint32_t address,
+   uint32_t size,
+   const uint8_t *data)
+{
+   UPDT_packerSegmentType *last = packer->segments;
+
+   if(0 == size)
+   {
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   if(address + size < address)
+   {
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+   /* in the binary formats the bytes must follow in the image too */
+   last += 0 < packer->count ? packer->count - 1 : 0;
+   if(0 < packer->count && last->address + last->size == address &&
+      (UPDT_PACKER_FORMAT_S19 == packer->format || UPDT_PACKER_FORMAT_IHEX == packer->format ||
+      last->data + last->size == data))
+   {
+      last->size += size;
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   if(packer->count == segments_max)
+   {
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+   last = &packer->segments[packer->count++];
+   last->address = address;
+   last->size = size;
+   last->data = data;
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Reads a 16 or 32 bit ELF field. */
+static uint32_t UPDT_packerElfGet(const uint8_t *field, uint8_t size, uint8_t big_endian)
+{
+   uint32_t value = 0;
+   uint8_t i;
+
+   for(i = 0; i < size; i++)
+   {
+      value |= (uint32_t) field[big_endian ? size - 1 - i : i] << (8 * i);
+   }
+   return value;
+}
+
+/** \brief Finds the segments of an ELF image, its loadable program
+ ** segments at their physical address. */
+static int32_t UPDT_packerElf(UPDT_packerType *packer, uint16_t segments_max)
+{
+   const uint8_t *image = packer->image;
+   const uint8_t *header;
+   uint8_t big_endian;
+   uint32_t phoff;
+   uint32_t phentsize;
+   uint32_t phnum;
+   uint32_t offset;
+   uint32_t size;
+   uint32_t i;
+   int32_t ret;
+
+   if(packer->image_size < UPDT_PACKER_ELF_HEADER_SIZE ||
+      UPDT_PACKER_ELF_CLASS32 != image[4])
+   {
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+   big_endian = UPDT_PACKER_ELF_DATA_MSB == image[5];
+   phoff = UPDT_packerElfGet(image + 28, 4, big_endian);
+   phentsize = UPDT_packerElfGet(image + 42, 2, big_endian);
+   phnum = UPDT_packerElfGet(image + 44, 2, big_endian);
+   if(phentsize < UPDT_PACKER_ELF_PHDR_SIZE || phoff > packer->image_size ||
+      phnum > (packer->image_size - phoff) / phentsize)
+   {
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+   for(i = 0; i < phnum; i++)
+   {
+      header = image + phoff + i * phentsize;
+      if(UPDT_PACKER_ELF_PT_LOAD != UPDT_packerElfGet(header, 4, big_endian))
+      {
+         continue;
+      }
+      /* the file size, the rest up to the memory size is .bss */
+      offset = UPDT_packerElfGet(header + 4, 4, big_endian);
+      size = UPDT_packerElfGet(header + 16, 4, big_endian);
+      if(offset > packer->image_size || size > packer->image_size - offset)
+      {
+         return UPDT_PROTOCOL_ERROR_PACKET;
+      }
+      ret = UPDT_packerAdd(packer, segments_max, UPDT_packerElfGet(header + 12, 4, big_endian),
+         size, image + offset);
+      if(UPDT_PROTOCOL_ERROR_NONE != ret)
+      {
+         return ret;
+      }
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Finds the segments of a text image, runs of data records with
+ ** consecutive addresses. */
+static int32_t UPDT_packerText(UPDT_packerType *packer, uint16_t segments_max)
+{
+   const uint8_t *text = packer->image;
+   const uint8_t *end = packer->image + packer->image_size;
+   UPDT_packerRecordType record;
+   uint32_t base = 0;
+   int32_t ret;
+
+   do
+   {
+      ret = UPDT_packerParse(packer->format, text, end, &record);
+      if(UPDT_PROTOCOL_ERROR_NONE != ret)
+      {
+         return ret;
+      }
+      if(UPDT_PACKER_RECORD_ADDRESS == record.kind)
+      {
+         base = record.address;
+      }
+      else if(UPDT_PACKER_RECORD_DATA == record.kind)
+      {
+         /* a new segment starts at its first record */
+         ret = UPDT_packerAdd(packer, segments_max, base + record.address, record.size, text);
+         if(UPDT_PROTOCOL_ERROR_NONE != ret)
+         {
+            return ret;
+         }
+      }
+      text = record.next;
+   } while(UPDT_PACKER_RECORD_END != record.kind);
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Produces the next bytes of the stream.
+ **
+ ** \param packer Packer structure.
+ ** \param buffer Memory for size bytes, NULL to skip them.
+ ** \param size Number of bytes, at most what is left of the stream.
+ **/
+static void UPDT_packerCopy(UPDT_packerType *packer, uint8_t *buffer, uint32_t size)
+{
+   const UPDT_packerSegmentType *segment;
+   UPDT_packerRecordType record;
+   uint32_t address;
+   uint32_t count;
+   uint32_t i;
+
+   while(size > 0)
+   {
+      address = packer->address + packer->position;
+      segment = &packer->segments[packer->segment];
+      while(packer->segment < packer->count && segment->address + segment->size <= address)
+      {
+         packer->segment++;
+         segment++;
+         packer->text = NULL;
+         packer->left = 0;
+      }
+
+      if(packer->segment == packer->count || address < segment->address)
+      {
+         /* a gap, or the padding of the last page */
+         count = packer->segment == packer->count ? size : segment->address - address;
+         count = count < size ? count : size;
+         if(NULL != buffer)
+         {
+            ciaaPOSIX_memset(buffer, UPDT_PACKER_FILL, count);
+         }
+      }
+      else if(UPDT_PACKER_FORMAT_S19 != packer->format && UPDT_PACKER_FORMAT_IHEX != packer->format)
+      {
+         count = segment->address + segment->size - address;
+         count = count < size ? count : size;
+         if(NULL != buffer)
+         {
+            ciaaPOSIX_memcpy(buffer, segment->data + (address - segment->address), count);
+         }
+      }
+      else
+      {
+         if(0 == packer->left)
+         {
+            /* the records were checked by UPDT_packerInit */
+            do
+            {
+               UPDT_packerParse(packer->format, NULL == packer->text ? segment->data : packer->text,
+                  packer->image + packer->image_size, &record);
+               packer->text = record.next;
+            } while(UPDT_PACKER_RECORD_DATA != record.kind || 0 == record.size);
+            packer->record = record.data;
+            packer->left = record.size;
+         }
+         count = packer->left < size ? packer->left : size;
+         for(i = 0; NULL != buffer && i < count; i++)
+         {
+            buffer[i] = UPDT_packerByte(packer->record + 2 * i);
+         }
+         packer->record += 2 * count;
+         packer->left -= count;
+      }
+
+      packer->position += count;
+      size -= count;
+      if(NULL != buffer)
+      {
+         buffer += count;
+      }
+   }
+}
+
+/*==================[external functions definition]==========================*/
+uint8_t UPDT_packerDetect(const uint8_t *image, size_t size)
+{
+   if(size >= UPDT_PACKER_ELF_IDENT_SIZE && 0x7F == image[0] && 'E' == image[1] &&
+      'L' == image[2] && 'F' == image[3])
+   {
+      return UPDT_PACKER_FORMAT_ELF;
+   }
+   if(size >= 2 && 'S' == image[0] && image[1] >= '0' && image[1] <= '9')
+   {
+      return UPDT_PACKER_FORMAT_S19;
+   }
+   if(size >= 1 && ':' == image[0])
+   {
+      return UPDT_PACKER_FORMAT_IHEX;
+   }
+   return UPDT_PACKER_FORMAT_RAW;
+}
+
+int32_t UPDT_packerInit(
+   UPDT_packerType *packer,
+   const uint8_t *image,
+   size_t size,
+   uint8_t format,
+   uint32_t address,
+   uint32_t page_size,
+   UPDT_packerSegmentType *segments,
+   uint16_t segments_max)
+{
+   UPDT_packerSegmentType segment;
+   uint32_t end;
+   uint16_t i;
+   uint16_t j;
+   int32_t ret;
+
+   ciaaPOSIX_assert(NULL != packer && NULL != image && 0 < page_size);
+   ciaaPOSIX_assert(NULL != segments && 0 < segments_max);
+
+   ciaaPOSIX_memset(packer, 0, sizeof(*packer));
+   packer->image = image;
+   packer->image_size = size;
+   packer->format = UPDT_PACKER_FORMAT_AUTO == format ? UPDT_packerDetect(image, size) : format;
+   packer->segments = segments;
+
+   switch(packer->format)
+   {
+      case UPDT_PACKER_FORMAT_RAW:
+         ret = size > UINT32_MAX ? UPDT_PROTOCOL_ERROR_PACKET :
+            UPDT_packerAdd(packer, segments_max, address, size, image);
+         break;
+      case UPDT_PACKER_FORMAT_ELF:
+         ret = UPDT_packerElf(packer, segments_max);
+         break;
+      case UPDT_PACKER_FORMAT_S19:
+      case UPDT_PACKER_FORMAT_IHEX:
+         ret = UPDT_packerText(packer, segments_max);
+         break;
+      default:
+         ret = UPDT_PROTOCOL_ERROR_PACKET;
+         break;
+   }
+   if(UPDT_PROTOCOL_ERROR_NONE != ret)
+   {
+      return ret;
+   }
+   if(0 == packer->count)
+   {
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+
+   /* sort by address, the segments of most images are already sorted */
+   for(i = 1; i < packer->count; i++)
+   {
+      segment = segments[i];
+      for(j = i; j > 0 && segments[j - 1].address > segment.address; j--)
+      {
+         segments[j] = segments[j - 1];
+      }
+      segments[j] = segment;
+   }
+   for(i = 1; i < packer->count; i++)
+   {
+      if(segments[i - 1].address + segments[i - 1].size > segments[i].address)
+      {
+         return UPDT_PROTOCOL_ERROR_PACKET;
+      }
+   }
+
+   /* from the start of the first page to the end of the last one */
+   packer->address = segments[0].address - segments[0].address % page_size;
+   end = segments[packer->count - 1].address + segments[packer->count - 1].size;
+   if(0 != end % page_size)
+   {
+      if(end + (page_size - end % page_size) < end)
+      {
+         return UPDT_PROTOCOL_ERROR_PACKET;
+      }
+      end += page_size - end % page_size;
+   }
+   packer->size = end - packer->address;
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+uint32_t UPDT_packerGetAddress(const UPDT_packerType *packer)
+{
+   return packer->address;
+}
+
+uint32_t UPDT_packerGetSize(const UPDT_packerType *packer)
+{
+   return packer->size;
+}
+
+int32_t UPDT_packerGet(
+   UPDT_packerType *packer,
+   uint8_t *buffer,
+   size_t size,
+   const uint8_t **payload)
+{
+   const UPDT_packerSegmentType *segment;
+   uint32_t address;
+
+   ciaaPOSIX_assert(NULL != packer && NULL != buffer && NULL != payload);
+
+   if(size > packer->size - packer->position)
+   {
+      size = packer->size - packer->position;
+   }
+   *payload = buffer;
+   if(0 == size)
+   {
+      return 0;
+   }
+
+   /* the binary formats give a payload inside one segment straight from the
+    * image */
+   if(UPDT_PACKER_FORMAT_S19 != packer->format && UPDT_PACKER_FORMAT_IHEX != packer->format)
+   {
+      address = packer->address + packer->position;
+      segment = &packer->segments[packer->segment];
+      while(packer->segment < packer->count && segment->address + segment->size <= address)
+      {
+         packer->segment++;
+         segment++;
+      }
+      if(packer->segment < packer->count && segment->address <= address &&
+         address + size <= segment->address + segment->size)
+      {
+         *payload = segment->data + (address - segment->address);
+         packer->position += size;
+         return (int32_t) size;
+      }
+   }
+
+   UPDT_packerCopy(packer, buffer, size);
+   return (int32_t) size;
+}
+
+int32_t UPDT_packerSeek(UPDT_packerType *packer, uint32_t offset)
+{
+   ciaaPOSIX_assert(NULL != packer);
+
+   if(offset > packer->size)
+   {
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+   if(offset < packer->position)
+   {
+      packer->position = 0;
+      packer->segment = 0;
+      packer->text = NULL;
+      packer->left = 0;
+   }
+   UPDT_packerCopy(packer, NULL, offset - packer->position);
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
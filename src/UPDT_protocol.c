@@ -2,6 +2,7 @@
  * Copyright 2014, Esteban Volentini
  * Copyright 2014, Matias Giori
  * Copyright 2014, Franco Salinas
+ * Copyright 2026, agent
  *
  * This file is part of CIAA Firmware.
  *
@@ -50,11 +51,30 @@
  * EV           Esteban Volentini
  * MG           Matias Giori
  * FS           Franco Salinas
+ * AG           agent
  */
 
 /*
  * modification history (new versions first)
  * -----------------------------------------------------------
+ * 20261017 v0.0.21 AG  check the size of the STA payload at compile time
+ * 20261017 v0.0.20 AG  resynchronize the receiver after a corrupted payload size
+ * 20261017 v0.0.19 AG  keep the retransmission timer on repeated acknowledgements
+ * 20261017 v0.0.18 AG  add the forward error correction
+ * 20261017 v0.0.17 AG  add the encryption of the DAT payloads
+ * 20261017 v0.0.16 AG  add trace points
+ * 20261017 v0.0.15 AG  add the session statistics and the STA packet
+ * 20261017 v0.0.14 AG  add the baud rate negotiation
+ * 20261017 v0.0.13 AG  add deferred acknowledgements
+ * 20261017 v0.0.12 AG  add the resume point
+ * 20261017 v0.0.11 AG  accept frame flags in SessionSend
+ * 20261017 v0.0.10 AG  add the session timeouts
+ * 20261017 v0.0.9  AG  add the non-blocking stream
+ * 20261017 v0.0.8  AG  add zero copy receive
+ * 20261017 v0.0.7  AG  add vectored send and receive
+ * 20261017 v0.0.6  AG  add frame and image CRC32C
+ * 20261017 v0.0.5  AG  add payload size negotiation
+ * 20261017 v0.0.4  AG  add sliding window sessions
  * 20150419 v0.0.3  FS  change prefixes
  * 20150408 v0.0.2  FS  first operating version
  * 20141010 v0.0.1  EV  first initial version
@@ -64,9 +84,39 @@
 #include "ciaaPOSIX_assert.h"
 #include "UPDT_protocol.h"
 #include "UPDT_ITransport.h"
+#include "UPDT_crc32c.h"
+#include "UPDT_time.h"
+#include "UPDT_trace.h"
 #include "ciaaLibs_Endianess.h"
 
 /*==================[macros and definitions]=================================*/
+/** rounds a payload size down to a size the header can describe */
+#define UPDT_PROTOCOL_PAYLOAD_ALIGN(size)                                     \
+   ((size) > UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE ?                               \
+   UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE : ((size) & ~((size_t) 0x07)))
+
+/** \brief Consumer wrapper computing the CRCs of a payload */
+typedef struct
+{
+   /** Final consumer */
+   UPDT_protocolConsumerType consumer;
+   /** Context of the final consumer */
+   void *context;
+   /** CRC of the header and the payload received so far */
+   uint32_t frame_crc;
+   /** Image CRC updated with the payload received so far */
+   uint32_t image_crc;
+} UPDT_protocolCrcConsumerType;
+
+/** \brief Fails to compile when the STA payload does not hold the statistics
+ **
+ ** The statistics are encoded as 32 bit words, the array size is negative
+ ** when a field is added without its word in
+ ** UPDT_PROTOCOL_PACKET_STA_PAYLOAD_SIZE or when a field of another size
+ ** changes the size of the structure. */
+typedef uint8_t UPDT_protocolStatsCheckType[
+   sizeof(UPDT_protocolStatsType) == UPDT_PROTOCOL_PACKET_STA_PAYLOAD_SIZE &&
+   0 == sizeof(UPDT_protocolStatsType) % sizeof(uint32_t) ? 1 : -1];
 
 /*==================[internal data declaration]==============================*/
 
@@ -77,96 +127,1812 @@
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+/** \brief Moves every byte described by a vector, like UPDT_protocolRecv and
+ ** UPDT_protocolSend do for a single block. */
+static int32_t UPDT_protocolTransferv(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count,
+   uint8_t send)
+{
+   UPDT_ITransportIoVecType pending[UPDT_PROTOCOL_IOV_MAX];
+   size_t first = 0;
+   size_t moved = 0;
+   int32_t result = UPDT_PROTOCOL_ERROR_NONE;
+   ssize_t ret;
 
-/*==================[external functions definition]==========================*/
+   ciaaPOSIX_assert(NULL != iov);
+   ciaaPOSIX_assert(count <= UPDT_PROTOCOL_IOV_MAX);
 
-int8_t UPDT_protocolGetPacketType(const uint8_t *header)
+   ciaaPOSIX_memcpy(pending, iov, count * sizeof(UPDT_ITransportIoVecType));
+   UPDT_TRACE_BEGIN(send ? UPDT_TRACE_EVENT_SEND : UPDT_TRACE_EVENT_RECV, count);
+   while(first < count)
+   {
+      if(0 == pending[first].size)
+      {
+         first++;
+         continue;
+      }
+      if(send)
+      {
+         ret = UPDT_ITransportSendVector(transport, pending + first, count - first);
+      }
+      else
+      {
+         ret = UPDT_ITransportRecvVector(transport, pending + first, count - first);
+      }
+      if(ret < 0)
+      {
+         result = UPDT_PROTOCOL_ERROR_TRANSPORT;
+         break;
+      }
+      if(0 == ret)
+      {
+         result = UPDT_PROTOCOL_ERROR_TIMEOUT;
+         break;
+      }
+      moved += ret;
+      /* skip the bytes already moved */
+      while(ret > 0)
+      {
+         if((size_t) ret >= pending[first].size)
+         {
+            ret -= pending[first].size;
+            pending[first].size = 0;
+            first++;
+         }
+         else
+         {
+            pending[first].base = (uint8_t *) pending[first].base + ret;
+            pending[first].size -= ret;
+            ret = 0;
+         }
+      }
+   }
+   UPDT_TRACE_END(send ? UPDT_TRACE_EVENT_SEND : UPDT_TRACE_EVENT_RECV, moved);
+   return result;
+}
+
+/** \brief Returns the window slot of an unacknowledged frame. */
+static uint8_t *UPDT_protocolSessionSlot(
+   UPDT_protocolSessionType *session,
+   uint8_t sequence_number)
 {
-   ciaaPOSIX_assert(NULL != header);
-   return header[0] & 0x0F;
+   uint8_t offset = UPDT_PROTOCOL_SEQUENCE_DISTANCE(sequence_number, session->base);
+
+   return session->frames +
+      ((session->base_slot + offset) % session->window_size) * session->frame_size;
 }
-uint16_t UPDT_protocolGetPayloadSize(const uint8_t *header)
+
+/** \brief Reads and drops the specified number of bytes. */
+static int32_t UPDT_protocolDiscard(UPDT_ITransportType *transport, size_t size)
 {
-   ciaaPOSIX_assert(NULL != header);
-   return  ((uint16_t) header[3]) << 3;
+   return UPDT_protocolRecvConsume(transport, size, NULL, NULL);
 }
-uint8_t UPDT_protocolGetSequenceNumber(const uint8_t *header)
+
+/** \brief Computes the frame CRC and the image CRC while a payload is
+ ** handed to the final consumer. */
+static int32_t UPDT_protocolCrcConsumer(
+   void *context,
+   size_t offset,
+   const uint8_t *data,
+   size_t size)
 {
-   ciaaPOSIX_assert(NULL != header);
+   UPDT_protocolCrcConsumerType *crc_consumer = (UPDT_protocolCrcConsumerType *) context;
 
-   return header[2];
+   crc_consumer->frame_crc = UPDT_crc32cUpdate(crc_consumer->frame_crc, data, size);
+   crc_consumer->image_crc = UPDT_crc32cUpdate(crc_consumer->image_crc, data, size);
+   return crc_consumer->consumer(crc_consumer->context, offset, data, size);
 }
 
-void UPDT_protocolSetHeader(
-   uint8_t *header,
-   uint8_t packet_type,
-   uint8_t sequence_number,
-   uint16_t payload_size)
+/** \brief Receives the payload and the trailer of a frame whose header was
+ ** already received, and checks its CRC.
+ **
+ ** The payload goes to the consumer if there is one, to the payload buffer
+ ** otherwise. Without both it is discarded.
+ **
+ ** \param image_crc If not NULL it is updated with the payload.
+ ** \return UPDT_PROTOCOL_ERROR_CRC if the frame is corrupted.
+ **/
+static int32_t UPDT_protocolRecvBody(
+   UPDT_ITransportType *transport,
+   const uint8_t *header,
+   uint8_t *payload,
+   UPDT_protocolConsumerType consumer,
+   void *context,
+   uint32_t *image_crc)
 {
-   ciaaPOSIX_assert(NULL != header);
-   /* payload must be size multiple of 8 and smaller than 2048 */
-   ciaaPOSIX_assert(0 == (payload_size & 0xF807));
+   uint8_t trailer[UPDT_PROTOCOL_CRC_SIZE];
+   UPDT_ITransportIoVecType iov[2];
+   UPDT_protocolCrcConsumerType crc_consumer;
+   uint16_t payload_size = UPDT_protocolGetPayloadSize(header);
+   uint32_t crc;
+   int32_t ret;
 
-   header[0] = (header[0] & 0xF0) | (packet_type & 0x0F);
-   header[1] = 0;
-   header[2] = sequence_number;
-   header[3] = (uint8_t) (payload_size >> 3);
+   iov[1].base = trailer;
+   iov[1].size = (UPDT_protocolGetFlags(header) & UPDT_PROTOCOL_FLAG_CRC) ? UPDT_PROTOCOL_CRC_SIZE : 0;
+
+   if(NULL != consumer)
+   {
+      crc_consumer.consumer = consumer;
+      crc_consumer.context = context;
+      crc_consumer.frame_crc = UPDT_crc32cUpdate(0, header, UPDT_PROTOCOL_HEADER_SIZE);
+      crc_consumer.image_crc = NULL != image_crc ? *image_crc : 0;
+      ret = UPDT_protocolRecvConsume(transport, payload_size, UPDT_protocolCrcConsumer, &crc_consumer);
+      if(UPDT_PROTOCOL_ERROR_NONE == ret)
+      {
+         ret = UPDT_protocolRecv(transport, trailer, iov[1].size);
+      }
+      crc = crc_consumer.frame_crc;
+   }
+   else if(NULL != payload)
+   {
+      /* payload and trailer are received together */
+      iov[0].base = payload;
+      iov[0].size = payload_size;
+      ret = UPDT_protocolRecvv(transport, iov, 2);
+      crc = UPDT_crc32cUpdate(0, header, UPDT_PROTOCOL_HEADER_SIZE);
+      if(0 < iov[1].size)
+      {
+         crc = UPDT_crc32cUpdate(crc, payload, payload_size);
+      }
+   }
+   else
+   {
+      return UPDT_protocolDiscard(transport, payload_size + iov[1].size);
+   }
+
+   if(UPDT_PROTOCOL_ERROR_NONE != ret)
+   {
+      return ret;
+   }
+   if(0 < iov[1].size && crc != UPDT_crc32cGet(trailer))
+   {
+      return UPDT_PROTOCOL_ERROR_CRC;
+   }
+   if(NULL != image_crc)
+   {
+      *image_crc = NULL != consumer ? crc_consumer.image_crc :
+         UPDT_crc32cUpdate(*image_crc, payload, payload_size);
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
 }
 
-int32_t UPDT_protocolRecv(
+/** \brief Receives a whole frame and checks its CRC.
+ **
+ ** \return UPDT_PROTOCOL_ERROR_PACKET if the payload does not fit in the
+ ** buffer, it is discarded. UPDT_PROTOCOL_ERROR_CRC if the frame is corrupted.
+ **/
+static int32_t UPDT_protocolRecvFrame(
    UPDT_ITransportType *transport,
-   uint8_t *buffer,
+   uint8_t *header,
+   uint8_t *payload,
    size_t size)
 {
-   ssize_t ret;
-   size_t bytes_read = 0;
+   int32_t ret;
 
-   ciaaPOSIX_assert(NULL != buffer);
+   ret = UPDT_protocolRecv(transport, header, UPDT_PROTOCOL_HEADER_SIZE);
+   if(UPDT_PROTOCOL_ERROR_NONE != ret)
+   {
+      return ret;
+   }
+   if(UPDT_protocolGetPayloadSize(header) > size)
+   {
+      ret = UPDT_protocolRecvBody(transport, header, NULL, NULL, NULL, NULL);
+      return UPDT_PROTOCOL_ERROR_NONE == ret ? UPDT_PROTOCOL_ERROR_PACKET : ret;
+   }
+   return UPDT_protocolRecvBody(transport, header, payload, NULL, NULL, NULL);
+}
 
-   if(0 == size)
+/** \brief Starts the deadline of the next wait, if the session has one. */
+static void UPDT_protocolSessionArm(UPDT_protocolSessionType *session)
+{
+   if(0 != session->timeout)
    {
-      return 0;
+      UPDT_ITransportDeadlineSet(&session->deadline, UPDT_timeNow() + session->timeout);
    }
-   /* read the specified number of bytes */
-   while(bytes_read < size)
+}
+
+/** \brief Starts the deadline of the body of a frame whose header arrived.
+ **
+ ** A frame is sent at once, its body follows the header closely. Half of
+ ** the timeout ends the wait for a frame whose size was corrupted before
+ ** the sender repeats its frames, so the receiver reads them from their
+ ** start instead of taking their bytes for the rest of the bad frame. */
+static void UPDT_protocolSessionArmBody(UPDT_protocolSessionType *session)
+{
+   if(0 != session->timeout)
    {
-      ret = transport->recv(transport, buffer + bytes_read, size - bytes_read);
-      if(ret < 0)
+      UPDT_ITransportDeadlineSet(&session->deadline, UPDT_timeNow() + session->timeout / 2);
+   }
+}
+
+/** \brief Restarts the retransmission timer of the oldest unacknowledged
+ ** frame. */
+static void UPDT_protocolSessionRestart(UPDT_protocolSessionType *session)
+{
+   session->expiry = UPDT_timeNow() + session->timeout;
+}
+
+/** \brief Accounts a frame sent by the session, if it keeps statistics. */
+static void UPDT_protocolSessionCountSent(UPDT_protocolSessionType *session, const uint8_t *frame)
+{
+   int8_t packet_type = UPDT_protocolGetPacketType(frame);
+
+   if(NULL != session->stats && packet_type < UPDT_PROTOCOL_PACKET_TYPES)
+   {
+      session->stats->frames_sent[packet_type]++;
+      session->stats->bytes_sent[packet_type] += UPDT_protocolGetFrameSize(frame);
+   }
+}
+
+/** \brief Accounts a valid frame received by the session, if it keeps
+ ** statistics. */
+static void UPDT_protocolSessionCountReceived(UPDT_protocolSessionType *session, const uint8_t *header)
+{
+   int8_t packet_type = UPDT_protocolGetPacketType(header);
+
+   if(NULL != session->stats && packet_type < UPDT_PROTOCOL_PACKET_TYPES)
+   {
+      session->stats->frames_received[packet_type]++;
+      session->stats->bytes_received[packet_type] += UPDT_protocolGetFrameSize(header);
+   }
+}
+
+static int32_t UPDT_protocolSessionSendAck(
+   UPDT_protocolSessionType *session,
+   uint8_t sequence_number)
+{
+   uint8_t frame[UPDT_PROTOCOL_HEADER_SIZE + UPDT_PROTOCOL_CRC_SIZE] = {0};
+
+   UPDT_protocolSetHeader(frame, UPDT_PROTOCOL_PACKET_ACK, sequence_number, 0);
+   if(session->flags & UPDT_PROTOCOL_FLAG_CRC)
+   {
+      UPDT_protocolSetCrc(frame);
+   }
+   session->acked = sequence_number;
+   UPDT_protocolSessionCountSent(session, frame);
+   UPDT_protocolSessionArm(session);
+   return UPDT_protocolSend(session->transport, frame, UPDT_protocolGetFrameSize(frame));
+}
+
+/** \brief Sends again every unacknowledged frame (go-back-N). */
+static int32_t UPDT_protocolSessionRetransmit(UPDT_protocolSessionType *session)
+{
+   uint8_t sequence_number;
+   const uint8_t *frame;
+   int32_t ret;
+
+   UPDT_protocolSessionArm(session);
+   UPDT_protocolSessionRestart(session);
+   for(sequence_number = session->base; sequence_number != session->next; ++sequence_number)
+   {
+      frame = UPDT_protocolSessionSlot(session, sequence_number);
+      UPDT_protocolSessionCountSent(session, frame);
+      if(NULL != session->stats)
       {
-         return UPDT_PROTOCOL_ERROR_TRANSPORT;
+         session->stats->retransmissions++;
+      }
+      ret = UPDT_protocolSend(session->transport, frame, UPDT_protocolGetFrameSize(frame));
+      if(UPDT_PROTOCOL_ERROR_NONE != ret)
+      {
+         return ret;
       }
-      bytes_read += ret;
    }
+   /* duplicated acknowledgements are ignored until the retransmitted frames
+    * are acknowledged */
+   session->recover = session->next;
+   session->recovering = 1;
    return UPDT_PROTOCOL_ERROR_NONE;
 }
 
-int32_t UPDT_protocolSend(
-   UPDT_ITransportType *transport,
-   const uint8_t *buffer,
-   size_t size)
+/** \brief Waits for an acknowledgement and slides the window. */
+static int32_t UPDT_protocolSessionProcessAck(UPDT_protocolSessionType *session)
 {
-   ssize_t ret;
-   size_t bytes_sent = 0;
+   uint8_t header[UPDT_PROTOCOL_HEADER_SIZE];
+   /* room for an STA answer, the largest frame a sender expects */
+   uint8_t payload[UPDT_PROTOCOL_PACKET_STA_PAYLOAD_SIZE];
+   uint8_t sequence_number;
+   uint8_t acked;
+   int8_t packet_type;
+   int32_t ret;
 
-   ciaaPOSIX_assert(NULL != buffer);
+   /* the wait ends when the oldest frame is due, whatever arrives before */
+   if(0 != session->timeout)
+   {
+      UPDT_ITransportDeadlineSet(&session->deadline, session->expiry);
+   }
+   ret = UPDT_protocolRecvFrame(session->transport, header, payload, sizeof(payload));
+   if(NULL != session->stats)
+   {
+      if(UPDT_PROTOCOL_ERROR_TIMEOUT == ret)
+      {
+         session->stats->timeouts++;
+      }
+      else if(UPDT_PROTOCOL_ERROR_CRC == ret || UPDT_PROTOCOL_ERROR_PACKET == ret)
+      {
+         session->stats->corrupted++;
+      }
+   }
+   if(UPDT_PROTOCOL_ERROR_TIMEOUT == ret && ++session->retries <= UPDT_PROTOCOL_RETRIES_MAX)
+   {
+      /* the frames or their acknowledgements were lost */
+      return UPDT_protocolSessionRetransmit(session);
+   }
+   if(UPDT_PROTOCOL_ERROR_CRC == ret)
+   {
+      /* a corrupted acknowledgement is as good as a lost one */
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   if(UPDT_PROTOCOL_ERROR_NONE != ret)
+   {
+      return ret;
+   }
 
-   if(0 == size)
+   UPDT_protocolSessionCountReceived(session, header);
+   packet_type = UPDT_protocolGetPacketType(header);
+   if(UPDT_PROTOCOL_PACKET_DNY == packet_type)
    {
-      return 0;
+      return UPDT_PROTOCOL_ERROR_DENIED;
    }
-   /* send the specified number of bytes */
-   while(bytes_sent < size)
+   if(UPDT_PROTOCOL_PACKET_STA == packet_type)
    {
-      ret = transport->send(transport, buffer + bytes_sent, size - bytes_sent);
-      if(ret < 0)
+      /* answer to UPDT_protocolSessionQueryStats, duplicates are ignored */
+      if(NULL != session->query &&
+         UPDT_PROTOCOL_PACKET_STA_PAYLOAD_SIZE == UPDT_protocolGetPayloadSize(header))
       {
-         return UPDT_PROTOCOL_ERROR_TRANSPORT;
+         UPDT_protocolGetStats(payload, session->query);
+         session->query = NULL;
       }
-      bytes_sent += ret;
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   if(UPDT_PROTOCOL_PACKET_ACK != packet_type)
+   {
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+
+   sequence_number = UPDT_protocolGetSequenceNumber(header);
+   /* number of frames covered by this cumulative acknowledgement */
+   acked = UPDT_PROTOCOL_SEQUENCE_DISTANCE(sequence_number + 1, session->base);
+
+   if(0 != acked && acked <= UPDT_PROTOCOL_SEQUENCE_DISTANCE(session->next, session->base))
+   {
+      if(session->recovering &&
+         UPDT_PROTOCOL_SEQUENCE_DISTANCE(session->recover, session->base) <= acked)
+      {
+         session->recovering = 0;
+      }
+      session->base_slot = (session->base_slot + acked) % session->window_size;
+      session->base = sequence_number + 1;
+      session->retries = 0;
+      UPDT_protocolSessionRestart(session);
+   }
+   else if(1 == UPDT_PROTOCOL_SEQUENCE_DISTANCE(session->base, sequence_number) &&
+      session->base != session->next && !session->recovering)
+   {
+      /* the receiver acknowledged again its last in order frame, so the
+       * frame at the base of the window was lost */
+      ret = UPDT_protocolSessionRetransmit(session);
+   }
+   /* else it is an old acknowledgement, ignore it, the retransmission timer
+    * keeps running */
+   return ret;
+}
+
+/** \brief Authenticates and decrypts an in order DAT frame.
+ **
+ ** On success the header describes the plain payload.
+ **
+ ** \return UPDT_PROTOCOL_ERROR_DENIED if the frame is not encrypted or not
+ ** authentic.
+ **/
+static int32_t UPDT_protocolSessionOpen(
+   UPDT_protocolSessionType *session,
+   uint8_t *header,
+   uint8_t *payload)
+{
+   uint16_t payload_size = UPDT_protocolGetPayloadSize(header);
+   int32_t ret;
+
+   if(0 == (UPDT_protocolGetFlags(header) & UPDT_PROTOCOL_FLAG_ENCRYPTED) ||
+      payload_size < UPDT_PROTOCOL_TAG_SIZE)
+   {
+      return UPDT_PROTOCOL_ERROR_DENIED;
+   }
+   ret = session->cipher(session->cipher_context, header, payload, session->ciphered);
+   if(UPDT_PROTOCOL_ERROR_NONE != ret)
+   {
+      return ret;
+   }
+   session->ciphered++;
+   payload_size -= UPDT_PROTOCOL_TAG_SIZE;
+   session->image_crc = UPDT_crc32cUpdate(session->image_crc, payload, payload_size);
+   UPDT_protocolSetHeader(header, UPDT_PROTOCOL_PACKET_DAT,
+      UPDT_protocolGetSequenceNumber(header), payload_size);
+   UPDT_protocolSetFlags(header, UPDT_protocolGetFlags(header) & ~UPDT_PROTOCOL_FLAG_ENCRYPTED);
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Delivers an in order frame: decrypts it if it is an encrypted DAT
+ ** frame, acknowledges it unless the acknowledgements are deferred and
+ ** expects the next one. */
+static int32_t UPDT_protocolSessionAccept(
+   UPDT_protocolSessionType *session,
+   uint8_t *header,
+   uint8_t *payload)
+{
+   int32_t ret = UPDT_PROTOCOL_ERROR_NONE;
+
+   if(UPDT_PROTOCOL_PACKET_DAT == UPDT_protocolGetPacketType(header) && NULL != session->cipher)
+   {
+      ret = UPDT_protocolSessionOpen(session, header, payload);
+      if(UPDT_PROTOCOL_ERROR_NONE != ret)
+      {
+         return ret;
+      }
+   }
+   session->retries = 0;
+   if(!session->defer_ack)
+   {
+      ret = UPDT_protocolSessionSendAck(session, session->expected);
+   }
+   session->expected++;
+   return ret;
+}
+
+/** \brief Writes the prefix of the FEC block of a DAT frame. */
+static void UPDT_protocolFecSetPrefix(uint8_t *prefix, const uint8_t *header)
+{
+   ciaaPOSIX_memset(prefix, 0, UPDT_PROTOCOL_FEC_PREFIX_SIZE);
+   prefix[0] = header[0];
+   prefix[1] = header[3];
+}
+
+/** \brief Sends the PAR frames of the current group and starts a new one. */
+static int32_t UPDT_protocolSessionSendParity(UPDT_protocolSessionType *session)
+{
+   uint8_t header[UPDT_PROTOCOL_HEADER_SIZE] = {0};
+   uint8_t count = UPDT_PROTOCOL_SEQUENCE_DISTANCE(session->next, session->fec_first);
+   uint8_t j;
+   int32_t ret = UPDT_PROTOCOL_ERROR_NONE;
+
+   for(j = 0; j < session->fec->parity && UPDT_PROTOCOL_ERROR_NONE == ret; j++)
+   {
+      UPDT_protocolSetHeader(header, UPDT_PROTOCOL_PACKET_PAR, session->fec_first,
+         session->fec->block_size);
+      UPDT_protocolSetFlags(header, session->flags & UPDT_PROTOCOL_FLAG_CRC);
+      header[1] = (uint8_t) ((j << 4) | (count - 1));
+      UPDT_protocolSessionCountSent(session, header);
+      UPDT_protocolSessionArm(session);
+      ret = UPDT_protocolSendFrame(session->transport, header,
+         UPDT_fecBlock(session->fec, session->fec->data + j));
+   }
+   UPDT_fecReset(session->fec);
+   return ret;
+}
+
+/** \brief Keeps a copy of an in order DAT frame, the missing frames of its
+ ** group may be rebuilt with it. */
+static void UPDT_protocolSessionFecKeep(
+   UPDT_protocolSessionType *session,
+   const uint8_t *header,
+   const uint8_t *payload)
+{
+   UPDT_fecType *fec = session->fec;
+   uint16_t payload_size = UPDT_protocolGetPayloadSize(header);
+   uint8_t index = header[1];
+   uint8_t *block;
+
+   if(index >= fec->data || UPDT_PROTOCOL_FEC_PREFIX_SIZE + payload_size > fec->block_size)
+   {
+      return;
+   }
+   if(0 == index && session->expected != session->fec_first)
+   {
+      UPDT_fecReset(fec);
+      session->fec_first = session->expected;
+   }
+   if(UPDT_PROTOCOL_SEQUENCE_DISTANCE(session->expected, session->fec_first) != index ||
+      UPDT_fecIsPresent(fec, index))
+   {
+      return;
+   }
+   block = UPDT_fecBlock(fec, index);
+   UPDT_protocolFecSetPrefix(block, header);
+   ciaaPOSIX_memcpy(block + UPDT_PROTOCOL_FEC_PREFIX_SIZE, payload, payload_size);
+   UPDT_fecAdd(fec, index, UPDT_PROTOCOL_FEC_PREFIX_SIZE + payload_size);
+}
+
+/** \brief Receives a DAT frame ahead of the expected one or a PAR frame.
+ **
+ ** A frame of the current group is kept, or of a new group if every frame
+ ** before it was received. Once enough PAR frames arrived the missing DAT
+ ** frames are rebuilt. A corrupted frame is not answered, the PAR frames
+ ** may rebuild it. A DAT frame of a later group, or the last PAR frame of a
+ ** group which can not be rebuilt, is answered with the last
+ ** acknowledgement so that the sender goes back to the first missing frame.
+ **/
+static int32_t UPDT_protocolSessionFecRecv(UPDT_protocolSessionType *session, const uint8_t *header)
+{
+   UPDT_fecType *fec = session->fec;
+   uint8_t packet_type = UPDT_protocolGetPacketType(header);
+   uint16_t payload_size = UPDT_protocolGetPayloadSize(header);
+   uint8_t *block = NULL;
+   uint8_t first;
+   uint8_t index;
+   uint8_t count = fec->data;
+   uint8_t valid;
+   uint8_t missing;
+   int32_t ret;
+
+   if(UPDT_PROTOCOL_PACKET_PAR == packet_type)
+   {
+      first = UPDT_protocolGetSequenceNumber(header);
+      index = fec->data + (header[1] >> 4);
+      count = (header[1] & 0x0F) + 1;
+      valid = (header[1] >> 4) < fec->parity && count <= fec->data &&
+         payload_size == fec->block_size;
+   }
+   else
+   {
+      first = UPDT_protocolGetSequenceNumber(header) - header[1];
+      index = header[1];
+      valid = index < fec->data && UPDT_PROTOCOL_FEC_PREFIX_SIZE + payload_size <= fec->block_size;
+   }
+   if(valid && first != session->fec_first && first == session->expected)
+   {
+      /* the first frames of a new group were lost */
+      UPDT_fecReset(fec);
+      session->fec_first = first;
+   }
+   if(valid && first == session->fec_first && !UPDT_fecIsPresent(fec, index))
+   {
+      block = UPDT_fecBlock(fec, index);
+   }
+
+   ret = UPDT_protocolRecvBody(session->transport, header,
+      NULL == block || UPDT_PROTOCOL_PACKET_PAR == packet_type ? block :
+      block + UPDT_PROTOCOL_FEC_PREFIX_SIZE, NULL, NULL, NULL);
+   if(UPDT_PROTOCOL_ERROR_TIMEOUT == ret)
+   {
+      if(NULL != session->stats)
+      {
+         session->stats->timeouts++;
+      }
+      if(++session->retries > UPDT_PROTOCOL_RETRIES_MAX)
+      {
+         return ret;
+      }
+      ret = UPDT_PROTOCOL_ERROR_CRC;
+   }
+   if(UPDT_PROTOCOL_ERROR_CRC == ret)
+   {
+      if(NULL != session->stats)
+      {
+         session->stats->corrupted++;
+      }
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   if(UPDT_PROTOCOL_ERROR_NONE != ret)
+   {
+      return ret;
+   }
+   UPDT_protocolSessionCountReceived(session, header);
+
+   if(NULL == block)
+   {
+      if(NULL != session->stats)
+      {
+         session->stats->discarded++;
+      }
+      /* duplicated and stale frames need no answer */
+      if(UPDT_PROTOCOL_PACKET_DAT == packet_type && (!valid || first != session->fec_first))
+      {
+         return UPDT_protocolSessionSendAck(session, session->acked);
+      }
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   if(UPDT_PROTOCOL_PACKET_DAT == packet_type)
+   {
+      UPDT_protocolFecSetPrefix(block, header);
+      UPDT_fecAdd(fec, index, UPDT_PROTOCOL_FEC_PREFIX_SIZE + payload_size);
+      if(NULL != session->stats)
+      {
+         session->stats->kept++;
+      }
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   UPDT_fecAdd(fec, index, payload_size);
+   missing = UPDT_fecMissing(fec, count);
+   if(0 < missing && missing <= UPDT_fecParity(fec))
+   {
+      UPDT_fecDecode(fec, count);
+      if(NULL != session->stats)
+      {
+         session->stats->rebuilt += missing;
+      }
+   }
+   else if(0 < missing && (missing > fec->parity || index == fec->data + fec->parity - 1))
+   {
+      /* too many frames lost, go back to the first one */
+      return UPDT_protocolSessionSendAck(session, session->acked);
    }
    return UPDT_PROTOCOL_ERROR_NONE;
 }
 
+/** \brief Returns non-zero if the expected frame was kept or rebuilt. */
+static uint8_t UPDT_protocolSessionFecReady(UPDT_protocolSessionType *session)
+{
+   uint8_t index = UPDT_PROTOCOL_SEQUENCE_DISTANCE(session->expected, session->fec_first);
+
+   return index < session->fec->data && UPDT_fecIsPresent(session->fec, index);
+}
+
+/** \brief Delivers the expected frame from its FEC block.
+ **
+ ** \return UPDT_PROTOCOL_ERROR_PACKET if the payload does not fit in the
+ ** buffer, the group is dropped and the sender sends its frames again.
+ **/
+static int32_t UPDT_protocolSessionFecDeliver(
+   UPDT_protocolSessionType *session,
+   uint8_t *header,
+   uint8_t *payload,
+   size_t size)
+{
+   uint8_t index = UPDT_PROTOCOL_SEQUENCE_DISTANCE(session->expected, session->fec_first);
+   const uint8_t *block = UPDT_fecBlock(session->fec, index);
+
+   /* the header as it was sent, the cipher authenticates it */
+   header[0] = block[0];
+   header[1] = index;
+   header[2] = session->expected;
+   header[3] = block[1];
+   if(UPDT_protocolGetPayloadSize(header) > size || NULL == payload ||
+      UPDT_PROTOCOL_FEC_PREFIX_SIZE + UPDT_protocolGetPayloadSize(header) > session->fec->block_size)
+   {
+      UPDT_fecReset(session->fec);
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+   ciaaPOSIX_memcpy(payload, block + UPDT_PROTOCOL_FEC_PREFIX_SIZE, UPDT_protocolGetPayloadSize(header));
+   if(NULL == session->cipher)
+   {
+      session->image_crc = UPDT_crc32cUpdate(session->image_crc, payload,
+         UPDT_protocolGetPayloadSize(header));
+   }
+   return UPDT_protocolSessionAccept(session, header, payload);
+}
+
+/** \brief Receives the next in order frame into a buffer or a consumer. */
+static int32_t UPDT_protocolSessionRecvFrame(
+   UPDT_protocolSessionType *session,
+   uint8_t *header,
+   uint8_t *payload,
+   size_t size,
+   UPDT_protocolConsumerType consumer,
+   void *context)
+{
+   uint8_t in_order;
+   int8_t packet_type;
+   int32_t ret;
+
+   ciaaPOSIX_assert(NULL != session);
+   ciaaPOSIX_assert(NULL != header);
+
+   while(1)
+   {
+      if(NULL != session->fec && UPDT_protocolSessionFecReady(session))
+      {
+         return UPDT_protocolSessionFecDeliver(session, header, payload, size);
+      }
+      UPDT_protocolSessionArm(session);
+      ret = UPDT_protocolRecv(session->transport, header, UPDT_PROTOCOL_HEADER_SIZE);
+      if(UPDT_PROTOCOL_ERROR_TIMEOUT == ret)
+      {
+         if(NULL != session->stats)
+         {
+            session->stats->timeouts++;
+         }
+         if(++session->retries > UPDT_PROTOCOL_RETRIES_MAX)
+         {
+            return ret;
+         }
+         /* nothing arrived, maybe the last acknowledgement was lost */
+         ret = UPDT_protocolSessionSendAck(session, session->acked);
+         if(UPDT_PROTOCOL_ERROR_NONE != ret)
+         {
+            return ret;
+         }
+         continue;
+      }
+      if(UPDT_PROTOCOL_ERROR_NONE != ret)
+      {
+         return ret;
+      }
+      UPDT_protocolSessionArmBody(session);
+      packet_type = UPDT_protocolGetPacketType(header);
+      /* acknowledgements and parity frames are not sequenced */
+      in_order = UPDT_PROTOCOL_PACKET_ACK != packet_type && UPDT_PROTOCOL_PACKET_PAR != packet_type &&
+         UPDT_protocolGetSequenceNumber(header) == session->expected;
+
+      if(NULL != session->fec && (UPDT_PROTOCOL_PACKET_PAR == packet_type ||
+         (UPDT_PROTOCOL_PACKET_DAT == packet_type && !in_order &&
+         UPDT_PROTOCOL_SEQUENCE_DISTANCE(UPDT_protocolGetSequenceNumber(header), session->expected) <
+         UPDT_PROTOCOL_WINDOW_MAX_SIZE)))
+      {
+         ret = UPDT_protocolSessionFecRecv(session, header);
+         if(UPDT_PROTOCOL_ERROR_NONE != ret)
+         {
+            return ret;
+         }
+         continue;
+      }
+      if(UPDT_protocolGetPayloadSize(header) > size)
+      {
+         ret = UPDT_protocolRecvBody(session->transport, header, NULL, NULL, NULL, NULL);
+         if(UPDT_PROTOCOL_ERROR_TIMEOUT != ret)
+         {
+            if(NULL != session->stats)
+            {
+               session->stats->corrupted++;
+            }
+            return UPDT_PROTOCOL_ERROR_NONE == ret ? UPDT_PROTOCOL_ERROR_PACKET : ret;
+         }
+         /* a size corrupted into a large one, dropped as a cut frame below */
+      }
+      else if(in_order)
+      {
+         /* the image CRC of an encrypted payload is updated once it is plain */
+         ret = UPDT_protocolRecvBody(session->transport, header, payload, consumer, context,
+            UPDT_PROTOCOL_PACKET_DAT == packet_type && NULL == session->cipher ?
+            &session->image_crc : NULL);
+      }
+      else
+      {
+         ret = UPDT_protocolRecvBody(session->transport, header, NULL, NULL, NULL, NULL);
+      }
+
+      if(UPDT_PROTOCOL_ERROR_NONE == ret)
+      {
+         UPDT_protocolSessionCountReceived(session, header);
+      }
+      if(UPDT_PROTOCOL_ERROR_NONE == ret && in_order)
+      {
+         if(NULL != session->fec && UPDT_PROTOCOL_PACKET_DAT == packet_type)
+         {
+            UPDT_protocolSessionFecKeep(session, header, payload);
+         }
+         else if(NULL != session->fec)
+         {
+            /* the sender closed the group before this frame */
+            UPDT_fecReset(session->fec);
+         }
+         return UPDT_protocolSessionAccept(session, header, payload);
+      }
+      if(UPDT_PROTOCOL_ERROR_TIMEOUT == ret)
+      {
+         /* the frame was cut, what is left of it is dropped with it */
+         if(NULL != session->stats)
+         {
+            session->stats->timeouts++;
+         }
+         if(++session->retries > UPDT_PROTOCOL_RETRIES_MAX)
+         {
+            return ret;
+         }
+         ret = UPDT_PROTOCOL_ERROR_CRC;
+      }
+      if(NULL != session->stats)
+      {
+         if(UPDT_PROTOCOL_ERROR_CRC == ret)
+         {
+            session->stats->corrupted++;
+         }
+         else if(UPDT_PROTOCOL_ERROR_NONE == ret && UPDT_PROTOCOL_PACKET_ACK != packet_type)
+         {
+            session->stats->discarded++;
+         }
+      }
+      if(UPDT_PROTOCOL_ERROR_NONE != ret && UPDT_PROTOCOL_ERROR_CRC != ret)
+      {
+         return ret;
+      }
+      if(UPDT_PROTOCOL_ERROR_CRC == ret && NULL != session->fec)
+      {
+         /* maybe a DAT frame the PAR frames rebuild */
+         continue;
+      }
+      if(UPDT_PROTOCOL_PACKET_ACK != packet_type || UPDT_PROTOCOL_ERROR_CRC == ret)
+      {
+         /* corrupted, out of order or duplicated frame: acknowledge again the
+          * last in order frame so the sender goes back to the missing one */
+         ret = UPDT_protocolSessionSendAck(session, session->acked);
+         if(UPDT_PROTOCOL_ERROR_NONE != ret)
+         {
+            return ret;
+         }
+      }
+   }
+}
+
+/** \brief Sends the pending bytes until the transport would block. */
+static int32_t UPDT_protocolStreamFlush(UPDT_protocolStreamType *stream)
+{
+   ssize_t ret;
+
+   while(0 < stream->tx_size)
+   {
+      ret = stream->transport->send(stream->transport, stream->tx_data, stream->tx_size);
+      if(ret < 0)
+      {
+         return UPDT_PROTOCOL_ERROR_TRANSPORT;
+      }
+      if(0 == ret)
+      {
+         return UPDT_PROTOCOL_ERROR_AGAIN;
+      }
+      stream->tx_data += ret;
+      stream->tx_size -= ret;
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Returns the number of bytes which complete the current step:
+ ** the skipped frame, the header or the rest of the frame. */
+static size_t UPDT_protocolStreamNeed(const UPDT_protocolStreamType *stream)
+{
+   if(0 < stream->skip)
+   {
+      return stream->skip;
+   }
+   if(stream->count < UPDT_PROTOCOL_HEADER_SIZE)
+   {
+      return UPDT_PROTOCOL_HEADER_SIZE - stream->count;
+   }
+   return UPDT_protocolGetFrameSize(stream->buffer) - stream->count;
+}
+
+/** \brief Accounts bytes stored at the end of the current frame, or dropped
+ ** while skipping, and gives the frame to the callback when it completes. */
+static int32_t UPDT_protocolStreamAdvance(UPDT_protocolStreamType *stream, size_t size)
+{
+   size_t frame_size;
+
+   if(0 < stream->skip)
+   {
+      stream->skip -= size;
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   stream->count += size;
+   if(stream->count < UPDT_PROTOCOL_HEADER_SIZE)
+   {
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+
+   frame_size = UPDT_protocolGetFrameSize(stream->buffer);
+   if(frame_size > stream->buffer_size)
+   {
+      /* the header is known, the rest of the frame is dropped */
+      stream->skip = frame_size - UPDT_PROTOCOL_HEADER_SIZE;
+      stream->count = 0;
+      stream->frames++;
+      return stream->callback(stream->context, stream->buffer, UPDT_PROTOCOL_ERROR_PACKET);
+   }
+   if(stream->count == frame_size)
+   {
+      stream->count = 0;
+      stream->frames++;
+      return stream->callback(stream->context, stream->buffer, UPDT_protocolCheckCrc(stream->buffer));
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/*==================[external functions definition]==========================*/
+
+int8_t UPDT_protocolGetPacketType(const uint8_t *header)
+{
+   ciaaPOSIX_assert(NULL != header);
+   return header[0] & 0x0F;
+}
+uint8_t UPDT_protocolGetFlags(const uint8_t *header)
+{
+   ciaaPOSIX_assert(NULL != header);
+   return header[0] & 0xF0;
+}
+uint16_t UPDT_protocolGetFrameSize(const uint8_t *header)
+{
+   ciaaPOSIX_assert(NULL != header);
+   return UPDT_PROTOCOL_HEADER_SIZE + UPDT_protocolGetPayloadSize(header) +
+      ((UPDT_protocolGetFlags(header) & UPDT_PROTOCOL_FLAG_CRC) ? UPDT_PROTOCOL_CRC_SIZE : 0);
+}
+uint16_t UPDT_protocolGetPayloadSize(const uint8_t *header)
+{
+   ciaaPOSIX_assert(NULL != header);
+   return  ((uint16_t) header[3]) << 3;
+}
+uint8_t UPDT_protocolGetSequenceNumber(const uint8_t *header)
+{
+   ciaaPOSIX_assert(NULL != header);
+
+   return header[2];
+}
+
+void UPDT_protocolSetHeader(
+   uint8_t *header,
+   uint8_t packet_type,
+   uint8_t sequence_number,
+   uint16_t payload_size)
+{
+   ciaaPOSIX_assert(NULL != header);
+   /* payload must be size multiple of 8 and smaller than 2048 */
+   ciaaPOSIX_assert(0 == (payload_size & 0xF807));
+
+   header[0] = (header[0] & 0xF0) | (packet_type & 0x0F);
+   header[1] = 0;
+   header[2] = sequence_number;
+   header[3] = (uint8_t) (payload_size >> 3);
+}
+
+int32_t UPDT_protocolRecvv(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count)
+{
+   return UPDT_protocolTransferv(transport, iov, count, 0);
+}
+
+int32_t UPDT_protocolSendv(
+   UPDT_ITransportType *transport,
+   const UPDT_ITransportIoVecType *iov,
+   size_t count)
+{
+   return UPDT_protocolTransferv(transport, iov, count, 1);
+}
+
+int32_t UPDT_protocolSendFrame(
+   UPDT_ITransportType *transport,
+   const uint8_t *header,
+   const uint8_t *payload)
+{
+   uint8_t trailer[UPDT_PROTOCOL_CRC_SIZE];
+   UPDT_ITransportIoVecType iov[3];
+   uint16_t payload_size;
+   uint32_t crc;
+
+   ciaaPOSIX_assert(NULL != header);
+
+   payload_size = UPDT_protocolGetPayloadSize(header);
+   ciaaPOSIX_assert(NULL != payload || 0 == payload_size);
+
+   iov[0].base = (uint8_t *) header;
+   iov[0].size = UPDT_PROTOCOL_HEADER_SIZE;
+   iov[1].base = (uint8_t *) payload;
+   iov[1].size = payload_size;
+   iov[2].base = trailer;
+   iov[2].size = 0;
+   if(UPDT_protocolGetFlags(header) & UPDT_PROTOCOL_FLAG_CRC)
+   {
+      crc = UPDT_crc32cUpdate(0, header, UPDT_PROTOCOL_HEADER_SIZE);
+      UPDT_crc32cSet(trailer, UPDT_crc32cUpdate(crc, payload, payload_size));
+      iov[2].size = UPDT_PROTOCOL_CRC_SIZE;
+   }
+   return UPDT_protocolSendv(transport, iov, 3);
+}
+
+void UPDT_protocolSetFlags(uint8_t *header, uint8_t flags)
+{
+   ciaaPOSIX_assert(NULL != header);
+   ciaaPOSIX_assert(0 == (flags & 0x0F));
+
+   header[0] = (header[0] & 0x0F) | flags;
+}
+
+void UPDT_protocolSetCrc(uint8_t *frame)
+{
+   uint16_t payload_size;
+
+   ciaaPOSIX_assert(NULL != frame);
+
+   /* the flag is part of the protected data */
+   frame[0] |= UPDT_PROTOCOL_FLAG_CRC;
+   payload_size = UPDT_protocolGetPayloadSize(frame);
+   UPDT_crc32cSet(frame + UPDT_PROTOCOL_HEADER_SIZE + payload_size,
+      UPDT_crc32cUpdate(0, frame, UPDT_PROTOCOL_HEADER_SIZE + payload_size));
+}
+
+int32_t UPDT_protocolCheckCrc(const uint8_t *frame)
+{
+   uint16_t payload_size;
+
+   ciaaPOSIX_assert(NULL != frame);
+
+   if(0 == (UPDT_protocolGetFlags(frame) & UPDT_PROTOCOL_FLAG_CRC))
+   {
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   payload_size = UPDT_protocolGetPayloadSize(frame);
+   if(UPDT_crc32cUpdate(0, frame, UPDT_PROTOCOL_HEADER_SIZE + payload_size) !=
+      UPDT_crc32cGet(frame + UPDT_PROTOCOL_HEADER_SIZE + payload_size))
+   {
+      return UPDT_PROTOCOL_ERROR_CRC;
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+int32_t UPDT_protocolRecv(
+   UPDT_ITransportType *transport,
+   uint8_t *buffer,
+   size_t size)
+{
+   ssize_t ret;
+   size_t bytes_read = 0;
+   int32_t result = UPDT_PROTOCOL_ERROR_NONE;
+
+   ciaaPOSIX_assert(NULL != buffer);
+
+   if(0 == size)
+   {
+      return 0;
+   }
+   UPDT_TRACE_BEGIN(UPDT_TRACE_EVENT_RECV, size);
+   /* read the specified number of bytes */
+   while(bytes_read < size)
+   {
+      ret = transport->recv(transport, buffer + bytes_read, size - bytes_read);
+      if(ret < 0)
+      {
+         result = UPDT_PROTOCOL_ERROR_TRANSPORT;
+         break;
+      }
+      if(0 == ret)
+      {
+         /* the deadline passed */
+         result = UPDT_PROTOCOL_ERROR_TIMEOUT;
+         break;
+      }
+      bytes_read += ret;
+   }
+   UPDT_TRACE_END(UPDT_TRACE_EVENT_RECV, bytes_read);
+   return result;
+}
+
+int32_t UPDT_protocolSend(
+   UPDT_ITransportType *transport,
+   const uint8_t *buffer,
+   size_t size)
+{
+   ssize_t ret;
+   size_t bytes_sent = 0;
+   int32_t result = UPDT_PROTOCOL_ERROR_NONE;
+
+   ciaaPOSIX_assert(NULL != buffer);
+
+   if(0 == size)
+   {
+      return 0;
+   }
+   UPDT_TRACE_BEGIN(UPDT_TRACE_EVENT_SEND, size);
+   /* send the specified number of bytes */
+   while(bytes_sent < size)
+   {
+      ret = transport->send(transport, buffer + bytes_sent, size - bytes_sent);
+      if(ret < 0)
+      {
+         result = UPDT_PROTOCOL_ERROR_TRANSPORT;
+         break;
+      }
+      if(0 == ret)
+      {
+         result = UPDT_PROTOCOL_ERROR_TIMEOUT;
+         break;
+      }
+      bytes_sent += ret;
+   }
+   UPDT_TRACE_END(UPDT_TRACE_EVENT_SEND, bytes_sent);
+   return result;
+}
+
+int32_t UPDT_protocolRecvConsume(
+   UPDT_ITransportType *transport,
+   size_t size,
+   UPDT_protocolConsumerType consumer,
+   void *context)
+{
+   uint8_t bounce[UPDT_PROTOCOL_BOUNCE_SIZE];
+   const void *data;
+   size_t offset = 0;
+   ssize_t ret;
+   int32_t error = UPDT_PROTOCOL_ERROR_NONE;
+
+   ciaaPOSIX_assert(NULL != transport);
+
+   while(offset < size && UPDT_PROTOCOL_ERROR_NONE == error)
+   {
+      if(NULL != transport->recv_acquire)
+      {
+         /* the consumer reads the bytes where the transport stored them */
+         ret = transport->recv_acquire(transport, &data, size - offset);
+         if(ret <= 0)
+         {
+            return 0 == ret ? UPDT_PROTOCOL_ERROR_TIMEOUT : UPDT_PROTOCOL_ERROR_TRANSPORT;
+         }
+         if(NULL != consumer)
+         {
+            error = consumer(context, offset, data, ret);
+         }
+         transport->recv_release(transport, ret);
+      }
+      else
+      {
+         ret = transport->recv(transport, bounce,
+            size - offset < sizeof(bounce) ? size - offset : sizeof(bounce));
+         if(ret <= 0)
+         {
+            return 0 == ret ? UPDT_PROTOCOL_ERROR_TIMEOUT : UPDT_PROTOCOL_ERROR_TRANSPORT;
+         }
+         if(NULL != consumer)
+         {
+            error = consumer(context, offset, bounce, ret);
+         }
+      }
+      offset += ret;
+   }
+   return error;
+}
+
+void UPDT_protocolSetCapabilities(
+   uint8_t *payload,
+   const UPDT_protocolCapabilitiesType *capabilities)
+{
+   ciaaPOSIX_assert(NULL != payload);
+   ciaaPOSIX_assert(NULL != capabilities);
+   ciaaPOSIX_assert(0 == (capabilities->payload_size & 0xF807));
+
+   /* the payload size uses the same encoding as the header */
+   payload[0] = (uint8_t) (capabilities->payload_size >> 3);
+   payload[1] = capabilities->window_size;
+   payload[2] = capabilities->flags;
+   payload[3] = capabilities->baud_rate;
+}
+
+void UPDT_protocolGetCapabilities(
+   const uint8_t *payload,
+   UPDT_protocolCapabilitiesType *capabilities)
+{
+   ciaaPOSIX_assert(NULL != payload);
+   ciaaPOSIX_assert(NULL != capabilities);
+
+   capabilities->payload_size = ((uint16_t) payload[0]) << 3;
+   capabilities->window_size = payload[1];
+   capabilities->flags = payload[2];
+   capabilities->baud_rate = payload[3];
+
+   /* a peer that does not negotiate uses stop and wait and default frames */
+   if(0 == capabilities->payload_size)
+   {
+      capabilities->payload_size = UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE;
+   }
+   if(0 == capabilities->window_size)
+   {
+      capabilities->window_size = 1;
+   }
+}
+
+void UPDT_protocolNegotiate(
+   const UPDT_protocolCapabilitiesType *local,
+   const UPDT_protocolCapabilitiesType *remote,
+   UPDT_protocolCapabilitiesType *agreed)
+{
+   ciaaPOSIX_assert(NULL != local);
+   ciaaPOSIX_assert(NULL != remote);
+   ciaaPOSIX_assert(NULL != agreed);
+
+   agreed->payload_size = local->payload_size < remote->payload_size ?
+      local->payload_size : remote->payload_size;
+   agreed->payload_size = UPDT_PROTOCOL_PAYLOAD_ALIGN(agreed->payload_size);
+   agreed->window_size = local->window_size < remote->window_size ?
+      local->window_size : remote->window_size;
+   agreed->flags = local->flags & remote->flags;
+   agreed->baud_rate = local->baud_rate < remote->baud_rate ?
+      local->baud_rate : remote->baud_rate;
+}
+
+uint32_t UPDT_protocolGetBaudRate(uint8_t code)
+{
+   static const uint32_t rates[] =
+   {
+      0, 115200, 230400, 460800, 921600, 1000000, 2000000, 3000000, 4000000,
+   };
+
+   return code < sizeof(rates) / sizeof(rates[0]) ? rates[code] : 0;
+}
+
+void UPDT_protocolSetResume(uint8_t *payload, uint32_t offset, uint32_t image_crc)
+{
+   ciaaPOSIX_assert(NULL != payload);
+
+   /* little endian, like the CRC */
+   payload[0] = (uint8_t) offset;
+   payload[1] = (uint8_t) (offset >> 8);
+   payload[2] = (uint8_t) (offset >> 16);
+   payload[3] = (uint8_t) (offset >> 24);
+   UPDT_crc32cSet(payload + 4, image_crc);
+}
+
+uint32_t UPDT_protocolGetResume(
+   const uint8_t *payload,
+   const uint8_t *image,
+   size_t size,
+   uint32_t *image_crc)
+{
+   uint32_t offset;
+   uint32_t crc;
+
+   ciaaPOSIX_assert(NULL != payload);
+   ciaaPOSIX_assert(NULL != image || 0 == size);
+   ciaaPOSIX_assert(NULL != image_crc);
+
+   offset = (uint32_t) payload[0] | ((uint32_t) payload[1] << 8) |
+      ((uint32_t) payload[2] << 16) | ((uint32_t) payload[3] << 24);
+   *image_crc = 0;
+   if(0 == offset || offset > size)
+   {
+      return 0;
+   }
+   crc = UPDT_crc32cUpdate(0, image, offset);
+   if(crc != UPDT_crc32cGet(payload + 4))
+   {
+      return 0;
+   }
+   *image_crc = crc;
+   return offset;
+}
+
+void UPDT_protocolSetStats(uint8_t *payload, const UPDT_protocolStatsType *stats)
+{
+   /* the statistics only have uint32_t fields, see UPDT_protocolStatsCheckType */
+   const uint32_t *words = (const uint32_t *) stats;
+   size_t i;
+
+   ciaaPOSIX_assert(NULL != payload);
+   ciaaPOSIX_assert(NULL != stats);
+
+   ciaaPOSIX_memset(payload, 0, UPDT_PROTOCOL_PACKET_STA_PAYLOAD_SIZE);
+   for(i = 0; i < sizeof(*stats) / sizeof(uint32_t); i++)
+   {
+      payload[4 * i] = (uint8_t) words[i];
+      payload[4 * i + 1] = (uint8_t) (words[i] >> 8);
+      payload[4 * i + 2] = (uint8_t) (words[i] >> 16);
+      payload[4 * i + 3] = (uint8_t) (words[i] >> 24);
+   }
+}
+
+void UPDT_protocolGetStats(const uint8_t *payload, UPDT_protocolStatsType *stats)
+{
+   uint32_t *words = (uint32_t *) stats;
+   size_t i;
+
+   ciaaPOSIX_assert(NULL != payload);
+   ciaaPOSIX_assert(NULL != stats);
+
+   for(i = 0; i < sizeof(*stats) / sizeof(uint32_t); i++)
+   {
+      words[i] = (uint32_t) payload[4 * i] | ((uint32_t) payload[4 * i + 1] << 8) |
+         ((uint32_t) payload[4 * i + 2] << 16) | ((uint32_t) payload[4 * i + 3] << 24);
+   }
+}
+
+int32_t UPDT_protocolSessionInit(
+   UPDT_protocolSessionType *session,
+   UPDT_ITransportType *transport,
+   uint8_t *frames,
+   size_t frame_size,
+   uint8_t window_size,
+   uint8_t sequence_number)
+{
+   ciaaPOSIX_assert(NULL != session);
+   ciaaPOSIX_assert(NULL != transport);
+   ciaaPOSIX_assert(0 < window_size && window_size <= UPDT_PROTOCOL_WINDOW_MAX_SIZE);
+   ciaaPOSIX_assert(NULL == frames || UPDT_PROTOCOL_FRAME_SIZE(0) <= frame_size);
+
+   session->transport = transport;
+   session->frames = frames;
+   session->frame_size = frame_size;
+   if(NULL != frames)
+   {
+      session->payload_size = UPDT_PROTOCOL_PAYLOAD_ALIGN(frame_size - UPDT_PROTOCOL_FRAME_SIZE(0));
+   }
+   else
+   {
+      session->payload_size = UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE;
+   }
+   session->window_size = window_size;
+   session->base_slot = 0;
+   session->base = sequence_number;
+   session->next = sequence_number;
+   session->recover = sequence_number;
+   session->recovering = 0;
+   session->expected = sequence_number;
+   session->flags = 0;
+   session->image_crc = 0;
+   session->timeout = 0;
+   session->retries = 0;
+   session->expiry = 0;
+   session->acked = sequence_number - 1;
+   session->defer_ack = 0;
+   session->stats = NULL;
+   session->query = NULL;
+   session->cipher = NULL;
+   session->cipher_context = NULL;
+   session->ciphered = 0;
+   session->fec = NULL;
+   session->fec_first = sequence_number;
+   UPDT_ITransportDeadlineInit(&session->deadline, transport);
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+int32_t UPDT_protocolSessionSetCapabilities(
+   UPDT_protocolSessionType *session,
+   const UPDT_protocolCapabilitiesType *agreed)
+{
+   ciaaPOSIX_assert(NULL != session);
+   ciaaPOSIX_assert(NULL != agreed);
+
+   /* the frames sent so far were sized for the previous values */
+   if(session->base != session->next ||
+      0 == agreed->payload_size || 0 == agreed->window_size)
+   {
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+   if(agreed->payload_size < session->payload_size)
+   {
+      session->payload_size = agreed->payload_size;
+   }
+   if(agreed->window_size < session->window_size)
+   {
+      session->window_size = agreed->window_size;
+      session->base_slot = 0;
+   }
+   if(agreed->flags & UPDT_PROTOCOL_CAPABILITY_CRC)
+   {
+      session->flags |= UPDT_PROTOCOL_FLAG_CRC;
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+void UPDT_protocolSessionSetCipher(
+   UPDT_protocolSessionType *session,
+   UPDT_protocolCipherType cipher,
+   void *context)
+{
+   ciaaPOSIX_assert(NULL != session);
+
+   session->cipher = cipher;
+   session->cipher_context = context;
+   session->ciphered = 0;
+}
+
+int32_t UPDT_protocolSessionSetFec(UPDT_protocolSessionType *session, UPDT_fecType *fec)
+{
+   ciaaPOSIX_assert(NULL != session);
+
+   /* a sender must be able to send a whole group before it waits */
+   if(session->base != session->next ||
+      (NULL != fec && (fec->block_size != session->payload_size ||
+      (NULL != session->frames && fec->data > session->window_size))))
+   {
+      return UPDT_PROTOCOL_ERROR_PACKET;
+   }
+   session->fec = fec;
+   session->fec_first = session->expected;
+   if(NULL != fec)
+   {
+      UPDT_fecReset(fec);
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+void UPDT_protocolSessionSetTimeout(UPDT_protocolSessionType *session, uint32_t timeout)
+{
+   ciaaPOSIX_assert(NULL != session);
+
+   session->timeout = timeout;
+   session->retries = 0;
+   UPDT_protocolSessionRestart(session);
+   if(0 != timeout)
+   {
+      /* the calls go through the decorator, which bounds their waits */
+      session->transport = &session->deadline.transport;
+   }
+   else
+   {
+      UPDT_ITransportDeadlineCancel(&session->deadline);
+      session->transport = session->deadline.inner;
+   }
+}
+
+void UPDT_protocolSessionSetStats(UPDT_protocolSessionType *session, UPDT_protocolStatsType *stats)
+{
+   UPDT_ITransportType *transport;
+
+   ciaaPOSIX_assert(NULL != session);
+
+   /* transport given to UPDT_protocolSessionInit */
+   transport = NULL != session->stats ? session->counter.inner : session->deadline.inner;
+   session->stats = stats;
+   if(NULL != stats)
+   {
+      ciaaPOSIX_memset(stats, 0, sizeof(*stats));
+      UPDT_ITransportCounterInit(&session->counter, transport, &stats->transport);
+      transport = &session->counter.transport;
+   }
+   UPDT_ITransportDeadlineInit(&session->deadline, transport);
+   UPDT_protocolSessionSetTimeout(session, session->timeout);
+}
+
+void UPDT_protocolSessionGetStats(const UPDT_protocolSessionType *session, UPDT_protocolStatsType *stats)
+{
+   ciaaPOSIX_assert(NULL != session);
+   ciaaPOSIX_assert(NULL != stats);
+
+   if(NULL != session->stats)
+   {
+      *stats = *session->stats;
+   }
+   else
+   {
+      ciaaPOSIX_memset(stats, 0, sizeof(*stats));
+   }
+}
+
+int32_t UPDT_protocolSessionSendStats(UPDT_protocolSessionType *session)
+{
+   uint8_t frame[UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PACKET_STA_PAYLOAD_SIZE)] = {0};
+   UPDT_protocolStatsType stats;
+
+   ciaaPOSIX_assert(NULL != session);
+
+   /* carries the sequence number of the request, like its acknowledgement */
+   UPDT_protocolSetHeader(frame, UPDT_PROTOCOL_PACKET_STA, session->expected - 1,
+      UPDT_PROTOCOL_PACKET_STA_PAYLOAD_SIZE);
+   /* the answer itself is accounted before the snapshot */
+   UPDT_protocolSessionCountSent(session, frame);
+   UPDT_protocolSessionGetStats(session, &stats);
+   UPDT_protocolSetStats(frame + UPDT_PROTOCOL_HEADER_SIZE, &stats);
+   if(session->flags & UPDT_PROTOCOL_FLAG_CRC)
+   {
+      UPDT_protocolSetCrc(frame);
+   }
+   UPDT_protocolSessionArm(session);
+   return UPDT_protocolSend(session->transport, frame, UPDT_protocolGetFrameSize(frame));
+}
+
+int32_t UPDT_protocolSessionQueryStats(UPDT_protocolSessionType *session, UPDT_protocolStatsType *remote)
+{
+   int32_t ret;
+
+   ciaaPOSIX_assert(NULL != session);
+   ciaaPOSIX_assert(NULL != remote);
+
+   ret = UPDT_protocolSessionSend(session, UPDT_PROTOCOL_PACKET_STA, NULL, 0);
+   session->query = remote;
+   while(NULL != session->query && UPDT_PROTOCOL_ERROR_NONE == ret)
+   {
+      ret = UPDT_protocolSessionProcessAck(session);
+   }
+   session->query = NULL;
+   return ret;
+}
+
+void UPDT_protocolSessionSetDeferredAck(UPDT_protocolSessionType *session, uint8_t defer)
+{
+   ciaaPOSIX_assert(NULL != session);
+
+   session->defer_ack = defer;
+}
+
+int32_t UPDT_protocolSessionAck(UPDT_protocolSessionType *session, uint8_t sequence_number)
+{
+   ciaaPOSIX_assert(NULL != session);
+   ciaaPOSIX_assert(UPDT_PROTOCOL_SEQUENCE_DISTANCE(sequence_number, session->acked) <=
+      UPDT_protocolSessionUnacked(session));
+
+   if(sequence_number == session->acked)
+   {
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   return UPDT_protocolSessionSendAck(session, sequence_number);
+}
+
+uint8_t UPDT_protocolSessionUnacked(const UPDT_protocolSessionType *session)
+{
+   ciaaPOSIX_assert(NULL != session);
+
+   return UPDT_PROTOCOL_SEQUENCE_DISTANCE(session->expected - 1, session->acked);
+}
+
+int32_t UPDT_protocolSessionSend(
+   UPDT_protocolSessionType *session,
+   uint8_t packet_type,
+   const uint8_t *payload,
+   uint16_t payload_size)
+{
+   uint8_t prefix[UPDT_PROTOCOL_FEC_PREFIX_SIZE];
+   uint8_t *frame;
+   uint8_t flags = packet_type & 0xF0;
+   uint16_t frame_payload_size = payload_size;
+   int32_t ret;
+
+   ciaaPOSIX_assert(NULL != session);
+   ciaaPOSIX_assert(NULL != session->frames);
+   ciaaPOSIX_assert(NULL != payload || 0 == payload_size);
+
+   if(NULL != session->cipher && UPDT_PROTOCOL_PACKET_DAT == (packet_type & 0x0F))
+   {
+      flags |= UPDT_PROTOCOL_FLAG_ENCRYPTED;
+      frame_payload_size += UPDT_PROTOCOL_TAG_SIZE;
+   }
+   ciaaPOSIX_assert(frame_payload_size <= session->payload_size);
+   if(NULL != session->fec && UPDT_PROTOCOL_PACKET_DAT == (packet_type & 0x0F))
+   {
+      /* the FEC block of the frame must fit in a PAR frame */
+      ciaaPOSIX_assert(UPDT_PROTOCOL_FEC_PREFIX_SIZE + frame_payload_size <= session->payload_size);
+   }
+   else if(NULL != session->fec && 0 != session->fec->present)
+   {
+      /* the receiver can not go past a missing DAT frame anyway */
+      ret = UPDT_protocolSessionSendParity(session);
+      if(UPDT_PROTOCOL_ERROR_NONE != ret)
+      {
+         return ret;
+      }
+   }
+
+   /* wait for a free slot */
+   while(UPDT_PROTOCOL_SEQUENCE_DISTANCE(session->next, session->base) >= session->window_size)
+   {
+      ret = UPDT_protocolSessionProcessAck(session);
+      if(UPDT_PROTOCOL_ERROR_NONE != ret)
+      {
+         return ret;
+      }
+   }
+
+   /* keep a copy of the frame until it is acknowledged */
+   frame = UPDT_protocolSessionSlot(session, session->next);
+   frame[0] = 0;
+   UPDT_protocolSetHeader(frame, packet_type & 0x0F, session->next, frame_payload_size);
+   /* the header is final before it is authenticated */
+   UPDT_protocolSetFlags(frame, flags | (session->flags & UPDT_PROTOCOL_FLAG_CRC));
+   if(NULL != session->fec && UPDT_PROTOCOL_PACKET_DAT == (packet_type & 0x0F))
+   {
+      if(0 == session->fec->present)
+      {
+         session->fec_first = session->next;
+      }
+      /* position of the frame in its group */
+      frame[1] = UPDT_PROTOCOL_SEQUENCE_DISTANCE(session->next, session->fec_first);
+   }
+   if(0 < payload_size)
+   {
+      ciaaPOSIX_memcpy(frame + UPDT_PROTOCOL_HEADER_SIZE, payload, payload_size);
+   }
+   if(UPDT_PROTOCOL_PACKET_DAT == (packet_type & 0x0F))
+   {
+      session->image_crc = UPDT_crc32cUpdate(session->image_crc, payload, payload_size);
+   }
+   if(flags & UPDT_PROTOCOL_FLAG_ENCRYPTED)
+   {
+      /* once, the retransmissions send the encrypted slot */
+      ret = session->cipher(session->cipher_context, frame, frame + UPDT_PROTOCOL_HEADER_SIZE,
+         session->ciphered++);
+      if(UPDT_PROTOCOL_ERROR_NONE != ret)
+      {
+         return ret;
+      }
+   }
+   if(session->flags & UPDT_PROTOCOL_FLAG_CRC)
+   {
+      UPDT_protocolSetCrc(frame);
+   }
+   if(NULL != session->fec && UPDT_PROTOCOL_PACKET_DAT == (packet_type & 0x0F))
+   {
+      /* the FEC block of the frame as it is sent */
+      UPDT_protocolFecSetPrefix(prefix, frame);
+      UPDT_fecEncode(session->fec, frame[1], 0, prefix, sizeof(prefix));
+      UPDT_fecEncode(session->fec, frame[1], sizeof(prefix), frame + UPDT_PROTOCOL_HEADER_SIZE,
+         frame_payload_size);
+   }
+   if(session->base == session->next)
+   {
+      /* the first frame in flight starts the retransmission timer */
+      UPDT_protocolSessionRestart(session);
+   }
+   session->next++;
+
+   UPDT_protocolSessionCountSent(session, frame);
+   UPDT_protocolSessionArm(session);
+   ret = UPDT_protocolSend(session->transport, frame, UPDT_protocolGetFrameSize(frame));
+   if(UPDT_PROTOCOL_ERROR_NONE == ret && NULL != session->fec && 0 != session->fec->present &&
+      UPDT_PROTOCOL_SEQUENCE_DISTANCE(session->next, session->fec_first) == session->fec->data)
+   {
+      ret = UPDT_protocolSessionSendParity(session);
+   }
+   return ret;
+}
+
+int32_t UPDT_protocolSessionFlush(UPDT_protocolSessionType *session)
+{
+   int32_t ret = UPDT_PROTOCOL_ERROR_NONE;
+
+   ciaaPOSIX_assert(NULL != session);
+
+   if(NULL != session->fec && 0 != session->fec->present)
+   {
+      ret = UPDT_protocolSessionSendParity(session);
+   }
+   while(session->base != session->next && UPDT_PROTOCOL_ERROR_NONE == ret)
+   {
+      ret = UPDT_protocolSessionProcessAck(session);
+   }
+   return ret;
+}
+
+int32_t UPDT_protocolSessionRecv(
+   UPDT_protocolSessionType *session,
+   uint8_t *header,
+   uint8_t *payload,
+   size_t size)
+{
+   return UPDT_protocolSessionRecvFrame(session, header, payload, size, NULL, NULL);
+}
+
+int32_t UPDT_protocolSessionRecvConsume(
+   UPDT_protocolSessionType *session,
+   uint8_t *header,
+   size_t size,
+   UPDT_protocolConsumerType consumer,
+   void *context)
+{
+   ciaaPOSIX_assert(NULL != consumer);
+   ciaaPOSIX_assert(NULL == session->cipher);
+   ciaaPOSIX_assert(NULL == session->fec);
+
+   return UPDT_protocolSessionRecvFrame(session, header, NULL, size, consumer, context);
+}
+
+void UPDT_protocolStreamInit(
+   UPDT_protocolStreamType *stream,
+   UPDT_ITransportType *transport,
+   uint8_t *buffer,
+   size_t size,
+   UPDT_protocolFrameCallbackType callback,
+   void *context)
+{
+   ciaaPOSIX_assert(NULL != stream);
+   ciaaPOSIX_assert(NULL != buffer);
+   ciaaPOSIX_assert(NULL != callback);
+   ciaaPOSIX_assert(size >= UPDT_PROTOCOL_HEADER_SIZE);
+
+   stream->transport = transport;
+   stream->buffer = buffer;
+   stream->buffer_size = size;
+   stream->count = 0;
+   stream->skip = 0;
+   stream->frames = 0;
+   stream->callback = callback;
+   stream->context = context;
+   stream->tx_data = NULL;
+   stream->tx_size = 0;
+}
+
+int32_t UPDT_protocolFeed(
+   UPDT_protocolStreamType *stream,
+   const uint8_t *data,
+   size_t size)
+{
+   size_t chunk;
+   int32_t ret;
+
+   ciaaPOSIX_assert(NULL != stream);
+   ciaaPOSIX_assert(NULL != data || 0 == size);
+
+   while(0 < size)
+   {
+      chunk = UPDT_protocolStreamNeed(stream);
+      if(chunk > size)
+      {
+         chunk = size;
+      }
+      if(0 == stream->skip)
+      {
+         ciaaPOSIX_memcpy(stream->buffer + stream->count, data, chunk);
+      }
+      data += chunk;
+      size -= chunk;
+      ret = UPDT_protocolStreamAdvance(stream, chunk);
+      if(UPDT_PROTOCOL_ERROR_NONE != ret)
+      {
+         return ret;
+      }
+   }
+   return (0 == stream->count && 0 == stream->skip) ?
+      UPDT_PROTOCOL_ERROR_NONE : UPDT_PROTOCOL_ERROR_AGAIN;
+}
+
+int32_t UPDT_protocolPoll(UPDT_protocolStreamType *stream)
+{
+   uint8_t bounce[UPDT_PROTOCOL_BOUNCE_SIZE];
+   uint32_t frames;
+   size_t chunk;
+   ssize_t ret;
+   int32_t error;
+
+   ciaaPOSIX_assert(NULL != stream);
+   ciaaPOSIX_assert(NULL != stream->transport);
+
+   error = UPDT_protocolStreamFlush(stream);
+   if(UPDT_PROTOCOL_ERROR_TRANSPORT == error)
+   {
+      return error;
+   }
+
+   frames = stream->frames;
+   do
+   {
+      chunk = UPDT_protocolStreamNeed(stream);
+      if(0 < stream->skip)
+      {
+         chunk = chunk < sizeof(bounce) ? chunk : sizeof(bounce);
+         ret = stream->transport->recv(stream->transport, bounce, chunk);
+      }
+      else
+      {
+         ret = stream->transport->recv(stream->transport, stream->buffer + stream->count, chunk);
+      }
+      if(ret < 0)
+      {
+         return UPDT_PROTOCOL_ERROR_TRANSPORT;
+      }
+      error = UPDT_protocolStreamAdvance(stream, ret);
+      if(UPDT_PROTOCOL_ERROR_NONE != error)
+      {
+         return error;
+      }
+      if(frames != stream->frames)
+      {
+         return UPDT_PROTOCOL_ERROR_NONE;
+      }
+      /* a short read means the transport has nothing else by now */
+   } while((size_t) ret == chunk);
+
+   return UPDT_PROTOCOL_ERROR_AGAIN;
+}
+
+int32_t UPDT_protocolStreamSend(
+   UPDT_protocolStreamType *stream,
+   const uint8_t *frame,
+   size_t size)
+{
+   ciaaPOSIX_assert(NULL != stream);
+   ciaaPOSIX_assert(NULL != stream->transport);
+   ciaaPOSIX_assert(NULL != frame);
+
+   if(0 < stream->tx_size)
+   {
+      return UPDT_PROTOCOL_ERROR_AGAIN;
+   }
+   stream->tx_data = frame;
+   stream->tx_size = size;
+   return UPDT_protocolStreamFlush(stream);
+}
+
+size_t UPDT_protocolStreamPending(const UPDT_protocolStreamType *stream)
+{
+   ciaaPOSIX_assert(NULL != stream);
+
+   return stream->tx_size;
+}
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /*==================[end of file]============================================*/
@@ -0,0 +1,204 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the Flash Update Resume
+ **
+ ** Tracks the image bytes written by the slave and stores checkpoints, so
+ ** an interrupted transfer continues where it stopped.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Resume
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_assert.h"
+#include "UPDT_resume.h"
+#include "UPDT_crc32c.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Stores the committed state. */
+static int32_t UPDT_resumeSave(UPDT_resumeType *resume)
+{
+   uint8_t record[UPDT_RESUME_RECORD_SIZE];
+
+   UPDT_crc32cSet(record, resume->image_id);
+   UPDT_crc32cSet(record + 4, resume->image_size);
+   UPDT_crc32cSet(record + 8, resume->offset);
+   UPDT_crc32cSet(record + 12, resume->image_crc);
+   UPDT_crc32cSet(record + 16, UPDT_crc32cUpdate(0, record, 16));
+   resume->saved = resume->offset;
+   return resume->save(resume->store, record);
+}
+
+/*==================[external functions definition]==========================*/
+void UPDT_resumeInit(
+   UPDT_resumeType *resume,
+   UPDT_resumeLoadType load,
+   UPDT_resumeSaveType save,
+   void *store,
+   uint32_t period,
+   UPDT_protocolConsumerType consumer,
+   void *context)
+{
+   ciaaPOSIX_assert(NULL != resume);
+   ciaaPOSIX_assert(NULL != load);
+   ciaaPOSIX_assert(NULL != save);
+   ciaaPOSIX_assert(NULL != consumer);
+
+   resume->load = load;
+   resume->save = save;
+   resume->store = store;
+   resume->image_id = 0;
+   resume->image_size = 0;
+   resume->offset = 0;
+   resume->image_crc = 0;
+   resume->pending_crc = 0;
+   resume->saved = 0;
+   resume->period = period;
+   resume->consumer = consumer;
+   resume->context = context;
+}
+
+uint32_t UPDT_resumeStart(UPDT_resumeType *resume, uint32_t image_id, uint32_t image_size)
+{
+   uint8_t record[UPDT_RESUME_RECORD_SIZE];
+
+   ciaaPOSIX_assert(NULL != resume);
+
+   resume->image_id = image_id;
+   resume->image_size = image_size;
+   resume->offset = 0;
+   resume->image_crc = 0;
+
+   /* a torn or foreign record means starting again */
+   if(UPDT_PROTOCOL_ERROR_NONE == resume->load(resume->store, record) &&
+      UPDT_crc32cGet(record + 16) == UPDT_crc32cUpdate(0, record, 16) &&
+      UPDT_crc32cGet(record) == image_id &&
+      UPDT_crc32cGet(record + 4) == image_size &&
+      UPDT_crc32cGet(record + 8) <= image_size)
+   {
+      resume->offset = UPDT_crc32cGet(record + 8);
+      resume->image_crc = UPDT_crc32cGet(record + 12);
+   }
+   resume->pending_crc = resume->image_crc;
+   resume->saved = resume->offset;
+   return resume->offset;
+}
+
+int32_t UPDT_resumeConsume(
+   void *context,
+   size_t offset,
+   const uint8_t *data,
+   size_t size)
+{
+   UPDT_resumeType *resume = (UPDT_resumeType *) context;
+   size_t position;
+
+   ciaaPOSIX_assert(NULL != resume);
+
+   if(0 == offset)
+   {
+      /* a new frame, or the retransmission of a bad one */
+      resume->pending_crc = resume->image_crc;
+   }
+   position = resume->offset + offset;
+   if(position >= resume->image_size)
+   {
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   if(size > resume->image_size - position)
+   {
+      size = resume->image_size - position;
+   }
+   resume->pending_crc = UPDT_crc32cUpdate(resume->pending_crc, data, size);
+   return resume->consumer(resume->context, position, data, size);
+}
+
+int32_t UPDT_resumeCommit(UPDT_resumeType *resume, size_t size)
+{
+   ciaaPOSIX_assert(NULL != resume);
+
+   if(size > resume->image_size - resume->offset)
+   {
+      size = resume->image_size - resume->offset;
+   }
+   resume->offset += size;
+   resume->image_crc = resume->pending_crc;
+   if(resume->offset - resume->saved >= resume->period ||
+      resume->offset == resume->image_size)
+   {
+      return UPDT_resumeSave(resume);
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+int32_t UPDT_resumeClear(UPDT_resumeType *resume)
+{
+   ciaaPOSIX_assert(NULL != resume);
+
+   resume->offset = 0;
+   resume->image_crc = 0;
+   resume->pending_crc = 0;
+   return UPDT_resumeSave(resume);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
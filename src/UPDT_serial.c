@@ -2,6 +2,7 @@
  * Copyright 2015, Esteban Volentini
  * Copyright 2015, Matias Giori
  * Copyright 2015, Franco Salinas
+ * Copyright 2026, agent
  *
  * This file is part of CIAA Firmware.
  *
@@ -38,7 +39,6 @@
  ** This file implements the Flash Update serial transport layer. It should
  ** be used for debug proposes only.
  **
- ** \todo change the serial struct. add a void * field to the transport struct.
  **/
 
 /** \addtogroup CIAA_Firmware CIAA Firmware
@@ -53,11 +53,18 @@
  * EV           Esteban Volentini
  * MG           Matias Giori
  * FS           Franco Salinas
+ * AG           agent
  */
 
 /*
  * modification history (new versions first)
  * -----------------------------------------------------------
+ * 20261017 v0.0.8  AG  clear the optional transport entries with UPDT_ITransportInit
+ * 20261017 v0.0.7  AG  add trace points
+ * 20261017 v0.0.6  AG  add the configuration. modify API
+ * 20261017 v0.0.5  AG  add deadline aware calls
+ * 20261017 v0.0.4  AG  add zero copy receive
+ * 20261017 v0.0.3  AG  embed the transport interface. add vectored IO
  * 20150419 v0.0.2  FS  change prefixes. modify API
  * 20150408 v0.0.1  FS  first initial version
  */
@@ -65,8 +72,11 @@
 /*==================[inclusions]=============================================*/
 #include "ciaaPOSIX_assert.h"
 #include "ciaaPOSIX_stdio.h"
+#include "ciaaPOSIX_unistd.h"
 #include "UPDT_ITransport.h"
 #include "UPDT_serial.h"
+#include "UPDT_time.h"
+#include "UPDT_trace.h"
 
 /*==================[macros and definitions]=================================*/
 
@@ -79,6 +89,198 @@
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+/** \brief Switches the device between blocking and non-blocking mode.
+ **
+ ** The ioctl is only issued when the mode changes, so consecutive calls of
+ ** the same kind cost nothing.
+ **/
+static void UPDT_serialSetNonBlocking(UPDT_serialType *self, uint8_t non_blocking)
+{
+   if(self->non_blocking != non_blocking)
+   {
+      ciaaPOSIX_ioctl(self->fd, ciaaPOSIX_IOCTL_SET_NONBLOCK_MODE, (void *) (uintptr_t) non_blocking);
+      self->non_blocking = non_blocking;
+   }
+}
+/** \brief Keeps reading until min_bytes arrive or the line is idle.
+ **
+ ** Emulates VMIN and VTIME, which ciaaPOSIX lacks, so the caller gets a
+ ** burst of bytes at once instead of a few per read.
+ **
+ ** \param self Serial structure.
+ ** \param data Buffer to receive.
+ ** \param size Size of the buffer.
+ ** \param count Bytes already in the buffer.
+ ** \return Number of bytes in the buffer.
+ **/
+static ssize_t UPDT_serialGather(UPDT_serialType *self, uint8_t *data, size_t size, size_t count)
+{
+   uint32_t idle = UPDT_timeNow() + self->config.gap_ms;
+   ssize_t ret;
+
+   UPDT_serialSetNonBlocking(self, 1);
+   while(count < size && count < self->config.min_bytes)
+   {
+      ret = ciaaPOSIX_read(self->fd, data + count, size - count);
+      if(ret < 0)
+      {
+         /* the bytes already read are returned, the error repeats next call */
+         break;
+      }
+      if(0 < ret)
+      {
+         count += ret;
+         idle = UPDT_timeNow() + self->config.gap_ms;
+      }
+      else if(0 == UPDT_timeRemaining(idle))
+      {
+         break;
+      }
+      else
+      {
+         ciaaPOSIX_usleep(UPDT_SERIAL_POLL_PERIOD_US);
+      }
+   }
+   return count;
+}
+/** \brief Applies a configuration to the device. */
+static int32_t UPDT_serialConfigure(UPDT_serialType *self, const UPDT_serialConfigType *config)
+{
+   if(0 != config->baud_rate &&
+      0 != ciaaPOSIX_ioctl(self->fd, ciaaPOSIX_IOCTL_SET_BAUDRATE, (void *) (uintptr_t) config->baud_rate))
+   {
+      return -1;
+   }
+   if(0 != config->fifo_level &&
+      0 != ciaaPOSIX_ioctl(self->fd, ciaaPOSIX_IOCTL_SET_FIFO_TRIGGER_LEVEL,
+         (void *) (uintptr_t) (config->fifo_level - 1)))
+   {
+      return -1;
+   }
+   if(0 != config->flow_control)
+   {
+#ifdef ciaaPOSIX_IOCTL_SET_FLOW_CONTROL
+      if(0 != ciaaPOSIX_ioctl(self->fd, ciaaPOSIX_IOCTL_SET_FLOW_CONTROL, (void *) (uintptr_t) 1))
+      {
+         return -1;
+      }
+#else
+      /* the driver can not do it */
+      return -1;
+#endif
+   }
+   self->config = *config;
+   return 0;
+}
+/** \brief Reads from the device.
+ **
+ ** ciaaPOSIX has no poll nor select, so a bounded read polls the device in
+ ** non-blocking mode, sleeping UPDT_SERIAL_POLL_PERIOD_US between attempts.
+ **
+ ** \param self Serial structure.
+ ** \param data Buffer to receive.
+ ** \param size Maximum number of bytes to receive.
+ ** \param deadline Deadline, NULL to block until something arrives.
+ ** \return Number of bytes received, 0 if the deadline passed. -1 on error.
+ **/
+static ssize_t UPDT_serialRead(UPDT_serialType *self, void *data, size_t size, const uint32_t *deadline)
+{
+   ssize_t ret;
+
+   UPDT_TRACE_BEGIN(UPDT_TRACE_EVENT_TRANSPORT_RECV, size);
+   if(NULL == deadline)
+   {
+      UPDT_serialSetNonBlocking(self, 0);
+      ret = ciaaPOSIX_read(self->fd, data, size);
+   }
+   else
+   {
+      UPDT_serialSetNonBlocking(self, 1);
+      while(0 == (ret = ciaaPOSIX_read(self->fd, data, size)) && 0 < size &&
+         0 < UPDT_timeRemaining(*deadline))
+      {
+         ciaaPOSIX_usleep(UPDT_SERIAL_POLL_PERIOD_US);
+      }
+   }
+   if(0 < ret && (size_t) ret < size && (size_t) ret < self->config.min_bytes)
+   {
+      ret = UPDT_serialGather(self, (uint8_t *) data, size, ret);
+   }
+   UPDT_TRACE_END(UPDT_TRACE_EVENT_TRANSPORT_RECV, ret);
+   return ret;
+}
+/** \brief Writes to the device.
+ **
+ ** \param self Serial structure.
+ ** \param data Data to send.
+ ** \param size Number of bytes to send.
+ ** \param deadline Deadline, NULL to block until something is sent.
+ ** \return Number of bytes sent, 0 if the deadline passed. -1 on error.
+ **/
+static ssize_t UPDT_serialWrite(UPDT_serialType *self, const void *data, size_t size, const uint32_t *deadline)
+{
+   ssize_t ret;
+
+   UPDT_TRACE_BEGIN(UPDT_TRACE_EVENT_TRANSPORT_SEND, size);
+   if(NULL == deadline)
+   {
+      UPDT_serialSetNonBlocking(self, 0);
+      ret = ciaaPOSIX_write(self->fd, data, size);
+   }
+   else
+   {
+      UPDT_serialSetNonBlocking(self, 1);
+      while(0 == (ret = ciaaPOSIX_write(self->fd, data, size)) && 0 < size &&
+         0 < UPDT_timeRemaining(*deadline))
+      {
+         ciaaPOSIX_usleep(UPDT_SERIAL_POLL_PERIOD_US);
+      }
+   }
+   UPDT_TRACE_END(UPDT_TRACE_EVENT_TRANSPORT_SEND, ret);
+   return ret;
+}
+/** \brief Receives, first the bytes left in the receive buffer. */
+static ssize_t UPDT_serialRecvBuffered(UPDT_serialType *self, void *data, size_t size, const uint32_t *deadline)
+{
+   if(self->rx_head < self->rx_tail)
+   {
+      /* bytes left by a partial release come first */
+      if(size > self->rx_tail - self->rx_head)
+      {
+         size = self->rx_tail - self->rx_head;
+      }
+      ciaaPOSIX_memcpy(data, self->rx_buffer + self->rx_head, size);
+      self->rx_head += size;
+      return size;
+   }
+   return UPDT_serialRead(self, data, size, deadline);
+}
+/** \brief Lends received bytes, reading them if the buffer is empty.
+ **
+ ** When the receive buffer is empty a single read fills it with whatever the
+ ** driver has, up to the buffer size.
+ **/
+static ssize_t UPDT_serialAcquire(UPDT_serialType *self, const void **data, size_t size, const uint32_t *deadline)
+{
+   ssize_t ret;
+
+   if(self->rx_head == self->rx_tail)
+   {
+      ret = UPDT_serialRead(self, self->rx_buffer, sizeof(self->rx_buffer), deadline);
+      if(ret <= 0)
+      {
+         return ret;
+      }
+      self->rx_head = 0;
+      self->rx_tail = ret;
+   }
+   if(size > self->rx_tail - self->rx_head)
+   {
+      size = self->rx_tail - self->rx_head;
+   }
+   *data = self->rx_buffer + self->rx_head;
+   return size;
+}
 /** \brief Sends a packet.
  **
  ** \param serial Serial structure.
@@ -90,7 +292,7 @@ ssize_t UPDT_serialSend(UPDT_ITransportType *serial, const void *data, size_t si
 {
    ciaaPOSIX_assert(NULL != serial);
 
-   return ciaaPOSIX_write(((UPDT_serialType *) serial)->fd, data, size);
+   return UPDT_serialWrite((UPDT_serialType *) serial, data, size, NULL);
 }
 /** \brief Receives a packet.
  **
@@ -103,26 +305,233 @@ ssize_t UPDT_serialRecv(UPDT_ITransportType *serial, void *data, size_t size)
 {
    ciaaPOSIX_assert(NULL != serial);
 
-   return ciaaPOSIX_read(((UPDT_serialType *) serial)->fd, data, size);
+   return UPDT_serialRecvBuffered((UPDT_serialType *) serial, data, size, NULL);
+}
+/** \brief Sends a packet before a deadline.
+ **
+ ** \param serial Serial structure.
+ ** \param data Data to send.
+ ** \param size Number of bytes to send.
+ ** \param deadline Deadline, a UPDT_timeNow value.
+ ** \return Number of bytes sent, 0 if the deadline passed. -1 on error.
+ **/
+static ssize_t UPDT_serialSendUntil(UPDT_ITransportType *serial, const void *data, size_t size, uint32_t deadline)
+{
+   ciaaPOSIX_assert(NULL != serial);
+
+   return UPDT_serialWrite((UPDT_serialType *) serial, data, size, &deadline);
+}
+/** \brief Receives a packet before a deadline.
+ **
+ ** \param serial Serial structure.
+ ** \param data Buffer to receive.
+ ** \param size Number of bytes to receive.
+ ** \param deadline Deadline, a UPDT_timeNow value.
+ ** \return Number of bytes received, 0 if the deadline passed. -1 on error.
+ **/
+static ssize_t UPDT_serialRecvUntil(UPDT_ITransportType *serial, void *data, size_t size, uint32_t deadline)
+{
+   ciaaPOSIX_assert(NULL != serial);
+
+   return UPDT_serialRecvBuffered((UPDT_serialType *) serial, data, size, &deadline);
+}
+/** \brief Sends several blocks with a single write.
+ **
+ ** ciaaPOSIX has no writev, so the blocks are gathered in the transmission
+ ** buffer. Vectors larger than the buffer are written block by block.
+ **
+ ** \param serial Serial structure.
+ ** \param iov Blocks to send.
+ ** \param count Number of blocks.
+ ** \return Number of bytes sent. -1 on error.
+ **/
+static ssize_t UPDT_serialSendv(UPDT_ITransportType *serial, const UPDT_ITransportIoVecType *iov, size_t count)
+{
+   UPDT_serialType *self = (UPDT_serialType *) serial;
+   ssize_t ret;
+   ssize_t total = 0;
+   size_t size = 0;
+   size_t i;
+
+   ciaaPOSIX_assert(NULL != serial);
+
+   for(i = 0; i < count; i++)
+   {
+      size += iov[i].size;
+   }
+   if(size <= sizeof(self->tx_buffer))
+   {
+      size = 0;
+      for(i = 0; i < count; i++)
+      {
+         ciaaPOSIX_memcpy(self->tx_buffer + size, iov[i].base, iov[i].size);
+         size += iov[i].size;
+      }
+      return UPDT_serialWrite(self, self->tx_buffer, size, NULL);
+   }
+
+   /* the vector does not fit, the copy would not save any write */
+   for(i = 0; i < count; i++)
+   {
+      if(0 == iov[i].size)
+      {
+         continue;
+      }
+      ret = UPDT_serialWrite(self, iov[i].base, iov[i].size, NULL);
+      if(ret < 0)
+      {
+         return 0 < total ? total : ret;
+      }
+      total += ret;
+      if((size_t) ret < iov[i].size)
+      {
+         break;
+      }
+   }
+   return total;
+}
+/** \brief Receives into several blocks.
+ **
+ ** ciaaPOSIX has no readv, the blocks are read in order until the driver
+ ** returns less bytes than requested, so no read blocks waiting for data
+ ** that belongs to a later block.
+ **
+ ** \param serial Serial structure.
+ ** \param iov Blocks to fill.
+ ** \param count Number of blocks.
+ ** \return Number of bytes received. -1 on error.
+ **/
+static ssize_t UPDT_serialRecvv(UPDT_ITransportType *serial, const UPDT_ITransportIoVecType *iov, size_t count)
+{
+   UPDT_serialType *self = (UPDT_serialType *) serial;
+   ssize_t ret;
+   ssize_t total = 0;
+   size_t i;
+
+   ciaaPOSIX_assert(NULL != serial);
+
+   if(self->rx_head < self->rx_tail)
+   {
+      /* the blocks are filled in the next calls after the buffered bytes */
+      i = 0;
+      while(i < count && 0 == iov[i].size)
+      {
+         i++;
+      }
+      return i < count ? UPDT_serialRecv(serial, iov[i].base, iov[i].size) : 0;
+   }
+
+   for(i = 0; i < count; i++)
+   {
+      if(0 == iov[i].size)
+      {
+         continue;
+      }
+      ret = UPDT_serialRead(self, iov[i].base, iov[i].size, NULL);
+      if(ret < 0)
+      {
+         return 0 < total ? total : ret;
+      }
+      total += ret;
+      if((size_t) ret < iov[i].size)
+      {
+         break;
+      }
+   }
+   return total;
+}
+/** \brief Lends received bytes.
+ **
+ ** \param serial Serial structure.
+ ** \param data Returns the position of the bytes.
+ ** \param size Maximum number of bytes to lend.
+ ** \return Number of bytes lent. -1 on error.
+ **/
+static ssize_t UPDT_serialRecvAcquire(UPDT_ITransportType *serial, const void **data, size_t size)
+{
+   ciaaPOSIX_assert(NULL != serial && NULL != data);
+
+   return UPDT_serialAcquire((UPDT_serialType *) serial, data, size, NULL);
+}
+/** \brief Lends received bytes, waiting until a deadline at most.
+ **
+ ** \param serial Serial structure.
+ ** \param data Returns the position of the bytes.
+ ** \param size Maximum number of bytes to lend.
+ ** \param deadline Deadline, a UPDT_timeNow value.
+ ** \return Number of bytes lent, 0 if the deadline passed. -1 on error.
+ **/
+static ssize_t UPDT_serialRecvAcquireUntil(UPDT_ITransportType *serial, const void **data, size_t size, uint32_t deadline)
+{
+   ciaaPOSIX_assert(NULL != serial && NULL != data);
+
+   return UPDT_serialAcquire((UPDT_serialType *) serial, data, size, &deadline);
+}
+/** \brief Releases lent bytes.
+ **
+ ** \param serial Serial structure.
+ ** \param size Number of bytes consumed.
+ **/
+static void UPDT_serialRecvRelease(UPDT_ITransportType *serial, size_t size)
+{
+   UPDT_serialType *self = (UPDT_serialType *) serial;
+
+   ciaaPOSIX_assert(NULL != serial);
+   ciaaPOSIX_assert(size <= self->rx_tail - self->rx_head);
+
+   self->rx_head += size;
 }
 /*==================[external functions definition]==========================*/
-int32_t UPDT_serialInit(UPDT_serialType *serial, const char *dev)
+int32_t UPDT_serialInit(UPDT_serialType *serial, const char *dev, const UPDT_serialConfigType *config)
 {
    ciaaPOSIX_assert(NULL != serial && NULL != dev);
 
    serial->fd = ciaaPOSIX_open(dev, ciaaPOSIX_O_RDWR);
    ciaaPOSIX_assert(serial->fd >= 0);
 
-   serial->recv = UPDT_serialRecv;
-   serial->send = UPDT_serialSend;
+   ciaaPOSIX_memset(&serial->config, 0, sizeof(serial->config));
+   if(NULL != config && 0 != UPDT_serialConfigure(serial, config))
+   {
+      ciaaPOSIX_close(serial->fd);
+      serial->fd = -1;
+      return -1;
+   }
+
+   UPDT_ITransportInit(&serial->transport, UPDT_serialRecv, UPDT_serialSend);
+   serial->transport.recvv = UPDT_serialRecvv;
+   serial->transport.sendv = UPDT_serialSendv;
+   serial->transport.recv_acquire = UPDT_serialRecvAcquire;
+   serial->transport.recv_release = UPDT_serialRecvRelease;
+   serial->transport.recv_until = UPDT_serialRecvUntil;
+   serial->transport.send_until = UPDT_serialSendUntil;
+   serial->transport.recv_acquire_until = UPDT_serialRecvAcquireUntil;
+   serial->non_blocking = 0;
+   serial->rx_head = 0;
+   serial->rx_tail = 0;
+   return 0;
+}
+int32_t UPDT_serialSetBaudRate(UPDT_serialType *serial, uint32_t baud_rate)
+{
+   uint32_t current;
+
+   ciaaPOSIX_assert(NULL != serial);
+   ciaaPOSIX_assert(0 < baud_rate);
+
+   current = 0 != serial->config.baud_rate ? serial->config.baud_rate : UPDT_SERIAL_DEFAULT_BAUD_RATE;
+   /* ciaaPOSIX has no tcdrain, waits for the bytes the driver may hold */
+   ciaaPOSIX_usleep((uint32_t) ((uint64_t) UPDT_SERIAL_TX_DRAIN_SIZE * 10u * 1000000u / current));
+   if(0 != ciaaPOSIX_ioctl(serial->fd, ciaaPOSIX_IOCTL_SET_BAUDRATE, (void *) (uintptr_t) baud_rate))
+   {
+      return -1;
+   }
+   serial->config.baud_rate = baud_rate;
    return 0;
 }
 void UPDT_serialClear(UPDT_serialType *serial)
 {
    ciaaPOSIX_assert(NULL != serial);
 
-   serial->send = NULL;
-   serial->recv = NULL;
+   UPDT_ITransportInit(&serial->transport, NULL, NULL);
    ciaaPOSIX_close(serial->fd);
    serial->fd = -1;
 }
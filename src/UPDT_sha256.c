@@ -0,0 +1,240 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/** \brief This file implements the Flash Update SHA-256
+ **
+ ** SHA-256 (FIPS 180-4) of the image, fed with the DAT payloads as they
+ ** arrive. It is the digest the image signature covers, see
+ ** UPDT_signature.h.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update SHA-256
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_assert.h"
+#include "ciaaPOSIX_string.h"
+#include "UPDT_sha256.h"
+
+/*==================[macros and definitions]=================================*/
+#define UPDT_SHA256_ROR(x, n)            (((x) >> (n)) | ((x) << (32 - (n))))
+/** reads 4 bytes in big endian order, regardless of the alignment */
+#define UPDT_SHA256_LOAD32(p)                                                 \
+   (((uint32_t) (p)[0] << 24) | ((uint32_t) (p)[1] << 16) |                   \
+   ((uint32_t) (p)[2] << 8) | (uint32_t) (p)[3])
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** round constants */
+static const uint32_t UPDT_sha256K[64] =
+{
+   0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+   0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+   0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+   0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+   0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+   0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+   0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+   0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Compresses count blocks into the chaining value.
+ **
+ ** The message schedule is kept in a 16 word ring, computed as the rounds
+ ** need it.
+ **/
+static void UPDT_sha256Blocks(uint32_t *state, const uint8_t *data, size_t count)
+{
+   uint32_t w[16];
+   uint32_t a, b, c, d, e, f, g, h;
+   uint32_t s0, s1, t1, t2;
+   uint8_t i;
+
+   while(count-- > 0)
+   {
+      a = state[0];
+      b = state[1];
+      c = state[2];
+      d = state[3];
+      e = state[4];
+      f = state[5];
+      g = state[6];
+      h = state[7];
+      for(i = 0; i < 64; i++)
+      {
+         if(i < 16)
+         {
+            w[i] = UPDT_SHA256_LOAD32(data + 4 * i);
+         }
+         else
+         {
+            s0 = w[(i + 1) & 15];
+            s0 = UPDT_SHA256_ROR(s0, 7) ^ UPDT_SHA256_ROR(s0, 18) ^ (s0 >> 3);
+            s1 = w[(i + 14) & 15];
+            s1 = UPDT_SHA256_ROR(s1, 17) ^ UPDT_SHA256_ROR(s1, 19) ^ (s1 >> 10);
+            w[i & 15] += s0 + s1 + w[(i + 9) & 15];
+         }
+         t1 = h + (UPDT_SHA256_ROR(e, 6) ^ UPDT_SHA256_ROR(e, 11) ^ UPDT_SHA256_ROR(e, 25)) +
+            ((e & f) ^ (~e & g)) + UPDT_sha256K[i] + w[i & 15];
+         t2 = (UPDT_SHA256_ROR(a, 2) ^ UPDT_SHA256_ROR(a, 13) ^ UPDT_SHA256_ROR(a, 22)) +
+            ((a & b) ^ (a & c) ^ (b & c));
+         h = g;
+         g = f;
+         f = e;
+         e = d + t1;
+         d = c;
+         c = b;
+         b = a;
+         a = t1 + t2;
+      }
+      state[0] += a;
+      state[1] += b;
+      state[2] += c;
+      state[3] += d;
+      state[4] += e;
+      state[5] += f;
+      state[6] += g;
+      state[7] += h;
+      data += UPDT_SHA256_BLOCK_SIZE;
+   }
+}
+
+/*==================[external functions definition]==========================*/
+void UPDT_sha256Init(UPDT_sha256Type *sha)
+{
+   ciaaPOSIX_assert(NULL != sha);
+
+   sha->state[0] = 0x6a09e667;
+   sha->state[1] = 0xbb67ae85;
+   sha->state[2] = 0x3c6ef372;
+   sha->state[3] = 0xa54ff53a;
+   sha->state[4] = 0x510e527f;
+   sha->state[5] = 0x9b05688c;
+   sha->state[6] = 0x1f83d9ab;
+   sha->state[7] = 0x5be0cd19;
+   sha->length = 0;
+}
+
+void UPDT_sha256Update(UPDT_sha256Type *sha, const void *data, size_t size)
+{
+   const uint8_t *bytes = (const uint8_t *) data;
+   size_t fill = (size_t) (sha->length % UPDT_SHA256_BLOCK_SIZE);
+   size_t count;
+
+   if(0 == size)
+   {
+      return;
+   }
+   sha->length += size;
+
+   /* complete the pending block first */
+   if(0 != fill)
+   {
+      count = UPDT_SHA256_BLOCK_SIZE - fill;
+      if(count > size)
+      {
+         count = size;
+      }
+      ciaaPOSIX_memcpy(sha->block + fill, bytes, count);
+      bytes += count;
+      size -= count;
+      if(fill + count < UPDT_SHA256_BLOCK_SIZE)
+      {
+         return;
+      }
+      UPDT_sha256Blocks(sha->state, sha->block, 1);
+   }
+
+   /* the whole blocks straight from the caller memory */
+   UPDT_sha256Blocks(sha->state, bytes, size / UPDT_SHA256_BLOCK_SIZE);
+   bytes += size - size % UPDT_SHA256_BLOCK_SIZE;
+   ciaaPOSIX_memcpy(sha->block, bytes, size % UPDT_SHA256_BLOCK_SIZE);
+}
+
+void UPDT_sha256Final(UPDT_sha256Type *sha, uint8_t *digest)
+{
+   uint64_t bits = sha->length * 8;
+   size_t fill = (size_t) (sha->length % UPDT_SHA256_BLOCK_SIZE);
+   uint8_t i;
+
+   /* a one bit, zeros and the length in bits, big endian */
+   sha->block[fill++] = 0x80;
+   if(fill > UPDT_SHA256_BLOCK_SIZE - 8)
+   {
+      ciaaPOSIX_memset(sha->block + fill, 0, UPDT_SHA256_BLOCK_SIZE - fill);
+      UPDT_sha256Blocks(sha->state, sha->block, 1);
+      fill = 0;
+   }
+   ciaaPOSIX_memset(sha->block + fill, 0, UPDT_SHA256_BLOCK_SIZE - 8 - fill);
+   for(i = 0; i < 8; i++)
+   {
+      sha->block[UPDT_SHA256_BLOCK_SIZE - 1 - i] = (uint8_t) (bits >> (8 * i));
+   }
+   UPDT_sha256Blocks(sha->state, sha->block, 1);
+
+   for(i = 0; i < UPDT_SHA256_SIZE / 4; i++)
+   {
+      digest[4 * i] = (uint8_t) (sha->state[i] >> 24);
+      digest[4 * i + 1] = (uint8_t) (sha->state[i] >> 16);
+      digest[4 * i + 2] = (uint8_t) (sha->state[i] >> 8);
+      digest[4 * i + 3] = (uint8_t) sha->state[i];
+   }
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
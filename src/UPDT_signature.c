@@ -0,0 +1,864 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/** \brief This file implements the Flash Update Signature
+ **
+ ** Ed25519 (RFC 8032) signatures of the image digest. The arithmetic works
+ ** on 16 limbs of 16 bits held in 64 bit integers, small and without tables
+ ** rather than fast: a verification is done once per update. SHA-512, which
+ ** Ed25519 needs internally, is kept private to this file.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Signature
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_assert.h"
+#include "ciaaPOSIX_string.h"
+#include "UPDT_signature.h"
+
+/*==================[macros and definitions]=================================*/
+/** size of a SHA-512 digest */
+#define UPDT_SIGNATURE_SHA512_SIZE       64
+/** size of the SHA-512 blocks */
+#define UPDT_SIGNATURE_SHA512_BLOCK_SIZE 128
+
+#define UPDT_SIGNATURE_ROR64(x, n)       (((x) >> (n)) | ((x) << (64 - (n))))
+
+/** \brief Element of GF(2^255 - 19), 16 limbs of 16 bits, least significant
+ ** first. The limbs may exceed 16 bits between carries. */
+typedef int64_t UPDT_signatureFieldType[16];
+
+/** \brief SHA-512 hash. */
+typedef struct
+{
+   uint64_t state[8];
+   uint64_t length;
+   uint8_t block[UPDT_SIGNATURE_SHA512_BLOCK_SIZE];
+} UPDT_signatureSha512Type;
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static const uint64_t UPDT_signatureSha512K[80] =
+{
+   0x428a2f98d728ae22ull, 0x7137449123ef65cdull, 0xb5c0fbcfec4d3b2full, 0xe9b5dba58189dbbcull,
+   0x3956c25bf348b538ull, 0x59f111f1b605d019ull, 0x923f82a4af194f9bull, 0xab1c5ed5da6d8118ull,
+   0xd807aa98a3030242ull, 0x12835b0145706fbeull, 0x243185be4ee4b28cull, 0x550c7dc3d5ffb4e2ull,
+   0x72be5d74f27b896full, 0x80deb1fe3b1696b1ull, 0x9bdc06a725c71235ull, 0xc19bf174cf692694ull,
+   0xe49b69c19ef14ad2ull, 0xefbe4786384f25e3ull, 0x0fc19dc68b8cd5b5ull, 0x240ca1cc77ac9c65ull,
+   0x2de92c6f592b0275ull, 0x4a7484aa6ea6e483ull, 0x5cb0a9dcbd41fbd4ull, 0x76f988da831153b5ull,
+   0x983e5152ee66dfabull, 0xa831c66d2db43210ull, 0xb00327c898fb213full, 0xbf597fc7beef0ee4ull,
+   0xc6e00bf33da88fc2ull, 0xd5a79147930aa725ull, 0x06ca6351e003826full, 0x142929670a0e6e70ull,
+   0x27b70a8546d22ffcull, 0x2e1b21385c26c926ull, 0x4d2c6dfc5ac42aedull, 0x53380d139d95b3dfull,
+   0x650a73548baf63deull, 0x766a0abb3c77b2a8ull, 0x81c2c92e47edaee6ull, 0x92722c851482353bull,
+   0xa2bfe8a14cf10364ull, 0xa81a664bbc423001ull, 0xc24b8b70d0f89791ull, 0xc76c51a30654be30ull,
+   0xd192e819d6ef5218ull, 0xd69906245565a910ull, 0xf40e35855771202aull, 0x106aa07032bbd1b8ull,
+   0x19a4c116b8d2d0c8ull, 0x1e376c085141ab53ull, 0x2748774cdf8eeb99ull, 0x34b0bcb5e19b48a8ull,
+   0x391c0cb3c5c95a63ull, 0x4ed8aa4ae3418acbull, 0x5b9cca4f7763e373ull, 0x682e6ff3d6b2b8a3ull,
+   0x748f82ee5defb2fcull, 0x78a5636f43172f60ull, 0x84c87814a1f0ab72ull, 0x8cc702081a6439ecull,
+   0x90befffa23631e28ull, 0xa4506cebde82bde9ull, 0xbef9a3f7b2c67915ull, 0xc67178f2e372532bull,
+   0xca273eceea26619cull, 0xd186b8c721c0c207ull, 0xeada7dd6cde0eb1eull, 0xf57d4f7fee6ed178ull,
+   0x06f067aa72176fbaull, 0x0a637dc5a2c898a6ull, 0x113f9804bef90daeull, 0x1b710b35131c471bull,
+   0x28db77f523047d84ull, 0x32caab7b40c72493ull, 0x3c9ebe0a15c9bebcull, 0x431d67c49c100d4cull,
+   0x4cc5d4becb3e42b6ull, 0x597f299cfc657e2aull, 0x5fcb6fab3ad6faecull, 0x6c44198c4a475817ull,
+};
+
+static const UPDT_signatureFieldType UPDT_signatureZero = { 0 };
+static const UPDT_signatureFieldType UPDT_signatureOne = { 1 };
+/** curve constant d = -121665/121666 */
+static const UPDT_signatureFieldType UPDT_signatureD =
+{
+   0x78a3, 0x1359, 0x4dca, 0x75eb, 0xd8ab, 0x4141, 0x0a4d, 0x0070,
+   0xe898, 0x7779, 0x4079, 0x8cc7, 0xfe73, 0x2b6f, 0x6cee, 0x5203,
+};
+/** 2 * d */
+static const UPDT_signatureFieldType UPDT_signatureD2 =
+{
+   0xf159, 0x26b2, 0x9b94, 0xebd6, 0xb156, 0x8283, 0x149a, 0x00e0,
+   0xd130, 0xeef3, 0x80f2, 0x198e, 0xfce7, 0x56df, 0xd9dc, 0x2406,
+};
+/** coordinates of the base point */
+static const UPDT_signatureFieldType UPDT_signatureX =
+{
+   0xd51a, 0x8f25, 0x2d60, 0xc956, 0xa7b2, 0x9525, 0xc760, 0x692c,
+   0xdc5c, 0xfdd6, 0xe231, 0xc0a4, 0x53fe, 0xcd6e, 0x36d3, 0x2169,
+};
+static const UPDT_signatureFieldType UPDT_signatureY =
+{
+   0x6658, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666,
+   0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666,
+};
+/** square root of -1 */
+static const UPDT_signatureFieldType UPDT_signatureI =
+{
+   0xa0b0, 0x4a0e, 0x1b27, 0xc4ee, 0xe478, 0xad2f, 0x1806, 0x2f43,
+   0xd7a7, 0x3dfb, 0x0099, 0x2b4d, 0xdf0b, 0x4fc1, 0x2480, 0x2b83,
+};
+/** order of the base point, little endian */
+static const int64_t UPDT_signatureL[32] =
+{
+   0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10,
+};
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Compresses count SHA-512 blocks into the chaining value. */
+static void UPDT_signatureSha512Blocks(uint64_t *state, const uint8_t *data, size_t count)
+{
+   uint64_t w[16];
+   uint64_t v[8];
+   uint64_t s0, s1, t1, t2;
+   uint8_t i;
+   uint8_t j;
+
+   while(count-- > 0)
+   {
+      for(i = 0; i < 8; i++)
+      {
+         v[i] = state[i];
+      }
+      for(i = 0; i < 80; i++)
+      {
+         if(i < 16)
+         {
+            w[i] = 0;
+            for(j = 0; j < 8; j++)
+            {
+               w[i] = (w[i] << 8) | data[8 * i + j];
+            }
+         }
+         else
+         {
+            s0 = w[(i + 1) & 15];
+            s0 = UPDT_SIGNATURE_ROR64(s0, 1) ^ UPDT_SIGNATURE_ROR64(s0, 8) ^ (s0 >> 7);
+            s1 = w[(i + 14) & 15];
+            s1 = UPDT_SIGNATURE_ROR64(s1, 19) ^ UPDT_SIGNATURE_ROR64(s1, 61) ^ (s1 >> 6);
+            w[i & 15] += s0 + s1 + w[(i + 9) & 15];
+         }
+         t1 = v[7] + (UPDT_SIGNATURE_ROR64(v[4], 14) ^ UPDT_SIGNATURE_ROR64(v[4], 18) ^
+            UPDT_SIGNATURE_ROR64(v[4], 41)) + ((v[4] & v[5]) ^ (~v[4] & v[6])) +
+            UPDT_signatureSha512K[i] + w[i & 15];
+         t2 = (UPDT_SIGNATURE_ROR64(v[0], 28) ^ UPDT_SIGNATURE_ROR64(v[0], 34) ^
+            UPDT_SIGNATURE_ROR64(v[0], 39)) + ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+         for(j = 7; j > 0; j--)
+         {
+            v[j] = v[j - 1];
+         }
+         v[4] += t1;
+         v[0] = t1 + t2;
+      }
+      for(i = 0; i < 8; i++)
+      {
+         state[i] += v[i];
+      }
+      data += UPDT_SIGNATURE_SHA512_BLOCK_SIZE;
+   }
+}
+
+/** \brief Starts a SHA-512 hash. */
+static void UPDT_signatureSha512Init(UPDT_signatureSha512Type *sha)
+{
+   sha->state[0] = 0x6a09e667f3bcc908ull;
+   sha->state[1] = 0xbb67ae8584caa73bull;
+   sha->state[2] = 0x3c6ef372fe94f82bull;
+   sha->state[3] = 0xa54ff53a5f1d36f1ull;
+   sha->state[4] = 0x510e527fade682d1ull;
+   sha->state[5] = 0x9b05688c2b3e6c1full;
+   sha->state[6] = 0x1f83d9abfb41bd6bull;
+   sha->state[7] = 0x5be0cd19137e2179ull;
+   sha->length = 0;
+}
+
+/** \brief Hashes a piece of a SHA-512 stream. */
+static void UPDT_signatureSha512Update(UPDT_signatureSha512Type *sha, const uint8_t *data, size_t size)
+{
+   size_t fill = (size_t) (sha->length % UPDT_SIGNATURE_SHA512_BLOCK_SIZE);
+   size_t count;
+
+   if(0 == size)
+   {
+      return;
+   }
+   sha->length += size;
+   if(0 != fill)
+   {
+      count = UPDT_SIGNATURE_SHA512_BLOCK_SIZE - fill;
+      count = count < size ? count : size;
+      ciaaPOSIX_memcpy(sha->block + fill, data, count);
+      data += count;
+      size -= count;
+      if(fill + count < UPDT_SIGNATURE_SHA512_BLOCK_SIZE)
+      {
+         return;
+      }
+      UPDT_signatureSha512Blocks(sha->state, sha->block, 1);
+   }
+   UPDT_signatureSha512Blocks(sha->state, data, size / UPDT_SIGNATURE_SHA512_BLOCK_SIZE);
+   data += size - size % UPDT_SIGNATURE_SHA512_BLOCK_SIZE;
+   ciaaPOSIX_memcpy(sha->block, data, size % UPDT_SIGNATURE_SHA512_BLOCK_SIZE);
+}
+
+/** \brief Ends a SHA-512 hash. The length of the images fits in 64 bits,
+ ** the upper half of the 128 bit length is zero. */
+static void UPDT_signatureSha512Final(UPDT_signatureSha512Type *sha, uint8_t *digest)
+{
+   uint64_t bits = sha->length * 8;
+   size_t fill = (size_t) (sha->length % UPDT_SIGNATURE_SHA512_BLOCK_SIZE);
+   uint8_t i;
+
+   sha->block[fill++] = 0x80;
+   if(fill > UPDT_SIGNATURE_SHA512_BLOCK_SIZE - 16)
+   {
+      ciaaPOSIX_memset(sha->block + fill, 0, UPDT_SIGNATURE_SHA512_BLOCK_SIZE - fill);
+      UPDT_signatureSha512Blocks(sha->state, sha->block, 1);
+      fill = 0;
+   }
+   ciaaPOSIX_memset(sha->block + fill, 0, UPDT_SIGNATURE_SHA512_BLOCK_SIZE - 8 - fill);
+   for(i = 0; i < 8; i++)
+   {
+      sha->block[UPDT_SIGNATURE_SHA512_BLOCK_SIZE - 1 - i] = (uint8_t) (bits >> (8 * i));
+   }
+   UPDT_signatureSha512Blocks(sha->state, sha->block, 1);
+   for(i = 0; i < UPDT_SIGNATURE_SHA512_SIZE; i++)
+   {
+      digest[i] = (uint8_t) (sha->state[i / 8] >> (56 - 8 * (i % 8)));
+   }
+}
+
+/** \brief Returns non-zero if two byte strings differ, in constant time. */
+static uint8_t UPDT_signatureCompare(const uint8_t *a, const uint8_t *b, size_t size)
+{
+   uint8_t diff = 0;
+
+   while(size-- > 0)
+   {
+      diff |= a[size] ^ b[size];
+   }
+   return 0 != diff;
+}
+
+/** \brief Copies a field element. */
+static void UPDT_signatureSet(UPDT_signatureFieldType r, const UPDT_signatureFieldType a)
+{
+   uint8_t i;
+
+   for(i = 0; i < 16; i++)
+   {
+      r[i] = a[i];
+   }
+}
+
+/** \brief Carries the limbs above 16 bits into the next ones, 2^256 wraps
+ ** to 38. */
+static void UPDT_signatureCarry(UPDT_signatureFieldType o)
+{
+   int64_t c;
+   uint8_t i;
+
+   for(i = 0; i < 16; i++)
+   {
+      c = o[i] >> 16;
+      o[i] -= c * 65536;
+      if(i < 15)
+      {
+         o[i + 1] += c;
+      }
+      else
+      {
+         o[0] += 38 * c;
+      }
+   }
+}
+
+/** \brief Swaps p and q if b is 1, in constant time. */
+static void UPDT_signatureSelect(UPDT_signatureFieldType p, UPDT_signatureFieldType q, int64_t b)
+{
+   int64_t c = ~(b - 1);
+   int64_t t;
+   uint8_t i;
+
+   for(i = 0; i < 16; i++)
+   {
+      t = c & (p[i] ^ q[i]);
+      p[i] ^= t;
+      q[i] ^= t;
+   }
+}
+
+/** \brief Encodes a field element fully reduced, little endian. */
+static void UPDT_signaturePack25519(uint8_t *o, const UPDT_signatureFieldType n)
+{
+   UPDT_signatureFieldType m;
+   UPDT_signatureFieldType t;
+   int64_t b;
+   uint8_t i;
+   uint8_t j;
+
+   UPDT_signatureSet(t, n);
+   UPDT_signatureCarry(t);
+   UPDT_signatureCarry(t);
+   UPDT_signatureCarry(t);
+   /* subtracts p at most twice */
+   for(j = 0; j < 2; j++)
+   {
+      m[0] = t[0] - 0xffed;
+      for(i = 1; i < 15; i++)
+      {
+         m[i] = t[i] - 0xffff - ((m[i - 1] >> 16) & 1);
+         m[i - 1] &= 0xffff;
+      }
+      m[15] = t[15] - 0x7fff - ((m[14] >> 16) & 1);
+      b = (m[15] >> 16) & 1;
+      m[14] &= 0xffff;
+      UPDT_signatureSelect(t, m, 1 - b);
+   }
+   for(i = 0; i < 16; i++)
+   {
+      o[2 * i] = (uint8_t) t[i];
+      o[2 * i + 1] = (uint8_t) (t[i] >> 8);
+   }
+}
+
+/** \brief Returns non-zero if two field elements differ. */
+static uint8_t UPDT_signatureDiffer(const UPDT_signatureFieldType a, const UPDT_signatureFieldType b)
+{
+   uint8_t c[32];
+   uint8_t d[32];
+
+   UPDT_signaturePack25519(c, a);
+   UPDT_signaturePack25519(d, b);
+   return UPDT_signatureCompare(c, d, 32);
+}
+
+/** \brief Returns the least significant bit of a field element. */
+static uint8_t UPDT_signatureParity(const UPDT_signatureFieldType a)
+{
+   uint8_t d[32];
+
+   UPDT_signaturePack25519(d, a);
+   return d[0] & 1;
+}
+
+/** \brief Decodes a field element, the top bit is ignored. */
+static void UPDT_signatureUnpack25519(UPDT_signatureFieldType o, const uint8_t *n)
+{
+   uint8_t i;
+
+   for(i = 0; i < 16; i++)
+   {
+      o[i] = n[2 * i] + ((int64_t) n[2 * i + 1] << 8);
+   }
+   o[15] &= 0x7fff;
+}
+
+/** \brief o = a + b */
+static void UPDT_signatureAdd(UPDT_signatureFieldType o, const UPDT_signatureFieldType a,
+   const UPDT_signatureFieldType b)
+{
+   uint8_t i;
+
+   for(i = 0; i < 16; i++)
+   {
+      o[i] = a[i] + b[i];
+   }
+}
+
+/** \brief o = a - b */
+static void UPDT_signatureSub(UPDT_signatureFieldType o, const UPDT_signatureFieldType a,
+   const UPDT_signatureFieldType b)
+{
+   uint8_t i;
+
+   for(i = 0; i < 16; i++)
+   {
+      o[i] = a[i] - b[i];
+   }
+}
+
+/** \brief o = a * b */
+static void UPDT_signatureMul(UPDT_signatureFieldType o, const UPDT_signatureFieldType a,
+   const UPDT_signatureFieldType b)
+{
+   int64_t t[31];
+   uint8_t i;
+   uint8_t j;
+
+   for(i = 0; i < 31; i++)
+   {
+      t[i] = 0;
+   }
+   for(i = 0; i < 16; i++)
+   {
+      for(j = 0; j < 16; j++)
+      {
+         t[i + j] += a[i] * b[j];
+      }
+   }
+   for(i = 0; i < 15; i++)
+   {
+      t[i] += 38 * t[i + 16];
+   }
+   for(i = 0; i < 16; i++)
+   {
+      o[i] = t[i];
+   }
+   UPDT_signatureCarry(o);
+   UPDT_signatureCarry(o);
+}
+
+/** \brief o = 1 / a, as a^(p - 2) */
+static void UPDT_signatureInvert(UPDT_signatureFieldType o, const UPDT_signatureFieldType a)
+{
+   UPDT_signatureFieldType c;
+   int16_t i;
+
+   UPDT_signatureSet(c, a);
+   for(i = 253; i >= 0; i--)
+   {
+      UPDT_signatureMul(c, c, c);
+      if(2 != i && 4 != i)
+      {
+         UPDT_signatureMul(c, c, a);
+      }
+   }
+   UPDT_signatureSet(o, c);
+}
+
+/** \brief o = a^((p - 5) / 8), used for the square roots */
+static void UPDT_signaturePow2523(UPDT_signatureFieldType o, const UPDT_signatureFieldType a)
+{
+   UPDT_signatureFieldType c;
+   int16_t i;
+
+   UPDT_signatureSet(c, a);
+   for(i = 250; i >= 0; i--)
+   {
+      UPDT_signatureMul(c, c, c);
+      if(1 != i)
+      {
+         UPDT_signatureMul(c, c, a);
+      }
+   }
+   UPDT_signatureSet(o, c);
+}
+
+/** \brief p = p + q, points in extended coordinates (X, Y, Z, T) */
+static void UPDT_signaturePointAdd(UPDT_signatureFieldType p[4], UPDT_signatureFieldType q[4])
+{
+   UPDT_signatureFieldType a, b, c, d, t, e, f, g, h;
+
+   UPDT_signatureSub(a, p[1], p[0]);
+   UPDT_signatureSub(t, q[1], q[0]);
+   UPDT_signatureMul(a, a, t);
+   UPDT_signatureAdd(b, p[0], p[1]);
+   UPDT_signatureAdd(t, q[0], q[1]);
+   UPDT_signatureMul(b, b, t);
+   UPDT_signatureMul(c, p[3], q[3]);
+   UPDT_signatureMul(c, c, UPDT_signatureD2);
+   UPDT_signatureMul(d, p[2], q[2]);
+   UPDT_signatureAdd(d, d, d);
+   UPDT_signatureSub(e, b, a);
+   UPDT_signatureSub(f, d, c);
+   UPDT_signatureAdd(g, d, c);
+   UPDT_signatureAdd(h, b, a);
+   UPDT_signatureMul(p[0], e, f);
+   UPDT_signatureMul(p[1], h, g);
+   UPDT_signatureMul(p[2], g, f);
+   UPDT_signatureMul(p[3], e, h);
+}
+
+/** \brief Encodes a point: y with the parity of x in the top bit. */
+static void UPDT_signaturePointPack(uint8_t *r, UPDT_signatureFieldType p[4])
+{
+   UPDT_signatureFieldType tx, ty, zi;
+
+   UPDT_signatureInvert(zi, p[2]);
+   UPDT_signatureMul(tx, p[0], zi);
+   UPDT_signatureMul(ty, p[1], zi);
+   UPDT_signaturePack25519(r, ty);
+   r[31] ^= UPDT_signatureParity(tx) << 7;
+}
+
+/** \brief p = s * q, with a constant time ladder. q is destroyed. */
+static void UPDT_signatureScalarMult(UPDT_signatureFieldType p[4], UPDT_signatureFieldType q[4],
+   const uint8_t *s)
+{
+   int16_t i;
+   uint8_t j;
+   uint8_t b;
+
+   UPDT_signatureSet(p[0], UPDT_signatureZero);
+   UPDT_signatureSet(p[1], UPDT_signatureOne);
+   UPDT_signatureSet(p[2], UPDT_signatureOne);
+   UPDT_signatureSet(p[3], UPDT_signatureZero);
+   for(i = 255; i >= 0; i--)
+   {
+      b = (s[i / 8] >> (i & 7)) & 1;
+      for(j = 0; j < 4; j++)
+      {
+         UPDT_signatureSelect(p[j], q[j], b);
+      }
+      UPDT_signaturePointAdd(q, p);
+      UPDT_signaturePointAdd(p, p);
+      for(j = 0; j < 4; j++)
+      {
+         UPDT_signatureSelect(p[j], q[j], b);
+      }
+   }
+}
+
+/** \brief p = s * B, B the base point */
+static void UPDT_signatureScalarBase(UPDT_signatureFieldType p[4], const uint8_t *s)
+{
+   UPDT_signatureFieldType q[4];
+
+   UPDT_signatureSet(q[0], UPDT_signatureX);
+   UPDT_signatureSet(q[1], UPDT_signatureY);
+   UPDT_signatureSet(q[2], UPDT_signatureOne);
+   UPDT_signatureMul(q[3], UPDT_signatureX, UPDT_signatureY);
+   UPDT_signatureScalarMult(p, q, s);
+}
+
+/** \brief r = x mod L, x holds 64 little endian bytes and is destroyed */
+static void UPDT_signatureModL(uint8_t *r, int64_t *x)
+{
+   int64_t carry;
+   int16_t i;
+   int16_t j;
+
+   for(i = 63; i >= 32; i--)
+   {
+      carry = 0;
+      for(j = i - 32; j < i - 12; j++)
+      {
+         x[j] += carry - 16 * x[i] * UPDT_signatureL[j - (i - 32)];
+         carry = (x[j] + 128) >> 8;
+         x[j] -= carry * 256;
+      }
+      x[j] += carry;
+      x[i] = 0;
+   }
+   carry = 0;
+   for(j = 0; j < 32; j++)
+   {
+      x[j] += carry - (x[31] >> 4) * UPDT_signatureL[j];
+      carry = x[j] >> 8;
+      x[j] &= 255;
+   }
+   for(j = 0; j < 32; j++)
+   {
+      x[j] -= carry * UPDT_signatureL[j];
+   }
+   for(i = 0; i < 32; i++)
+   {
+      x[i + 1] += x[i] >> 8;
+      r[i] = (uint8_t) x[i];
+   }
+}
+
+/** \brief Reduces a 64 byte hash mod L, in place. */
+static void UPDT_signatureReduce(uint8_t *r)
+{
+   int64_t x[64];
+   uint8_t i;
+
+   for(i = 0; i < 64; i++)
+   {
+      x[i] = r[i];
+      r[i] = 0;
+   }
+   UPDT_signatureModL(r, x);
+}
+
+/** \brief Decodes a public key as its negated point.
+ **
+ ** \return 0 on success, -1 if the key is not a point of the curve.
+ **/
+static int32_t UPDT_signatureUnpackNeg(UPDT_signatureFieldType r[4], const uint8_t *p)
+{
+   UPDT_signatureFieldType t, chk, num, den, den2, den4, den6;
+
+   UPDT_signatureSet(r[2], UPDT_signatureOne);
+   UPDT_signatureUnpack25519(r[1], p);
+   /* x^2 = (y^2 - 1) / (d y^2 + 1) */
+   UPDT_signatureMul(num, r[1], r[1]);
+   UPDT_signatureMul(den, num, UPDT_signatureD);
+   UPDT_signatureSub(num, num, r[2]);
+   UPDT_signatureAdd(den, r[2], den);
+
+   UPDT_signatureMul(den2, den, den);
+   UPDT_signatureMul(den4, den2, den2);
+   UPDT_signatureMul(den6, den4, den2);
+   UPDT_signatureMul(t, den6, num);
+   UPDT_signatureMul(t, t, den);
+
+   UPDT_signaturePow2523(t, t);
+   UPDT_signatureMul(t, t, num);
+   UPDT_signatureMul(t, t, den);
+   UPDT_signatureMul(t, t, den);
+   UPDT_signatureMul(r[0], t, den);
+
+   UPDT_signatureMul(chk, r[0], r[0]);
+   UPDT_signatureMul(chk, chk, den);
+   if(UPDT_signatureDiffer(chk, num))
+   {
+      UPDT_signatureMul(r[0], r[0], UPDT_signatureI);
+   }
+   UPDT_signatureMul(chk, r[0], r[0]);
+   UPDT_signatureMul(chk, chk, den);
+   if(UPDT_signatureDiffer(chk, num))
+   {
+      return -1;
+   }
+
+   if(UPDT_signatureParity(r[0]) == (p[31] >> 7))
+   {
+      UPDT_signatureSub(r[0], UPDT_signatureZero, r[0]);
+   }
+   UPDT_signatureMul(r[3], r[0], r[1]);
+   return 0;
+}
+
+/** \brief Returns non-zero if a scalar is below L, the canonical S of a
+ ** signature. */
+static uint8_t UPDT_signatureCanonical(const uint8_t *s)
+{
+   int8_t i;
+
+   for(i = 31; i >= 0; i--)
+   {
+      if(s[i] != UPDT_signatureL[i])
+      {
+         return s[i] < UPDT_signatureL[i];
+      }
+   }
+   return 0;
+}
+
+/** \brief Expands a seed into the secret scalar and the nonce prefix. */
+static void UPDT_signatureExpand(const uint8_t *seed, uint8_t *expanded)
+{
+   UPDT_signatureSha512Type sha;
+
+   UPDT_signatureSha512Init(&sha);
+   UPDT_signatureSha512Update(&sha, seed, UPDT_SIGNATURE_SEED_SIZE);
+   UPDT_signatureSha512Final(&sha, expanded);
+   expanded[0] &= 248;
+   expanded[31] &= 127;
+   expanded[31] |= 64;
+}
+
+/*==================[external functions definition]==========================*/
+int32_t UPDT_signatureVerify(
+   const uint8_t *public_key,
+   const uint8_t *message,
+   size_t size,
+   const uint8_t *signature)
+{
+   UPDT_signatureSha512Type sha;
+   UPDT_signatureFieldType p[4];
+   UPDT_signatureFieldType q[4];
+   uint8_t h[UPDT_SIGNATURE_SHA512_SIZE];
+   uint8_t t[32];
+
+   ciaaPOSIX_assert(NULL != public_key && NULL != signature);
+   ciaaPOSIX_assert(NULL != message || 0 == size);
+
+   if(!UPDT_signatureCanonical(signature + 32) || 0 != UPDT_signatureUnpackNeg(q, public_key))
+   {
+      return UPDT_PROTOCOL_ERROR_DENIED;
+   }
+
+   /* h = SHA-512(R || A || M) mod L */
+   UPDT_signatureSha512Init(&sha);
+   UPDT_signatureSha512Update(&sha, signature, 32);
+   UPDT_signatureSha512Update(&sha, public_key, UPDT_SIGNATURE_KEY_SIZE);
+   UPDT_signatureSha512Update(&sha, message, size);
+   UPDT_signatureSha512Final(&sha, h);
+   UPDT_signatureReduce(h);
+
+   /* S B - h A must be R */
+   UPDT_signatureScalarMult(p, q, h);
+   UPDT_signatureScalarBase(q, signature + 32);
+   UPDT_signaturePointAdd(p, q);
+   UPDT_signaturePointPack(t, p);
+   return UPDT_signatureCompare(t, signature, 32) ? UPDT_PROTOCOL_ERROR_DENIED : UPDT_PROTOCOL_ERROR_NONE;
+}
+
+void UPDT_signaturePublicKey(const uint8_t *seed, uint8_t *public_key)
+{
+   UPDT_signatureFieldType p[4];
+   uint8_t d[UPDT_SIGNATURE_SHA512_SIZE];
+
+   ciaaPOSIX_assert(NULL != seed && NULL != public_key);
+
+   UPDT_signatureExpand(seed, d);
+   UPDT_signatureScalarBase(p, d);
+   UPDT_signaturePointPack(public_key, p);
+}
+
+void UPDT_signatureSign(
+   const uint8_t *seed,
+   const uint8_t *message,
+   size_t size,
+   uint8_t *signature)
+{
+   UPDT_signatureSha512Type sha;
+   UPDT_signatureFieldType p[4];
+   uint8_t d[UPDT_SIGNATURE_SHA512_SIZE];
+   uint8_t r[UPDT_SIGNATURE_SHA512_SIZE];
+   uint8_t h[UPDT_SIGNATURE_SHA512_SIZE];
+   uint8_t public_key[UPDT_SIGNATURE_KEY_SIZE];
+   int64_t x[64];
+   uint8_t i;
+   uint8_t j;
+
+   ciaaPOSIX_assert(NULL != seed && NULL != signature);
+   ciaaPOSIX_assert(NULL != message || 0 == size);
+
+   UPDT_signatureExpand(seed, d);
+   UPDT_signatureScalarBase(p, d);
+   UPDT_signaturePointPack(public_key, p);
+
+   /* r = SHA-512(prefix || M) mod L, R = r B */
+   UPDT_signatureSha512Init(&sha);
+   UPDT_signatureSha512Update(&sha, d + 32, 32);
+   UPDT_signatureSha512Update(&sha, message, size);
+   UPDT_signatureSha512Final(&sha, r);
+   UPDT_signatureReduce(r);
+   UPDT_signatureScalarBase(p, r);
+   UPDT_signaturePointPack(signature, p);
+
+   /* S = r + SHA-512(R || A || M) a mod L */
+   UPDT_signatureSha512Init(&sha);
+   UPDT_signatureSha512Update(&sha, signature, 32);
+   UPDT_signatureSha512Update(&sha, public_key, UPDT_SIGNATURE_KEY_SIZE);
+   UPDT_signatureSha512Update(&sha, message, size);
+   UPDT_signatureSha512Final(&sha, h);
+   UPDT_signatureReduce(h);
+   for(i = 0; i < 64; i++)
+   {
+      x[i] = i < 32 ? r[i] : 0;
+   }
+   for(i = 0; i < 32; i++)
+   {
+      for(j = 0; j < 32; j++)
+      {
+         x[i + j] += h[i] * (int64_t) d[j];
+      }
+   }
+   UPDT_signatureModL(signature + 32, x);
+}
+
+void UPDT_signatureVerifierInit(
+   UPDT_signatureVerifierType *verifier,
+   const uint8_t *public_key,
+   size_t size,
+   UPDT_protocolConsumerType consumer,
+   void *context)
+{
+   ciaaPOSIX_assert(NULL != verifier && NULL != public_key);
+
+   UPDT_sha256Init(&verifier->sha);
+   verifier->size = size;
+   verifier->offset = 0;
+   verifier->public_key = public_key;
+   verifier->consumer = consumer;
+   verifier->context = context;
+}
+
+int32_t UPDT_signatureVerifierConsume(
+   void *verifier,
+   size_t offset,
+   const uint8_t *data,
+   size_t size)
+{
+   UPDT_signatureVerifierType *self = (UPDT_signatureVerifierType *) verifier;
+   size_t count = 0;
+
+   if(self->offset < self->size)
+   {
+      count = self->size - self->offset;
+      count = count < size ? count : size;
+      UPDT_sha256Update(&self->sha, data, count);
+   }
+   self->offset += size;
+   if(NULL == self->consumer)
+   {
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   return self->consumer(self->context, offset, data, size);
+}
+
+int32_t UPDT_signatureVerifierCheck(
+   UPDT_signatureVerifierType *verifier,
+   const uint8_t *signature)
+{
+   uint8_t digest[UPDT_SHA256_SIZE];
+
+   ciaaPOSIX_assert(NULL != verifier && NULL != signature);
+
+   if(verifier->offset < verifier->size)
+   {
+      return UPDT_PROTOCOL_ERROR_DENIED;
+   }
+   UPDT_sha256Final(&verifier->sha, digest);
+   return UPDT_signatureVerify(verifier->public_key, digest, sizeof(digest), signature);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
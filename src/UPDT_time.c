@@ -0,0 +1,127 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the Flash Update Time
+ **
+ ** Monotonic millisecond time used for the deadlines of the transport calls.
+ ** The source can be replaced so the tests control the time.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Time
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdio.h"
+#include "UPDT_time.h"
+#if (ARCH == posix)
+#include <time.h>
+#endif
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** time source in use */
+static UPDT_timeSourceType UPDT_timeSource = NULL;
+
+#if (ARCH != posix)
+/** time of the default source, advanced by UPDT_timeTick */
+static volatile uint32_t UPDT_timeTicks;
+#endif
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Default time source. */
+static uint32_t UPDT_timeDefault(void)
+{
+#if (ARCH == posix)
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (uint32_t) now.tv_sec * 1000u + (uint32_t) (now.tv_nsec / 1000000);
+#else
+   return UPDT_timeTicks;
+#endif
+}
+
+/*==================[external functions definition]==========================*/
+void UPDT_timeSetSource(UPDT_timeSourceType source)
+{
+   UPDT_timeSource = source;
+}
+
+uint32_t UPDT_timeNow(void)
+{
+   return NULL != UPDT_timeSource ? UPDT_timeSource() : UPDT_timeDefault();
+}
+
+void UPDT_timeTick(uint32_t milliseconds)
+{
+#if (ARCH != posix)
+   UPDT_timeTicks += milliseconds;
+#else
+   (void) milliseconds;
+#endif
+}
+
+uint32_t UPDT_timeRemaining(uint32_t deadline)
+{
+   uint32_t now = UPDT_timeNow();
+
+   return UPDT_TIME_BEFORE(now, deadline) ? deadline - now : 0;
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
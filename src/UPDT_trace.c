@@ -0,0 +1,206 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief This file implements the Flash Update Trace
+ **
+ ** Fixed size binary records of the hot path kept in a ring buffer, to see
+ ** where the time of an update goes.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Trace
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_assert.h"
+#include "UPDT_trace.h"
+#include "UPDT_time.h"
+#if (ARCH == posix)
+#include <time.h>
+#endif
+
+/*==================[macros and definitions]=================================*/
+/** claims the next slot of the ring, atomically where the compiler can */
+#if defined(__GNUC__)
+#define UPDT_TRACE_CLAIM(head)   __atomic_fetch_add((head), 1u, __ATOMIC_RELAXED)
+#else
+#define UPDT_TRACE_CLAIM(head)   ((*(head))++)
+#endif
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** memory of the ring, NULL while not recording */
+static UPDT_traceRecordType *UPDT_traceRecords = NULL;
+
+/** number of records of the ring minus 1 */
+static uint32_t UPDT_traceMask;
+
+/** number of records claimed since UPDT_traceInit */
+static volatile uint32_t UPDT_traceHead;
+
+/** clock in use, NULL for the default one */
+static UPDT_traceClockType UPDT_traceClock = NULL;
+
+/** track source in use */
+static UPDT_traceTrackSourceType UPDT_traceTrackSource = NULL;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Default trace clock. */
+static uint32_t UPDT_traceClockDefault(void)
+{
+#if (ARCH == posix)
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (uint32_t) now.tv_sec * 1000000u + (uint32_t) (now.tv_nsec / 1000);
+#else
+   return UPDT_timeNow() * 1000u;
+#endif
+}
+
+/** \brief Encodes a 32 bit word in little endian byte order. */
+static void UPDT_traceSet32(uint8_t *buffer, uint32_t value)
+{
+   buffer[0] = (uint8_t) value;
+   buffer[1] = (uint8_t) (value >> 8);
+   buffer[2] = (uint8_t) (value >> 16);
+   buffer[3] = (uint8_t) (value >> 24);
+}
+
+/*==================[external functions definition]==========================*/
+void UPDT_traceInit(UPDT_traceRecordType *records, uint32_t count)
+{
+   ciaaPOSIX_assert(NULL == records || (0 < count && 0 == (count & (count - 1))));
+
+   /* stops the recorders before the ring changes */
+   UPDT_traceRecords = NULL;
+   UPDT_traceMask = count - 1;
+   UPDT_traceHead = 0;
+   UPDT_traceRecords = records;
+}
+
+void UPDT_traceSetClock(UPDT_traceClockType clock)
+{
+   UPDT_traceClock = clock;
+}
+
+void UPDT_traceSetTrackSource(UPDT_traceTrackSourceType source)
+{
+   UPDT_traceTrackSource = source;
+}
+
+void UPDT_traceRecord(uint8_t event, uint8_t phase, uint32_t arg)
+{
+   UPDT_traceRecordType *records = UPDT_traceRecords;
+   UPDT_traceRecordType *record;
+
+   if(NULL == records)
+   {
+      return;
+   }
+   record = &records[UPDT_TRACE_CLAIM(&UPDT_traceHead) & UPDT_traceMask];
+   record->time = NULL != UPDT_traceClock ? UPDT_traceClock() : UPDT_traceClockDefault();
+   record->arg = arg;
+   record->event = event;
+   record->phase = phase;
+   record->track = NULL != UPDT_traceTrackSource ? UPDT_traceTrackSource() : 0;
+   record->reserved = 0;
+}
+
+size_t UPDT_traceDump(uint8_t *buffer, size_t size)
+{
+   const UPDT_traceRecordType *record;
+   uint32_t head = UPDT_traceHead;
+   uint32_t count;
+   uint32_t first;
+   uint32_t i;
+   uint8_t *out;
+
+   ciaaPOSIX_assert(NULL != buffer);
+   ciaaPOSIX_assert(UPDT_TRACE_HEADER_SIZE <= size);
+
+   count = NULL != UPDT_traceRecords ? head : 0;
+   if(count > UPDT_traceMask + 1)
+   {
+      count = UPDT_traceMask + 1;
+   }
+   if(count > (size - UPDT_TRACE_HEADER_SIZE) / UPDT_TRACE_RECORD_SIZE)
+   {
+      count = (size - UPDT_TRACE_HEADER_SIZE) / UPDT_TRACE_RECORD_SIZE;
+   }
+   first = head - count;
+
+   buffer[0] = 'U';
+   buffer[1] = 'T';
+   buffer[2] = 'R';
+   buffer[3] = 'C';
+   UPDT_traceSet32(buffer + 4, first);
+   out = buffer + UPDT_TRACE_HEADER_SIZE;
+   for(i = first; i != head; i++)
+   {
+      record = &UPDT_traceRecords[i & UPDT_traceMask];
+      UPDT_traceSet32(out, record->time);
+      UPDT_traceSet32(out + 4, record->arg);
+      out[8] = record->event;
+      out[9] = record->phase;
+      out[10] = record->track;
+      out[11] = 0;
+      out += UPDT_TRACE_RECORD_SIZE;
+   }
+   return out - buffer;
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
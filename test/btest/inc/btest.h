@@ -0,0 +1,122 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef BTEST_H
+#define BTEST_H
+/** \brief Update Benchmarks header file
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup BTests CIAA Firmware Benchmarks
+ ** @{ */
+/** \addtogroup Update Update Module Benchmarks
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1   AG   first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+
+/*==================[macros]=================================================*/
+#if (ARCH == posix)
+/** the posix time source counts nanoseconds */
+#define BTEST_TICKS_PER_SECOND     1000000000u
+/** bytes processed by each benchmark case */
+#define BTEST_VOLUME               (16u * 1024u * 1024u)
+#else
+/** the target time source counts core clock cycles */
+#ifndef BTEST_TICKS_PER_SECOND
+#define BTEST_TICKS_PER_SECOND     204000000u
+#endif
+/** bytes processed by each benchmark case */
+#define BTEST_VOLUME               (256u * 1024u)
+#endif
+
+/*==================[typedef]================================================*/
+typedef uint64_t btest_ticksType;
+
+/*==================[external data declaration]==============================*/
+/** Written by the benchmarks so the measured code is not optimized out */
+extern volatile uint32_t btest_sink;
+
+/*==================[external functions declaration]=========================*/
+/** \brief Returns the current value of the benchmark time source. */
+btest_ticksType btest_now(void);
+
+/** \brief Reports the result of a benchmark case.
+ **
+ ** \param benchmark Name of the benchmark.
+ ** \param name Name of the case.
+ ** \param size Size of the unit processed by each iteration, usually the
+ ** payload size.
+ ** \param iterations Number of iterations measured.
+ ** \param bytes Number of bytes processed by all the iterations.
+ ** \param ticks Time spent by all the iterations.
+ **/
+void btest_report(
+   const char *benchmark,
+   const char *name,
+   uint32_t size,
+   uint32_t iterations,
+   uint32_t bytes,
+   btest_ticksType ticks);
+
+/* benchmarks */
+void btest_crc32cRun(void);
+void btest_lzssRun(void);
+void btest_flashRun(void);
+void btest_batchRun(void);
+void btest_readaheadRun(void);
+void btest_framingRun(void);
+void btest_signatureRun(void);
+void btest_cipherRun(void);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef BTEST_H */
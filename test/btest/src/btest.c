@@ -0,0 +1,222 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief Update Benchmarks source file
+ **
+ ** Runs the benchmarks of the update module one after the other and prints
+ ** one CSV line per case:
+ **
+ **    benchmark,case,size,iterations,bytes,ns_per_iteration,bytes_per_second
+ **
+ ** On posix the time source is CLOCK_MONOTONIC. On Cortex-M targets the DWT
+ ** cycle counter is used and BTEST_TICKS_PER_SECOND must match the core
+ ** clock.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup BTests CIAA Firmware Benchmarks
+ ** @{ */
+/** \addtogroup Update Update Module Benchmarks
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1   AG   first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "os.h"               /* <= operating system header */
+#include "ciaaPOSIX_stdio.h"  /* <= device handler header */
+#include "ciaak.h"            /* <= ciaa kernel header */
+#include "btest.h"
+#if (ARCH == posix)
+#include <time.h>
+#endif
+
+/*==================[macros and definitions]=================================*/
+#if (ARCH != posix)
+/* ARMv7-M debug registers used to count core cycles */
+#define BTEST_DEMCR           (*(volatile uint32_t *) 0xE000EDFCu)
+#define BTEST_DEMCR_TRCENA    (1u << 24)
+#define BTEST_DWT_CTRL        (*(volatile uint32_t *) 0xE0001000u)
+#define BTEST_DWT_CYCCNTENA   (1u << 0)
+#define BTEST_DWT_CYCCNT      (*(volatile uint32_t *) 0xE0001004u)
+#endif
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/** benchmarks run by the InitTask */
+static void (* const btest_benchmarks[])(void) =
+{
+   btest_crc32cRun,
+   btest_lzssRun,
+   btest_flashRun,
+   btest_batchRun,
+   btest_readaheadRun,
+   btest_framingRun,
+   btest_signatureRun,
+   btest_cipherRun,
+};
+
+#if (ARCH != posix)
+/** extends the 32 bits cycle counter */
+static btest_ticksType btest_ticks;
+static uint32_t btest_lastCycles;
+#endif
+
+/*==================[external data definition]===============================*/
+volatile uint32_t btest_sink;
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+btest_ticksType btest_now(void)
+{
+#if (ARCH == posix)
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (btest_ticksType) now.tv_sec * BTEST_TICKS_PER_SECOND + now.tv_nsec;
+#else
+   uint32_t cycles = BTEST_DWT_CYCCNT;
+
+   /* it must be called at least once per counter overflow */
+   btest_ticks += (uint32_t) (cycles - btest_lastCycles);
+   btest_lastCycles = cycles;
+   return btest_ticks;
+#endif
+}
+
+void btest_report(
+   const char *benchmark,
+   const char *name,
+   uint32_t size,
+   uint32_t iterations,
+   uint32_t bytes,
+   btest_ticksType ticks)
+{
+   uint64_t ns_per_iteration = 0;
+   uint64_t bytes_per_second = 0;
+
+   if(0 < iterations)
+   {
+      ns_per_iteration = ticks / iterations * 1000000000u / BTEST_TICKS_PER_SECOND;
+   }
+   if(0 < ticks)
+   {
+      bytes_per_second = (uint64_t) bytes * BTEST_TICKS_PER_SECOND / ticks;
+   }
+   ciaaPOSIX_printf("%s,%s,%lu,%lu,%lu,%lu,%lu\n", benchmark, name,
+      (unsigned long) size, (unsigned long) iterations, (unsigned long) bytes,
+      (unsigned long) ns_per_iteration, (unsigned long) bytes_per_second);
+}
+
+/** \brief Main function
+ *
+ * This is the main entry point of the software.
+ *
+ * \return 0
+ *
+ * \remarks This function never returns. Return value is only to avoid compiler
+ *          warnings or errors.
+ */
+int main(void)
+{
+   /* Starts the operating system in the Application Mode 1 */
+   /* This example has only one Application Mode */
+   StartOS(AppMode1);
+
+   /* StartOs shall never returns, but to avoid compiler warnings or errors
+    * 0 is returned */
+   return 0;
+}
+
+/** \brief Error Hook function
+ *
+ * This function is called from the OS if an OS interface (API) returns an
+ * error. Is for debugging proposes. If called this function triggers a
+ * ShutdownOs which ends in a while(1).
+ */
+void ErrorHook(void)
+{
+   ciaaPOSIX_printf("ErrorHook was called\n");
+   ciaaPOSIX_printf("Service: %d, P1: %d, P2: %d, P3: %d, RET: %d\n", OSErrorGetServiceId(), OSErrorGetParam1(), OSErrorGetParam2(), OSErrorGetParam3(), OSErrorGetRet());
+   ShutdownOS(0);
+}
+
+/** \brief Initial task
+ *
+ * This task is started automatically in the application mode 1. It runs
+ * every benchmark and shuts the system down.
+ */
+TASK(InitTask)
+{
+   size_t i;
+
+   /* init CIAA kernel and devices */
+   ciaak_start();
+
+#if (ARCH != posix)
+   /* start the cycle counter */
+   BTEST_DEMCR |= BTEST_DEMCR_TRCENA;
+   BTEST_DWT_CYCCNT = 0;
+   BTEST_DWT_CTRL |= BTEST_DWT_CYCCNTENA;
+#endif
+
+   ciaaPOSIX_printf("benchmark,case,size,iterations,bytes,ns_per_iteration,bytes_per_second\n");
+   for(i = 0; i < sizeof(btest_benchmarks) / sizeof(btest_benchmarks[0]); i++)
+   {
+      btest_benchmarks[i]();
+   }
+
+   ShutdownOS(0);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
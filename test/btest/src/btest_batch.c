@@ -0,0 +1,161 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief Send batching benchmark source file
+ **
+ ** Sends an image as DAT frames, a window of frames at a time, straight to
+ ** a transport and through the batching decorator. Each send of the
+ ** transport costs BTEST_BATCH_WRITE_NS, standing for the system call and
+ ** the UART FIFO flush of the POSIX serial stack. The number of sends is
+ ** reported as the iterations.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup BTests CIAA Firmware Benchmarks
+ ** @{ */
+/** \addtogroup Update Update Module Benchmarks
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.2   AG   clear the optional transport entries with UPDT_ITransportInit
+ * 20261017 v0.0.1   AG   first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdio.h"
+#include "UPDT_ITransport.h"
+#include "UPDT_protocol.h"
+#include "btest.h"
+
+/*==================[macros and definitions]=================================*/
+/** size of the image sent */
+#define BTEST_BATCH_IMAGE_SIZE     (64u * 1024u)
+/** frames sent before waiting for the acknowledgements */
+#define BTEST_BATCH_WINDOW         8u
+/** cost of a send of the transport in nanoseconds */
+#ifndef BTEST_BATCH_WRITE_NS
+#define BTEST_BATCH_WRITE_NS       5000u
+#endif
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static uint8_t btest_batchFrame[UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE)];
+static uint8_t btest_batchStaging[BTEST_BATCH_WINDOW *
+   UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE)];
+static UPDT_ITransportType btest_batchWire;
+static UPDT_ITransportBatchType btest_batchObj;
+static uint32_t btest_batchWrites;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Send of the modeled serial stack. */
+static ssize_t btest_batchSend(UPDT_ITransportType *transport, const void *data, size_t size)
+{
+   btest_ticksType end = btest_now() +
+      (btest_ticksType) BTEST_BATCH_WRITE_NS * BTEST_TICKS_PER_SECOND / 1000000000u;
+
+   (void) transport;
+   btest_sink += ((const uint8_t *) data)[size - 1];
+   btest_batchWrites++;
+   while(btest_now() < end)
+   {
+   }
+   return size;
+}
+
+/** \brief Sends the image, returns the time spent. */
+static btest_ticksType btest_batchImage(UPDT_ITransportType *transport, UPDT_ITransportBatchType *batch)
+{
+   const size_t chunk = UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE;
+   btest_ticksType start;
+   uint32_t frames;
+   uint8_t sequence_number = 0;
+
+   btest_batchWrites = 0;
+   start = btest_now();
+   for(frames = 0; frames < BTEST_BATCH_IMAGE_SIZE / chunk; frames++)
+   {
+      btest_batchFrame[0] = 0;
+      UPDT_protocolSetHeader(btest_batchFrame, UPDT_PROTOCOL_PACKET_DAT, sequence_number++, chunk);
+      UPDT_protocolSend(transport, btest_batchFrame, UPDT_protocolGetFrameSize(btest_batchFrame));
+      if(NULL != batch && BTEST_BATCH_WINDOW - 1 == frames % BTEST_BATCH_WINDOW)
+      {
+         /* the master waits for the acknowledgements */
+         UPDT_ITransportBatchFlush(batch);
+      }
+   }
+   if(NULL != batch)
+   {
+      UPDT_ITransportBatchFlush(batch);
+   }
+   return btest_now() - start;
+}
+
+/*==================[external functions definition]==========================*/
+void btest_batchRun(void)
+{
+   btest_ticksType ticks;
+
+   UPDT_ITransportInit(&btest_batchWire, NULL, btest_batchSend);
+
+   ticks = btest_batchImage(&btest_batchWire, NULL);
+   btest_report("batch", "direct", UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE,
+      btest_batchWrites, BTEST_BATCH_IMAGE_SIZE, ticks);
+
+   UPDT_ITransportBatchInit(&btest_batchObj, &btest_batchWire, btest_batchStaging,
+      sizeof(btest_batchStaging), sizeof(btest_batchStaging));
+   ticks = btest_batchImage(&btest_batchObj.transport, &btest_batchObj);
+   btest_report("batch", "batched", UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE,
+      btest_batchWrites, BTEST_BATCH_IMAGE_SIZE, ticks);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
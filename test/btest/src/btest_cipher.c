@@ -0,0 +1,234 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/** \brief Cipher benchmark source file
+ **
+ ** Measures the encrypted DAT path against the plain one: the copy of the
+ ** payload into the window slot and its CRC, then the same with the
+ ** payload sealed in place, and the receiver side check and open. The
+ ** ChaCha20 kernels and Poly1305 are measured alone too, to tell which
+ ** one bounds the throughput on the target.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup BTests CIAA Firmware Benchmarks
+ ** @{ */
+/** \addtogroup Update Update Module Benchmarks
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1   AG   first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdio.h"
+#include "ciaaPOSIX_string.h"
+#include "UPDT_protocol.h"
+#include "UPDT_cipher.h"
+#include "UPDT_crc32c.h"
+#include "btest.h"
+
+/*==================[macros and definitions]=================================*/
+typedef struct
+{
+   const char *name;
+   UPDT_cipherKernelType kernel;
+} btest_cipherCaseType;
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static const btest_cipherCaseType btest_cipherKernels[] =
+{
+   { "chacha20_scalar", UPDT_cipherChaCha20Scalar },
+#ifdef UPDT_CIPHER_SIMD
+   { "chacha20_simd", UPDT_cipherChaCha20Simd },
+#endif
+};
+
+/** DAT payload sizes, the tag included */
+static const uint16_t btest_cipherSizes[] =
+{
+   UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE,
+   512,
+   UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE,
+};
+
+static uint8_t btest_cipherPayload[UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE];
+static uint8_t btest_cipherFrame[UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE)];
+static UPDT_cipherType btest_cipher;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Copies the payload into the frame the way UPDT_protocolSessionSend
+ ** does, encrypting it if seal is non-zero. */
+static void btest_cipherBuild(uint16_t size, uint8_t seal, uint32_t number)
+{
+   btest_cipherFrame[0] = 0;
+   UPDT_protocolSetHeader(btest_cipherFrame, UPDT_PROTOCOL_PACKET_DAT, (uint8_t) number, size);
+   UPDT_protocolSetFlags(btest_cipherFrame, UPDT_PROTOCOL_FLAG_CRC |
+      (seal ? UPDT_PROTOCOL_FLAG_ENCRYPTED : 0));
+   ciaaPOSIX_memcpy(btest_cipherFrame + UPDT_PROTOCOL_HEADER_SIZE, btest_cipherPayload,
+      seal ? size - UPDT_CIPHER_TAG_SIZE : size);
+   if(seal)
+   {
+      UPDT_cipherSeal(&btest_cipher, btest_cipherFrame, btest_cipherFrame + UPDT_PROTOCOL_HEADER_SIZE, number);
+   }
+   UPDT_protocolSetCrc(btest_cipherFrame);
+}
+
+/*==================[external functions definition]==========================*/
+void btest_cipherRun(void)
+{
+   uint8_t key[UPDT_CIPHER_KEY_SIZE];
+   uint8_t inf[UPDT_PROTOCOL_PACKET_INF_PAYLOAD_SIZE];
+   uint8_t alw[UPDT_PROTOCOL_PACKET_ALW_PAYLOAD_SIZE];
+   uint8_t tag[UPDT_CIPHER_TAG_SIZE];
+   size_t kernel;
+   size_t size;
+   uint32_t iterations;
+   uint32_t i;
+   int32_t ret;
+   btest_ticksType start;
+   btest_ticksType ticks;
+
+   for(i = 0; i < sizeof(btest_cipherPayload); i++)
+   {
+      btest_cipherPayload[i] = (uint8_t) ciaaPOSIX_rand();
+   }
+   for(i = 0; i < sizeof(key); i++)
+   {
+      key[i] = (uint8_t) ciaaPOSIX_rand();
+   }
+   ciaaPOSIX_memset(inf, 0, sizeof(inf));
+   ciaaPOSIX_memset(alw, 0, sizeof(alw));
+   UPDT_cipherInit(&btest_cipher, key, inf, alw);
+
+   for(size = 0; size < sizeof(btest_cipherSizes) / sizeof(btest_cipherSizes[0]); size++)
+   {
+      iterations = BTEST_VOLUME / btest_cipherSizes[size];
+
+      /* the sender, without and with encryption */
+      start = btest_now();
+      for(i = 0; i < iterations; i++)
+      {
+         btest_cipherBuild(btest_cipherSizes[size], 0, i);
+      }
+      btest_sink = btest_cipherFrame[UPDT_PROTOCOL_HEADER_SIZE];
+      btest_report("cipher", "plain_send", btest_cipherSizes[size], iterations,
+         iterations * btest_cipherSizes[size], btest_now() - start);
+
+      start = btest_now();
+      for(i = 0; i < iterations; i++)
+      {
+         btest_cipherBuild(btest_cipherSizes[size], 1, i);
+      }
+      btest_sink = btest_cipherFrame[UPDT_PROTOCOL_HEADER_SIZE];
+      btest_report("cipher", "sealed_send", btest_cipherSizes[size], iterations,
+         iterations * btest_cipherSizes[size], btest_now() - start);
+
+      /* the receiver, the same frame is opened and encrypted again in
+       * turns so that every open works on an authentic frame */
+      btest_cipherBuild(btest_cipherSizes[size], 0, 0);
+      start = btest_now();
+      ret = UPDT_PROTOCOL_ERROR_NONE;
+      for(i = 0; i < iterations; i++)
+      {
+         ret |= UPDT_protocolCheckCrc(btest_cipherFrame);
+      }
+      btest_sink = ret;
+      btest_report("cipher", "plain_recv", btest_cipherSizes[size], iterations,
+         iterations * btest_cipherSizes[size], btest_now() - start);
+
+      btest_cipherBuild(btest_cipherSizes[size], 1, 0);
+      ticks = 0;
+      for(i = 0; i < iterations; i++)
+      {
+         start = btest_now();
+         ret |= UPDT_protocolCheckCrc(btest_cipherFrame);
+         ret |= UPDT_cipherOpen(&btest_cipher, btest_cipherFrame, btest_cipherFrame + UPDT_PROTOCOL_HEADER_SIZE, 0);
+         ticks += btest_now() - start;
+         /* not measured, it encrypts the payload again */
+         UPDT_cipherChaCha20(btest_cipher.key, btest_cipher.nonce, 1,
+            btest_cipherFrame + UPDT_PROTOCOL_HEADER_SIZE, btest_cipherSizes[size] - UPDT_CIPHER_TAG_SIZE);
+      }
+      btest_sink = ret;
+      btest_report("cipher", "opened_recv", btest_cipherSizes[size], iterations,
+         iterations * btest_cipherSizes[size], ticks);
+
+      /* the primitives alone */
+      for(kernel = 0; kernel < sizeof(btest_cipherKernels) / sizeof(btest_cipherKernels[0]); kernel++)
+      {
+         start = btest_now();
+         for(i = 0; i < iterations; i++)
+         {
+            btest_cipherKernels[kernel].kernel(btest_cipher.key, btest_cipher.nonce, 1,
+               btest_cipherPayload, btest_cipherSizes[size]);
+         }
+         btest_sink = btest_cipherPayload[0];
+         btest_report("cipher", btest_cipherKernels[kernel].name, btest_cipherSizes[size], iterations,
+            iterations * btest_cipherSizes[size], btest_now() - start);
+      }
+
+      start = btest_now();
+      for(i = 0; i < iterations; i++)
+      {
+         UPDT_cipherPoly1305(key, btest_cipherPayload, btest_cipherSizes[size], tag);
+      }
+      btest_sink = tag[0];
+      btest_report("cipher", "poly1305", btest_cipherSizes[size], iterations,
+         iterations * btest_cipherSizes[size], btest_now() - start);
+   }
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,144 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief CRC32C benchmark source file
+ **
+ ** Compares the CRC32C kernels over the payload sizes used by the protocol:
+ ** an ACK trailer, a default DAT frame, a 512 bytes flash page and the
+ ** largest frame the header can describe.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup BTests CIAA Firmware Benchmarks
+ ** @{ */
+/** \addtogroup Update Update Module Benchmarks
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1   AG   first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdio.h"
+#include "UPDT_crc32c.h"
+#include "UPDT_protocol.h"
+#include "btest.h"
+
+/*==================[macros and definitions]=================================*/
+typedef uint32_t (*btest_crc32cKernelType)(uint32_t crc, const void *data, size_t size);
+
+typedef struct
+{
+   const char *name;
+   btest_crc32cKernelType kernel;
+} btest_crc32cCaseType;
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static const btest_crc32cCaseType btest_crc32cKernels[] =
+{
+   { "bytewise", UPDT_crc32cUpdateBytewise },
+   { "slice8", UPDT_crc32cUpdateSlice8 },
+#ifdef UPDT_CRC32C_HARDWARE
+   { "hardware", UPDT_crc32cUpdateHardware },
+#endif
+};
+
+static const uint16_t btest_crc32cSizes[] =
+{
+   UPDT_PROTOCOL_HEADER_SIZE,
+   UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE) - UPDT_PROTOCOL_CRC_SIZE,
+   UPDT_PROTOCOL_FRAME_SIZE(512) - UPDT_PROTOCOL_CRC_SIZE,
+   UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE) - UPDT_PROTOCOL_CRC_SIZE,
+};
+
+static uint8_t btest_crc32cData[UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE)];
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+void btest_crc32cRun(void)
+{
+   size_t kernel;
+   size_t size;
+   uint32_t iterations;
+   uint32_t i;
+   uint32_t crc = 0;
+   btest_ticksType start;
+
+   for(i = 0; i < sizeof(btest_crc32cData); i++)
+   {
+      btest_crc32cData[i] = (uint8_t) ciaaPOSIX_rand();
+   }
+
+   for(kernel = 0; kernel < sizeof(btest_crc32cKernels) / sizeof(btest_crc32cKernels[0]); kernel++)
+   {
+      for(size = 0; size < sizeof(btest_crc32cSizes) / sizeof(btest_crc32cSizes[0]); size++)
+      {
+         iterations = BTEST_VOLUME / btest_crc32cSizes[size];
+
+         start = btest_now();
+         for(i = 0; i < iterations; i++)
+         {
+            crc = btest_crc32cKernels[kernel].kernel(crc, btest_crc32cData, btest_crc32cSizes[size]);
+         }
+         btest_sink = crc;
+
+         btest_report("crc32c", btest_crc32cKernels[kernel].name,
+            btest_crc32cSizes[size], iterations,
+            iterations * btest_crc32cSizes[size], btest_now() - start);
+      }
+   }
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
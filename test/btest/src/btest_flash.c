@@ -0,0 +1,270 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief Flash sink benchmark source file
+ **
+ ** Receives an image over a modeled link, one DAT frame every
+ ** BTEST_FLASH_FRAME_MS, and writes it to a simulated flash whose erase
+ ** and program latencies are BTEST_FLASH_ERASE_MS and
+ ** BTEST_FLASH_PROGRAM_MS. Each payload is handed to the sink in
+ ** UPDT_PROTOCOL_BOUNCE_SIZE pieces at their payload offsets, like
+ ** UPDT_protocolSessionRecvConsume does, and committed after the frame.
+ ** The cases compare programming in the receiving task with a worker task
+ ** and two to four page buffers, two being the least as the payloads cross
+ ** the pages, the erases planned ahead from the image size, and the skip
+ ** mode updating an installed image that differs in a single sector.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup BTests CIAA Firmware Benchmarks
+ ** @{ */
+/** \addtogroup Update Update Module Benchmarks
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.2   AG   consume the payloads in pieces
+ * 20261017 v0.0.1   AG   first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "os.h"
+#include "ciaaPOSIX_stdio.h"
+#include "ciaaPOSIX_assert.h"
+#include "ciaaPOSIX_string.h"
+#include "UPDT_flash.h"
+#include "UPDT_protocol.h"
+#include "btest.h"
+
+/*==================[macros and definitions]=================================*/
+/** size of the image written */
+#define BTEST_FLASH_IMAGE_SIZE     (16u * 1024u)
+/** geometry of the simulated flash */
+#define BTEST_FLASH_SECTOR_SIZE    4096u
+#define BTEST_FLASH_PAGE_SIZE      512u
+/** latency of a sector erase in milliseconds */
+#ifndef BTEST_FLASH_ERASE_MS
+#define BTEST_FLASH_ERASE_MS       100u
+#endif
+/** latency of a page program in milliseconds */
+#ifndef BTEST_FLASH_PROGRAM_MS
+#define BTEST_FLASH_PROGRAM_MS     4u
+#endif
+/** baud rate of the modeled link */
+#define BTEST_FLASH_BAUD_RATE      115200u
+/** milliseconds the link needs for a DAT frame, rounded up */
+#define BTEST_FLASH_FRAME_MS       (((UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE + \
+   UPDT_PROTOCOL_HEADER_SIZE) * 10u * 1000u + BTEST_FLASH_BAUD_RATE - 1u) / BTEST_FLASH_BAUD_RATE)
+
+/** flags of the cases */
+#define BTEST_FLASH_THREADED       0x01u
+#define BTEST_FLASH_PLAN           0x02u
+#define BTEST_FLASH_SKIP           0x04u
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static uint8_t btest_flashImage[BTEST_FLASH_IMAGE_SIZE];
+static uint8_t btest_flashMemory[BTEST_FLASH_IMAGE_SIZE];
+static uint8_t btest_flashBuffers[UPDT_FLASH_BUFFERS_MAX * BTEST_FLASH_PAGE_SIZE];
+static uint8_t btest_flashScratch[BTEST_FLASH_SECTOR_SIZE];
+static UPDT_flashSinkType btest_flashSinkObj;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Blocks the running task for some milliseconds.
+ **
+ ** The task waits for an event so the other task runs meanwhile, like it
+ ** would during a real flash operation or a reception.
+ **/
+static void btest_flashDelay(uint32_t ms)
+{
+   TaskType task;
+
+   GetTaskID(&task);
+   if(FlashTask == task)
+   {
+      SetRelAlarm(FlashDelayAlarm, ms, 0);
+      WaitEvent(FLASH_DELAY_EVENT);
+      ClearEvent(FLASH_DELAY_EVENT);
+   }
+   else
+   {
+      SetRelAlarm(InitDelayAlarm, ms, 0);
+      WaitEvent(INIT_DELAY_EVENT);
+      ClearEvent(INIT_DELAY_EVENT);
+   }
+}
+
+static int32_t btest_flashErase(UPDT_IFlashType *flash, uint32_t address, size_t size)
+{
+   (void) flash;
+   btest_flashDelay(BTEST_FLASH_ERASE_MS);
+   ciaaPOSIX_memset(btest_flashMemory + address, 0xFF, size);
+   return 0;
+}
+
+static int32_t btest_flashProgram(UPDT_IFlashType *flash, uint32_t address, const void *data, size_t size)
+{
+   (void) flash;
+   btest_flashDelay(BTEST_FLASH_PROGRAM_MS);
+   ciaaPOSIX_memcpy(btest_flashMemory + address, data, size);
+   return 0;
+}
+
+static int32_t btest_flashRead(UPDT_IFlashType *flash, uint32_t address, void *data, size_t size)
+{
+   (void) flash;
+   ciaaPOSIX_memcpy(data, btest_flashMemory + address, size);
+   return 0;
+}
+
+static UPDT_IFlashType btest_flashDevice =
+{
+   btest_flashErase,
+   btest_flashProgram,
+   btest_flashRead,
+   BTEST_FLASH_SECTOR_SIZE,
+   BTEST_FLASH_PAGE_SIZE
+};
+
+/** \brief Receives the image over the modeled link and writes it.
+ **
+ ** \param name Name of the case.
+ ** \param count Number of page buffers.
+ ** \param flags BTEST_FLASH_THREADED to program the pages in the FlashTask,
+ ** BTEST_FLASH_PLAN to give the image size in advance and BTEST_FLASH_SKIP
+ ** to update an installed image with the skip mode.
+ **/
+static void btest_flashCase(const char *name, uint8_t count, uint8_t flags)
+{
+   const size_t chunk = UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE;
+   size_t offset;
+   size_t piece;
+   size_t position;
+   size_t size;
+   uint32_t frames = 0;
+   btest_ticksType start;
+   btest_ticksType ticks;
+
+   ciaaPOSIX_memset(btest_flashMemory, 0, sizeof(btest_flashMemory));
+   UPDT_flashSinkInit(&btest_flashSinkObj, &btest_flashDevice, btest_flashBuffers, count, 0);
+   if(flags & BTEST_FLASH_SKIP)
+   {
+      /* the new image changes a few bytes of its second sector */
+      ciaaPOSIX_memcpy(btest_flashMemory, btest_flashImage, BTEST_FLASH_IMAGE_SIZE);
+      btest_flashMemory[BTEST_FLASH_SECTOR_SIZE + 100] ^= 0xFF;
+      UPDT_flashSinkSetSkip(&btest_flashSinkObj, btest_flashScratch);
+   }
+   if(flags & BTEST_FLASH_THREADED)
+   {
+      UPDT_flashSinkSetWorker(&btest_flashSinkObj, FlashTask, FLASH_WORK_EVENT,
+         InitTask, FLASH_DONE_EVENT);
+      ActivateTask(FlashTask);
+   }
+   if(flags & BTEST_FLASH_PLAN)
+   {
+      /* as soon as the INF frame is received */
+      UPDT_flashSinkPlan(&btest_flashSinkObj, BTEST_FLASH_IMAGE_SIZE);
+   }
+
+   start = btest_now();
+   for(offset = 0; offset < BTEST_FLASH_IMAGE_SIZE; offset += piece)
+   {
+      piece = BTEST_FLASH_IMAGE_SIZE - offset < chunk ? BTEST_FLASH_IMAGE_SIZE - offset : chunk;
+      btest_flashDelay(BTEST_FLASH_FRAME_MS);
+      for(position = 0; position < piece; position += size)
+      {
+         size = piece - position < UPDT_PROTOCOL_BOUNCE_SIZE ? piece - position : UPDT_PROTOCOL_BOUNCE_SIZE;
+         UPDT_flashSinkConsume(&btest_flashSinkObj, position, btest_flashImage + offset + position, size);
+      }
+      UPDT_flashSinkCommit(&btest_flashSinkObj, (uint8_t) frames);
+      frames++;
+   }
+   UPDT_flashSinkClose(&btest_flashSinkObj);
+   ticks = btest_now() - start;
+
+   for(offset = 0; offset < BTEST_FLASH_IMAGE_SIZE; offset++)
+   {
+      ciaaPOSIX_assert(btest_flashImage[offset] == btest_flashMemory[offset]);
+   }
+   btest_report("flash", name, BTEST_FLASH_PAGE_SIZE, frames, BTEST_FLASH_IMAGE_SIZE, ticks);
+}
+
+/*==================[external functions definition]==========================*/
+void btest_flashRun(void)
+{
+   size_t i;
+
+   for(i = 0; i < BTEST_FLASH_IMAGE_SIZE; i++)
+   {
+      btest_flashImage[i] = (uint8_t) ciaaPOSIX_rand();
+   }
+
+   /* link alone, the bound for the overlapped cases */
+   btest_report("flash", "link", BTEST_FLASH_PAGE_SIZE, 0, BTEST_FLASH_IMAGE_SIZE,
+      (btest_ticksType) ((BTEST_FLASH_IMAGE_SIZE + UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE - 1) /
+      UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE) * BTEST_FLASH_FRAME_MS * (BTEST_TICKS_PER_SECOND / 1000u));
+   btest_flashCase("inline", 2, 0);
+   btest_flashCase("buffers_2", 2, BTEST_FLASH_THREADED);
+   btest_flashCase("buffers_3", 3, BTEST_FLASH_THREADED);
+   btest_flashCase("buffers_4", 4, BTEST_FLASH_THREADED);
+   btest_flashCase("buffers_2_plan", 2, BTEST_FLASH_THREADED | BTEST_FLASH_PLAN);
+   btest_flashCase("buffers_2_skip", 2, BTEST_FLASH_THREADED | BTEST_FLASH_SKIP);
+}
+
+/** \brief Flash worker task */
+TASK(FlashTask)
+{
+   UPDT_flashSinkWork(&btest_flashSinkObj);
+   TerminateTask();
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,227 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief Framing benchmark source file
+ **
+ ** Runs the header accessors and the UPDT_protocolSend and UPDT_protocolRecv
+ ** loops over BTEST_FRAMING_FRAMES DAT frames. The loops run against a null
+ ** transport, which only returns the size, to measure the framing alone and
+ ** against a memcpy transport, which moves the bytes through a buffer like a
+ ** driver would.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup BTests CIAA Firmware Benchmarks
+ ** @{ */
+/** \addtogroup Update Update Module Benchmarks
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.2   AG   clear the optional transport entries with UPDT_ITransportInit
+ * 20261017 v0.0.1   AG   first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdio.h"
+#include "ciaaPOSIX_string.h"
+#include "UPDT_ITransport.h"
+#include "UPDT_protocol.h"
+#include "btest.h"
+
+/*==================[macros and definitions]=================================*/
+/** number of frames of each case */
+#if (ARCH == posix)
+#define BTEST_FRAMING_FRAMES       (4u * 1024u * 1024u)
+#else
+#define BTEST_FRAMING_FRAMES       (64u * 1024u)
+#endif
+/** size of a DAT frame */
+#define BTEST_FRAMING_FRAME_SIZE \
+   UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE)
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static uint8_t btest_framingFrame[BTEST_FRAMING_FRAME_SIZE];
+/** stands for the driver buffer of the memcpy transport */
+static uint8_t btest_framingWire[BTEST_FRAMING_FRAME_SIZE];
+static UPDT_ITransportType btest_framingNull;
+static UPDT_ITransportType btest_framingMemcpy;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Send of the null transport. */
+static ssize_t btest_framingNullSend(UPDT_ITransportType *transport, const void *data, size_t size)
+{
+   (void) transport;
+   (void) data;
+   return size;
+}
+
+/** \brief Receive of the null transport. */
+static ssize_t btest_framingNullRecv(UPDT_ITransportType *transport, void *data, size_t size)
+{
+   (void) transport;
+   (void) data;
+   return size;
+}
+
+/** \brief Send of the memcpy transport. */
+static ssize_t btest_framingMemcpySend(UPDT_ITransportType *transport, const void *data, size_t size)
+{
+   (void) transport;
+   ciaaPOSIX_memcpy(btest_framingWire, data, size);
+   return size;
+}
+
+/** \brief Receive of the memcpy transport. */
+static ssize_t btest_framingMemcpyRecv(UPDT_ITransportType *transport, void *data, size_t size)
+{
+   (void) transport;
+   ciaaPOSIX_memcpy(data, btest_framingWire, size);
+   return size;
+}
+
+/** \brief Writes the header of every frame. */
+static void btest_framingSetHeader(void)
+{
+   btest_ticksType start;
+   uint32_t i;
+
+   start = btest_now();
+   for(i = 0; i < BTEST_FRAMING_FRAMES; i++)
+   {
+      btest_framingFrame[0] = 0;
+      UPDT_protocolSetHeader(btest_framingFrame, UPDT_PROTOCOL_PACKET_DAT, (uint8_t) i,
+         UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE);
+   }
+   btest_report("framing", "set_header", UPDT_PROTOCOL_HEADER_SIZE, BTEST_FRAMING_FRAMES,
+      BTEST_FRAMING_FRAMES * UPDT_PROTOCOL_HEADER_SIZE, btest_now() - start);
+   btest_sink += btest_framingFrame[UPDT_PROTOCOL_HEADER_SIZE - 1];
+}
+
+/** \brief Reads the packet type, payload size and sequence number of every
+ ** frame. */
+static void btest_framingGetHeader(void)
+{
+   btest_ticksType start;
+   uint32_t sum = 0;
+   uint32_t i;
+
+   start = btest_now();
+   for(i = 0; i < BTEST_FRAMING_FRAMES; i++)
+   {
+      btest_framingFrame[2] = (uint8_t) i;
+      sum += UPDT_protocolGetPacketType(btest_framingFrame);
+      sum += UPDT_protocolGetPayloadSize(btest_framingFrame);
+      sum += UPDT_protocolGetSequenceNumber(btest_framingFrame);
+   }
+   btest_report("framing", "get_header", UPDT_PROTOCOL_HEADER_SIZE, BTEST_FRAMING_FRAMES,
+      BTEST_FRAMING_FRAMES * UPDT_PROTOCOL_HEADER_SIZE, btest_now() - start);
+   btest_sink += sum;
+}
+
+/** \brief Sends every frame, header and payload at once. */
+static void btest_framingSend(const char *name, UPDT_ITransportType *transport)
+{
+   btest_ticksType start;
+   uint32_t i;
+
+   start = btest_now();
+   for(i = 0; i < BTEST_FRAMING_FRAMES; i++)
+   {
+      UPDT_protocolSend(transport, btest_framingFrame, BTEST_FRAMING_FRAME_SIZE);
+   }
+   btest_report("framing", name, BTEST_FRAMING_FRAME_SIZE, BTEST_FRAMING_FRAMES,
+      BTEST_FRAMING_FRAMES * BTEST_FRAMING_FRAME_SIZE, btest_now() - start);
+}
+
+/** \brief Receives every frame, the header first and then the rest of the
+ ** frame, like the protocol does. */
+static void btest_framingRecv(const char *name, UPDT_ITransportType *transport)
+{
+   btest_ticksType start;
+   uint32_t i;
+
+   start = btest_now();
+   for(i = 0; i < BTEST_FRAMING_FRAMES; i++)
+   {
+      UPDT_protocolRecv(transport, btest_framingFrame, UPDT_PROTOCOL_HEADER_SIZE);
+      UPDT_protocolRecv(transport, btest_framingFrame + UPDT_PROTOCOL_HEADER_SIZE,
+         UPDT_protocolGetFrameSize(btest_framingFrame) - UPDT_PROTOCOL_HEADER_SIZE);
+   }
+   btest_report("framing", name, BTEST_FRAMING_FRAME_SIZE, BTEST_FRAMING_FRAMES,
+      BTEST_FRAMING_FRAMES * BTEST_FRAMING_FRAME_SIZE, btest_now() - start);
+   btest_sink += btest_framingFrame[BTEST_FRAMING_FRAME_SIZE - 1];
+}
+
+/*==================[external functions definition]==========================*/
+void btest_framingRun(void)
+{
+   UPDT_ITransportInit(&btest_framingNull, btest_framingNullRecv, btest_framingNullSend);
+   UPDT_ITransportInit(&btest_framingMemcpy, btest_framingMemcpyRecv, btest_framingMemcpySend);
+
+   btest_framingSetHeader();
+   btest_framingGetHeader();
+
+   /* the frames received carry a valid header */
+   btest_framingFrame[0] = 0;
+   UPDT_protocolSetHeader(btest_framingFrame, UPDT_PROTOCOL_PACKET_DAT, 0,
+      UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE);
+   ciaaPOSIX_memcpy(btest_framingWire, btest_framingFrame, sizeof(btest_framingWire));
+
+   btest_framingSend("send_null", &btest_framingNull);
+   btest_framingSend("send_memcpy", &btest_framingMemcpy);
+   btest_framingRecv("recv_null", &btest_framingNull);
+   btest_framingRecv("recv_memcpy", &btest_framingMemcpy);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,174 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief LZSS benchmark source file
+ **
+ ** Measures the LZSS decoder fed with DAT sized pieces and the effective
+ ** image throughput of a serial link with and without compression. The
+ ** link is modeled, 10 bits per byte at BTEST_LZSS_BAUD_RATE, and the
+ ** decoding time is added to the compressed transfer.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup BTests CIAA Firmware Benchmarks
+ ** @{ */
+/** \addtogroup Update Update Module Benchmarks
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1   AG   first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdio.h"
+#include "UPDT_lzss.h"
+#include "UPDT_protocol.h"
+#include "btest.h"
+
+/*==================[macros and definitions]=================================*/
+/** size of the image compressed */
+#define BTEST_LZSS_IMAGE_SIZE      (16u * 1024u)
+/** baud rate of the modeled link */
+#define BTEST_LZSS_BAUD_RATE       115200u
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static uint8_t btest_lzssImage[BTEST_LZSS_IMAGE_SIZE];
+static uint8_t btest_lzssCompressed[UPDT_LZSS_BOUND(BTEST_LZSS_IMAGE_SIZE)];
+static UPDT_lzssDecoderType btest_lzssDecoder;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Consumer standing for the flash writer. */
+static int32_t btest_lzssSink(void *context, size_t offset, const uint8_t *data, size_t size)
+{
+   (void) context;
+   btest_sink += (uint32_t) offset + data[size - 1];
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Fills the image with something resembling Thumb-2 code.
+ **
+ ** A small vocabulary of instructions with random operands, literal pools
+ ** and the erased flash padding at the end of the image.
+ **/
+static void btest_lzssFill(void)
+{
+   static const uint16_t opcodes[] =
+   {
+      0xB580, 0x4668, 0xF000, 0x2000, 0x6818, 0x4770, 0xBD80, 0x9001,
+   };
+   size_t i;
+
+   for(i = 0; i < BTEST_LZSS_IMAGE_SIZE * 7 / 8; i += 2)
+   {
+      uint16_t word = opcodes[ciaaPOSIX_rand() % 8];
+
+      if(0 == ciaaPOSIX_rand() % 4)
+      {
+         word |= (uint16_t) (ciaaPOSIX_rand() & 0x00FF);
+      }
+      btest_lzssImage[i] = (uint8_t) word;
+      btest_lzssImage[i + 1] = (uint8_t) (word >> 8);
+   }
+   for(; i < BTEST_LZSS_IMAGE_SIZE; i++)
+   {
+      btest_lzssImage[i] = 0xFF;
+   }
+}
+
+/** \brief Returns the ticks a link needs to transfer a number of bytes. */
+static btest_ticksType btest_lzssLinkTicks(size_t bytes)
+{
+   return (btest_ticksType) bytes * 10u * BTEST_TICKS_PER_SECOND / BTEST_LZSS_BAUD_RATE;
+}
+
+/*==================[external functions definition]==========================*/
+void btest_lzssRun(void)
+{
+   const size_t chunk = UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE;
+   size_t size;
+   size_t offset;
+   size_t piece;
+   uint32_t iterations;
+   uint32_t i;
+   btest_ticksType start;
+   btest_ticksType decode;
+
+   btest_lzssFill();
+   size = UPDT_lzssEncode(btest_lzssImage, BTEST_LZSS_IMAGE_SIZE,
+      btest_lzssCompressed, sizeof(btest_lzssCompressed));
+
+   /* decoder alone, fed one DAT payload at a time */
+   iterations = BTEST_VOLUME / BTEST_LZSS_IMAGE_SIZE;
+   start = btest_now();
+   for(i = 0; i < iterations; i++)
+   {
+      UPDT_lzssDecoderInit(&btest_lzssDecoder, BTEST_LZSS_IMAGE_SIZE, btest_lzssSink, NULL);
+      for(offset = 0; offset < size; offset += piece)
+      {
+         piece = size - offset < chunk ? size - offset : chunk;
+         UPDT_lzssDecoderConsume(&btest_lzssDecoder, offset, btest_lzssCompressed + offset, piece);
+      }
+   }
+   decode = btest_now() - start;
+   btest_report("lzss", "decode", chunk, iterations,
+      iterations * BTEST_LZSS_IMAGE_SIZE, decode);
+
+   /* effective image bytes per second over the link */
+   btest_report("lzss", "link_raw", BTEST_LZSS_IMAGE_SIZE, 1,
+      BTEST_LZSS_IMAGE_SIZE, btest_lzssLinkTicks(BTEST_LZSS_IMAGE_SIZE));
+   btest_report("lzss", "link_lzss", (uint32_t) size, 1,
+      BTEST_LZSS_IMAGE_SIZE, btest_lzssLinkTicks(size) + decode / iterations);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
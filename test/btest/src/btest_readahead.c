@@ -0,0 +1,173 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief Read-ahead benchmark source file
+ **
+ ** Receives DAT frames, header first and then the rest of the frame like
+ ** the protocol does, straight from a transport and through the read-ahead
+ ** decorator. The transport stands for the POSIX serial driver: each read
+ ** costs BTEST_READAHEAD_READ_NS and returns at most the bytes the driver
+ ** holds, a hardware FIFO or a large driver buffer. The number of reads is
+ ** reported as the iterations.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup BTests CIAA Firmware Benchmarks
+ ** @{ */
+/** \addtogroup Update Update Module Benchmarks
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.2   AG   clear the optional transport entries with UPDT_ITransportInit
+ * 20261017 v0.0.1   AG   first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdio.h"
+#include "UPDT_ITransport.h"
+#include "UPDT_protocol.h"
+#include "btest.h"
+
+/*==================[macros and definitions]=================================*/
+/** number of frames received by each case */
+#define BTEST_READAHEAD_FRAMES     256u
+/** size of the ring buffer of the decorator */
+#define BTEST_READAHEAD_RING_SIZE  512u
+/** cost of a read of the transport in nanoseconds */
+#ifndef BTEST_READAHEAD_READ_NS
+#define BTEST_READAHEAD_READ_NS    5000u
+#endif
+/** size of a DAT frame */
+#define BTEST_READAHEAD_FRAME_SIZE \
+   (UPDT_PROTOCOL_HEADER_SIZE + UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE)
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static uint8_t btest_readaheadFrame[BTEST_READAHEAD_FRAME_SIZE];
+static uint8_t btest_readaheadRing[BTEST_READAHEAD_RING_SIZE];
+static UPDT_ITransportType btest_readaheadWire;
+static UPDT_ITransportReadAheadType btest_readaheadObj;
+/** bytes returned by a read at most */
+static size_t btest_readaheadDriver;
+/** position in the stream of frames */
+static size_t btest_readaheadPosition;
+static uint32_t btest_readaheadReads;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Read of the modeled serial driver. */
+static ssize_t btest_readaheadRecv(UPDT_ITransportType *transport, void *data, size_t size)
+{
+   btest_ticksType end = btest_now() +
+      (btest_ticksType) BTEST_READAHEAD_READ_NS * BTEST_TICKS_PER_SECOND / 1000000000u;
+   uint8_t *bytes = (uint8_t *) data;
+   size_t i;
+
+   (void) transport;
+   if(size > btest_readaheadDriver)
+   {
+      size = btest_readaheadDriver;
+   }
+   for(i = 0; i < size; i++)
+   {
+      bytes[i] = btest_readaheadFrame[btest_readaheadPosition++ % BTEST_READAHEAD_FRAME_SIZE];
+   }
+   btest_readaheadReads++;
+   while(btest_now() < end)
+   {
+   }
+   return size;
+}
+
+/** \brief Receives the frames and reports the case. */
+static void btest_readaheadCase(const char *name, UPDT_ITransportType *transport, size_t driver)
+{
+   static uint8_t frame[BTEST_READAHEAD_FRAME_SIZE];
+   btest_ticksType start;
+   uint32_t i;
+
+   btest_readaheadDriver = driver;
+   btest_readaheadPosition = 0;
+   btest_readaheadReads = 0;
+   start = btest_now();
+   for(i = 0; i < BTEST_READAHEAD_FRAMES; i++)
+   {
+      UPDT_protocolRecv(transport, frame, UPDT_PROTOCOL_HEADER_SIZE);
+      UPDT_protocolRecv(transport, frame + UPDT_PROTOCOL_HEADER_SIZE,
+         UPDT_protocolGetFrameSize(frame) - UPDT_PROTOCOL_HEADER_SIZE);
+      btest_sink += frame[BTEST_READAHEAD_FRAME_SIZE - 1];
+   }
+   btest_report("readahead", name, (uint32_t) driver, btest_readaheadReads,
+      BTEST_READAHEAD_FRAMES * BTEST_READAHEAD_FRAME_SIZE, btest_now() - start);
+}
+
+/*==================[external functions definition]==========================*/
+void btest_readaheadRun(void)
+{
+   static const size_t drivers[] = { 16, 1024 };
+   size_t i;
+
+   btest_readaheadFrame[0] = 0;
+   UPDT_protocolSetHeader(btest_readaheadFrame, UPDT_PROTOCOL_PACKET_DAT, 0,
+      UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE);
+   UPDT_ITransportInit(&btest_readaheadWire, btest_readaheadRecv, NULL);
+
+   for(i = 0; i < sizeof(drivers) / sizeof(drivers[0]); i++)
+   {
+      btest_readaheadCase("direct", &btest_readaheadWire, drivers[i]);
+      UPDT_ITransportReadAheadInit(&btest_readaheadObj, &btest_readaheadWire,
+         btest_readaheadRing, sizeof(btest_readaheadRing));
+      btest_readaheadCase("readahead", &btest_readaheadObj.transport, drivers[i]);
+   }
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
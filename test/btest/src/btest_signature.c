@@ -0,0 +1,159 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/** \brief Signature benchmark source file
+ **
+ ** Measures the cost of the image signature on the slave: the SHA-256 of
+ ** the DAT payloads as they arrive, per payload size, and the Ed25519
+ ** verification done once after the SIG frame. The 1024 bytes case gives
+ ** the hashing cost per KB of image.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup BTests CIAA Firmware Benchmarks
+ ** @{ */
+/** \addtogroup Update Update Module Benchmarks
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1   AG   first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdio.h"
+#include "UPDT_protocol.h"
+#include "UPDT_sha256.h"
+#include "UPDT_signature.h"
+#include "btest.h"
+
+/*==================[macros and definitions]=================================*/
+#if (ARCH == posix)
+/** verifications measured */
+#define BTEST_SIGNATURE_VERIFICATIONS    50u
+#else
+#define BTEST_SIGNATURE_VERIFICATIONS    2u
+#endif
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static const uint16_t btest_signatureSizes[] =
+{
+   UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE,
+   512,
+   1024,
+   UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE,
+};
+
+static uint8_t btest_signatureData[UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE];
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+void btest_signatureRun(void)
+{
+   UPDT_sha256Type sha;
+   uint8_t seed[UPDT_SIGNATURE_SEED_SIZE];
+   uint8_t public_key[UPDT_SIGNATURE_KEY_SIZE];
+   uint8_t digest[UPDT_SHA256_SIZE];
+   uint8_t signature[UPDT_SIGNATURE_SIZE];
+   size_t size;
+   uint32_t iterations;
+   uint32_t i;
+   int32_t ret = UPDT_PROTOCOL_ERROR_NONE;
+   btest_ticksType start;
+
+   for(i = 0; i < sizeof(btest_signatureData); i++)
+   {
+      btest_signatureData[i] = (uint8_t) ciaaPOSIX_rand();
+   }
+
+   /* one stream hashed payload by payload */
+   for(size = 0; size < sizeof(btest_signatureSizes) / sizeof(btest_signatureSizes[0]); size++)
+   {
+      iterations = BTEST_VOLUME / btest_signatureSizes[size];
+
+      UPDT_sha256Init(&sha);
+      start = btest_now();
+      for(i = 0; i < iterations; i++)
+      {
+         UPDT_sha256Update(&sha, btest_signatureData, btest_signatureSizes[size]);
+      }
+      UPDT_sha256Final(&sha, digest);
+      btest_sink = digest[0];
+
+      btest_report("signature", "sha256", btest_signatureSizes[size], iterations,
+         iterations * btest_signatureSizes[size], btest_now() - start);
+   }
+
+   /* the check after the SIG frame */
+   for(i = 0; i < sizeof(seed); i++)
+   {
+      seed[i] = (uint8_t) ciaaPOSIX_rand();
+   }
+   UPDT_signaturePublicKey(seed, public_key);
+   UPDT_signatureSign(seed, digest, sizeof(digest), signature);
+
+   start = btest_now();
+   for(i = 0; i < BTEST_SIGNATURE_VERIFICATIONS; i++)
+   {
+      ret |= UPDT_signatureVerify(public_key, digest, sizeof(digest), signature);
+      btest_now();
+   }
+   btest_sink = ret;
+
+   btest_report("signature", "ed25519_verify", sizeof(digest), BTEST_SIGNATURE_VERIFICATIONS,
+      BTEST_SIGNATURE_VERIFICATIONS * sizeof(digest), btest_now() - start);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -2,6 +2,7 @@
  * Copyright 2015, Esteban Volentini
  * Copyright 2015, Matias Giori
  * Copyright 2015, Franco Salinas
+ * Copyright 2026, agent
  *
  * This file is part of CIAA Firmware.
  *
@@ -52,11 +53,13 @@
  * EV           Esteban Volentini
  * MG           Matias Giori
  * FS           Franco Salinas
+ * AG           agent
  */
 
 /*
  * modification history (new versions first)
  * -----------------------------------------------------------
+ * 20261017 v0.0.2  AG  add deadline aware receive
  * 20150418 v0.0.1  FS  first initial version
  */
 
@@ -72,6 +75,11 @@ extern "C" {
 #endif
 
 /*==================[macros]=================================================*/
+/** Size of the loopback circular buffers. It must be a power of two large
+ ** enough to hold the frames of a whole sliding window */
+#define TEST_UPDATE_LOOPBACK_BUFFER_SIZE     1024
+/** Longest relative alarm, the MAXALLOWEDVALUE of the OIL counter */
+#define TEST_UPDATE_LOOPBACK_ALARM_MAX       10000
 
 /*==================[typedef]================================================*/
 /** \brief Loopback transport layer type. */
@@ -82,7 +90,7 @@ typedef struct test_update_loopbackType
    /** Transport interface */
    UPDT_ITransportType transport;
    /** Memory block for the circular buffer */
-   uint8_t own_cbuf_mem[UPDT_PROTOCOL_PACKET_MAX_SIZE * 2];
+   uint8_t own_cbuf_mem[TEST_UPDATE_LOOPBACK_BUFFER_SIZE];
    /** Own circular buffer struct */
    ciaaLibs_CircBufType own_cbuf;
    /** Destination circular buffer struct */
@@ -91,6 +99,12 @@ typedef struct test_update_loopbackType
    TaskType task_id;
    /** Event Mask */
    EventMaskType recv_event;
+   /** Event set by the timeout alarm */
+   EventMaskType timeout_event;
+   /** Alarm which bounds the waits with a deadline */
+   AlarmType timeout_alarm;
+   /** Non-zero while the timeout alarm is running */
+   uint8_t alarm_armed;
    /** Counterpart */
    test_update_loopbackType *counterpart;
 } test_update_loopbackType;
@@ -107,12 +121,16 @@ typedef struct test_update_loopbackType
  ** \param tx_buffer Transmitter circular buffer.
  ** \param task_id Task ID for the calling task.
  ** \param recv_event Receive event mask used by SetEvent and WaitEvent.
+ ** \param timeout_event Event mask set by the timeout alarm.
+ ** \param timeout_alarm Alarm which sets timeout_event on the task.
  ** \return 0 on success. Non-zero on error.
  **/
 int32_t test_update_loopbackInit(
    test_update_loopbackType *loopback,
    TaskType task_id,
-   EventMaskType recv_event);
+   EventMaskType recv_event,
+   EventMaskType timeout_event,
+   AlarmType timeout_alarm);
 
 /** \brief Connects two loopback entities.
  **
@@ -129,7 +147,9 @@ void test_update_loopbackConnect(
 
 /** \brief Clears a loopback structure.
  **
- ** Clears the loopback transport layer structure.
+ ** Clears the loopback transport layer structure. It waits for the timeout
+ ** alarm if it is running, so it must be called by the task owning the
+ ** loopback before it terminates.
  **
  ** \param loopback The loopback structure to clear.
  **/
@@ -3,6 +3,7 @@
  * Copyright 2015, Matias Giori
  * Copyright 2015, Franco Salinas
  * Copyright 2015, Pablo Alcorta
+ * Copyright 2026, agent
  *
  * This file is part of CIAA Firmware.
  *
@@ -59,11 +60,16 @@
  * MG           Matias Giori
  * FS           Franco Salinas
  * PA           Pablo Alcorta
+ * AG           agent
  */
 
 /*
  * modification history (new versions first)
  * -----------------------------------------------------------
+ * 20261017 v0.0.5   AG   encrypt the DAT payloads
+ * 20261017 v0.0.4   AG   sign the image and send the SIG packet
+ * 20261017 v0.0.3   AG   send the data of a packed image
+ * 20261017 v0.0.2   AG   bound the master waits with a timeout
  * 20150408 v0.0.1   FS   first initial version
  */
 
@@ -74,12 +80,21 @@
 #include "ciaaPOSIX_stdio.h"  /* <= device handler header */
 #include "ciaak.h"            /* <= ciaa kernel header */
 #include "UPDT_services.h"
+#include "UPDT_packer.h"
+#include "UPDT_signature.h"
+#include "UPDT_cipher.h"
 #include "test_protocol_loopback.h"
 #include "ciaaLibs_Endianess.h"
 #include "ciaaLibs_format.h"
 
 /*==================[macros and definitions]=================================*/
 #define DATA_SIZE 1024
+/** number of data packets sent without waiting for their acknowledgement */
+#define MASTER_WINDOW_SIZE 4
+/** milliseconds the master waits for an acknowledgement before retransmitting */
+#define MASTER_TIMEOUT 500
+/** flash page size the image is padded to */
+#define MASTER_PAGE_SIZE 512
 
 typedef struct {
    uint32_t reserved1;
@@ -102,7 +117,36 @@ typedef struct {
 /*==================[internal data definition]===============================*/
 /* master side*/
 static test_update_loopbackType master_transport;
-static uint8_t payload_size=248;
+static UPDT_protocolSessionType master_session;
+static const UPDT_protocolCapabilitiesType master_capabilities =
+{
+   UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE,
+   MASTER_WINDOW_SIZE,
+   UPDT_PROTOCOL_CAPABILITY_SIGNATURE | UPDT_PROTOCOL_CAPABILITY_ENCRYPTION
+};
+static uint8_t master_frames[MASTER_WINDOW_SIZE][UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE)];
+static uint8_t master_image[DATA_SIZE];
+static UPDT_packerType master_packer;
+static UPDT_packerSegmentType master_segments[1];
+/** test key of the master, the slave holds its public key */
+static const uint8_t master_seed[UPDT_SIGNATURE_SEED_SIZE] =
+{
+   0x9d, 0x61, 0xb1, 0x9d, 0xef, 0xfd, 0x5a, 0x60, 0xba, 0x84, 0x4a, 0xf4, 0x92, 0xec, 0x2c, 0xc4,
+   0x44, 0x49, 0xc5, 0x69, 0x7b, 0x32, 0x69, 0x19, 0x70, 0x3b, 0xac, 0x03, 0x1c, 0xae, 0x7f, 0x60
+};
+static UPDT_sha256Type master_sha;
+/** test key shared with the slave */
+static const uint8_t master_key[UPDT_CIPHER_KEY_SIZE] =
+{
+   0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
+   0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f
+};
+static UPDT_cipherType master_cipher;
+/** INF payload sent, the session nonce is derived from it */
+static uint8_t master_inf[UPDT_PROTOCOL_PACKET_INF_PAYLOAD_SIZE];
+/** the slave of this test answers the INF with an ACK, so its ALW payload
+ ** is all zero */
+static const uint8_t master_alw[UPDT_PROTOCOL_PACKET_ALW_PAYLOAD_SIZE];
 /* slave side */
 static test_update_loopbackType slave_transport;
 static int32_t slave_fd = -1;
@@ -162,13 +206,13 @@ static void test_update_value (test_updt_configType *values)
    values->unique_id_high = 8;
    values->unique_id_low = 9;
    #endif // CIAAPLATFORM_BIGENDIAN
-   values->data_size = 10;
+   values->data_size = UPDT_packerGetSize(&master_packer);
 }
 
-/* I assign values random to the payload to perform a test*/
+/* I assign values random to the image to perform a test*/
 static void testUpdtValueData (uint8_t *vector, uint32_t paySize)
 {
-   uint8_t i;
+   uint32_t i;
    for (i=0;i<paySize;i++)
    {
       vector[i]=ciaaPOSIX_rand();
@@ -180,6 +224,7 @@ static void makeHandshakeOk (test_updt_configType *type,uint8_t *vector)
    UPDT_protocolSetHeader (vector,UPDT_PROTOCOL_PACKET_INF,SequenceNumber,32);
    test_update_value (type);
    test_updt_configFormat (type,vector+4,32);
+   UPDT_protocolSetCapabilities (vector+4+UPDT_PROTOCOL_INF_CAPABILITIES_OFFSET,&master_capabilities);
    SequenceNumber++;
 }
 
@@ -196,6 +241,7 @@ static void makeHandshakeOkNextSequenceNumber(test_updt_configType *type, uint8_
    UPDT_protocolSetHeader (vector, UPDT_PROTOCOL_PACKET_INF,SequenceNumber,32);
    test_update_value (type);
    test_updt_configFormat (type,vector+4,32);
+   UPDT_protocolSetCapabilities (vector+4+UPDT_PROTOCOL_INF_CAPABILITIES_OFFSET,&master_capabilities);
    SequenceNumber++;
 }
 
@@ -206,16 +252,46 @@ static uint32_t testHandshakeOkNextSequenceNumber(test_updt_configType *type, ui
    return 0;
 }
 
-static void makeDataOk (test_updt_configType *type, uint8_t *vector, uint8_t payload_size)
-{
-   UPDT_protocolSetHeader (vector,UPDT_PROTOCOL_PACKET_DAT,SequenceNumber,32);
-   testUpdtValueData (vector+4,payload_size);
-}
-
-static uint32_t testDataOk(uint8_t *vector)
+/* I send the packed image encrypted through a sliding window session and sign it */
+static uint32_t testDataWindowOk (void)
 {
-   ciaaPOSIX_assert (UPDT_PROTOCOL_PACKET_ACK == UPDT_protocolGetPacketType(vector));
-   ciaaPOSIX_assert (SequenceNumber==UPDT_protocolGetSequenceNumber(vector));
+   /* the tag takes the end of each DAT payload */
+   uint8_t payload[UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE - UPDT_CIPHER_TAG_SIZE];
+   uint8_t digest[UPDT_SHA256_SIZE];
+   uint8_t signature[UPDT_SIGNATURE_SIZE];
+   const uint8_t *data;
+   int32_t bytes_packed;
+   uint32_t data_size = UPDT_packerGetSize(&master_packer);
+   uint32_t hashed = 0;
+
+   ciaaPOSIX_assert(UPDT_protocolSessionInit(&master_session,
+      (UPDT_ITransportType *) &master_transport, master_frames[0],
+      sizeof(master_frames[0]), MASTER_WINDOW_SIZE, SequenceNumber) == UPDT_PROTOCOL_ERROR_NONE);
+   UPDT_protocolSessionSetTimeout(&master_session, MASTER_TIMEOUT);
+   UPDT_protocolSessionSetCipher(&master_session, UPDT_cipherSeal, &master_cipher);
+   UPDT_sha256Init(&master_sha);
+
+   /* the payloads come straight from the image, the last one is padded */
+   while((bytes_packed = UPDT_packerGet(&master_packer, payload, sizeof(payload), &data)) > 0)
+   {
+      /* the padding after data_size is not signed */
+      if(hashed < data_size)
+      {
+         UPDT_sha256Update(&master_sha, data,
+            (data_size - hashed) < (uint32_t) bytes_packed ? (data_size - hashed) : (uint32_t) bytes_packed);
+      }
+      hashed += bytes_packed;
+      ciaaPOSIX_assert(UPDT_protocolSessionSend(&master_session,
+         UPDT_PROTOCOL_PACKET_DAT, data, bytes_packed) == UPDT_PROTOCOL_ERROR_NONE);
+   }
+   /* the signature closes the image */
+   UPDT_sha256Final(&master_sha, digest);
+   UPDT_signatureSign(master_seed, digest, sizeof(digest), signature);
+   ciaaPOSIX_assert(UPDT_protocolSessionSend(&master_session,
+      UPDT_PROTOCOL_PACKET_SIG, signature, sizeof(signature)) == UPDT_PROTOCOL_ERROR_NONE);
+   /* wait for the acknowledgement of the last data packet */
+   ciaaPOSIX_assert(UPDT_protocolSessionFlush(&master_session) == UPDT_PROTOCOL_ERROR_NONE);
+   SequenceNumber = master_session.next;
    return 0;
 }
 
@@ -278,10 +354,12 @@ TASK(InitTask)
    ciaaPOSIX_printf("Init Task\n");
 
    /* initialize loopback transport layers */
-   ret = test_update_loopbackInit(&master_transport, MasterTask, MASTER_RECV_EVENT);
+   ret = test_update_loopbackInit(&master_transport, MasterTask, MASTER_RECV_EVENT,
+      MASTER_TIMEOUT_EVENT, MasterTimeoutAlarm);
    ciaaPOSIX_assert(0 == ret);
 
-   ret = test_update_loopbackInit(&slave_transport, SlaveTask, SLAVE_RECV_EVENT);
+   ret = test_update_loopbackInit(&slave_transport, SlaveTask, SLAVE_RECV_EVENT,
+      SLAVE_TIMEOUT_EVENT, SlaveTimeoutAlarm);
    ciaaPOSIX_assert(0 == ret);
 
    /* connect master and slave */
@@ -304,46 +382,28 @@ TASK(MasterTask)
    test_updt_configType type;
    ciaaPOSIX_printf("Master Task\n");
 
+   /* a raw image, padded to whole flash pages */
+   testUpdtValueData (master_image, sizeof(master_image));
+   ciaaPOSIX_assert(UPDT_packerInit(&master_packer, master_image, sizeof(master_image),
+      UPDT_PACKER_FORMAT_RAW, 0, MASTER_PAGE_SIZE, master_segments, 1) == UPDT_PROTOCOL_ERROR_NONE);
+
    /** \todo Handshake */
 
    /*initialize handshake packet for send*/
    makeHandshakeOk (&type, vector);
+   ciaaPOSIX_memcpy(master_inf, vector + UPDT_PROTOCOL_HEADER_SIZE, sizeof(master_inf));
    /*send Handshake packet*/
    ciaaPOSIX_assert(UPDT_protocolSend((UPDT_ITransportType *) &master_transport, vector, 32) == UPDT_PROTOCOL_ERROR_NONE);
    /*received answer*/
    ciaaPOSIX_assert(UPDT_protocolRecv((UPDT_ITransportType *) &master_transport, vector,32) == UPDT_PROTOCOL_ERROR_NONE);
    /*testing SequenceNumberand package type of answer*/
    ciaaPOSIX_assert(testHandshakeOk (&type,vector)==0);
+   UPDT_cipherInit(&master_cipher, master_key, master_inf, master_alw);
 
-   /*initialize data packet for send*/
-   makeDataOk (&type,vector, payload_size);
-   /*send data packet*/
-   ciaaPOSIX_assert(UPDT_protocolSend((UPDT_ITransportType *) &master_transport, vector, payload_size) == UPDT_PROTOCOL_ERROR_NONE);
-   /*received answer*/
-   ciaaPOSIX_assert(UPDT_protocolRecv((UPDT_ITransportType *) &master_transport, vector,payload_size) == UPDT_PROTOCOL_ERROR_NONE);
-   /*testing SequenceNumberand package type of answer*/
-   ciaaPOSIX_assert(testDataOk(vector)==0);
-
-   #if(0)
-   do
-   {
-      /* request a block of packed data */
-      bytes_packed = UPDT_packerGet(&packer);
-      ciaaPOSIX_assert(bytes_packed >= 0);
-
-      /** \todo encrypt */
-      /** \todo calculate signature */
-
-      /* send the packet data */
-      bytes_sent =  UPDT_masterSendData(&master, master_buffer, bytes_packed);
-
-   /* it finishes when we send a block of data smaller than the others */
-   } while(bytes_sent == UPDT_PROTOCOL_PAYLOAD_MAX_SIZE);
-   #endif
-
-
-   /** \todo send signature */
+   /*send the data packets keeping several of them in flight*/
+   ciaaPOSIX_assert(testDataWindowOk()==0);
 
+   test_update_loopbackClear(&master_transport);
    TerminateTask();
 }
 
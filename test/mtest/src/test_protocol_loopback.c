@@ -2,6 +2,7 @@
  * Copyright 2015, Esteban Volentini
  * Copyright 2015, Matias Giori
  * Copyright 2015, Franco Salinas
+ * Copyright 2026, agent
  *
  * This file is part of CIAA Firmware.
  *
@@ -51,16 +52,21 @@
  * EV           Esteban Volentini
  * MG           Matias Giori
  * FS           Franco Salinas
+ * AG           agent
  */
 
 /*
  * modification history (new versions first)
  * -----------------------------------------------------------
+ * 20261017 v0.0.4  AG  clear the optional transport entries with UPDT_ITransportInit
+ * 20261017 v0.0.3  AG  add deadline aware receive
+ * 20261017 v0.0.2  AG  add zero copy receive
  * 20150408 v0.0.1  FS  first initial version
  */
 
 /*==================[inclusions]=============================================*/
 #include "UPDT_ITransport.h"
+#include "UPDT_time.h"
 
 #include "test_protocol_loopback.h"
 /*==================[macros and definitions]=================================*/
@@ -74,16 +80,42 @@
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
-static uint32_t test_update_nextPowerOfTwo(uint32_t v)
+/** \brief Waits until there is data to receive or the deadline passes.
+ **
+ ** The timeout alarm is left running when data arrives first, cancelling it
+ ** could race with its expiration. A later wait just uses it again.
+ **
+ ** \param loopback Loopback structure.
+ ** \param deadline Deadline, a UPDT_timeNow value.
+ ** \return Non-zero if there is data.
+ **/
+static uint8_t test_update_loopbackWaitUntil(test_update_loopbackType *loopback, uint32_t deadline)
 {
-    --v;
-    v |= v >> 1;
-    v |= v >> 2;
-    v |= v >> 4;
-    v |= v >> 8;
-    v |= v >> 16;
-    ++v;
-    return v;
+   EventMaskType events;
+   uint32_t remaining;
+
+   while(ciaaLibs_circBufEmpty(&loopback->own_cbuf))
+   {
+      remaining = UPDT_timeRemaining(deadline);
+      if(0 == remaining)
+      {
+         return 0;
+      }
+      if(!loopback->alarm_armed)
+      {
+         SetRelAlarm(loopback->timeout_alarm,
+            remaining < TEST_UPDATE_LOOPBACK_ALARM_MAX ? remaining : TEST_UPDATE_LOOPBACK_ALARM_MAX, 0);
+         loopback->alarm_armed = 1;
+      }
+      WaitEvent(loopback->recv_event | loopback->timeout_event);
+      GetEvent(loopback->task_id, &events);
+      ClearEvent(events & (loopback->recv_event | loopback->timeout_event));
+      if(events & loopback->timeout_event)
+      {
+         loopback->alarm_armed = 0;
+      }
+   }
+   return 1;
 }
 /** \brief Sends a packet.
  **
@@ -138,28 +170,114 @@ static ssize_t test_update_loopbackRecv(UPDT_ITransportType *transport, void *da
    }
    return ret;
 }
+/** \brief Receives a packet, waiting until a deadline at most.
+ **
+ ** \param loopback Loopback structure.
+ ** \param data Buffer to receive.
+ ** \param size Maximum number of bytes to receive.
+ ** \param deadline Deadline, a UPDT_timeNow value.
+ ** \return Number of bytes received, 0 if the deadline passed.
+ **/
+static ssize_t test_update_loopbackRecvUntil(UPDT_ITransportType *transport, void *data, size_t size, uint32_t deadline)
+{
+   test_update_loopbackType *loopback = (test_update_loopbackType *) transport;
+
+   ciaaPOSIX_assert(NULL != loopback);
+
+   if(!test_update_loopbackWaitUntil(loopback, deadline))
+   {
+      return 0;
+   }
+   return ciaaLibs_circBufGet(&loopback->own_cbuf, data, size);
+}
+/** \brief Lends the received bytes stored contiguously in the circular
+ ** buffer.
+ **
+ ** \param loopback Loopback structure.
+ ** \param data Returns the position of the bytes.
+ ** \param size Maximum number of bytes to lend.
+ ** \return Number of bytes lent.
+ **/
+static ssize_t test_update_loopbackRecvAcquire(UPDT_ITransportType *transport, const void **data, size_t size)
+{
+   size_t count;
+   test_update_loopbackType *loopback = (test_update_loopbackType *) transport;
+
+   ciaaPOSIX_assert(NULL != loopback);
+   ciaaPOSIX_assert(NULL != data);
+
+   while(ciaaLibs_circBufEmpty(&loopback->own_cbuf))
+   {
+      WaitEvent(loopback->recv_event);
+      ClearEvent(loopback->recv_event);
+   }
+
+   /* only up to the end of the memory block, the rest comes next time */
+   count = ciaaLibs_circBufRawCount(&loopback->own_cbuf, loopback->own_cbuf.tail);
+   *data = ciaaLibs_circBufReadPos(&loopback->own_cbuf);
+   return size < count ? size : count;
+}
+/** \brief Lends received bytes, waiting until a deadline at most.
+ **
+ ** \param loopback Loopback structure.
+ ** \param data Returns the position of the bytes.
+ ** \param size Maximum number of bytes to lend.
+ ** \param deadline Deadline, a UPDT_timeNow value.
+ ** \return Number of bytes lent, 0 if the deadline passed.
+ **/
+static ssize_t test_update_loopbackRecvAcquireUntil(UPDT_ITransportType *transport, const void **data, size_t size, uint32_t deadline)
+{
+   test_update_loopbackType *loopback = (test_update_loopbackType *) transport;
+
+   ciaaPOSIX_assert(NULL != loopback);
+
+   if(!test_update_loopbackWaitUntil(loopback, deadline))
+   {
+      return 0;
+   }
+   return test_update_loopbackRecvAcquire(transport, data, size);
+}
+/** \brief Releases lent bytes.
+ **
+ ** \param loopback Loopback structure.
+ ** \param size Number of bytes consumed.
+ **/
+static void test_update_loopbackRecvRelease(UPDT_ITransportType *transport, size_t size)
+{
+   test_update_loopbackType *loopback = (test_update_loopbackType *) transport;
+
+   ciaaPOSIX_assert(NULL != loopback);
+
+   ciaaLibs_circBufUpdateHead(&loopback->own_cbuf, size);
+}
 /*==================[external functions definition]==========================*/
 
 int32_t test_update_loopbackInit(
    test_update_loopbackType *loopback,
    TaskType task_id,
-   EventMaskType recv_event)
+   EventMaskType recv_event,
+   EventMaskType timeout_event,
+   AlarmType timeout_alarm)
 {
-   size_t buffer_size;
-
    ciaaPOSIX_assert(NULL != loopback);
 
-   loopback->transport.recv = test_update_loopbackRecv;
-   loopback->transport.send = test_update_loopbackSend;
+   /* no vectored entries, sending never waits */
+   UPDT_ITransportInit(&loopback->transport, test_update_loopbackRecv, test_update_loopbackSend);
+   loopback->transport.recv_acquire = test_update_loopbackRecvAcquire;
+   loopback->transport.recv_release = test_update_loopbackRecvRelease;
+   loopback->transport.recv_until = test_update_loopbackRecvUntil;
+   loopback->transport.recv_acquire_until = test_update_loopbackRecvAcquireUntil;
    loopback->task_id = task_id;
    loopback->recv_event = recv_event;
+   loopback->timeout_event = timeout_event;
+   loopback->timeout_alarm = timeout_alarm;
+   loopback->alarm_armed = 0;
    loopback->counterpart = NULL;
    loopback->dest_cbuf = NULL;
 
-   buffer_size = test_update_nextPowerOfTwo(UPDT_PROTOCOL_PACKET_MAX_SIZE);
-
    /* return non-zero on error */
-   return -1 == ciaaLibs_circBufInit(&loopback->own_cbuf, loopback->own_cbuf_mem, buffer_size);
+   return -1 == ciaaLibs_circBufInit(&loopback->own_cbuf, loopback->own_cbuf_mem,
+      TEST_UPDATE_LOOPBACK_BUFFER_SIZE);
 }
 
 void test_update_loopbackConnect(
@@ -182,8 +300,14 @@ void test_update_loopbackClear(test_update_loopbackType *loopback)
 {
    ciaaPOSIX_assert(NULL != loopback);
 
-   loopback->transport.send = NULL;
-   loopback->transport.recv = NULL;
+   UPDT_ITransportInit(&loopback->transport, NULL, NULL);
+   if(loopback->alarm_armed)
+   {
+      /* the alarm must not set an event on a terminated task */
+      WaitEvent(loopback->timeout_event);
+      ClearEvent(loopback->timeout_event);
+      loopback->alarm_armed = 0;
+   }
    loopback->counterpart = NULL;
    loopback->dest_cbuf = NULL;
 }
@@ -0,0 +1,127 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef CIAAPOSIX_STDIO_H
+#define CIAAPOSIX_STDIO_H
+/** \brief ciaaPOSIX stdio header file of the pty benchmark
+ **
+ ** Only the calls and ioctl requests used by UPDT_serial are available, they
+ ** are implemented on the pty devices registered with ptest_posixAddDevice.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup BTests CIAA Firmware Benchmarks
+ ** @{ */
+/** \addtogroup Update Update Module Benchmarks
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1   AG   first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ciaaPOSIX_stdint.h"
+#include "ciaaPOSIX_string.h"
+#include <stdio.h>
+
+/*==================[macros]=================================================*/
+#define ciaaPOSIX_O_RDONLY                      0x00u
+#define ciaaPOSIX_O_WRONLY                      0x01u
+#define ciaaPOSIX_O_RDWR                        0x02u
+#define ciaaPOSIX_O_NONBLOCK                    0x04u
+
+#define ciaaPOSIX_IOCTL_SET_BAUDRATE            1
+#define ciaaPOSIX_IOCTL_SET_FIFO_TRIGGER_LEVEL  2
+#define ciaaPOSIX_IOCTL_SET_NONBLOCK_MODE       3
+#define ciaaPOSIX_IOCTL_GET_RX_COUNT            4
+
+#define ciaaFIFO_TRIGGER_LEVEL0                 0
+#define ciaaFIFO_TRIGGER_LEVEL1                 1
+#define ciaaFIFO_TRIGGER_LEVEL2                 2
+#define ciaaFIFO_TRIGGER_LEVEL3                 3
+
+#define ciaaPOSIX_printf                        printf
+
+/*==================[external functions declaration]=========================*/
+/** \brief Opens a device registered with ptest_posixAddDevice.
+ **
+ ** \param path Path of the device.
+ ** \param oflag Open flags, ignored.
+ ** \return File descriptor, -1 if the device does not exist.
+ **/
+int32_t ciaaPOSIX_open(char const *path, uint8_t oflag);
+
+/** \brief Closes a device. */
+int32_t ciaaPOSIX_close(int32_t fildes);
+
+/** \brief Reads from a device.
+ **
+ ** \return Number of bytes read, 0 in non-blocking mode when there are
+ ** none. -1 on error.
+ **/
+ssize_t ciaaPOSIX_read(int32_t fildes, void *buf, size_t nbyte);
+
+/** \brief Writes to a device.
+ **
+ ** The bytes go through the baud rate emulation and the bit error injection
+ ** of the device.
+ **
+ ** \return Number of bytes written, 0 in non-blocking mode when none fit.
+ ** -1 on error.
+ **/
+ssize_t ciaaPOSIX_write(int32_t fildes, void const *buf, size_t nbyte);
+
+/** \brief Controls a device.
+ **
+ ** ciaaPOSIX_IOCTL_SET_BAUDRATE changes the emulated baud rate, the fifo
+ ** trigger level is accepted and ignored.
+ **/
+int32_t ciaaPOSIX_ioctl(int32_t fildes, int32_t request, void *param);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
+#endif /* #ifndef CIAAPOSIX_STDIO_H */
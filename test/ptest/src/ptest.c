@@ -0,0 +1,679 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief Pty benchmark source file
+ **
+ ** Linux program which joins a master and a slave through a pty pair, each
+ ** one running the real UPDT_serial transport on its end. The master sends
+ ** an INF frame with its capabilities and the image size, the slave answers
+ ** with an ALW frame carrying the agreed ones, both switch to the agreed
+ ** baud rate and the master streams a synthetic image in DAT frames through
+ ** a protocol session. When it is done it prints a CSV line:
+ **
+ **    baud_rate,bit_error_rate,payload_size,window_size,fec_data,fec_parity,
+ **    frames,bytes,frames_per_second,mbytes_per_second,p50_us,p99_us,
+ **    cpu_ns_per_byte,bit_errors,image
+ **
+ ** The latency of a frame goes from the call which sends it to its in order
+ ** reception by the slave, so it includes the wait for a free slot of the
+ ** window and the retransmissions. The CPU time is the one of the whole
+ ** process, both ends included, divided by the image size. The image is
+ ** "ok" when the slave received it unchanged.
+ **
+ ** With bit errors the goodput with and without forward error correction
+ ** can be compared, for example:
+ **
+ **    ptest -b 115200 -s 262144 -e 1e-5
+ **    ptest -b 115200 -s 262144 -e 1e-5 -f 8,1
+ **
+ ** Options:
+ **    -s size      image size in bytes, rounded up to a multiple of 8
+ **    -p size      DAT payload size offered by both ends
+ **    -w frames    window size offered by both ends
+ **    -b baud      emulated baud rate agreed after the handshake, the pty
+ **                 starts at UPDT_SERIAL_DEFAULT_BAUD_RATE. 0 disables the
+ **                 emulation
+ **    -e rate      bit error rate of the data phase, it turns the CRC on
+ **    -c           turns the CRC on
+ **    -t ms        session timeout, by default two windows of line time
+ **    -f data,parity
+ **                 forward error correction offered by both ends: groups
+ **                 of data DAT frames followed by parity PAR frames. The
+ **                 window must hold a group
+ **    -r seed      seed of the bit errors
+ **    -T file      writes the trace of both ends, see tools/updt_trace.py.
+ **                 The trace points are only built with make TRACE=1
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup BTests CIAA Firmware Benchmarks
+ ** @{ */
+/** \addtogroup Update Update Module Benchmarks
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.3   AG   add the forward error correction
+ * 20261017 v0.0.2   AG   add the trace capture
+ * 20261017 v0.0.1   AG   first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "ciaaPOSIX_stdio.h"
+#include "UPDT_protocol.h"
+#include "UPDT_serial.h"
+#include "UPDT_trace.h"
+#include "ptest_posix.h"
+
+/*==================[macros and definitions]=================================*/
+#define PTEST_MASTER_DEVICE      "/dev/serial/pty/0"
+#define PTEST_SLAVE_DEVICE       "/dev/serial/pty/1"
+/** default image size */
+#define PTEST_IMAGE_SIZE         (4u * 1024u * 1024u)
+/** default DAT payload size */
+#define PTEST_PAYLOAD_SIZE       1024u
+/** default window size */
+#define PTEST_WINDOW_SIZE        8u
+/** sequence number of the first DAT frame */
+#define PTEST_SEQUENCE_NUMBER    1u
+/** size of the frame slots of the master */
+#define PTEST_FRAME_SIZE         UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE)
+/** time added to the default timeout, in milliseconds */
+#define PTEST_TIMEOUT_MARGIN     50u
+/** records of the trace ring, the newest ones are kept */
+#define PTEST_TRACE_RECORDS      (1u << 18)
+/** size of the FEC memory of each end, the largest group of the largest
+ ** blocks */
+#define PTEST_FEC_SIZE                                                        \
+   UPDT_FEC_BUFFER_SIZE(UPDT_FEC_DATA_MAX, UPDT_FEC_PARITY_MAX, UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE)
+
+/** \brief Options of the benchmark */
+typedef struct
+{
+   uint32_t image_size;
+   uint16_t payload_size;
+   uint8_t window_size;
+   uint32_t baud_rate;
+   double bit_error_rate;
+   uint8_t crc;
+   uint8_t fec_data;
+   uint8_t fec_parity;
+   uint32_t timeout;
+   uint32_t seed;
+   const char *trace;
+} ptest_optionsType;
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static ptest_optionsType ptest_options =
+{
+   PTEST_IMAGE_SIZE, PTEST_PAYLOAD_SIZE, PTEST_WINDOW_SIZE, 0, 0, 0, 0, 0, 0, 1, NULL,
+};
+/** capabilities offered by both ends */
+static UPDT_protocolCapabilitiesType ptest_capabilities;
+static uint8_t *ptest_image;
+static uint8_t *ptest_received;
+/** time each frame is sent by the master and received by the slave */
+static uint64_t *ptest_sent;
+static uint64_t *ptest_delivered;
+static uint32_t ptest_frames;
+
+static UPDT_serialType ptest_master;
+static UPDT_protocolSessionType ptest_masterSession;
+static uint8_t ptest_masterFrames[UPDT_PROTOCOL_WINDOW_MAX_SIZE][PTEST_FRAME_SIZE];
+static UPDT_fecType ptest_masterFec;
+static uint8_t ptest_masterBlocks[PTEST_FEC_SIZE];
+
+static UPDT_serialType ptest_slave;
+static UPDT_protocolSessionType ptest_slaveSession;
+static UPDT_fecType ptest_slaveFec;
+static uint8_t ptest_slaveBlocks[PTEST_FEC_SIZE];
+/** bytes received by the slave, or -1 if it failed */
+static int64_t ptest_slaveReceived;
+
+/** trace track of the thread: 0 for the master, 1 for the slave */
+static __thread uint8_t ptest_track;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Returns the time of CLOCK_MONOTONIC in nanoseconds. */
+static uint64_t ptest_now(void)
+{
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (uint64_t) now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+/** \brief Returns the CPU time used by the process in nanoseconds. */
+static uint64_t ptest_cpu(void)
+{
+   struct rusage usage;
+
+   getrusage(RUSAGE_SELF, &usage);
+   return ((uint64_t) usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000u +
+      ((uint64_t) usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000u;
+}
+
+/** \brief Compares two latencies for qsort. */
+static int ptest_compare(const void *a, const void *b)
+{
+   uint64_t x = *(const uint64_t *) a;
+   uint64_t y = *(const uint64_t *) b;
+
+   return x < y ? -1 : x > y;
+}
+
+/** \brief Returns the code of a baud rate, -1 if the protocol has none. */
+static int32_t ptest_baudCode(uint32_t baud_rate)
+{
+   uint8_t code = UPDT_PROTOCOL_BAUD_KEEP;
+
+   /* the rates of the codes after UPDT_PROTOCOL_BAUD_KEEP are not 0 */
+   do
+   {
+      if(UPDT_protocolGetBaudRate(code) == baud_rate)
+      {
+         return code;
+      }
+      code++;
+   } while(0 != UPDT_protocolGetBaudRate(code));
+   return -1;
+}
+
+/** \brief Returns the trace track of the calling thread. */
+static uint8_t ptest_traceTrack(void)
+{
+   return ptest_track;
+}
+
+/** \brief Writes the trace to a file.
+ **
+ ** \return 0 on success.
+ **/
+static int32_t ptest_traceWrite(const char *path)
+{
+   size_t size = UPDT_TRACE_HEADER_SIZE + (size_t) PTEST_TRACE_RECORDS * UPDT_TRACE_RECORD_SIZE;
+   uint8_t *buffer = malloc(size);
+   FILE *file;
+   int32_t ret = -1;
+
+   if(NULL != buffer && NULL != (file = fopen(path, "wb")))
+   {
+      size = UPDT_traceDump(buffer, size);
+      ret = size == fwrite(buffer, 1, size, file) ? 0 : -1;
+      ret = 0 == fclose(file) ? ret : -1;
+   }
+   free(buffer);
+   return ret;
+}
+
+/** \brief Parses the options.
+ **
+ ** \return 0 on success.
+ **/
+static int32_t ptest_parse(int argc, char *argv[])
+{
+   char *end;
+   int32_t code;
+   int option;
+
+   while(-1 != (option = getopt(argc, argv, "s:p:w:b:e:cf:t:r:T:")))
+   {
+      switch(option)
+      {
+         case 's':
+            ptest_options.image_size = (strtoul(optarg, NULL, 0) + 7u) & ~7u;
+            break;
+         case 'p':
+            ptest_options.payload_size = strtoul(optarg, NULL, 0);
+            break;
+         case 'w':
+            ptest_options.window_size = strtoul(optarg, NULL, 0);
+            break;
+         case 'b':
+            ptest_options.baud_rate = strtoul(optarg, NULL, 0);
+            break;
+         case 'e':
+            ptest_options.bit_error_rate = strtod(optarg, NULL);
+            break;
+         case 'c':
+            ptest_options.crc = 1;
+            break;
+         case 'f':
+            ptest_options.fec_data = strtoul(optarg, &end, 0);
+            ptest_options.fec_parity = ',' == *end ? strtoul(end + 1, NULL, 0) : 0;
+            break;
+         case 't':
+            ptest_options.timeout = strtoul(optarg, NULL, 0);
+            break;
+         case 'r':
+            ptest_options.seed = strtoul(optarg, NULL, 0);
+            break;
+         case 'T':
+            ptest_options.trace = optarg;
+            break;
+         default:
+            return -1;
+      }
+   }
+   code = ptest_baudCode(ptest_options.baud_rate);
+   if(0 == ptest_options.image_size || code < 0 ||
+      ptest_options.payload_size < 8 || ptest_options.payload_size > UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE ||
+      0 == ptest_options.window_size || ptest_options.window_size > UPDT_PROTOCOL_WINDOW_MAX_SIZE ||
+      ptest_options.bit_error_rate < 0 || ptest_options.bit_error_rate >= 1 ||
+      ptest_options.fec_data > UPDT_FEC_DATA_MAX || ptest_options.fec_parity > UPDT_FEC_PARITY_MAX ||
+      (0 == ptest_options.fec_data) != (0 == ptest_options.fec_parity) ||
+      ptest_options.fec_data > ptest_options.window_size ||
+      (0 != ptest_options.fec_data &&
+         (ptest_options.payload_size & ~7u) <= UPDT_PROTOCOL_FEC_PREFIX_SIZE))
+   {
+      return -1;
+   }
+   if(0 < ptest_options.bit_error_rate)
+   {
+      /* a corrupted frame must not be taken as a good one */
+      ptest_options.crc = 1;
+   }
+   if(0 == ptest_options.timeout)
+   {
+      /* long enough for a window and its acknowledgements at the baud rate */
+      ptest_options.timeout = PTEST_TIMEOUT_MARGIN;
+      if(0 != ptest_options.baud_rate)
+      {
+         ptest_options.timeout += (uint32_t) ((uint64_t) 2u * ptest_options.window_size *
+            UPDT_PROTOCOL_FRAME_SIZE(ptest_options.payload_size) * 10u * 1000u / ptest_options.baud_rate);
+      }
+   }
+   ptest_capabilities.payload_size = ptest_options.payload_size;
+   ptest_capabilities.window_size = ptest_options.window_size;
+   ptest_capabilities.flags = ptest_options.crc ? UPDT_PROTOCOL_CAPABILITY_CRC : 0;
+   if(0 != ptest_options.fec_data)
+   {
+      ptest_capabilities.flags |= UPDT_PROTOCOL_CAPABILITY_FEC;
+   }
+   ptest_capabilities.baud_rate = code;
+   return 0;
+}
+
+/** \brief Switches an end to the agreed baud rate and bit error rate. */
+static int32_t ptest_agree(UPDT_serialType *serial, const UPDT_protocolCapabilitiesType *agreed)
+{
+   if(UPDT_PROTOCOL_BAUD_KEEP != agreed->baud_rate &&
+      0 != UPDT_serialSetBaudRate(serial, UPDT_protocolGetBaudRate(agreed->baud_rate)))
+   {
+      return -1;
+   }
+   ptest_posixSetBitErrorRate(serial->fd, ptest_options.bit_error_rate);
+   return 0;
+}
+
+/** \brief Protects the DAT frames of a session if both ends agreed on it.
+ **
+ ** \return DAT payload size of the session.
+ **/
+static uint16_t ptest_fec(
+   UPDT_protocolSessionType *session,
+   UPDT_fecType *fec,
+   uint8_t *blocks,
+   uint8_t geometry,
+   const UPDT_protocolCapabilitiesType *agreed)
+{
+   if(0 == (agreed->flags & UPDT_PROTOCOL_CAPABILITY_FEC) ||
+      0 != UPDT_fecInit(fec, blocks, PTEST_FEC_SIZE, UPDT_PROTOCOL_FEC_DATA(geometry),
+         UPDT_PROTOCOL_FEC_PARITY(geometry), session->payload_size) ||
+      UPDT_PROTOCOL_ERROR_NONE != UPDT_protocolSessionSetFec(session, fec))
+   {
+      return session->payload_size;
+   }
+   return session->payload_size - UPDT_PROTOCOL_FEC_PREFIX_SIZE;
+}
+
+/** \brief Slave end: answers the handshake and receives the image. */
+static void *ptest_slaveRun(void *arg)
+{
+   uint8_t frame[UPDT_PROTOCOL_HEADER_SIZE + UPDT_PROTOCOL_PACKET_INF_PAYLOAD_SIZE] = {0};
+   uint8_t header[UPDT_PROTOCOL_HEADER_SIZE];
+   const uint8_t *payload = frame + UPDT_PROTOCOL_HEADER_SIZE;
+   UPDT_protocolCapabilitiesType remote;
+   UPDT_protocolCapabilitiesType agreed;
+   UPDT_ITransportType *transport = &ptest_slave.transport;
+   uint32_t data_size;
+   uint32_t offset = 0;
+   uint16_t payload_size;
+   uint8_t geometry;
+   int32_t ret;
+
+   (void) arg;
+   ptest_track = 1;
+   ptest_slaveReceived = -1;
+   if(0 != UPDT_serialInit(&ptest_slave, PTEST_SLAVE_DEVICE, NULL) ||
+      UPDT_PROTOCOL_ERROR_NONE != UPDT_protocolRecv(transport, frame, sizeof(frame)) ||
+      UPDT_PROTOCOL_PACKET_INF != UPDT_protocolGetPacketType(frame))
+   {
+      return NULL;
+   }
+   data_size = (uint32_t) payload[UPDT_PROTOCOL_INF_DATA_SIZE_OFFSET] |
+      (uint32_t) payload[UPDT_PROTOCOL_INF_DATA_SIZE_OFFSET + 1] << 8 |
+      (uint32_t) payload[UPDT_PROTOCOL_INF_DATA_SIZE_OFFSET + 2] << 16 |
+      (uint32_t) payload[UPDT_PROTOCOL_INF_DATA_SIZE_OFFSET + 3] << 24;
+   geometry = payload[UPDT_PROTOCOL_INF_FEC_OFFSET];
+   UPDT_protocolGetCapabilities(payload + UPDT_PROTOCOL_INF_CAPABILITIES_OFFSET, &remote);
+   UPDT_protocolNegotiate(&ptest_capabilities, &remote, &agreed);
+
+   /* answer with the agreed capabilities, then switch to them */
+   ciaaPOSIX_memset(frame, 0, sizeof(frame));
+   UPDT_protocolSetHeader(frame, UPDT_PROTOCOL_PACKET_ALW, UPDT_protocolGetSequenceNumber(frame),
+      UPDT_PROTOCOL_PACKET_ALW_PAYLOAD_SIZE);
+   UPDT_protocolSetCapabilities(frame + UPDT_PROTOCOL_HEADER_SIZE + UPDT_PROTOCOL_ALW_CAPABILITIES_OFFSET,
+      &agreed);
+   if(UPDT_PROTOCOL_ERROR_NONE != UPDT_protocolSend(transport, frame,
+         UPDT_PROTOCOL_HEADER_SIZE + UPDT_PROTOCOL_PACKET_ALW_PAYLOAD_SIZE) ||
+      0 != ptest_agree(&ptest_slave, &agreed))
+   {
+      return NULL;
+   }
+
+   UPDT_protocolSessionInit(&ptest_slaveSession, transport, NULL, 0, 1, PTEST_SEQUENCE_NUMBER);
+   UPDT_protocolSessionSetCapabilities(&ptest_slaveSession, &agreed);
+   UPDT_protocolSessionSetTimeout(&ptest_slaveSession, ptest_options.timeout);
+   payload_size = ptest_fec(&ptest_slaveSession, &ptest_slaveFec, ptest_slaveBlocks, geometry, &agreed);
+   while(offset < data_size)
+   {
+      ret = UPDT_protocolSessionRecv(&ptest_slaveSession, header, ptest_received + offset,
+         UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE);
+      if(UPDT_PROTOCOL_ERROR_PACKET == ret)
+      {
+         /* a header corrupted into an oversized frame, the sender repeats it */
+         continue;
+      }
+      if(UPDT_PROTOCOL_ERROR_NONE != ret)
+      {
+         return NULL;
+      }
+      if(UPDT_PROTOCOL_PACKET_DAT == UPDT_protocolGetPacketType(header))
+      {
+         ptest_delivered[offset / payload_size] = ptest_now();
+         offset += UPDT_protocolGetPayloadSize(header);
+      }
+   }
+   ptest_slaveReceived = offset;
+
+   /* the last acknowledgements may be lost, answer until the master stops */
+   while(0 < ptest_options.bit_error_rate)
+   {
+      ret = UPDT_protocolSessionRecv(&ptest_slaveSession, header, ptest_received + offset,
+         UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE);
+      if(UPDT_PROTOCOL_ERROR_NONE != ret && UPDT_PROTOCOL_ERROR_PACKET != ret)
+      {
+         break;
+      }
+   }
+   return NULL;
+}
+
+/** \brief Master end: handshake and image transfer.
+ **
+ ** \param elapsed Returns the time spent sending the image.
+ ** \param cpu Returns the CPU time used while sending the image.
+ ** \return 0 on success.
+ **/
+static int32_t ptest_masterRun(uint64_t *elapsed, uint64_t *cpu)
+{
+   uint8_t frame[UPDT_PROTOCOL_HEADER_SIZE + UPDT_PROTOCOL_PACKET_INF_PAYLOAD_SIZE] = {0};
+   uint8_t *payload = frame + UPDT_PROTOCOL_HEADER_SIZE;
+   UPDT_protocolCapabilitiesType agreed;
+   UPDT_ITransportType *transport = &ptest_master.transport;
+   uint32_t offset;
+   uint32_t size;
+   uint32_t i;
+   uint16_t payload_size;
+   uint8_t geometry = 0;
+   int32_t ret = UPDT_PROTOCOL_ERROR_NONE;
+
+   if(0 != UPDT_serialInit(&ptest_master, PTEST_MASTER_DEVICE, NULL))
+   {
+      return -1;
+   }
+   UPDT_protocolSetHeader(frame, UPDT_PROTOCOL_PACKET_INF, 0, UPDT_PROTOCOL_PACKET_INF_PAYLOAD_SIZE);
+   payload[UPDT_PROTOCOL_INF_DATA_SIZE_OFFSET] = (uint8_t) ptest_options.image_size;
+   payload[UPDT_PROTOCOL_INF_DATA_SIZE_OFFSET + 1] = (uint8_t) (ptest_options.image_size >> 8);
+   payload[UPDT_PROTOCOL_INF_DATA_SIZE_OFFSET + 2] = (uint8_t) (ptest_options.image_size >> 16);
+   payload[UPDT_PROTOCOL_INF_DATA_SIZE_OFFSET + 3] = (uint8_t) (ptest_options.image_size >> 24);
+   if(0 != ptest_options.fec_data)
+   {
+      geometry = UPDT_PROTOCOL_FEC_GEOMETRY(ptest_options.fec_data, ptest_options.fec_parity);
+      payload[UPDT_PROTOCOL_INF_FEC_OFFSET] = geometry;
+   }
+   UPDT_protocolSetCapabilities(payload + UPDT_PROTOCOL_INF_CAPABILITIES_OFFSET, &ptest_capabilities);
+   if(UPDT_PROTOCOL_ERROR_NONE != UPDT_protocolSend(transport, frame, sizeof(frame)) ||
+      UPDT_PROTOCOL_ERROR_NONE != UPDT_protocolRecv(transport, frame,
+         UPDT_PROTOCOL_HEADER_SIZE + UPDT_PROTOCOL_PACKET_ALW_PAYLOAD_SIZE) ||
+      UPDT_PROTOCOL_PACKET_ALW != UPDT_protocolGetPacketType(frame))
+   {
+      return -1;
+   }
+   UPDT_protocolGetCapabilities(payload + UPDT_PROTOCOL_ALW_CAPABILITIES_OFFSET, &agreed);
+   if(0 != ptest_agree(&ptest_master, &agreed))
+   {
+      return -1;
+   }
+   UPDT_protocolSessionInit(&ptest_masterSession, transport, ptest_masterFrames[0],
+      sizeof(ptest_masterFrames[0]), ptest_options.window_size, PTEST_SEQUENCE_NUMBER);
+   UPDT_protocolSessionSetCapabilities(&ptest_masterSession, &agreed);
+   UPDT_protocolSessionSetTimeout(&ptest_masterSession, ptest_options.timeout);
+   payload_size = ptest_fec(&ptest_masterSession, &ptest_masterFec, ptest_masterBlocks, geometry, &agreed);
+
+   *elapsed = ptest_now();
+   *cpu = ptest_cpu();
+   for(offset = 0, i = 0; offset < ptest_options.image_size && UPDT_PROTOCOL_ERROR_NONE == ret;
+      offset += size, i++)
+   {
+      size = ptest_options.image_size - offset;
+      if(size > payload_size)
+      {
+         size = payload_size;
+      }
+      ptest_sent[i] = ptest_now();
+      ret = UPDT_protocolSessionSend(&ptest_masterSession, UPDT_PROTOCOL_PACKET_DAT,
+         ptest_image + offset, size);
+   }
+   if(UPDT_PROTOCOL_ERROR_NONE == ret)
+   {
+      ret = UPDT_protocolSessionFlush(&ptest_masterSession);
+   }
+   *elapsed = ptest_now() - *elapsed;
+   *cpu = ptest_cpu() - *cpu;
+   ptest_frames = i;
+   if(UPDT_PROTOCOL_ERROR_NONE != ret)
+   {
+      fprintf(stderr, "master: error %ld after %lu frames\n", (long) ret, (unsigned long) i);
+      return -1;
+   }
+   return 0;
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief Main function
+ *
+ * \return 0 if the image was transferred unchanged.
+ */
+int main(int argc, char *argv[])
+{
+   pthread_t slave;
+   UPDT_traceRecordType *trace = NULL;
+   uint64_t elapsed = 0;
+   uint64_t cpu = 0;
+   uint32_t frames;
+   uint32_t delivered;
+   uint32_t i;
+   int32_t ret;
+   int master_fd;
+   int slave_fd;
+   uint8_t ok;
+
+   if(0 != ptest_parse(argc, argv))
+   {
+      fprintf(stderr, "usage: %s [-s size] [-p payload_size] [-w window_size] [-b baud_rate] "
+         "[-e bit_error_rate] [-c] [-f data,parity] [-t timeout_ms] [-r seed] [-T trace_file]\n",
+         argv[0]);
+      return 2;
+   }
+
+   /* a pty pair, each end registered as a serial device */
+   master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+   if(master_fd < 0 || 0 != grantpt(master_fd) || 0 != unlockpt(master_fd) ||
+      (slave_fd = open(ptsname(master_fd), O_RDWR | O_NOCTTY)) < 0 ||
+      0 != ptest_posixAddDevice(PTEST_MASTER_DEVICE, master_fd,
+         0 != ptest_options.baud_rate ? UPDT_SERIAL_DEFAULT_BAUD_RATE : 0, ptest_options.seed) ||
+      0 != ptest_posixAddDevice(PTEST_SLAVE_DEVICE, slave_fd,
+         0 != ptest_options.baud_rate ? UPDT_SERIAL_DEFAULT_BAUD_RATE : 0, ptest_options.seed + 1))
+   {
+      perror("pty");
+      return 2;
+   }
+
+   /* the smallest DAT payload the ends may agree on */
+   i = ptest_options.payload_size & ~7u;
+   if(0 != ptest_options.fec_data)
+   {
+      i -= UPDT_PROTOCOL_FEC_PREFIX_SIZE;
+   }
+   frames = (ptest_options.image_size + i - 1) / i;
+   ptest_image = malloc(ptest_options.image_size);
+   ptest_received = malloc(ptest_options.image_size + UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE);
+   ptest_sent = calloc(frames, sizeof(uint64_t));
+   ptest_delivered = calloc(frames, sizeof(uint64_t));
+   if(NULL == ptest_image || NULL == ptest_received || NULL == ptest_sent || NULL == ptest_delivered)
+   {
+      return 2;
+   }
+   /* not compressible, like a firmware image */
+   srand(ptest_options.seed);
+   for(i = 0; i < ptest_options.image_size; i++)
+   {
+      ptest_image[i] = (uint8_t) rand();
+   }
+
+   if(NULL != ptest_options.trace)
+   {
+      trace = malloc(PTEST_TRACE_RECORDS * sizeof(UPDT_traceRecordType));
+      if(NULL == trace)
+      {
+         return 2;
+      }
+      UPDT_traceSetTrackSource(ptest_traceTrack);
+      UPDT_traceInit(trace, PTEST_TRACE_RECORDS);
+   }
+
+   pthread_create(&slave, NULL, ptest_slaveRun, NULL);
+   ret = ptest_masterRun(&elapsed, &cpu);
+   if(0 != ret)
+   {
+      /* unblocks the slave */
+      close(master_fd);
+      master_fd = -1;
+   }
+   pthread_join(slave, NULL);
+
+   if(NULL != trace)
+   {
+      if(0 != ptest_traceWrite(ptest_options.trace))
+      {
+         perror(ptest_options.trace);
+      }
+      UPDT_traceInit(NULL, 0);
+      free(trace);
+   }
+
+   ok = 0 == ret && (int64_t) ptest_options.image_size == ptest_slaveReceived &&
+      0 == memcmp(ptest_image, ptest_received, ptest_options.image_size);
+   /* after a failure the frames sent last may not have arrived */
+   delivered = ok ? ptest_frames : 0;
+   for(i = 0; i < delivered; i++)
+   {
+      ptest_sent[i] = ptest_delivered[i] - ptest_sent[i];
+   }
+   qsort(ptest_sent, delivered, sizeof(uint64_t), ptest_compare);
+
+   ciaaPOSIX_printf("baud_rate,bit_error_rate,payload_size,window_size,fec_data,fec_parity,frames,bytes,"
+      "frames_per_second,mbytes_per_second,p50_us,p99_us,cpu_ns_per_byte,bit_errors,image\n");
+   ciaaPOSIX_printf("%lu,%g,%u,%u,%u,%u,%lu,%lu,%.1f,%.3f,%.1f,%.1f,%.2f,%llu,%s\n",
+      (unsigned long) (0 != ptest_options.baud_rate ? ptest_options.baud_rate : 0),
+      ptest_options.bit_error_rate,
+      (unsigned) ptest_masterSession.payload_size, (unsigned) ptest_masterSession.window_size,
+      NULL != ptest_masterSession.fec ? (unsigned) ptest_masterFec.data : 0u,
+      NULL != ptest_masterSession.fec ? (unsigned) ptest_masterFec.parity : 0u,
+      (unsigned long) ptest_frames, (unsigned long) ptest_options.image_size,
+      0 < elapsed ? ptest_frames * 1e9 / elapsed : 0.0,
+      0 < elapsed ? ptest_options.image_size * 1e3 / elapsed : 0.0,
+      0 < delivered ? ptest_sent[delivered / 2] / 1e3 : 0.0,
+      0 < delivered ? ptest_sent[(uint64_t) delivered * 99u / 100u] / 1e3 : 0.0,
+      (double) cpu / ptest_options.image_size,
+      (unsigned long long) (ptest_posixGetBitErrors(ptest_master.fd) + ptest_posixGetBitErrors(ptest_slave.fd)),
+      ok ? "ok" : "failed");
+
+   if(master_fd >= 0)
+   {
+      close(master_fd);
+   }
+   close(slave_fd);
+   return ok ? 0 : 1;
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,403 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief Pty devices of the pty benchmark source file
+ **
+ ** Implements the ciaaPOSIX calls used by UPDT_serial on Linux file
+ ** descriptors, so the real serial transport runs over a pty pair.
+ **
+ ** A pty moves bytes as fast as memory, so each device can emulate a UART:
+ ** a write first waits until the bytes written before it and itself would
+ ** have left the line at baud_rate, 10 bits per byte. It can also flip
+ ** written bits at random with a given bit error rate. The distance to the
+ ** next flipped bit is drawn from the geometric distribution, so the cost
+ ** does not depend on the rate.
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup BTests CIAA Firmware Benchmarks
+ ** @{ */
+/** \addtogroup Update Update Module Benchmarks
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1   AG   first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "ciaaPOSIX_assert.h"
+#include "ciaaPOSIX_stdio.h"
+#include "ciaaPOSIX_unistd.h"
+#include "ptest_posix.h"
+
+/*==================[macros and definitions]=================================*/
+/** Largest write corrupted at once, larger writes are cut */
+#define PTEST_POSIX_WRITE_MAX   4096u
+
+/** \brief Emulated device type */
+typedef struct
+{
+   /** Path given to ciaaPOSIX_open */
+   const char *path;
+   /** Linux file descriptor */
+   int fd;
+   /** Emulated baud rate, 0 if not emulated */
+   uint32_t baud_rate;
+   /** Time when the last byte written leaves the line, in nanoseconds */
+   uint64_t line_free;
+   /** Bit error rate */
+   double bit_error_rate;
+   /** Bits written before the next flipped one */
+   uint64_t next_error;
+   /** Bits flipped so far */
+   uint64_t bit_errors;
+   /** State of the random number generator */
+   uint64_t random;
+   /** Copy of the bytes written, with the flipped bits */
+   uint8_t buffer[PTEST_POSIX_WRITE_MAX];
+} ptest_posixDeviceType;
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static ptest_posixDeviceType ptest_posixDevices[PTEST_POSIX_DEVICES_MAX];
+static uint8_t ptest_posixCount;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Returns the device of a file descriptor, NULL if there is none. */
+static ptest_posixDeviceType *ptest_posixGet(int32_t fildes)
+{
+   if(fildes < 0 || fildes >= ptest_posixCount || ptest_posixDevices[fildes].fd < 0)
+   {
+      return NULL;
+   }
+   return &ptest_posixDevices[fildes];
+}
+
+/** \brief Returns the time of CLOCK_MONOTONIC in nanoseconds. */
+static uint64_t ptest_posixNow(void)
+{
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (uint64_t) now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+/** \brief Sleeps until a CLOCK_MONOTONIC time in nanoseconds. */
+static void ptest_posixSleepUntil(uint64_t time)
+{
+   struct timespec until;
+
+   until.tv_sec = time / 1000000000u;
+   until.tv_nsec = time % 1000000000u;
+   while(EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL))
+   {
+   }
+}
+
+/** \brief Draws the number of correct bits before the next flipped one. */
+static uint64_t ptest_posixDrawError(ptest_posixDeviceType *device)
+{
+   double uniform;
+
+   if(device->bit_error_rate >= 1.0)
+   {
+      return 0;
+   }
+   /* xorshift64* */
+   device->random ^= device->random >> 12;
+   device->random ^= device->random << 25;
+   device->random ^= device->random >> 27;
+   uniform = ((device->random * 0x2545F4914F6CDD1Dull >> 11) + 1) * (1.0 / 9007199254740992.0);
+   return (uint64_t) floor(log(uniform) / log1p(-device->bit_error_rate));
+}
+
+/** \brief Copies the bytes to write flipping the bits which fail.
+ **
+ ** \return Number of bits flipped.
+ **/
+static uint64_t ptest_posixCorrupt(ptest_posixDeviceType *device, const uint8_t *data, size_t size)
+{
+   uint64_t bits = (uint64_t) size * 8u;
+   uint64_t position = device->next_error;
+   uint64_t flipped = 0;
+
+   ciaaPOSIX_memcpy(device->buffer, data, size);
+   while(position < bits)
+   {
+      device->buffer[position / 8u] ^= (uint8_t) (1u << (position % 8u));
+      flipped++;
+      position += 1 + ptest_posixDrawError(device);
+   }
+   device->next_error = position - bits;
+   return flipped;
+}
+
+/*==================[external functions definition]==========================*/
+int32_t ptest_posixAddDevice(const char *path, int fd, uint32_t baud_rate, uint32_t seed)
+{
+   ptest_posixDeviceType *device;
+   struct termios attributes;
+
+   if(ptest_posixCount >= PTEST_POSIX_DEVICES_MAX)
+   {
+      return -1;
+   }
+   if(isatty(fd))
+   {
+      /* no echo, no line editing nor translation of the bytes */
+      if(0 != tcgetattr(fd, &attributes))
+      {
+         return -1;
+      }
+      cfmakeraw(&attributes);
+      if(0 != tcsetattr(fd, TCSANOW, &attributes))
+      {
+         return -1;
+      }
+   }
+   device = &ptest_posixDevices[ptest_posixCount++];
+   device->path = path;
+   device->fd = fd;
+   device->baud_rate = baud_rate;
+   device->line_free = 0;
+   device->bit_error_rate = 0;
+   device->next_error = 0;
+   device->bit_errors = 0;
+   /* the generator must not start at 0 */
+   device->random = ((uint64_t) seed << 32) | (ptest_posixCount * 0x9E3779B9u + 1u);
+   return 0;
+}
+
+void ptest_posixSetBitErrorRate(int32_t fildes, double bit_error_rate)
+{
+   ptest_posixDeviceType *device = ptest_posixGet(fildes);
+
+   ciaaPOSIX_assert(NULL != device);
+
+   device->bit_error_rate = bit_error_rate;
+   if(0 < bit_error_rate)
+   {
+      device->next_error = ptest_posixDrawError(device);
+   }
+}
+
+uint64_t ptest_posixGetBitErrors(int32_t fildes)
+{
+   ptest_posixDeviceType *device = ptest_posixGet(fildes);
+
+   ciaaPOSIX_assert(NULL != device);
+
+   return device->bit_errors;
+}
+
+int32_t ciaaPOSIX_open(char const *path, uint8_t oflag)
+{
+   int32_t fildes;
+
+   (void) oflag;
+   for(fildes = 0; fildes < ptest_posixCount; fildes++)
+   {
+      if(ptest_posixDevices[fildes].fd >= 0 && 0 == strcmp(path, ptest_posixDevices[fildes].path))
+      {
+         return fildes;
+      }
+   }
+   return -1;
+}
+
+int32_t ciaaPOSIX_close(int32_t fildes)
+{
+   ptest_posixDeviceType *device = ptest_posixGet(fildes);
+
+   if(NULL == device)
+   {
+      return -1;
+   }
+   /* the pty itself is closed by its owner */
+   return 0;
+}
+
+ssize_t ciaaPOSIX_read(int32_t fildes, void *buf, size_t nbyte)
+{
+   ptest_posixDeviceType *device = ptest_posixGet(fildes);
+   ssize_t ret;
+
+   if(NULL == device)
+   {
+      return -1;
+   }
+   ret = read(device->fd, buf, nbyte);
+   if(ret < 0 && (EAGAIN == errno || EINTR == errno))
+   {
+      return 0;
+   }
+   return ret;
+}
+
+ssize_t ciaaPOSIX_write(int32_t fildes, void const *buf, size_t nbyte)
+{
+   ptest_posixDeviceType *device = ptest_posixGet(fildes);
+   const uint8_t *data = (const uint8_t *) buf;
+   uint64_t flipped = 0;
+   uint64_t start;
+   uint64_t byte_time = 0;
+   ssize_t ret;
+   size_t i;
+
+   if(NULL == device)
+   {
+      return -1;
+   }
+   if(0 < device->baud_rate)
+   {
+      /* the bytes arrive once they would have crossed the line */
+      byte_time = 10000000000ull / device->baud_rate;
+      start = ptest_posixNow();
+      if(start < device->line_free)
+      {
+         start = device->line_free;
+      }
+      device->line_free = start + nbyte * byte_time;
+      ptest_posixSleepUntil(device->line_free);
+   }
+   if(0 < device->bit_error_rate)
+   {
+      if(nbyte > sizeof(device->buffer))
+      {
+         nbyte = sizeof(device->buffer);
+      }
+      flipped = ptest_posixCorrupt(device, data, nbyte);
+      data = device->buffer;
+   }
+   ret = write(device->fd, data, nbyte);
+   if(ret < 0 && (EAGAIN == errno || EINTR == errno))
+   {
+      ret = 0;
+   }
+   if(ret < 0)
+   {
+      return ret;
+   }
+   if((size_t) ret < nbyte)
+   {
+      /* the bytes not written did not use the line */
+      device->line_free -= (nbyte - ret) * byte_time;
+      if(0 < device->bit_error_rate)
+      {
+         /* they are corrupted again on the next write, the distance to the
+          * next error is memoryless so it is just drawn again */
+         flipped = 0;
+         for(i = 0; i < (size_t) ret; i++)
+         {
+            flipped += __builtin_popcount(((const uint8_t *) buf)[i] ^ device->buffer[i]);
+         }
+         device->next_error = ptest_posixDrawError(device);
+      }
+   }
+   device->bit_errors += flipped;
+   return ret;
+}
+
+int32_t ciaaPOSIX_ioctl(int32_t fildes, int32_t request, void *param)
+{
+   ptest_posixDeviceType *device = ptest_posixGet(fildes);
+   int flags;
+   int count;
+
+   if(NULL == device)
+   {
+      return -1;
+   }
+   switch(request)
+   {
+      case ciaaPOSIX_IOCTL_SET_BAUDRATE:
+         if(0 < device->baud_rate)
+         {
+            device->baud_rate = (uint32_t) (uintptr_t) param;
+         }
+         return 0;
+      case ciaaPOSIX_IOCTL_SET_FIFO_TRIGGER_LEVEL:
+         return 0;
+      case ciaaPOSIX_IOCTL_SET_NONBLOCK_MODE:
+         flags = fcntl(device->fd, F_GETFL);
+         if(flags < 0)
+         {
+            return -1;
+         }
+         flags = 0 != (uintptr_t) param ? flags | O_NONBLOCK : flags & ~O_NONBLOCK;
+         return 0 == fcntl(device->fd, F_SETFL, flags) ? 0 : -1;
+      case ciaaPOSIX_IOCTL_GET_RX_COUNT:
+         if(0 != ioctl(device->fd, FIONREAD, &count))
+         {
+            return -1;
+         }
+         *(uint32_t *) param = count;
+         return 0;
+      default:
+         return -1;
+   }
+}
+
+int32_t ciaaPOSIX_usleep(uint32_t useconds)
+{
+   return usleep(useconds);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,334 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief this file implements the unit tests for the functions of the file UPDT_ITransport
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup update Implementation
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.3  AG  test the interface initialization
+ * 20261017 v0.0.2  AG  add the counting decorator tests
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "UPDT_ITransport.h"
+#include "UPDT_time.h"
+#include <string.h>
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static UPDT_ITransportType inner;
+static UPDT_ITransportBatchType batch;
+static UPDT_ITransportReadAheadType readahead;
+static UPDT_ITransportCounterType counter;
+static UPDT_ITransportStatsType stats;
+static uint32_t fake_time;
+static uint8_t ring[64];
+static size_t source_pos;
+static uint32_t recv_calls;
+static uint8_t staging[64];
+static uint8_t wire[256];
+static size_t wire_size;
+static uint32_t send_calls;
+/* bytes the inner transport takes per send, 0 for all of them */
+static size_t send_limit;
+static uint8_t data[128];
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static ssize_t test_UPDT_ITransportSendWire (UPDT_ITransportType* transport, const void* buffer, size_t size){
+   send_calls++;
+   if(0 != send_limit && size > send_limit)
+   {
+      size = send_limit;
+   }
+   memcpy(wire + wire_size, buffer, size);
+   wire_size += size;
+   return size;
+}
+
+static ssize_t test_UPDT_ITransportRecvNothing (UPDT_ITransportType* transport, void* buffer, size_t size){
+   /* the bytes sent so far must be on the wire */
+   TEST_ASSERT_EQUAL (0, batch.fill);
+   return 0;
+}
+
+static ssize_t test_UPDT_ITransportRecvSource (UPDT_ITransportType* transport, void* buffer, size_t size){
+   /* everything left is available, like a driver with a large buffer */
+   recv_calls++;
+   if(size > sizeof(data) - source_pos)
+   {
+      size = sizeof(data) - source_pos;
+   }
+   memcpy(buffer, data + source_pos, size);
+   source_pos += size;
+   return size;
+}
+
+static ssize_t test_UPDT_ITransportRecvSlow (UPDT_ITransportType* transport, void* buffer, size_t size){
+   /* each read takes 3 ms */
+   fake_time += 3;
+   return test_UPDT_ITransportRecvSource(transport, buffer, size);
+}
+
+static uint32_t test_UPDT_timeFake (void){
+   return fake_time;
+}
+
+/*==================[external functions definition]==========================*/
+void setUp(void)
+{
+   size_t i;
+
+   for(i = 0; i < sizeof(data); i++)
+   {
+      data[i] = (uint8_t) i;
+   }
+   UPDT_ITransportInit(&inner, test_UPDT_ITransportRecvNothing, test_UPDT_ITransportSendWire);
+   wire_size = 0;
+   send_calls = 0;
+   send_limit = 0;
+   source_pos = 0;
+   recv_calls = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test_UPDT_ITransportInit()
+{
+   UPDT_ITransportDeadlineType deadline;
+
+   /* a transport which is not zero initialized */
+   memset(&inner, 0xA5, sizeof(inner));
+   UPDT_ITransportInit(&inner, test_UPDT_ITransportRecvNothing, test_UPDT_ITransportSendWire);
+   TEST_ASSERT_TRUE (inner.recv == test_UPDT_ITransportRecvNothing);
+   TEST_ASSERT_TRUE (inner.send == test_UPDT_ITransportSendWire);
+   TEST_ASSERT_NULL (inner.recvv);
+   TEST_ASSERT_NULL (inner.sendv);
+   TEST_ASSERT_NULL (inner.recv_acquire);
+   TEST_ASSERT_NULL (inner.recv_release);
+   TEST_ASSERT_NULL (inner.recv_until);
+   TEST_ASSERT_NULL (inner.send_until);
+   TEST_ASSERT_NULL (inner.recv_acquire_until);
+
+   /* the decorators only set the entries they provide */
+   memset(&deadline, 0xA5, sizeof(deadline));
+   UPDT_ITransportDeadlineInit(&deadline, &inner);
+   TEST_ASSERT_NULL (deadline.transport.recv_acquire);
+   TEST_ASSERT_NULL (deadline.transport.recv_release);
+   TEST_ASSERT_NULL (deadline.transport.recv_until);
+   TEST_ASSERT_NULL (deadline.transport.send_until);
+   TEST_ASSERT_NULL (deadline.transport.recv_acquire_until);
+}
+
+void test_UPDT_ITransportBatchFlush()
+{
+   UPDT_ITransportIoVecType iov[2] = { { data + 10, 6 }, { data + 16, 10 } };
+
+   UPDT_ITransportBatchInit(&batch, &inner, staging, sizeof(staging), sizeof(staging));
+
+   /* frames and vectored frames are staged */
+   TEST_ASSERT_EQUAL (10, batch.transport.send(&batch.transport, data, 10));
+   TEST_ASSERT_EQUAL (16, UPDT_ITransportSendVector(&batch.transport, iov, 2));
+   TEST_ASSERT_EQUAL (0, send_calls);
+
+   /* and leave in one write */
+   TEST_ASSERT_EQUAL (0, UPDT_ITransportBatchFlush(&batch));
+   TEST_ASSERT_EQUAL (1, send_calls);
+   TEST_ASSERT_EQUAL (1, batch.writes);
+   TEST_ASSERT_EQUAL (26, wire_size);
+   TEST_ASSERT_EQUAL_MEMORY (data, wire, 26);
+}
+
+void test_UPDT_ITransportBatchThreshold()
+{
+   UPDT_ITransportBatchInit(&batch, &inner, staging, sizeof(staging), 20);
+
+   batch.transport.send(&batch.transport, data, 10);
+   TEST_ASSERT_EQUAL (0, send_calls);
+   batch.transport.send(&batch.transport, data + 10, 10);
+   TEST_ASSERT_EQUAL (1, send_calls);
+   TEST_ASSERT_EQUAL (20, wire_size);
+   TEST_ASSERT_EQUAL (0, batch.fill);
+}
+
+void test_UPDT_ITransportBatchRecv()
+{
+   uint8_t buffer[4];
+
+   UPDT_ITransportBatchInit(&batch, &inner, staging, sizeof(staging), sizeof(staging));
+
+   batch.transport.send(&batch.transport, data, 10);
+   TEST_ASSERT_EQUAL (0, batch.transport.recv(&batch.transport, buffer, sizeof(buffer)));
+   TEST_ASSERT_EQUAL (10, wire_size);
+}
+
+void test_UPDT_ITransportBatchLarge()
+{
+   UPDT_ITransportBatchInit(&batch, &inner, staging, sizeof(staging), sizeof(staging));
+
+   batch.transport.send(&batch.transport, data, 10);
+   /* does not fit, the staged bytes go first */
+   TEST_ASSERT_EQUAL (100, batch.transport.send(&batch.transport, data + 10, 100));
+   TEST_ASSERT_EQUAL (2, send_calls);
+   TEST_ASSERT_EQUAL (110, wire_size);
+   TEST_ASSERT_EQUAL_MEMORY (data, wire, 110);
+}
+
+void test_UPDT_ITransportBatchPartial()
+{
+   UPDT_ITransportBatchInit(&batch, &inner, staging, sizeof(staging), sizeof(staging));
+
+   batch.transport.send(&batch.transport, data, 20);
+   send_limit = 8;
+   TEST_ASSERT_EQUAL (0, UPDT_ITransportBatchFlush(&batch));
+   TEST_ASSERT_EQUAL (3, send_calls);
+   TEST_ASSERT_EQUAL_MEMORY (data, wire, 20);
+}
+
+void test_UPDT_ITransportReadAheadRecv()
+{
+   uint8_t buffer[16];
+   size_t offset;
+
+   inner.recv = test_UPDT_ITransportRecvSource;
+   TEST_ASSERT_EQUAL (0, UPDT_ITransportReadAheadInit(&readahead, &inner, ring, sizeof(ring)));
+
+   /* headers and payloads of three frames, from one read */
+   for(offset = 0; offset < 60; offset += 20)
+   {
+      TEST_ASSERT_EQUAL (4, readahead.transport.recv(&readahead.transport, buffer, 4));
+      TEST_ASSERT_EQUAL_MEMORY (data + offset, buffer, 4);
+      TEST_ASSERT_EQUAL (16, readahead.transport.recv(&readahead.transport, buffer, 16));
+      TEST_ASSERT_EQUAL_MEMORY (data + offset + 4, buffer, 16);
+   }
+   TEST_ASSERT_EQUAL (1, recv_calls);
+   TEST_ASSERT_EQUAL (1, readahead.reads);
+
+   /* what is left in the ring, then a new read */
+   TEST_ASSERT_EQUAL (3, readahead.transport.recv(&readahead.transport, buffer, 16));
+   TEST_ASSERT_EQUAL (16, readahead.transport.recv(&readahead.transport, buffer, 16));
+   TEST_ASSERT_EQUAL_MEMORY (data + 63, buffer, 16);
+   TEST_ASSERT_EQUAL (2, recv_calls);
+}
+
+void test_UPDT_ITransportReadAheadAcquire()
+{
+   const void *lent;
+
+   inner.recv = test_UPDT_ITransportRecvSource;
+   UPDT_ITransportReadAheadInit(&readahead, &inner, ring, sizeof(ring));
+
+   TEST_ASSERT_EQUAL (10, readahead.transport.recv_acquire(&readahead.transport, &lent, 10));
+   TEST_ASSERT_EQUAL_MEMORY (data, lent, 10);
+   readahead.transport.recv_release(&readahead.transport, 6);
+   TEST_ASSERT_EQUAL (57, readahead.transport.recv_acquire(&readahead.transport, &lent, 100));
+   TEST_ASSERT_EQUAL_MEMORY (data + 6, lent, 57);
+   readahead.transport.recv_release(&readahead.transport, 57);
+   TEST_ASSERT_EQUAL (1, recv_calls);
+}
+
+void test_UPDT_ITransportReadAheadLarge()
+{
+   uint8_t buffer[sizeof(ring)];
+
+   inner.recv = test_UPDT_ITransportRecvSource;
+   UPDT_ITransportReadAheadInit(&readahead, &inner, ring, sizeof(ring));
+
+   /* straight to the caller buffer */
+   TEST_ASSERT_EQUAL (sizeof(buffer), readahead.transport.recv(&readahead.transport, buffer, sizeof(buffer)));
+   TEST_ASSERT_EQUAL_MEMORY (data, buffer, sizeof(buffer));
+   TEST_ASSERT_TRUE (ciaaLibs_circBufEmpty(&readahead.cbuf));
+}
+
+void test_UPDT_ITransportCounter()
+{
+   uint8_t buffer[100];
+
+   inner.recv = test_UPDT_ITransportRecvSlow;
+   memset(&stats, 0, sizeof(stats));
+   UPDT_ITransportCounterInit(&counter, &inner, &stats);
+   TEST_ASSERT_NULL (counter.transport.recv_acquire);
+   TEST_ASSERT_NULL (counter.transport.recv_until);
+   UPDT_timeSetSource(test_UPDT_timeFake);
+   fake_time = 0xFFFFFFFE;
+
+   /* a full read, a partial one and one which gets nothing */
+   TEST_ASSERT_EQUAL (100, counter.transport.recv(&counter.transport, buffer, 100));
+   TEST_ASSERT_EQUAL (28, counter.transport.recv(&counter.transport, buffer, 100));
+   TEST_ASSERT_EQUAL (0, counter.transport.recv(&counter.transport, buffer, 100));
+   TEST_ASSERT_EQUAL (3, stats.reads);
+   TEST_ASSERT_EQUAL (1, stats.partial_reads);
+   TEST_ASSERT_EQUAL (1, stats.expired);
+   TEST_ASSERT_EQUAL (128, stats.bytes_received);
+   TEST_ASSERT_EQUAL (9, stats.recv_time);
+
+   /* the partial sends of the wrapped transport are seen */
+   send_limit = 8;
+   TEST_ASSERT_EQUAL (8, counter.transport.send(&counter.transport, data, 20));
+   TEST_ASSERT_EQUAL (1, stats.writes);
+   TEST_ASSERT_EQUAL (1, stats.partial_writes);
+   TEST_ASSERT_EQUAL (8, stats.bytes_sent);
+   TEST_ASSERT_EQUAL (0, stats.errors);
+
+   UPDT_timeSetSource(NULL);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,372 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief this file implements the unit tests for the functions of the file UPDT_broadcast
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup update Implementation
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "UPDT_broadcast.h"
+#include <string.h>
+
+/*==================[macros and definitions]=================================*/
+#define SLAVES          30
+#define IMAGE_SIZE      20001
+#define IMAGE_ID        0x0B0B0B0Bu
+#define PAYLOAD_SIZE    UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE
+#define FRAME_SIZE      UPDT_PROTOCOL_FRAME_SIZE(PAYLOAD_SIZE)
+#define BLOCKS          ((IMAGE_SIZE + PAYLOAD_SIZE - 1) / PAYLOAD_SIZE)
+#define BITMAP_SIZE     UPDT_BROADCAST_BITMAP_SIZE(BLOCKS)
+
+/* a slave on the bus */
+typedef struct
+{
+   /* the transport of the slave, first so that it can be cast back */
+   UPDT_ITransportType transport;
+   UPDT_broadcastSlaveType slave;
+   uint8_t frame[FRAME_SIZE];
+   uint8_t received[BITMAP_SIZE];
+   uint8_t flash[IMAGE_SIZE];
+   /* bus bytes read */
+   size_t pos;
+   /* next frame of the bus to end */
+   size_t next;
+   /* one frame out of loss is corrupted, 0 for none */
+   uint32_t loss;
+   /* the first frames of the bus are corrupted */
+   uint32_t skip;
+   uint32_t seed;
+   uint32_t writes;
+   uint8_t dead;
+} test_slaveType;
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static uint8_t image[IMAGE_SIZE];
+/* every byte sent on the bus, by the master and by the slaves */
+static uint8_t bus[1u << 19];
+static size_t bus_size;
+/* end of each frame of the bus */
+static size_t ends[1u << 13];
+static size_t frames;
+static size_t parsed;
+/* answers waiting for the master */
+static uint8_t inbox[1u << 12];
+static size_t inbox_size;
+static size_t inbox_pos;
+static UPDT_ITransportType master_transport;
+static UPDT_broadcastMasterType master;
+static uint8_t missing[BITMAP_SIZE];
+static test_slaveType slaves[SLAVES];
+static uint8_t addresses[SLAVES];
+static uint8_t status[SLAVES];
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static void test_UPDT_broadcastAppend (const void* data, size_t size){
+   TEST_ASSERT_TRUE (bus_size + size <= sizeof(bus));
+   memcpy(bus + bus_size, data, size);
+   bus_size += size;
+   while(parsed + UPDT_PROTOCOL_HEADER_SIZE <= bus_size &&
+      parsed + UPDT_protocolGetFrameSize(bus + parsed) <= bus_size)
+   {
+      TEST_ASSERT_TRUE (frames < sizeof(ends) / sizeof(ends[0]));
+      parsed += UPDT_protocolGetFrameSize(bus + parsed);
+      ends[frames++] = parsed;
+   }
+}
+
+static ssize_t test_UPDT_ITransportSendMaster (UPDT_ITransportType* transport, const void* data, size_t size){
+   test_UPDT_broadcastAppend(data, size);
+   return size;
+}
+
+static ssize_t test_UPDT_ITransportRecvMaster (UPDT_ITransportType* transport, void* data, size_t size){
+   size_t i;
+
+   if(inbox_pos == inbox_size)
+   {
+      /* the slaves run until the bus is quiet */
+      inbox_pos = 0;
+      inbox_size = 0;
+      for(i = 0; i < SLAVES; i++)
+      {
+         while(!slaves[i].dead && slaves[i].pos < bus_size)
+         {
+            TEST_ASSERT_TRUE (UPDT_broadcastSlaveRecv(&slaves[i].slave) != UPDT_PROTOCOL_ERROR_TRANSPORT);
+         }
+      }
+   }
+   if(size > inbox_size - inbox_pos)
+   {
+      size = inbox_size - inbox_pos;
+   }
+   /* 0 is a timeout */
+   memcpy(data, inbox + inbox_pos, size);
+   inbox_pos += size;
+   return size;
+}
+
+static ssize_t test_UPDT_ITransportSendSlave (UPDT_ITransportType* transport, const void* data, size_t size){
+   TEST_ASSERT_TRUE (inbox_size + size <= sizeof(inbox));
+   memcpy(inbox + inbox_size, data, size);
+   inbox_size += size;
+   test_UPDT_broadcastAppend(data, size);
+   return size;
+}
+
+static ssize_t test_UPDT_ITransportRecvSlave (UPDT_ITransportType* transport, void* data, size_t size){
+   test_slaveType *slave = (test_slaveType *) transport;
+
+   if(size > bus_size - slave->pos)
+   {
+      size = bus_size - slave->pos;
+   }
+   memcpy(data, bus + slave->pos, size);
+   slave->pos += size;
+   /* the frames ending in this read may be hit by noise */
+   for(; slave->next < frames && ends[slave->next] <= slave->pos; slave->next++)
+   {
+      slave->seed = slave->seed * 1103515245u + 12345u;
+      if(slave->next < slave->skip || (0 != slave->loss && 0 == (slave->seed >> 16) % slave->loss))
+      {
+         ((uint8_t *) data)[ends[slave->next] - 1 - (slave->pos - size)] ^= 0x01;
+      }
+   }
+   return size;
+}
+
+static int32_t test_UPDT_broadcastFlash (void *context, size_t offset, const uint8_t *data, size_t size){
+   test_slaveType *slave = (test_slaveType *) context;
+
+   TEST_ASSERT_TRUE (offset + size <= IMAGE_SIZE);
+   memcpy(slave->flash + offset, data, size);
+   slave->writes++;
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+static void test_UPDT_broadcastAssertDone (size_t i){
+   TEST_ASSERT_EQUAL (UPDT_BROADCAST_SLAVE_DONE, status[i]);
+   TEST_ASSERT_TRUE (slaves[i].slave.ended);
+   TEST_ASSERT_EQUAL (0, slaves[i].slave.missing);
+   TEST_ASSERT_EQUAL (BLOCKS, slaves[i].writes);
+   TEST_ASSERT_EQUAL_HEX32 (UPDT_crc32cUpdate(0, slaves[i].flash, IMAGE_SIZE), slaves[i].slave.image_crc);
+   TEST_ASSERT_EQUAL_MEMORY (image, slaves[i].flash, IMAGE_SIZE);
+}
+
+/* the master is done, the slaves get the end of the transfer */
+static void test_UPDT_broadcastDrain (void){
+   uint8_t byte;
+
+   TEST_ASSERT_EQUAL (0, test_UPDT_ITransportRecvMaster(&master_transport, &byte, 1));
+}
+
+/*==================[external functions definition]==========================*/
+void setUp(void)
+{
+   size_t i;
+
+   for(i = 0; i < sizeof(image); i++)
+   {
+      image[i] = (uint8_t) (i * 29 + i / 253);
+   }
+   bus_size = 0;
+   frames = 0;
+   parsed = 0;
+   inbox_size = 0;
+   inbox_pos = 0;
+   memset(&master_transport, 0, sizeof(master_transport));
+   master_transport.send = test_UPDT_ITransportSendMaster;
+   master_transport.recv = test_UPDT_ITransportRecvMaster;
+   memset(slaves, 0, sizeof(slaves));
+   for(i = 0; i < SLAVES; i++)
+   {
+      addresses[i] = (uint8_t) (0x40 + i);
+      slaves[i].transport.send = test_UPDT_ITransportSendSlave;
+      slaves[i].transport.recv = test_UPDT_ITransportRecvSlave;
+      slaves[i].seed = (uint32_t) i * 7919u + 1u;
+      UPDT_broadcastSlaveInit(&slaves[i].slave, &slaves[i].transport, addresses[i],
+         slaves[i].frame, sizeof(slaves[i].frame), slaves[i].received, sizeof(slaves[i].received),
+         test_UPDT_broadcastFlash, &slaves[i]);
+   }
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_broadcastMasterInit(&master, &master_transport,
+      image, IMAGE_SIZE, PAYLOAD_SIZE, missing, sizeof(missing), IMAGE_ID));
+}
+
+void tearDown(void)
+{
+}
+
+void test_UPDT_broadcastMasterInit()
+{
+   UPDT_broadcastMasterType other;
+
+   TEST_ASSERT_EQUAL (BLOCKS, master.blocks);
+   TEST_ASSERT_EQUAL_HEX32 (UPDT_crc32cUpdate(0, image, IMAGE_SIZE), master.image_crc);
+   /* the payload size must be one the header can describe */
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_PACKET, UPDT_broadcastMasterInit(&other, &master_transport,
+      image, IMAGE_SIZE, PAYLOAD_SIZE + 1, missing, sizeof(missing), IMAGE_ID));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_PACKET, UPDT_broadcastMasterInit(&other, &master_transport,
+      image, IMAGE_SIZE, 0, missing, sizeof(missing), IMAGE_ID));
+   /* and the bitmap must hold every frame */
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_PACKET, UPDT_broadcastMasterInit(&other, &master_transport,
+      image, IMAGE_SIZE, PAYLOAD_SIZE, missing, sizeof(missing) - 1, IMAGE_ID));
+}
+
+void test_UPDT_broadcastLossless()
+{
+   size_t i;
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_broadcastMasterRun(&master, addresses, status, SLAVES));
+   test_UPDT_broadcastDrain();
+
+   /* the image went once over the bus, whatever the number of slaves */
+   TEST_ASSERT_EQUAL (BLOCKS, master.sent);
+   TEST_ASSERT_EQUAL (0, master.rounds);
+   TEST_ASSERT_EQUAL (SLAVES, master.polls);
+   for(i = 0; i < SLAVES; i++)
+   {
+      test_UPDT_broadcastAssertDone(i);
+   }
+}
+
+void test_UPDT_broadcastRepair()
+{
+   size_t i;
+
+   /* every slave loses its own frames, one of them a lot of them */
+   for(i = 0; i < SLAVES; i++)
+   {
+      slaves[i].loss = 40;
+   }
+   slaves[5].loss = 3;
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_broadcastMasterRun(&master, addresses, status, SLAVES));
+   test_UPDT_broadcastDrain();
+
+   /* only the union of the missing frames is sent again, far less than a
+    * transfer per slave */
+   TEST_ASSERT_TRUE (master.rounds > 1);
+   TEST_ASSERT_TRUE (master.sent > BLOCKS);
+   TEST_ASSERT_TRUE (master.sent < 3 * BLOCKS);
+   for(i = 0; i < SLAVES; i++)
+   {
+      test_UPDT_broadcastAssertDone(i);
+   }
+}
+
+void test_UPDT_broadcastMissedAnnouncement()
+{
+   size_t i;
+
+   /* the first slave misses the announcement, so it drops the image */
+   slaves[0].skip = 1;
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_broadcastMasterRun(&master, addresses, status, SLAVES));
+   test_UPDT_broadcastDrain();
+
+   TEST_ASSERT_EQUAL (1, master.rounds);
+   TEST_ASSERT_EQUAL (2 * BLOCKS, master.sent);
+   for(i = 0; i < SLAVES; i++)
+   {
+      test_UPDT_broadcastAssertDone(i);
+   }
+}
+
+void test_UPDT_broadcastSilentSlave()
+{
+   size_t i;
+
+   slaves[3].dead = 1;
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_TIMEOUT, UPDT_broadcastMasterRun(&master, addresses, status, SLAVES));
+   test_UPDT_broadcastDrain();
+
+   /* it is asked again a few times, then left out */
+   TEST_ASSERT_EQUAL (UPDT_BROADCAST_SLAVE_SILENT, status[3]);
+   TEST_ASSERT_EQUAL (SLAVES - 1 + UPDT_PROTOCOL_RETRIES_MAX, master.polls);
+   TEST_ASSERT_EQUAL (BLOCKS, master.sent);
+   for(i = 0; i < SLAVES; i++)
+   {
+      if(3 != i)
+      {
+         test_UPDT_broadcastAssertDone(i);
+      }
+   }
+}
+
+void test_UPDT_broadcastRefused()
+{
+   /* a slave whose bitmap can not hold the image */
+   UPDT_broadcastSlaveInit(&slaves[1].slave, &slaves[1].transport, addresses[1],
+      slaves[1].frame, sizeof(slaves[1].frame), slaves[1].received, BITMAP_SIZE - 1,
+      test_UPDT_broadcastFlash, &slaves[1]);
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_TIMEOUT, UPDT_broadcastMasterRun(&master, addresses, status, SLAVES));
+   test_UPDT_broadcastDrain();
+
+   TEST_ASSERT_EQUAL (UPDT_BROADCAST_SLAVE_REFUSED, status[1]);
+   TEST_ASSERT_TRUE (slaves[1].slave.refused);
+   TEST_ASSERT_TRUE (slaves[1].slave.ended);
+   TEST_ASSERT_EQUAL (0, slaves[1].writes);
+   TEST_ASSERT_EQUAL (0, master.rounds);
+   test_UPDT_broadcastAssertDone(0);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,237 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/** \brief this file implements the unit tests for the functions of the file UPDT_cipher
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup update Implementation
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "UPDT_cipher.h"
+#include <string.h>
+
+/*==================[macros and definitions]=================================*/
+#define TEXT_SIZE    114
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/* RFC 8439 section 2.8.2 */
+static const char text[] = "Ladies and Gentlemen of the class of '99: If I could offer you only "
+   "one tip for the future, sunscreen would be it.";
+static const uint8_t session_nonce[UPDT_CIPHER_SESSION_NONCE_SIZE] =
+{
+   0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+};
+static const uint8_t aad[12] =
+{
+   0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7,
+};
+static const uint8_t ciphertext[TEXT_SIZE] =
+{
+   0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+   0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe, 0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+   0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+   0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+   0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c, 0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+   0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+   0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+   0x61, 0x16,
+};
+static const uint8_t tag[UPDT_CIPHER_TAG_SIZE] =
+{
+   0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91,
+};
+/* RFC 8439 section 2.5.2 */
+static const uint8_t poly_key[32] =
+{
+   0x85, 0xd6, 0xbe, 0x78, 0x57, 0x55, 0x6d, 0x33, 0x7f, 0x44, 0x52, 0xfe, 0x42, 0xd5, 0x06, 0xa8,
+   0x01, 0x03, 0x80, 0x8a, 0xfb, 0x0d, 0xb2, 0xfd, 0x4a, 0xbf, 0xf6, 0xaf, 0x41, 0x49, 0xf5, 0x1b,
+};
+static const uint8_t poly_tag[UPDT_CIPHER_TAG_SIZE] =
+{
+   0xa8, 0x06, 0x1d, 0xc1, 0x30, 0x51, 0x36, 0xc6, 0xc2, 0x2b, 0x8b, 0xaf, 0x0c, 0x01, 0x27, 0xa9,
+};
+
+static uint8_t key[UPDT_CIPHER_KEY_SIZE];
+static uint8_t inf[UPDT_PROTOCOL_PACKET_INF_PAYLOAD_SIZE];
+static uint8_t alw[UPDT_PROTOCOL_PACKET_ALW_PAYLOAD_SIZE];
+static UPDT_cipherType cipher;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+void setUp(void)
+{
+   size_t i;
+
+   for(i = 0; i < sizeof(key); i++)
+   {
+      key[i] = (uint8_t) (0x80 + i);
+   }
+   memset(inf, 0, sizeof(inf));
+   memset(alw, 0, sizeof(alw));
+   UPDT_cipherInit(&cipher, key, inf, alw);
+   UPDT_cipherSetNonce(&cipher, session_nonce);
+}
+
+void tearDown(void)
+{
+}
+
+void test_UPDT_cipherPoly1305()
+{
+   uint8_t computed[UPDT_CIPHER_TAG_SIZE];
+
+   UPDT_cipherPoly1305(poly_key, (const uint8_t *) "Cryptographic Forum Research Group", 34, computed);
+   TEST_ASSERT_EQUAL_MEMORY (poly_tag, computed, sizeof(poly_tag));
+}
+
+void test_UPDT_cipherEncrypt()
+{
+   uint8_t data[TEXT_SIZE];
+   uint8_t computed[UPDT_CIPHER_TAG_SIZE];
+
+   memcpy(data, text, TEXT_SIZE);
+   UPDT_cipherEncrypt(&cipher, 7, aad, sizeof(aad), data, TEXT_SIZE, computed);
+   TEST_ASSERT_EQUAL_MEMORY (ciphertext, data, TEXT_SIZE);
+   TEST_ASSERT_EQUAL_MEMORY (tag, computed, sizeof(tag));
+}
+
+void test_UPDT_cipherDecrypt()
+{
+   uint8_t data[TEXT_SIZE];
+   uint8_t forged[UPDT_CIPHER_TAG_SIZE];
+
+   memcpy(data, ciphertext, TEXT_SIZE);
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_cipherDecrypt(&cipher, 7, aad, sizeof(aad), data, TEXT_SIZE, tag));
+   TEST_ASSERT_EQUAL_MEMORY (text, data, TEXT_SIZE);
+
+   /* a data that is not authentic is left as it is */
+   memcpy(data, ciphertext, TEXT_SIZE);
+   data[100] ^= 1;
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_DENIED, UPDT_cipherDecrypt(&cipher, 7, aad, sizeof(aad), data, TEXT_SIZE, tag));
+   TEST_ASSERT_TRUE (data[0] == ciphertext[0]);
+   data[100] ^= 1;
+   memcpy(forged, tag, sizeof(forged));
+   forged[15] ^= 0x80;
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_DENIED, UPDT_cipherDecrypt(&cipher, 7, aad, sizeof(aad), data, TEXT_SIZE, forged));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_DENIED, UPDT_cipherDecrypt(&cipher, 7, aad, sizeof(aad) - 1, data, TEXT_SIZE, tag));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_DENIED, UPDT_cipherDecrypt(&cipher, 8, aad, sizeof(aad), data, TEXT_SIZE, tag));
+   TEST_ASSERT_EQUAL_MEMORY (ciphertext, data, TEXT_SIZE);
+}
+
+void test_UPDT_cipherKernels()
+{
+   uint8_t expected[600];
+   uint8_t data[600];
+   size_t size;
+
+   /* every kernel gives the same key stream, whatever the size */
+   for(size = 0; size <= sizeof(data); size += 37)
+   {
+      memset(expected, 0xA5, size);
+      memset(data, 0xA5, size);
+      UPDT_cipherChaCha20Scalar(cipher.key, cipher.nonce, 1, expected, size);
+      UPDT_cipherChaCha20(cipher.key, cipher.nonce, 1, data, size);
+      TEST_ASSERT_EQUAL_MEMORY (expected, data, size);
+   }
+}
+
+void test_UPDT_cipherSealOpen()
+{
+   uint8_t frame[UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE)];
+   uint8_t plain[UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE - UPDT_CIPHER_TAG_SIZE];
+   size_t i;
+
+   for(i = 0; i < sizeof(plain); i++)
+   {
+      plain[i] = (uint8_t) i;
+   }
+   frame[0] = 0;
+   UPDT_protocolSetHeader(frame, UPDT_PROTOCOL_PACKET_DAT, 9, UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE);
+   UPDT_protocolSetFlags(frame, UPDT_PROTOCOL_FLAG_ENCRYPTED);
+   memcpy(frame + UPDT_PROTOCOL_HEADER_SIZE, plain, sizeof(plain));
+
+   /* the payload is encrypted in the frame, the tag takes its end */
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_cipherSeal(&cipher, frame, frame + UPDT_PROTOCOL_HEADER_SIZE, 300));
+   TEST_ASSERT_TRUE (memcmp(plain, frame + UPDT_PROTOCOL_HEADER_SIZE, sizeof(plain)) != 0);
+
+   /* the header is authenticated too */
+   frame[2] = 10;
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_DENIED, UPDT_cipherOpen(&cipher, frame, frame + UPDT_PROTOCOL_HEADER_SIZE, 300));
+   frame[2] = 9;
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_DENIED, UPDT_cipherOpen(&cipher, frame, frame + UPDT_PROTOCOL_HEADER_SIZE, 301));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_cipherOpen(&cipher, frame, frame + UPDT_PROTOCOL_HEADER_SIZE, 300));
+   TEST_ASSERT_EQUAL_MEMORY (plain, frame + UPDT_PROTOCOL_HEADER_SIZE, sizeof(plain));
+}
+
+void test_UPDT_cipherInit()
+{
+   UPDT_cipherType other;
+
+   /* another slave nonce, another session nonce */
+   UPDT_cipherInit(&cipher, key, inf, alw);
+   alw[UPDT_PROTOCOL_ALW_NONCE_OFFSET] = 1;
+   UPDT_cipherInit(&other, key, inf, alw);
+   TEST_ASSERT_EQUAL_MEMORY (cipher.key, other.key, sizeof(cipher.key));
+   TEST_ASSERT_TRUE (cipher.nonce[1] != other.nonce[1] || cipher.nonce[2] != other.nonce[2]);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,142 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief this file implements the unit tests for the functions of the file UPDT_crc32c
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup update Implementation
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "UPDT_crc32c.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/* standard check string, its CRC32C is 0xE3069283 */
+static const uint8_t check[] = "123456789";
+
+static uint8_t data[1000];
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+void setUp(void)
+{
+   size_t i;
+
+   for(i = 0; i < sizeof(data); i++)
+   {
+      data[i] = (uint8_t) (i * 31 + 7);
+   }
+}
+
+void tearDown(void)
+{
+}
+
+void test_UPDT_crc32cCheckValue()
+{
+   TEST_ASSERT_EQUAL_HEX32 (0xE3069283, UPDT_crc32cUpdateBytewise(0, check, 9));
+   TEST_ASSERT_EQUAL_HEX32 (0xE3069283, UPDT_crc32cUpdateSlice8(0, check, 9));
+   TEST_ASSERT_EQUAL_HEX32 (0xE3069283, UPDT_crc32cUpdate(0, check, 9));
+#ifdef UPDT_CRC32C_HARDWARE
+   TEST_ASSERT_EQUAL_HEX32 (0xE3069283, UPDT_crc32cUpdateHardware(0, check, 9));
+#endif
+}
+
+void test_UPDT_crc32cEmpty()
+{
+   TEST_ASSERT_EQUAL_HEX32 (0, UPDT_crc32cUpdate(0, data, 0));
+}
+
+void test_UPDT_crc32cKernelsMatch()
+{
+   size_t size;
+
+   for(size = 0; size < sizeof(data); size += 13)
+   {
+      TEST_ASSERT_EQUAL_HEX32 (UPDT_crc32cUpdateBytewise(0, data, size),
+         UPDT_crc32cUpdateSlice8(0, data, size));
+      TEST_ASSERT_EQUAL_HEX32 (UPDT_crc32cUpdateBytewise(0, data, size),
+         UPDT_crc32cUpdate(0, data, size));
+   }
+}
+
+void test_UPDT_crc32cIncremental()
+{
+   uint32_t crc;
+
+   crc = UPDT_crc32cUpdate(0, data, 5);
+   crc = UPDT_crc32cUpdate(crc, data + 5, 224);
+   crc = UPDT_crc32cUpdate(crc, data + 229, 771);
+   TEST_ASSERT_EQUAL_HEX32 (UPDT_crc32cUpdate(0, data, sizeof(data)), crc);
+}
+
+void test_UPDT_crc32cSetGet()
+{
+   uint8_t buffer[UPDT_CRC32C_SIZE];
+
+   UPDT_crc32cSet(buffer, 0x12345678);
+   TEST_ASSERT_EQUAL_HEX8 (0x78, buffer[0]);
+   TEST_ASSERT_EQUAL_HEX8 (0x12, buffer[3]);
+   TEST_ASSERT_EQUAL_HEX32 (0x12345678, UPDT_crc32cGet(buffer));
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
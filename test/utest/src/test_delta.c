@@ -0,0 +1,276 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief this file implements the unit tests for the functions of the file UPDT_delta
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup update Implementation
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "UPDT_delta.h"
+#include "UPDT_lzss.h"
+#include <string.h>
+
+/*==================[macros and definitions]=================================*/
+#define SOURCE_SIZE     4000
+#define INSERT_AT       1000
+#define INSERT_SIZE     50
+#define TARGET_SIZE     (SOURCE_SIZE + INSERT_SIZE)
+#define PATCH_SIZE      (UPDT_DELTA_HEADER_SIZE + 2 * UPDT_DELTA_RECORD_SIZE + TARGET_SIZE)
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static uint8_t source[SOURCE_SIZE];
+static uint8_t target[TARGET_SIZE];
+static uint8_t patch[PATCH_SIZE];
+static uint8_t compressed[UPDT_LZSS_BOUND(PATCH_SIZE)];
+static uint8_t output[TARGET_SIZE];
+static size_t output_size;
+/* frames sent by the master, read back by the slave */
+static uint8_t wire[2 * PATCH_SIZE];
+static size_t wire_size;
+static size_t wire_pos;
+static UPDT_ITransportType transport;
+static UPDT_deltaPatcherType patcher;
+static UPDT_lzssDecoderType decoder;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static ssize_t test_UPDT_ITransportSendWire (UPDT_ITransportType* transport, const void* data, size_t size){
+   TEST_ASSERT_TRUE (wire_size + size <= sizeof(wire));
+   memcpy(wire + wire_size, data, size);
+   wire_size += size;
+   return size;
+}
+
+static ssize_t test_UPDT_ITransportRecvWire (UPDT_ITransportType* transport, void* data, size_t size){
+   if(size > wire_size - wire_pos)
+   {
+      size = wire_size - wire_pos;
+   }
+   memcpy(data, wire + wire_pos, size);
+   wire_pos += size;
+   return size;
+}
+
+static int32_t test_UPDT_deltaRead (void *context, size_t offset, uint8_t *data, size_t size){
+   TEST_ASSERT_TRUE (offset + size <= sizeof(source));
+   memcpy(data, source + offset, size);
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+static int32_t test_UPDT_deltaWrite (void *context, size_t offset, const uint8_t *data, size_t size){
+   TEST_ASSERT_EQUAL (output_size, offset);
+   TEST_ASSERT_TRUE (output_size + size <= sizeof(output));
+   memcpy(output + output_size, data, size);
+   output_size += size;
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+static uint8_t *test_UPDT_deltaPut (uint8_t *buffer, uint32_t value){
+   buffer[0] = (uint8_t) value;
+   buffer[1] = (uint8_t) (value >> 8);
+   buffer[2] = (uint8_t) (value >> 16);
+   buffer[3] = (uint8_t) (value >> 24);
+   return buffer + 4;
+}
+
+/* the patch a host tool would make: the inserted bytes are extra, the rest
+ * are diff bytes against the same source bytes */
+static uint8_t *test_UPDT_deltaRecord (uint8_t *buffer, size_t target_at, size_t source_at, size_t diff_size, size_t extra_size){
+   size_t i;
+
+   buffer = test_UPDT_deltaPut(buffer, diff_size);
+   buffer = test_UPDT_deltaPut(buffer, extra_size);
+   buffer = test_UPDT_deltaPut(buffer, 0);
+   for(i = 0; i < diff_size; i++)
+   {
+      *buffer++ = (uint8_t) (target[target_at + i] - source[source_at + i]);
+   }
+   memcpy(buffer, target + target_at + diff_size, extra_size);
+   return buffer + extra_size;
+}
+
+/* sends a stream as DAT frames, padded to a multiple of 8 bytes */
+static void test_UPDT_deltaSend (const uint8_t *stream, size_t size, uint8_t flags){
+   uint8_t frame[UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE)];
+   uint8_t sequence = 1;
+   size_t offset;
+   size_t chunk;
+
+   for(offset = 0; offset < size; offset += chunk)
+   {
+      chunk = size - offset < UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE ? size - offset : UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE;
+      memset(frame, 0, sizeof(frame));
+      memcpy(frame + UPDT_PROTOCOL_HEADER_SIZE, stream + offset, chunk);
+      UPDT_protocolSetHeader(frame, UPDT_PROTOCOL_PACKET_DAT, sequence++, (chunk + 7) & ~7u);
+      UPDT_protocolSetFlags(frame, flags);
+      TEST_ASSERT_TRUE (UPDT_protocolSend(&transport, frame, UPDT_PROTOCOL_HEADER_SIZE + ((chunk + 7) & ~7u)) == UPDT_PROTOCOL_ERROR_NONE);
+   }
+}
+
+/* receives every DAT frame on the wire and feeds its payload to a consumer */
+static int32_t test_UPDT_deltaRecv (UPDT_protocolConsumerType consumer, void *context){
+   uint8_t header[UPDT_PROTOCOL_HEADER_SIZE];
+   int32_t ret = UPDT_PROTOCOL_ERROR_NONE;
+
+   while(wire_pos < wire_size && UPDT_PROTOCOL_ERROR_NONE == ret)
+   {
+      TEST_ASSERT_TRUE (UPDT_protocolRecv(&transport, header, sizeof(header)) == UPDT_PROTOCOL_ERROR_NONE);
+      TEST_ASSERT_TRUE (UPDT_protocolGetPacketType(header) == UPDT_PROTOCOL_PACKET_DAT);
+      ret = UPDT_protocolRecvConsume(&transport, UPDT_protocolGetPayloadSize(header), consumer, context);
+   }
+   return ret;
+}
+
+/*==================[external functions definition]==========================*/
+void setUp(void)
+{
+   uint8_t *end;
+   size_t i;
+
+   for(i = 0; i < sizeof(source); i++)
+   {
+      source[i] = (uint8_t) ((i % 40) * 3 + i / 400);
+   }
+   /* bytes inserted, and the code after them relocated */
+   memcpy(target, source, INSERT_AT);
+   for(i = 0; i < INSERT_SIZE; i++)
+   {
+      target[INSERT_AT + i] = (uint8_t) (0xA0 + i);
+   }
+   memcpy(target + INSERT_AT + INSERT_SIZE, source + INSERT_AT, SOURCE_SIZE - INSERT_AT);
+   for(i = INSERT_AT + INSERT_SIZE; i < TARGET_SIZE; i += 64)
+   {
+      target[i] += INSERT_SIZE;
+   }
+
+   end = patch;
+   end = test_UPDT_deltaPut(end, UPDT_DELTA_MAGIC);
+   end = test_UPDT_deltaPut(end, SOURCE_SIZE);
+   end = test_UPDT_deltaPut(end, UPDT_crc32cUpdate(0, source, SOURCE_SIZE));
+   end = test_UPDT_deltaPut(end, TARGET_SIZE);
+   end = test_UPDT_deltaPut(end, UPDT_crc32cUpdate(0, target, TARGET_SIZE));
+   end = test_UPDT_deltaRecord(end, 0, 0, INSERT_AT, INSERT_SIZE);
+   end = test_UPDT_deltaRecord(end, INSERT_AT + INSERT_SIZE, INSERT_AT, SOURCE_SIZE - INSERT_AT, 0);
+   TEST_ASSERT_EQUAL (PATCH_SIZE, end - patch);
+
+   memset(output, 0, sizeof(output));
+   output_size = 0;
+   wire_size = 0;
+   wire_pos = 0;
+   memset(&transport, 0, sizeof(transport));
+   transport.send = test_UPDT_ITransportSendWire;
+   transport.recv = test_UPDT_ITransportRecvWire;
+   UPDT_deltaPatcherInit(&patcher, SOURCE_SIZE, test_UPDT_deltaRead, NULL, test_UPDT_deltaWrite, NULL);
+}
+
+void tearDown(void)
+{
+}
+
+void test_UPDT_deltaLoopback()
+{
+   test_UPDT_deltaSend(patch, sizeof(patch), 0);
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, test_UPDT_deltaRecv(UPDT_deltaPatcherConsume, &patcher));
+   TEST_ASSERT_TRUE (UPDT_deltaPatcherDone(&patcher));
+   TEST_ASSERT_EQUAL (TARGET_SIZE, output_size);
+   TEST_ASSERT_EQUAL_MEMORY (target, output, TARGET_SIZE);
+}
+
+void test_UPDT_deltaCompressedLoopback()
+{
+   size_t size;
+
+   /* the diff bytes are mostly zero */
+   size = UPDT_lzssEncode(patch, sizeof(patch), compressed, sizeof(compressed));
+   TEST_ASSERT_TRUE (0 < size && size < sizeof(patch) / 4);
+   test_UPDT_deltaSend(compressed, size, UPDT_PROTOCOL_FLAG_COMPRESSED);
+
+   UPDT_lzssDecoderInit(&decoder, sizeof(patch), UPDT_deltaPatcherConsume, &patcher);
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, test_UPDT_deltaRecv(UPDT_lzssDecoderConsume, &decoder));
+   TEST_ASSERT_TRUE (UPDT_deltaPatcherDone(&patcher));
+   TEST_ASSERT_EQUAL_MEMORY (target, output, TARGET_SIZE);
+}
+
+void test_UPDT_deltaWrongSource()
+{
+   source[SOURCE_SIZE - 1]++;
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_DENIED, UPDT_deltaPatcherConsume(&patcher, 0, patch, sizeof(patch)));
+   TEST_ASSERT_EQUAL (0, output_size);
+}
+
+void test_UPDT_deltaCorrupted()
+{
+   patch[PATCH_SIZE - 10]++;
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_CRC, UPDT_deltaPatcherConsume(&patcher, 0, patch, sizeof(patch)));
+   TEST_ASSERT_FALSE (UPDT_deltaPatcherDone(&patcher));
+}
+
+void test_UPDT_deltaBadSeek()
+{
+   /* the first record reaches before the start of the source */
+   test_UPDT_deltaPut(patch + UPDT_DELTA_HEADER_SIZE + 8, (uint32_t) -1);
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_PACKET, UPDT_deltaPatcherConsume(&patcher, 0, patch, sizeof(patch)));
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
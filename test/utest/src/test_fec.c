@@ -0,0 +1,263 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief this file implements the unit tests for the functions of the file UPDT_fec
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup update Implementation
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include <string.h>
+#include "unity.h"
+#include "UPDT_fec.h"
+
+/*==================[macros and definitions]=================================*/
+#define TEST_DATA          6
+#define TEST_PARITY        3
+#define TEST_BLOCK_SIZE    40
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static uint8_t data[TEST_DATA][TEST_BLOCK_SIZE];
+
+static uint8_t sender_buffer[UPDT_FEC_BUFFER_SIZE(TEST_DATA, TEST_PARITY, TEST_BLOCK_SIZE)];
+
+static uint8_t receiver_buffer[UPDT_FEC_BUFFER_SIZE(TEST_DATA, TEST_PARITY, TEST_BLOCK_SIZE)];
+
+static UPDT_fecType sender;
+
+static UPDT_fecType receiver;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Returns the number of bits set in a mask. */
+static uint8_t test_UPDT_fecBits(uint32_t mask)
+{
+   uint8_t bits = 0;
+
+   for(; 0 != mask; mask &= mask - 1)
+   {
+      bits++;
+   }
+   return bits;
+}
+
+/** \brief Encodes the first count data blocks on the sender. The blocks are
+ ** shorter than the block size and added in two pieces. */
+static void test_UPDT_fecEncodeGroup(uint8_t count)
+{
+   uint8_t i;
+
+   for(i = 0; i < count; i++)
+   {
+      UPDT_fecEncode(&sender, i, 0, data[i], 8);
+      UPDT_fecEncode(&sender, i, 8, data[i] + 8, TEST_BLOCK_SIZE - 8 - i);
+   }
+}
+
+/** \brief Gives the receiver the data blocks not in lost and the parity
+ ** blocks not in dropped, as bit masks. */
+static void test_UPDT_fecReceiveGroup(uint8_t count, uint32_t lost, uint32_t dropped)
+{
+   uint8_t i;
+
+   UPDT_fecInit(&receiver, receiver_buffer, sizeof(receiver_buffer), TEST_DATA, TEST_PARITY,
+      TEST_BLOCK_SIZE);
+   for(i = 0; i < count; i++)
+   {
+      if(0 == (lost & (1u << i)))
+      {
+         memcpy(UPDT_fecBlock(&receiver, i), data[i], TEST_BLOCK_SIZE - i);
+         UPDT_fecAdd(&receiver, i, TEST_BLOCK_SIZE - i);
+      }
+   }
+   for(i = 0; i < TEST_PARITY; i++)
+   {
+      if(0 == (dropped & (1u << i)))
+      {
+         memcpy(UPDT_fecBlock(&receiver, TEST_DATA + i), UPDT_fecBlock(&sender, TEST_DATA + i),
+            TEST_BLOCK_SIZE);
+         UPDT_fecAdd(&receiver, TEST_DATA + i, TEST_BLOCK_SIZE);
+      }
+   }
+}
+
+/*==================[external functions definition]==========================*/
+void setUp(void)
+{
+   uint8_t i;
+   uint8_t j;
+
+   /* the bytes after TEST_BLOCK_SIZE - i are never sent, they are zeros */
+   memset(data, 0, sizeof(data));
+   for(i = 0; i < TEST_DATA; i++)
+   {
+      for(j = 0; j < TEST_BLOCK_SIZE - i; j++)
+      {
+         data[i][j] = (uint8_t) (i * 73 + j * 29 + 5);
+      }
+   }
+   UPDT_fecInit(&sender, sender_buffer, sizeof(sender_buffer), TEST_DATA, TEST_PARITY,
+      TEST_BLOCK_SIZE);
+}
+
+void tearDown(void)
+{
+}
+
+void test_UPDT_fecInit()
+{
+   TEST_ASSERT_EQUAL_INT32 (0, UPDT_fecInit(&receiver, receiver_buffer, sizeof(receiver_buffer),
+      TEST_DATA, TEST_PARITY, TEST_BLOCK_SIZE));
+   TEST_ASSERT_EQUAL_UINT32 (0, receiver.present);
+   TEST_ASSERT_EQUAL_INT32 (-1, UPDT_fecInit(&receiver, receiver_buffer, sizeof(receiver_buffer) - 1,
+      TEST_DATA, TEST_PARITY, TEST_BLOCK_SIZE));
+   TEST_ASSERT_EQUAL_INT32 (-1, UPDT_fecInit(&receiver, receiver_buffer, sizeof(receiver_buffer),
+      UPDT_FEC_DATA_MAX + 1, 1, 8));
+   TEST_ASSERT_EQUAL_INT32 (-1, UPDT_fecInit(&receiver, receiver_buffer, sizeof(receiver_buffer),
+      TEST_DATA, 0, TEST_BLOCK_SIZE));
+   TEST_ASSERT_EQUAL_INT32 (-1, UPDT_fecInit(&receiver, receiver_buffer, sizeof(receiver_buffer),
+      TEST_DATA, UPDT_FEC_PARITY_MAX + 1, 8));
+}
+
+void test_UPDT_fecFirstParityIsXor()
+{
+   uint8_t expected[TEST_BLOCK_SIZE] = {0};
+   uint8_t i;
+   uint8_t j;
+
+   test_UPDT_fecEncodeGroup(TEST_DATA);
+   for(i = 0; i < TEST_DATA; i++)
+   {
+      for(j = 0; j < TEST_BLOCK_SIZE; j++)
+      {
+         expected[j] ^= data[i][j];
+      }
+   }
+   TEST_ASSERT_EQUAL_MEMORY (expected, UPDT_fecBlock(&sender, TEST_DATA), TEST_BLOCK_SIZE);
+   TEST_ASSERT_EQUAL_UINT8 (0, UPDT_fecMissing(&sender, TEST_DATA));
+}
+
+void test_UPDT_fecRebuildOne()
+{
+   test_UPDT_fecEncodeGroup(TEST_DATA);
+   /* only the xor parity block arrives */
+   test_UPDT_fecReceiveGroup(TEST_DATA, 1u << 4, 6);
+   TEST_ASSERT_EQUAL_UINT8 (1, UPDT_fecMissing(&receiver, TEST_DATA));
+   TEST_ASSERT_EQUAL_UINT8 (1, UPDT_fecParity(&receiver));
+   TEST_ASSERT_EQUAL_INT32 (0, UPDT_fecDecode(&receiver, TEST_DATA));
+   TEST_ASSERT_EQUAL_MEMORY (data[4], UPDT_fecBlock(&receiver, 4), TEST_BLOCK_SIZE);
+   /* the parity block used is consumed */
+   TEST_ASSERT_EQUAL_UINT8 (0, UPDT_fecParity(&receiver));
+}
+
+void test_UPDT_fecRebuildMany()
+{
+   uint32_t lost;
+   uint32_t dropped;
+   uint8_t count;
+   uint8_t i;
+
+   test_UPDT_fecEncodeGroup(TEST_DATA);
+   /* every pattern of up to TEST_PARITY losses, with as many parity blocks */
+   for(lost = 1; lost < (1u << TEST_DATA); lost++)
+   {
+      count = test_UPDT_fecBits(lost);
+      if(count > TEST_PARITY)
+      {
+         continue;
+      }
+      /* the first parity blocks arrive, the others are dropped */
+      dropped = ((1u << (TEST_PARITY - count)) - 1) << count;
+      test_UPDT_fecReceiveGroup(TEST_DATA, lost, dropped);
+      TEST_ASSERT_EQUAL_INT32 (0, UPDT_fecDecode(&receiver, TEST_DATA));
+      for(i = 0; i < TEST_DATA; i++)
+      {
+         TEST_ASSERT_EQUAL_MEMORY (data[i], UPDT_fecBlock(&receiver, i), TEST_BLOCK_SIZE);
+      }
+   }
+}
+
+void test_UPDT_fecShortGroup()
+{
+   /* the sender closed the group after 2 data blocks */
+   test_UPDT_fecEncodeGroup(2);
+   test_UPDT_fecReceiveGroup(2, 3, 0);
+   TEST_ASSERT_EQUAL_UINT8 (2, UPDT_fecMissing(&receiver, 2));
+   TEST_ASSERT_EQUAL_INT32 (0, UPDT_fecDecode(&receiver, 2));
+   TEST_ASSERT_EQUAL_MEMORY (data[0], UPDT_fecBlock(&receiver, 0), TEST_BLOCK_SIZE);
+   TEST_ASSERT_EQUAL_MEMORY (data[1], UPDT_fecBlock(&receiver, 1), TEST_BLOCK_SIZE);
+}
+
+void test_UPDT_fecTooManyLost()
+{
+   test_UPDT_fecEncodeGroup(TEST_DATA);
+   test_UPDT_fecReceiveGroup(TEST_DATA, 0x0B, 1);
+   TEST_ASSERT_EQUAL_INT32 (-1, UPDT_fecDecode(&receiver, TEST_DATA));
+   TEST_ASSERT_EQUAL_UINT8 (3, UPDT_fecMissing(&receiver, TEST_DATA));
+}
+
+void test_UPDT_fecReset()
+{
+   test_UPDT_fecEncodeGroup(TEST_DATA);
+   UPDT_fecReset(&sender);
+   TEST_ASSERT_EQUAL_UINT8 (TEST_DATA, UPDT_fecMissing(&sender, TEST_DATA));
+   TEST_ASSERT_EQUAL_UINT8 (0, UPDT_fecBlock(&sender, TEST_DATA)[0]);
+   TEST_ASSERT_EQUAL_UINT8 (0, UPDT_fecBlock(&sender, TEST_DATA + TEST_PARITY - 1)[TEST_BLOCK_SIZE - 1]);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
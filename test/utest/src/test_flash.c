@@ -0,0 +1,391 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief this file implements the unit tests for the functions of the file UPDT_flash
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup update Implementation
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.4  AG  check the statistics reported by the skip mode
+ * 20261017 v0.0.3  AG  add the test of a session writing to the sink
+ * 20261017 v0.0.2  AG  add skip mode test
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "UPDT_flash.h"
+#include <string.h>
+
+/*==================[macros and definitions]=================================*/
+#define SECTOR_SIZE     1024
+#define PAGE_SIZE       256
+#define FLASH_SIZE      (8 * SECTOR_SIZE)
+#define IMAGE_SIZE      3000
+#define PAYLOAD_SIZE    UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE
+#define FRAMES          10
+#define WINDOW_SIZE     4
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static uint8_t memory[FLASH_SIZE];
+/* non-zero for every byte programmed since its sector was erased */
+static uint8_t programmed[FLASH_SIZE];
+static uint8_t erased[FLASH_SIZE / SECTOR_SIZE];
+static uint32_t erases;
+static uint32_t programs;
+static uint32_t fail_at;
+static uint8_t image[IMAGE_SIZE];
+static uint8_t buffers[2 * PAGE_SIZE];
+static uint8_t scratch[SECTOR_SIZE];
+static UPDT_flashSinkType sink;
+/* frames received by the session */
+static uint8_t wire[2 * FRAMES * UPDT_PROTOCOL_FRAME_SIZE(PAYLOAD_SIZE)];
+static size_t wire_size;
+static size_t wire_pos;
+static uint8_t acked[2 * FRAMES];
+static size_t acks;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static int32_t test_UPDT_IFlashErase (UPDT_IFlashType* flash, uint32_t address, size_t size){
+   TEST_ASSERT_EQUAL (0, address % SECTOR_SIZE);
+   TEST_ASSERT_EQUAL (SECTOR_SIZE, size);
+   memset(memory + address, 0xFF, size);
+   memset(programmed + address, 0, size);
+   erased[address / SECTOR_SIZE] = 1;
+   erases++;
+   return 0;
+}
+
+static int32_t test_UPDT_IFlashProgram (UPDT_IFlashType* flash, uint32_t address, const void* data, size_t size){
+   size_t i;
+
+   if(++programs == fail_at)
+   {
+      return -1;
+   }
+   /* inside one page, erased and programmed once */
+   TEST_ASSERT_EQUAL (address / PAGE_SIZE, (address + size - 1) / PAGE_SIZE);
+   for(i = 0; i < size; i++)
+   {
+      TEST_ASSERT_TRUE (erased[(address + i) / SECTOR_SIZE]);
+      TEST_ASSERT_FALSE (programmed[address + i]);
+      programmed[address + i] = 1;
+   }
+   memcpy(memory + address, data, size);
+   return 0;
+}
+
+static int32_t test_UPDT_IFlashRead (UPDT_IFlashType* flash, uint32_t address, void* data, size_t size){
+   memcpy(data, memory + address, size);
+   return 0;
+}
+
+static ssize_t test_UPDT_ITransportRecv (UPDT_ITransportType* transport, void* data, size_t size){
+   /* the payloads arrive in pieces */
+   if(size > 100)
+   {
+      size = 100;
+   }
+   if(size > wire_size - wire_pos)
+   {
+      size = wire_size - wire_pos;
+   }
+   memcpy(data, wire + wire_pos, size);
+   wire_pos += size;
+   return size;
+}
+
+static ssize_t test_UPDT_ITransportSendWire (UPDT_ITransportType* transport, const void* data, size_t size){
+   TEST_ASSERT_TRUE (wire_size + size <= sizeof(wire));
+   memcpy(wire + wire_size, data, size);
+   wire_size += size;
+   return size;
+}
+
+static ssize_t test_UPDT_ITransportSendAck (UPDT_ITransportType* transport, const void* data, size_t size){
+   const uint8_t *header = (const uint8_t *) data;
+   uint8_t sequence_number;
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_PACKET_ACK, UPDT_protocolGetPacketType(header));
+   sequence_number = UPDT_protocolGetSequenceNumber(header);
+   TEST_ASSERT_TRUE (acks < sizeof(acked));
+   acked[acks++] = sequence_number;
+   /* nothing is acknowledged before it is programmed, 0xFF is the
+    * acknowledgement before the first frame */
+   if(0xFF != sequence_number)
+   {
+      TEST_ASSERT_EQUAL_MEMORY (image, memory + SECTOR_SIZE, (sequence_number + 1) * PAYLOAD_SIZE);
+   }
+   return size;
+}
+
+static UPDT_IFlashType flash =
+{
+   test_UPDT_IFlashErase,
+   test_UPDT_IFlashProgram,
+   test_UPDT_IFlashRead,
+   SECTOR_SIZE,
+   PAGE_SIZE
+};
+
+/*==================[external functions definition]==========================*/
+void setUp(void)
+{
+   size_t i;
+
+   for(i = 0; i < sizeof(image); i++)
+   {
+      image[i] = (uint8_t) (i * 7 + i / 100);
+   }
+   memset(memory, 0, sizeof(memory));
+   memset(programmed, 0, sizeof(programmed));
+   memset(erased, 0, sizeof(erased));
+   erases = 0;
+   programs = 0;
+   fail_at = 0;
+   UPDT_flashSinkInit(&sink, &flash, buffers, 2, SECTOR_SIZE);
+}
+
+void tearDown(void)
+{
+}
+
+void test_UPDT_flashSinkWrite()
+{
+   size_t offset;
+   size_t size;
+
+   /* DAT payloads do not line up with the pages */
+   for(offset = 0; offset < IMAGE_SIZE; offset += size)
+   {
+      size = IMAGE_SIZE - offset < 224 ? IMAGE_SIZE - offset : 224;
+      TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkConsume(&sink, 0, image + offset, size));
+      TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkCommit(&sink, 0));
+   }
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkClose(&sink));
+
+   TEST_ASSERT_EQUAL_MEMORY (image, memory + SECTOR_SIZE, IMAGE_SIZE);
+   TEST_ASSERT_FALSE (erased[0]);
+   TEST_ASSERT_EQUAL (3, erases);
+   TEST_ASSERT_EQUAL ((IMAGE_SIZE + PAGE_SIZE - 1) / PAGE_SIZE, programs);
+   TEST_ASSERT_EQUAL (IMAGE_SIZE, sink.durable);
+}
+
+void test_UPDT_flashSinkDurable()
+{
+   uint8_t tag = 0;
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkConsume(&sink, 0, image, 224));
+   UPDT_flashSinkCommit(&sink, 1);
+   /* still in a buffer */
+   TEST_ASSERT_FALSE (UPDT_flashSinkDurable(&sink, &tag));
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkConsume(&sink, 0, image + 224, 224));
+   UPDT_flashSinkCommit(&sink, 2);
+   /* the first page is programmed, it holds all of the first frame */
+   TEST_ASSERT_TRUE (UPDT_flashSinkDurable(&sink, &tag));
+   TEST_ASSERT_EQUAL (1, tag);
+
+   /* a flush programs the partial page, the rest goes later */
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkFlush(&sink));
+   TEST_ASSERT_TRUE (UPDT_flashSinkDurable(&sink, &tag));
+   TEST_ASSERT_EQUAL (2, tag);
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkConsume(&sink, 0, image + 448, 224));
+   UPDT_flashSinkCommit(&sink, 3);
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkClose(&sink));
+   TEST_ASSERT_EQUAL_MEMORY (image, memory + SECTOR_SIZE, 672);
+   TEST_ASSERT_EQUAL (4, programs);
+}
+
+void test_UPDT_flashSinkError()
+{
+   fail_at = 2;
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkConsume(&sink, 0, image, PAGE_SIZE));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkCommit(&sink, 1));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkConsume(&sink, 0, image, PAGE_SIZE));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_FLASH, UPDT_flashSinkCommit(&sink, 2));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_FLASH, UPDT_flashSinkClose(&sink));
+   TEST_ASSERT_EQUAL (PAGE_SIZE, sink.durable);
+}
+
+void test_UPDT_flashSinkSkip()
+{
+   UPDT_protocolStatsType stats;
+   size_t offset;
+   size_t size;
+
+   /* the installed image differs in the second page of its second sector */
+   memset(erased, 1, sizeof(erased));
+   memset(programmed + SECTOR_SIZE, 1, IMAGE_SIZE);
+   memcpy(memory + SECTOR_SIZE, image, IMAGE_SIZE);
+   image[SECTOR_SIZE + PAGE_SIZE + 10] ^= 0x5A;
+
+   UPDT_flashSinkSetSkip(&sink, scratch);
+   for(offset = 0; offset < IMAGE_SIZE; offset += size)
+   {
+      size = IMAGE_SIZE - offset < 224 ? IMAGE_SIZE - offset : 224;
+      TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkConsume(&sink, 0, image + offset, size));
+      TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkCommit(&sink, 0));
+   }
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkClose(&sink));
+
+   TEST_ASSERT_EQUAL_MEMORY (image, memory + SECTOR_SIZE, IMAGE_SIZE);
+   /* the first page of the sector is programmed back after the erase */
+   TEST_ASSERT_EQUAL (1, erases);
+   TEST_ASSERT_EQUAL (4, programs);
+   TEST_ASSERT_EQUAL (1, sink.stats.erases);
+   TEST_ASSERT_EQUAL (4, sink.stats.programs);
+   TEST_ASSERT_EQUAL (2, sink.stats.erases_saved);
+   TEST_ASSERT_EQUAL (8, sink.stats.programs_saved);
+
+   /* reported to the master with the session statistics */
+   memset(&stats, 0, sizeof(stats));
+   UPDT_flashSinkGetStats(&sink, &stats);
+   TEST_ASSERT_EQUAL (1, stats.erases);
+   TEST_ASSERT_EQUAL (4, stats.programs);
+   TEST_ASSERT_EQUAL (2, stats.erases_saved);
+   TEST_ASSERT_EQUAL (8, stats.programs_saved);
+}
+
+void test_UPDT_flashSinkRetry()
+{
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkConsume(&sink, 0, image, 200));
+   UPDT_flashSinkCommit(&sink, 1);
+   /* a payload crossing into the next page fails its CRC check after
+    * reaching the end of the page */
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkConsume(&sink, 0, image + 1000, 100));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkConsume(&sink, 100, image + 1100, 124));
+   TEST_ASSERT_EQUAL (0, programs);
+   /* the retransmission replaces it */
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkConsume(&sink, 0, image + 200, 150));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkConsume(&sink, 150, image + 350, 74));
+   UPDT_flashSinkCommit(&sink, 2);
+   TEST_ASSERT_EQUAL (1, programs);
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkClose(&sink));
+
+   TEST_ASSERT_EQUAL (424, sink.durable);
+   TEST_ASSERT_EQUAL_MEMORY (image, memory + SECTOR_SIZE, 424);
+   TEST_ASSERT_EQUAL (2, programs);
+}
+
+void test_UPDT_flashSinkSession()
+{
+   UPDT_ITransportType transport;
+   UPDT_protocolSessionType session;
+   UPDT_protocolStatsType stats;
+   uint8_t header[UPDT_PROTOCOL_HEADER_SIZE];
+   uint8_t sequence_number;
+   size_t frame_size = UPDT_PROTOCOL_FRAME_SIZE(PAYLOAD_SIZE);
+   size_t i;
+
+   memset(&transport, 0, sizeof(transport));
+   transport.recv = test_UPDT_ITransportRecv;
+   transport.send = test_UPDT_ITransportSendWire;
+   wire_size = 0;
+   wire_pos = 0;
+   acks = 0;
+   memset(header, 0, sizeof(header));
+   for(i = 0; i < FRAMES; i++)
+   {
+      UPDT_protocolSetHeader(header, UPDT_PROTOCOL_PACKET_DAT, (uint8_t) i, PAYLOAD_SIZE);
+      UPDT_protocolSetFlags(header, UPDT_PROTOCOL_FLAG_CRC);
+      if(3 == i)
+      {
+         /* frame 3 is corrupted in the middle of its payload and sent
+          * again */
+         TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_protocolSendFrame(&transport, header,
+            image + i * PAYLOAD_SIZE));
+         wire[wire_size - frame_size + UPDT_PROTOCOL_HEADER_SIZE + PAYLOAD_SIZE / 2] ^= 0x10;
+      }
+      TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_protocolSendFrame(&transport, header,
+         image + i * PAYLOAD_SIZE));
+   }
+
+   /* the slave acknowledges the frames once they are programmed */
+   transport.send = test_UPDT_ITransportSendAck;
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_protocolSessionInit(&session, &transport, NULL,
+      frame_size, WINDOW_SIZE, 0));
+   UPDT_protocolSessionSetStats(&session, &stats);
+   UPDT_protocolSessionSetDeferredAck(&session, 1);
+   for(i = 0; i < FRAMES; i++)
+   {
+      TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_protocolSessionRecvConsume(&session, header,
+         PAYLOAD_SIZE, UPDT_flashSinkConsume, &sink));
+      TEST_ASSERT_EQUAL (i, UPDT_protocolGetSequenceNumber(header));
+      TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkCommit(&sink,
+         UPDT_protocolGetSequenceNumber(header)));
+      if(UPDT_protocolSessionUnacked(&session) >= WINDOW_SIZE)
+      {
+         TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkFlush(&sink));
+      }
+      if(UPDT_flashSinkDurable(&sink, &sequence_number))
+      {
+         TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_protocolSessionAck(&session, sequence_number));
+      }
+   }
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_flashSinkClose(&sink));
+   TEST_ASSERT_TRUE (UPDT_flashSinkDurable(&sink, &sequence_number));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_protocolSessionAck(&session, sequence_number));
+
+   TEST_ASSERT_EQUAL (wire_size, wire_pos);
+   TEST_ASSERT_EQUAL (1, stats.corrupted);
+   /* the flash mock fails a byte programmed twice */
+   TEST_ASSERT_EQUAL_MEMORY (image, memory + SECTOR_SIZE, FRAMES * PAYLOAD_SIZE);
+   TEST_ASSERT_EQUAL (FRAMES - 1, acked[acks - 1]);
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
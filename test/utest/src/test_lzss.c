@@ -0,0 +1,186 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief this file implements the unit tests for the functions of the file UPDT_lzss
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup update Implementation
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "UPDT_lzss.h"
+#include <string.h>
+
+/*==================[macros and definitions]=================================*/
+#define DATA_SIZE    3000
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static uint8_t data[DATA_SIZE];
+static uint8_t compressed[UPDT_LZSS_BOUND(DATA_SIZE)];
+static uint8_t output[DATA_SIZE + 64];
+static size_t output_size;
+static UPDT_lzssDecoderType decoder;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static int32_t sink(void *context, size_t offset, const uint8_t *piece, size_t size)
+{
+   (void) context;
+   TEST_ASSERT_EQUAL (output_size, offset);
+   TEST_ASSERT_TRUE (output_size + size <= sizeof(output));
+   memcpy(output + output_size, piece, size);
+   output_size += size;
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/*==================[external functions definition]==========================*/
+void setUp(void)
+{
+   size_t i;
+
+   /* code like data: repeated words with some noise and a run of padding */
+   for(i = 0; i < sizeof(data); i++)
+   {
+      data[i] = (uint8_t) ((i % 24) * 7 + (0 == i % 97 ? i / 97 : 0));
+   }
+   memset(data + 2000, 0xFF, 300);
+   memset(output, 0, sizeof(output));
+   output_size = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test_UPDT_lzssRoundTrip()
+{
+   size_t size;
+
+   size = UPDT_lzssEncode(data, sizeof(data), compressed, sizeof(compressed));
+   TEST_ASSERT_TRUE (0 < size && size < sizeof(data) / 2);
+
+   UPDT_lzssDecoderInit(&decoder, sizeof(data), sink, NULL);
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_lzssDecoderConsume(&decoder, 0, compressed, size));
+   TEST_ASSERT_TRUE (UPDT_lzssDecoderDone(&decoder));
+   TEST_ASSERT_EQUAL (sizeof(data), output_size);
+   TEST_ASSERT_EQUAL_MEMORY (data, output, sizeof(data));
+}
+
+void test_UPDT_lzssFragmented()
+{
+   size_t size;
+   size_t i;
+
+   size = UPDT_lzssEncode(data, sizeof(data), compressed, sizeof(compressed));
+
+   /* one byte at a time cuts every match token in half */
+   UPDT_lzssDecoderInit(&decoder, sizeof(data), sink, NULL);
+   for(i = 0; i < size; i++)
+   {
+      TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_lzssDecoderConsume(&decoder, i, compressed + i, 1));
+   }
+   TEST_ASSERT_EQUAL (sizeof(data), output_size);
+   TEST_ASSERT_EQUAL_MEMORY (data, output, sizeof(data));
+}
+
+void test_UPDT_lzssPadding()
+{
+   size_t size;
+
+   size = UPDT_lzssEncode(data, 1000, compressed, sizeof(compressed));
+   /* the last frame is padded to a multiple of 8 bytes */
+   memset(compressed + size, 0, 8);
+
+   UPDT_lzssDecoderInit(&decoder, 1000, sink, NULL);
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_lzssDecoderConsume(&decoder, 0, compressed, size + 8));
+   TEST_ASSERT_EQUAL (1000, output_size);
+   TEST_ASSERT_EQUAL_MEMORY (data, output, 1000);
+}
+
+void test_UPDT_lzssIncompressible()
+{
+   uint32_t random = 1;
+   size_t size;
+   size_t i;
+
+   for(i = 0; i < sizeof(data); i++)
+   {
+      random ^= random << 13;
+      random ^= random >> 17;
+      random ^= random << 5;
+      data[i] = (uint8_t) random;
+   }
+   TEST_ASSERT_EQUAL (0, UPDT_lzssEncode(data, sizeof(data), compressed, 100));
+   size = UPDT_lzssEncode(data, sizeof(data), compressed, sizeof(compressed));
+   TEST_ASSERT_TRUE (sizeof(data) < size && size <= UPDT_LZSS_BOUND(sizeof(data)));
+
+   UPDT_lzssDecoderInit(&decoder, sizeof(data), sink, NULL);
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_lzssDecoderConsume(&decoder, 0, compressed, size));
+   TEST_ASSERT_EQUAL_MEMORY (data, output, sizeof(data));
+}
+
+void test_UPDT_lzssBadDistance()
+{
+   /* a literal followed by a match two bytes back */
+   static const uint8_t stream[] = { 0x01, 'a', 0x00, 0x40 };
+
+   UPDT_lzssDecoderInit(&decoder, 10, sink, NULL);
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_PACKET, UPDT_lzssDecoderConsume(&decoder, 0, stream, sizeof(stream)));
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,269 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/** \brief this file implements the unit tests for the functions of the file UPDT_packer
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup update Implementation
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "UPDT_packer.h"
+#include <string.h>
+
+/*==================[macros and definitions]=================================*/
+#define PAGE_SIZE    16
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static UPDT_packerType packer;
+static UPDT_packerSegmentType segments[4];
+static uint8_t buffer[64];
+static uint8_t stream[256];
+
+/* two runs, the second one first, and an Intel HEX example record */
+static const char s19[] =
+   "S00600004844521B\r\n"
+   "S1070024AABBCCDDC6\r\n"
+   "S1130000285F245F2212226A000424290008237C2A\r\n"
+   "S1050010010ADF\r\n"
+   "S9030000FC\r\n";
+static const char ihex[] =
+   ":020000040001F9\n"
+   ":10010000214601360121470136007EFE09D2190140\n"
+   ":040110001122334441\n"
+   ":00000001FF\n";
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Reads the whole stream in payloads of size bytes. */
+static uint32_t read_stream(size_t size)
+{
+   const uint8_t *payload;
+   uint32_t total = 0;
+   int32_t count;
+
+   while(0 < (count = UPDT_packerGet(&packer, buffer, size, &payload)))
+   {
+      TEST_ASSERT_TRUE (total + count <= sizeof(stream));
+      memcpy(stream + total, payload, count);
+      total += count;
+   }
+   return total;
+}
+
+/** \brief Writes a 32 bit little endian field. */
+static void put32(uint8_t *field, uint32_t value)
+{
+   field[0] = value;
+   field[1] = value >> 8;
+   field[2] = value >> 16;
+   field[3] = value >> 24;
+}
+
+/*==================[external functions definition]==========================*/
+void setUp(void)
+{
+   memset(stream, 0, sizeof(stream));
+}
+
+void tearDown(void)
+{
+}
+
+void test_UPDT_packerDetect()
+{
+   static const uint8_t elf[16] = { 0x7F, 'E', 'L', 'F', 1, 1, 1 };
+
+   TEST_ASSERT_EQUAL (UPDT_PACKER_FORMAT_ELF, UPDT_packerDetect(elf, sizeof(elf)));
+   TEST_ASSERT_EQUAL (UPDT_PACKER_FORMAT_S19, UPDT_packerDetect((const uint8_t *) s19, sizeof(s19) - 1));
+   TEST_ASSERT_EQUAL (UPDT_PACKER_FORMAT_IHEX, UPDT_packerDetect((const uint8_t *) ihex, sizeof(ihex) - 1));
+   TEST_ASSERT_EQUAL (UPDT_PACKER_FORMAT_RAW, UPDT_packerDetect(elf + 1, sizeof(elf) - 1));
+}
+
+void test_UPDT_packerRaw()
+{
+   static uint8_t image[40];
+   const uint8_t *payload;
+   size_t i;
+
+   for(i = 0; i < sizeof(image); i++)
+   {
+      image[i] = (uint8_t) i;
+   }
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_packerInit(&packer, image, sizeof(image),
+      UPDT_PACKER_FORMAT_AUTO, 0x1004, PAGE_SIZE, segments, 4));
+   TEST_ASSERT_EQUAL (0x1000, UPDT_packerGetAddress(&packer));
+   TEST_ASSERT_EQUAL (48, UPDT_packerGetSize(&packer));
+
+   /* the first payload crosses the padding, the second one is in the image */
+   TEST_ASSERT_EQUAL (16, UPDT_packerGet(&packer, buffer, 16, &payload));
+   TEST_ASSERT_TRUE (buffer == payload);
+   TEST_ASSERT_EQUAL_HEX8 (UPDT_PACKER_FILL, payload[3]);
+   TEST_ASSERT_EQUAL_MEMORY (image, payload + 4, 12);
+   TEST_ASSERT_EQUAL (16, UPDT_packerGet(&packer, buffer, 16, &payload));
+   TEST_ASSERT_TRUE (image + 12 == payload);
+   TEST_ASSERT_EQUAL (16, UPDT_packerGet(&packer, buffer, 32, &payload));
+   TEST_ASSERT_EQUAL_MEMORY (image + 28, payload, 12);
+   TEST_ASSERT_EQUAL_HEX8 (UPDT_PACKER_FILL, payload[15]);
+   TEST_ASSERT_EQUAL (0, UPDT_packerGet(&packer, buffer, 16, &payload));
+}
+
+void test_UPDT_packerS19()
+{
+   static const uint8_t first[] = { 0x28, 0x5F, 0x24, 0x5F, 0x22, 0x12, 0x22, 0x6A,
+      0x00, 0x04, 0x24, 0x29, 0x00, 0x08, 0x23, 0x7C, 0x01, 0x0A };
+   static const uint8_t second[] = { 0xAA, 0xBB, 0xCC, 0xDD };
+   size_t i;
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_packerInit(&packer, (const uint8_t *) s19,
+      sizeof(s19) - 1, UPDT_PACKER_FORMAT_AUTO, 0, PAGE_SIZE, segments, 4));
+   TEST_ASSERT_EQUAL (2, packer.count);
+   TEST_ASSERT_EQUAL (0, UPDT_packerGetAddress(&packer));
+   TEST_ASSERT_EQUAL (48, UPDT_packerGetSize(&packer));
+
+   /* odd payload sizes cut the records anywhere */
+   for(i = 1; i <= 17; i += 8)
+   {
+      UPDT_packerSeek(&packer, 0);
+      TEST_ASSERT_EQUAL (48, read_stream(i));
+      TEST_ASSERT_EQUAL_MEMORY (first, stream, sizeof(first));
+      TEST_ASSERT_EQUAL_HEX8 (UPDT_PACKER_FILL, stream[sizeof(first)]);
+      TEST_ASSERT_EQUAL_HEX8 (UPDT_PACKER_FILL, stream[0x23]);
+      TEST_ASSERT_EQUAL_MEMORY (second, stream + 0x24, sizeof(second));
+      TEST_ASSERT_EQUAL_HEX8 (UPDT_PACKER_FILL, stream[0x28]);
+   }
+
+   /* seeking into a record */
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_packerSeek(&packer, 5));
+   TEST_ASSERT_EQUAL (43, read_stream(7));
+   TEST_ASSERT_EQUAL_MEMORY (first + 5, stream, sizeof(first) - 5);
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_PACKET, UPDT_packerSeek(&packer, 49));
+}
+
+void test_UPDT_packerIhex()
+{
+   static const uint8_t first[] = { 0x21, 0x46, 0x01, 0x36, 0x01, 0x21, 0x47, 0x01,
+      0x36, 0x00, 0x7E, 0xFE, 0x09, 0xD2, 0x19, 0x01, 0x11, 0x22, 0x33, 0x44 };
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_packerInit(&packer, (const uint8_t *) ihex,
+      sizeof(ihex) - 1, UPDT_PACKER_FORMAT_AUTO, 0, PAGE_SIZE, segments, 4));
+   TEST_ASSERT_EQUAL (1, packer.count);
+   TEST_ASSERT_EQUAL (0x10100, UPDT_packerGetAddress(&packer));
+   TEST_ASSERT_EQUAL (32, UPDT_packerGetSize(&packer));
+   TEST_ASSERT_EQUAL (32, read_stream(24));
+   TEST_ASSERT_EQUAL_MEMORY (first, stream, sizeof(first));
+   TEST_ASSERT_EQUAL_HEX8 (UPDT_PACKER_FILL, stream[31]);
+}
+
+void test_UPDT_packerElf()
+{
+   static uint8_t elf[52 + 3 * 32 + 24];
+   uint8_t *header = elf + 52;
+   const uint8_t *payload;
+   size_t i;
+
+   /* two loadable segments with a gap and a note between them */
+   memset(elf, 0, sizeof(elf));
+   memcpy(elf, "\177ELF\1\1\1", 7);
+   put32(elf + 28, 52);
+   elf[42] = 32;
+   elf[44] = 3;
+   for(i = 0; i < 3; i++, header += 32)
+   {
+      put32(header, 1 == i ? 4 : 1);
+      put32(header + 4, 148 + 8 * i);
+      put32(header + 12, 0x2000 + 24 * i);
+      put32(header + 16, 8);
+      put32(header + 20, 2 == i ? 64 : 8);
+   }
+   for(i = 148; i < sizeof(elf); i++)
+   {
+      elf[i] = (uint8_t) i;
+   }
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_packerInit(&packer, elf, sizeof(elf),
+      UPDT_PACKER_FORMAT_ELF, 0, 8, segments, 4));
+   TEST_ASSERT_EQUAL (2, packer.count);
+   TEST_ASSERT_EQUAL (0x2000, UPDT_packerGetAddress(&packer));
+   TEST_ASSERT_EQUAL (56, UPDT_packerGetSize(&packer));
+   TEST_ASSERT_EQUAL (8, UPDT_packerGet(&packer, buffer, 8, &payload));
+   TEST_ASSERT_TRUE (elf + 148 == payload);
+   TEST_ASSERT_EQUAL (48, read_stream(16));
+   TEST_ASSERT_EQUAL_HEX8 (UPDT_PACKER_FILL, stream[0]);
+   TEST_ASSERT_EQUAL_HEX8 (UPDT_PACKER_FILL, stream[39]);
+   TEST_ASSERT_EQUAL_MEMORY (elf + 164, stream + 40, 8);
+}
+
+void test_UPDT_packerErrors()
+{
+   static const char crc[] = "S1050010010ADE\n";
+   static const char overlap[] = "S1050010010ADF\nS1050011010ADE\n";
+   static const char short_record[] = "S1050010010A\n";
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_CRC, UPDT_packerInit(&packer, (const uint8_t *) crc,
+      sizeof(crc) - 1, UPDT_PACKER_FORMAT_AUTO, 0, PAGE_SIZE, segments, 4));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_PACKET, UPDT_packerInit(&packer, (const uint8_t *) overlap,
+      sizeof(overlap) - 1, UPDT_PACKER_FORMAT_AUTO, 0, PAGE_SIZE, segments, 4));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_PACKET, UPDT_packerInit(&packer, (const uint8_t *) short_record,
+      sizeof(short_record) - 1, UPDT_PACKER_FORMAT_AUTO, 0, PAGE_SIZE, segments, 4));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_PACKET, UPDT_packerInit(&packer, (const uint8_t *) s19,
+      sizeof(s19) - 1, UPDT_PACKER_FORMAT_AUTO, 0, PAGE_SIZE, segments, 1));
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -3,6 +3,7 @@
  * Copyright 2015, Matias Giori
  * Copyright 2015, Franco Salinas
  * Copyright 2015, Pablo Alcorta
+ * Copyright 2026, agent
  *
  * This file is part of CIAA Firmware.
  *
@@ -50,18 +51,22 @@
  * MG           Matias Giori
  * FS           Franco Salinas
  * PA           Pablo Alcorta
+ * AG           agent
  */
 
 /*
  * modification history (new versions first)
  * -----------------------------------------------------------
+ * 20261017 v0.0.2  AG  test the sessions, the framing and the transport entries
  * 20151124 v0.0.1  PA  first initial version
  */
 
 /*==================[inclusions]=============================================*/
+#include <string.h>
 #include "unity.h"
 #include "protocol.h"
 #include "UPDT_ITransport.h"
+#include "UPDT_time.h"
 
 /*==================[macros and definitions]=================================*/
 
@@ -81,9 +86,187 @@ const uint8_t header[10];
 
 UPDT_ITransportType transport;
 
+UPDT_protocolSessionType session;
+
+uint8_t frames[2][UPDT_PROTOCOL_PACKET_MAX_SIZE];
+
+uint32_t send_calls;
+
+uint8_t source[256];
+
+size_t source_pos;
+
+uint8_t sink[64];
+
+size_t source_size;
+
+int32_t stream_errors[4];
+
+uint32_t stream_frames;
+
+uint32_t fake_time;
+
+uint8_t wire[512];
+
+uint32_t acks;
+
+size_t wire_size;
+
+size_t burst;
+
+uint32_t burst_time;
+
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+static ssize_t test_UPDT_ITransportSendCount (UPDT_ITransportType* transport, const void* data, size_t size){
+   send_calls++;
+   return size;
+}
+
+static ssize_t test_UPDT_ITransportRecvAck (UPDT_ITransportType* transport, void* data, size_t size){
+   /* acknowledges every frame sent so far */
+   ((uint8_t *) data)[0] = 0;
+   UPDT_protocolSetHeader(data, UPDT_PROTOCOL_PACKET_ACK, session.next - 1, 0);
+   return size;
+}
+
+static ssize_t test_UPDT_ITransportRecvSource (UPDT_ITransportType* transport, void* data, size_t size){
+   /* short reads, like a serial driver */
+   if(size > 5)
+   {
+      size = 5;
+   }
+   memcpy(data, source + source_pos, size);
+   source_pos += size;
+   return size;
+}
+
+static ssize_t test_UPDT_ITransportRecvAcquire (UPDT_ITransportType* transport, const void** data, size_t size){
+   /* lends at most 7 bytes at a time, like a wrapping ring buffer */
+   *data = source + source_pos;
+   return size > 7 ? 7 : size;
+}
+
+static void test_UPDT_ITransportRecvRelease (UPDT_ITransportType* transport, size_t size){
+   source_pos += size;
+}
+
+static int32_t test_UPDT_protocolConsumerCopy (void *context, size_t offset, const uint8_t *data, size_t size){
+   memcpy((uint8_t *) context + offset, data, size);
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+static ssize_t test_UPDT_ITransportRecvNonBlocking (UPDT_ITransportType* transport, void* data, size_t size){
+   /* what has arrived so far, nothing once source_size is reached */
+   if(size > source_size - source_pos)
+   {
+      size = source_size - source_pos;
+   }
+   memcpy(data, source + source_pos, size);
+   source_pos += size;
+   return size;
+}
+
+static ssize_t test_UPDT_ITransportSendNonBlocking (UPDT_ITransportType* transport, const void* data, size_t size){
+   /* a transmission FIFO with room for 6 bytes per call */
+   send_calls++;
+   if(send_calls > 2)
+   {
+      return 0;
+   }
+   return size > 6 ? 6 : size;
+}
+
+static int32_t test_UPDT_protocolFrameCallback (void *context, const uint8_t *frame, int32_t error){
+   stream_errors[stream_frames++ & 3] = error;
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+static uint32_t test_UPDT_timeFake (void){
+   return fake_time;
+}
+
+static int32_t test_UPDT_protocolCipherSeal (void *context, const uint8_t *header, uint8_t *payload, uint32_t number){
+   /* scrambles the payload and writes the frame number in the tag */
+   uint16_t size = UPDT_protocolGetPayloadSize(header) - UPDT_PROTOCOL_TAG_SIZE;
+   uint16_t i;
+   for(i = 0; i < size; i++)
+   {
+      payload[i] ^= 0x5A;
+   }
+   memset(payload + size, (uint8_t) number, UPDT_PROTOCOL_TAG_SIZE);
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+static int32_t test_UPDT_protocolCipherOpen (void *context, const uint8_t *header, uint8_t *payload, uint32_t number){
+   uint16_t size = UPDT_protocolGetPayloadSize(header) - UPDT_PROTOCOL_TAG_SIZE;
+   uint16_t i;
+   if(payload[size] != (uint8_t) number)
+   {
+      return UPDT_PROTOCOL_ERROR_DENIED;
+   }
+   for(i = 0; i < size; i++)
+   {
+      payload[i] ^= 0x5A;
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+static ssize_t test_UPDT_ITransportSendWire (UPDT_ITransportType* transport, const void* data, size_t size){
+   /* records what is sent */
+   memcpy(wire + wire_size, data, size);
+   wire_size += size;
+   return size;
+}
+
+static ssize_t test_UPDT_ITransportRecvUntilSilent (UPDT_ITransportType* transport, void* data, size_t size, uint32_t deadline){
+   /* nothing arrives, the time goes by until the deadline */
+   fake_time = deadline;
+   return 0;
+}
+
+static ssize_t test_UPDT_ITransportRecvUntilRepeatedAck (UPDT_ITransportType* transport, void* data, size_t size, uint32_t deadline){
+   /* the receiver acknowledges again its last in order frame every 30 ms,
+    * as it does on each of its own timeouts */
+   if((int32_t) (deadline - (fake_time + 30)) < 0)
+   {
+      fake_time = deadline;
+      return 0;
+   }
+   if(++acks > 1000)
+   {
+      return -1;
+   }
+   fake_time += 30;
+   ((uint8_t *) data)[0] = 0;
+   UPDT_protocolSetHeader(data, UPDT_PROTOCOL_PACKET_ACK, 0xFF, 0);
+   return UPDT_PROTOCOL_HEADER_SIZE;
+}
+
+static ssize_t test_UPDT_ITransportRecvUntilBursts (UPDT_ITransportType* transport, void* data, size_t size, uint32_t deadline){
+   /* the source up to burst is there at once, the rest arrives at
+    * burst_time, like the frames a sender repeats after its timeout */
+   size_t end = (int32_t) (fake_time - burst_time) >= 0 ? source_size : burst;
+
+   if(source_pos == end)
+   {
+      if(source_size == end || (int32_t) (deadline - burst_time) < 0)
+      {
+         fake_time = deadline;
+         return 0;
+      }
+      fake_time = burst_time;
+      end = source_size;
+   }
+   if(size > end - source_pos)
+   {
+      size = end - source_pos;
+   }
+   memcpy(data, source + source_pos, size);
+   source_pos += size;
+   return size;
+}
 
 /*==================[external functions definition]==========================*/
 
@@ -158,6 +341,668 @@ void test_UPDT_protocolSendSizeError(){
    TEST_ASSERT_TRUE (b == UPDT_PROTOCOL_ERROR_TRANSPORT);
 }
 
+void test_UPDT_protocolSequenceDistance()
+{
+   TEST_ASSERT_TRUE (UPDT_PROTOCOL_SEQUENCE_DISTANCE(5, 3) == 2);
+   TEST_ASSERT_TRUE (UPDT_PROTOCOL_SEQUENCE_DISTANCE(1, 255) == 2);
+}
+
+void test_UPDT_protocolSessionInit()
+{
+   int32_t b = UPDT_protocolSessionInit(&session, &transport, frames[0], UPDT_PROTOCOL_PACKET_MAX_SIZE, 2, 254);
+   TEST_ASSERT_TRUE (b == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (session.base == 254);
+   TEST_ASSERT_TRUE (session.next == 254);
+   TEST_ASSERT_TRUE (session.expected == 254);
+}
+
+void test_UPDT_protocolSessionSendWindow()
+{
+   uint8_t payload[8] = {0};
+   transport.send = test_UPDT_ITransportSend;
+   transport.recv = test_UPDT_ITransportRecvAck;
+   UPDT_protocolSessionInit(&session, &transport, frames[0], UPDT_PROTOCOL_PACKET_MAX_SIZE, 2, 254);
+   /* the first two frames fit in the window */
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSend(&session, UPDT_PROTOCOL_PACKET_DAT, payload, 8) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSend(&session, UPDT_PROTOCOL_PACKET_DAT, payload, 8) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (session.base == 254);
+   TEST_ASSERT_TRUE (session.next == 0);
+   /* the third one waits for a cumulative acknowledgement */
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSend(&session, UPDT_PROTOCOL_PACKET_DAT, payload, 8) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (session.base == 0);
+   TEST_ASSERT_TRUE (session.next == 1);
+   TEST_ASSERT_TRUE (UPDT_protocolSessionFlush(&session) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (session.base == session.next);
+}
+
+void test_UPDT_protocolSessionSendFlags()
+{
+   uint8_t payload[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+   transport.send = test_UPDT_ITransportSend;
+   transport.recv = test_UPDT_ITransportRecvAck;
+   UPDT_protocolSessionInit(&session, &transport, frames[0], UPDT_PROTOCOL_PACKET_MAX_SIZE, 2, 0);
+   /* the flags travel in the upper nibble, the frame is still a DAT frame */
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSend(&session, UPDT_PROTOCOL_PACKET_DAT | UPDT_PROTOCOL_FLAG_COMPRESSED, payload, 8) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (UPDT_protocolGetPacketType(frames[0]) == UPDT_PROTOCOL_PACKET_DAT);
+   TEST_ASSERT_TRUE (frames[0][0] & UPDT_PROTOCOL_FLAG_COMPRESSED);
+   TEST_ASSERT_TRUE (session.image_crc == UPDT_crc32cUpdate(0, payload, 8));
+}
+
+void test_UPDT_protocolCapabilities()
+{
+   uint8_t payload[UPDT_PROTOCOL_CAPABILITIES_SIZE];
+   UPDT_protocolCapabilitiesType local = {2040, 8, 0x03, UPDT_PROTOCOL_BAUD_921600};
+   UPDT_protocolCapabilitiesType remote;
+   UPDT_protocolCapabilitiesType agreed;
+
+   UPDT_protocolSetCapabilities(payload, &local);
+   TEST_ASSERT_TRUE (payload[0] == 0xFF);
+   UPDT_protocolGetCapabilities(payload, &remote);
+   TEST_ASSERT_TRUE (remote.payload_size == 2040);
+   TEST_ASSERT_TRUE (remote.window_size == 8);
+   TEST_ASSERT_TRUE (remote.flags == 0x03);
+   TEST_ASSERT_TRUE (remote.baud_rate == UPDT_PROTOCOL_BAUD_921600);
+   TEST_ASSERT_TRUE (UPDT_protocolGetBaudRate(remote.baud_rate) == 921600);
+
+   /* a peer which does not negotiate gets the defaults */
+   payload[0] = payload[1] = payload[2] = payload[3] = 0;
+   UPDT_protocolGetCapabilities(payload, &remote);
+   TEST_ASSERT_TRUE (remote.payload_size == UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE);
+   TEST_ASSERT_TRUE (remote.window_size == 1);
+
+   UPDT_protocolNegotiate(&local, &remote, &agreed);
+   TEST_ASSERT_TRUE (agreed.payload_size == UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE);
+   TEST_ASSERT_TRUE (agreed.window_size == 1);
+   TEST_ASSERT_TRUE (agreed.flags == 0);
+   /* it keeps the baud rate */
+   TEST_ASSERT_TRUE (agreed.baud_rate == UPDT_PROTOCOL_BAUD_KEEP);
+   TEST_ASSERT_TRUE (UPDT_protocolGetBaudRate(agreed.baud_rate) == 0);
+}
+
+void test_UPDT_protocolSessionSetCapabilities()
+{
+   UPDT_protocolCapabilitiesType agreed = {512, 1, 0};
+   static uint8_t large_frames[2][UPDT_PROTOCOL_FRAME_SIZE(1024)];
+
+   UPDT_protocolSessionInit(&session, &transport, large_frames[0], sizeof(large_frames[0]), 2, 0);
+   TEST_ASSERT_TRUE (session.payload_size == 1024);
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSetCapabilities(&session, &agreed) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (session.payload_size == 512);
+   TEST_ASSERT_TRUE (session.window_size == 1);
+}
+
+void test_UPDT_protocolCrc()
+{
+   uint8_t frame[UPDT_PROTOCOL_FRAME_SIZE(8)] = {0};
+
+   UPDT_protocolSetHeader(frame, UPDT_PROTOCOL_PACKET_DAT, 0x02, 8);
+   TEST_ASSERT_TRUE (UPDT_protocolGetFrameSize(frame) == 12);
+   UPDT_protocolSetCrc(frame);
+   TEST_ASSERT_TRUE (UPDT_protocolGetFlags(frame) == UPDT_PROTOCOL_FLAG_CRC);
+   TEST_ASSERT_TRUE (UPDT_protocolGetPacketType(frame) == UPDT_PROTOCOL_PACKET_DAT);
+   TEST_ASSERT_TRUE (UPDT_protocolGetFrameSize(frame) == 16);
+   TEST_ASSERT_TRUE (UPDT_protocolCheckCrc(frame) == UPDT_PROTOCOL_ERROR_NONE);
+   frame[5] ^= 0x01;
+   TEST_ASSERT_TRUE (UPDT_protocolCheckCrc(frame) == UPDT_PROTOCOL_ERROR_CRC);
+}
+
+void test_UPDT_protocolSendFrameFallback()
+{
+   uint8_t frame_header[UPDT_PROTOCOL_HEADER_SIZE] = {0};
+   uint8_t payload[16] = {0};
+
+   /* without sendv every block is sent on its own */
+   transport.send = test_UPDT_ITransportSendCount;
+   transport.sendv = NULL;
+   send_calls = 0;
+   UPDT_protocolSetHeader(frame_header, UPDT_PROTOCOL_PACKET_DAT, 1, 16);
+   UPDT_protocolSetFlags(frame_header, UPDT_PROTOCOL_FLAG_CRC);
+   TEST_ASSERT_TRUE (UPDT_protocolSendFrame(&transport, frame_header, payload) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (send_calls == 3);
+}
+
+void test_UPDT_protocolRecvConsume()
+{
+   size_t i;
+
+   for(i = 0; i < sizeof(source); i++)
+   {
+      source[i] = i;
+   }
+
+   /* through the bounce buffer */
+   transport.recv = test_UPDT_ITransportRecvSource;
+   transport.recv_acquire = NULL;
+   transport.recv_release = NULL;
+   source_pos = 0;
+   memset(sink, 0, sizeof(sink));
+   TEST_ASSERT_TRUE (UPDT_protocolRecvConsume(&transport, 40, test_UPDT_protocolConsumerCopy, sink) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (source_pos == 40);
+   TEST_ASSERT_TRUE (memcmp(sink, source, 40) == 0);
+
+   /* in place */
+   transport.recv_acquire = test_UPDT_ITransportRecvAcquire;
+   transport.recv_release = test_UPDT_ITransportRecvRelease;
+   source_pos = 0;
+   memset(sink, 0, sizeof(sink));
+   TEST_ASSERT_TRUE (UPDT_protocolRecvConsume(&transport, 40, test_UPDT_protocolConsumerCopy, sink) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (source_pos == 40);
+   TEST_ASSERT_TRUE (memcmp(sink, source, 40) == 0);
+}
+
+void test_UPDT_protocolSessionRecvConsume()
+{
+   uint8_t frame_header[UPDT_PROTOCOL_HEADER_SIZE];
+   uint32_t image_crc;
+
+   /* an in order DAT frame with its trailer */
+   memset(source, 0, sizeof(source));
+   UPDT_protocolSetHeader(source, UPDT_PROTOCOL_PACKET_DAT, 3, 16);
+   memset(source + UPDT_PROTOCOL_HEADER_SIZE, 0xA5, 16);
+   UPDT_protocolSetCrc(source);
+
+   UPDT_protocolSessionInit(&session, &transport, frames[0], sizeof(frames[0]), 2, 0);
+   session.expected = 3;
+   image_crc = session.image_crc;
+   transport.send = test_UPDT_ITransportSendCount;
+   transport.sendv = NULL;
+   transport.recv = test_UPDT_ITransportRecvSource;
+   transport.recv_acquire = test_UPDT_ITransportRecvAcquire;
+   transport.recv_release = test_UPDT_ITransportRecvRelease;
+   source_pos = 0;
+   send_calls = 0;
+   memset(sink, 0, sizeof(sink));
+   TEST_ASSERT_TRUE (UPDT_protocolSessionRecvConsume(&session, frame_header, 16, test_UPDT_protocolConsumerCopy, sink) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (memcmp(sink, source + UPDT_PROTOCOL_HEADER_SIZE, 16) == 0);
+   TEST_ASSERT_TRUE (source_pos == UPDT_protocolGetFrameSize(source));
+   TEST_ASSERT_TRUE (session.expected == 4);
+   TEST_ASSERT_TRUE (session.image_crc != image_crc);
+   TEST_ASSERT_TRUE (0 < send_calls);
+}
+
+void test_UPDT_protocolSessionDeferredAck()
+{
+   uint8_t frame_header[UPDT_PROTOCOL_HEADER_SIZE];
+
+   memset(source, 0, sizeof(source));
+   UPDT_protocolSetHeader(source, UPDT_PROTOCOL_PACKET_DAT, 3, 16);
+   UPDT_protocolSetCrc(source);
+
+   UPDT_protocolSessionInit(&session, &transport, frames[0], sizeof(frames[0]), 2, 3);
+   UPDT_protocolSessionSetDeferredAck(&session, 1);
+   transport.send = test_UPDT_ITransportSendCount;
+   transport.sendv = NULL;
+   transport.recv = test_UPDT_ITransportRecvSource;
+   transport.recv_acquire = test_UPDT_ITransportRecvAcquire;
+   transport.recv_release = test_UPDT_ITransportRecvRelease;
+   source_pos = 0;
+   send_calls = 0;
+   /* received but not acknowledged until the data is durable */
+   TEST_ASSERT_TRUE (UPDT_protocolSessionRecvConsume(&session, frame_header, 16, test_UPDT_protocolConsumerCopy, sink) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (0 == send_calls);
+   TEST_ASSERT_TRUE (1 == UPDT_protocolSessionUnacked(&session));
+
+   TEST_ASSERT_TRUE (UPDT_protocolSessionAck(&session, 3) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (0 < send_calls);
+   TEST_ASSERT_TRUE (0 == UPDT_protocolSessionUnacked(&session));
+}
+
+void test_UPDT_protocolFeed()
+{
+   UPDT_protocolStreamType stream;
+   uint8_t buffer[UPDT_PROTOCOL_FRAME_SIZE(16)];
+   size_t i;
+
+   /* a good frame, a corrupted one and one too large for the buffer */
+   memset(source, 0, sizeof(source));
+   UPDT_protocolSetHeader(source, UPDT_PROTOCOL_PACKET_DAT, 1, 8);
+   UPDT_protocolSetCrc(source);
+   UPDT_protocolSetHeader(source + 16, UPDT_PROTOCOL_PACKET_DAT, 2, 8);
+   UPDT_protocolSetCrc(source + 16);
+   source[20] ^= 0x01;
+   UPDT_protocolSetHeader(source + 32, UPDT_PROTOCOL_PACKET_DAT, 3, 24);
+
+   UPDT_protocolStreamInit(&stream, NULL, buffer, sizeof(buffer), test_UPDT_protocolFrameCallback, NULL);
+   stream_frames = 0;
+   for(i = 0; i < 60; i++)
+   {
+      /* the frames end at bytes 16, 32 and 60 */
+      TEST_ASSERT_TRUE (UPDT_protocolFeed(&stream, source + i, 1) ==
+         ((15 == i || 31 == i || 59 == i) ? UPDT_PROTOCOL_ERROR_NONE : UPDT_PROTOCOL_ERROR_AGAIN));
+   }
+   TEST_ASSERT_TRUE (stream_frames == 3);
+   TEST_ASSERT_TRUE (stream_errors[0] == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (stream_errors[1] == UPDT_PROTOCOL_ERROR_CRC);
+   TEST_ASSERT_TRUE (stream_errors[2] == UPDT_PROTOCOL_ERROR_PACKET);
+
+   /* the same bytes at once */
+   UPDT_protocolStreamInit(&stream, NULL, buffer, sizeof(buffer), test_UPDT_protocolFrameCallback, NULL);
+   stream_frames = 0;
+   TEST_ASSERT_TRUE (UPDT_protocolFeed(&stream, source, 60) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (stream_frames == 3);
+}
+
+void test_UPDT_protocolPoll()
+{
+   UPDT_protocolStreamType stream;
+   uint8_t buffer[UPDT_PROTOCOL_FRAME_SIZE(16)];
+   uint8_t frame[UPDT_PROTOCOL_FRAME_SIZE(8)] = {0};
+
+   memset(source, 0, sizeof(source));
+   UPDT_protocolSetHeader(source, UPDT_PROTOCOL_PACKET_DAT, 1, 8);
+   UPDT_protocolSetCrc(source);
+   transport.recv = test_UPDT_ITransportRecvNonBlocking;
+   transport.send = test_UPDT_ITransportSendNonBlocking;
+   UPDT_protocolStreamInit(&stream, &transport, buffer, sizeof(buffer), test_UPDT_protocolFrameCallback, NULL);
+   stream_frames = 0;
+   source_pos = 0;
+
+   /* the frame arrives in two pieces */
+   source_size = 7;
+   TEST_ASSERT_TRUE (UPDT_protocolPoll(&stream) == UPDT_PROTOCOL_ERROR_AGAIN);
+   TEST_ASSERT_TRUE (stream_frames == 0);
+   source_size = 16;
+   TEST_ASSERT_TRUE (UPDT_protocolPoll(&stream) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (stream_frames == 1);
+   TEST_ASSERT_TRUE (stream_errors[0] == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (UPDT_protocolPoll(&stream) == UPDT_PROTOCOL_ERROR_AGAIN);
+
+   /* the send continues in the next polls */
+   send_calls = 0;
+   TEST_ASSERT_TRUE (UPDT_protocolStreamSend(&stream, frame, sizeof(frame)) == UPDT_PROTOCOL_ERROR_AGAIN);
+   TEST_ASSERT_TRUE (UPDT_protocolStreamPending(&stream) == 4);
+   TEST_ASSERT_TRUE (UPDT_protocolStreamSend(&stream, frame, sizeof(frame)) == UPDT_PROTOCOL_ERROR_AGAIN);
+   send_calls = 0;
+   UPDT_protocolPoll(&stream);
+   TEST_ASSERT_TRUE (UPDT_protocolStreamPending(&stream) == 0);
+}
+
+void test_UPDT_protocolSessionTimeout()
+{
+   uint8_t frame_header[UPDT_PROTOCOL_HEADER_SIZE];
+   uint8_t payload[8] = {0};
+
+   UPDT_timeSetSource(test_UPDT_timeFake);
+   fake_time = 0xFFFFFF00;
+   transport.send = test_UPDT_ITransportSendCount;
+   transport.sendv = NULL;
+   transport.recv_acquire = NULL;
+   transport.recv_until = test_UPDT_ITransportRecvUntilSilent;
+
+   /* the sender retransmits on each timeout, then gives up */
+   UPDT_protocolSessionInit(&session, &transport, frames[0], sizeof(frames[0]), 2, 0);
+   UPDT_protocolSessionSetTimeout(&session, 100);
+   send_calls = 0;
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSend(&session, UPDT_PROTOCOL_PACKET_DAT, payload, 8) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (UPDT_protocolSessionFlush(&session) == UPDT_PROTOCOL_ERROR_TIMEOUT);
+   TEST_ASSERT_TRUE (send_calls == 1 + UPDT_PROTOCOL_RETRIES_MAX);
+
+   /* the receiver acknowledges again on each timeout, then gives up */
+   UPDT_protocolSessionInit(&session, &transport, NULL, 0, 1, 0);
+   UPDT_protocolSessionSetTimeout(&session, 100);
+   send_calls = 0;
+   TEST_ASSERT_TRUE (UPDT_protocolSessionRecv(&session, frame_header, payload, 8) == UPDT_PROTOCOL_ERROR_TIMEOUT);
+   TEST_ASSERT_TRUE (send_calls == UPDT_PROTOCOL_RETRIES_MAX);
+
+   /* without a timeout the session uses the transport as it is */
+   UPDT_protocolSessionSetTimeout(&session, 0);
+   TEST_ASSERT_TRUE (session.transport == &transport);
+
+   transport.recv_until = NULL;
+   UPDT_timeSetSource(NULL);
+}
+
+void test_UPDT_protocolSessionRepeatedAck()
+{
+   UPDT_protocolStatsType stats;
+   uint8_t payload[8] = {0};
+   size_t frame_size = UPDT_PROTOCOL_HEADER_SIZE + sizeof(payload);
+   size_t i;
+
+   UPDT_timeSetSource(test_UPDT_timeFake);
+   fake_time = 0xFFFFFF00;
+   acks = 0;
+   wire_size = 0;
+   transport.send = test_UPDT_ITransportSendWire;
+   transport.sendv = NULL;
+   transport.recv_acquire = NULL;
+   transport.recv_until = test_UPDT_ITransportRecvUntilRepeatedAck;
+
+   UPDT_protocolSessionInit(&session, &transport, frames[0], sizeof(frames[0]), 2, 0);
+   UPDT_protocolSessionSetTimeout(&session, 100);
+   UPDT_protocolSessionSetStats(&session, &stats);
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSend(&session, UPDT_PROTOCOL_PACKET_DAT, payload, 8) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSend(&session, UPDT_PROTOCOL_PACKET_DAT, payload, 8) == UPDT_PROTOCOL_ERROR_NONE);
+
+   /* the first repeated acknowledgement goes back to the base frame, the
+    * next ones are ignored while it is recovered, and they must not hold
+    * back the timeout that sends it again */
+   TEST_ASSERT_TRUE (UPDT_protocolSessionFlush(&session) == UPDT_PROTOCOL_ERROR_TIMEOUT);
+   TEST_ASSERT_TRUE (acks < 50);
+   TEST_ASSERT_TRUE (stats.timeouts == UPDT_PROTOCOL_RETRIES_MAX + 1);
+   TEST_ASSERT_TRUE (stats.retransmissions == 2 * (1 + UPDT_PROTOCOL_RETRIES_MAX));
+   TEST_ASSERT_TRUE (wire_size == 2 * (2 + UPDT_PROTOCOL_RETRIES_MAX) * frame_size);
+   for(i = 2; i < wire_size / frame_size; i += 2)
+   {
+      /* every retransmission starts with the base frame */
+      TEST_ASSERT_TRUE (UPDT_protocolGetSequenceNumber(wire + i * frame_size) == 0);
+      TEST_ASSERT_TRUE (UPDT_protocolGetSequenceNumber(wire + (i + 1) * frame_size) == 1);
+   }
+
+   UPDT_protocolSessionSetStats(&session, NULL);
+   transport.recv_until = NULL;
+   UPDT_timeSetSource(NULL);
+}
+
+void test_UPDT_protocolSessionResync()
+{
+   UPDT_protocolStatsType stats;
+   uint8_t frame_header[UPDT_PROTOCOL_HEADER_SIZE];
+   uint8_t payload[16];
+   uint8_t *frame;
+   size_t frame_size = UPDT_PROTOCOL_FRAME_SIZE(8);
+   size_t i;
+
+   /* frames 0 and 1, then both again */
+   memset(source, 0, sizeof(source));
+   for(i = 0; i < 4; i++)
+   {
+      frame = source + i * frame_size;
+      UPDT_protocolSetHeader(frame, UPDT_PROTOCOL_PACKET_DAT, i & 1, 8);
+      UPDT_protocolSetFlags(frame, UPDT_PROTOCOL_FLAG_CRC);
+      memset(frame + UPDT_PROTOCOL_HEADER_SIZE, 0x30 + (i & 1), 8);
+      if(1 == i)
+      {
+         /* payload bytes which look like the header of a long frame */
+         UPDT_protocolSetHeader(frame + UPDT_PROTOCOL_HEADER_SIZE + 4, UPDT_PROTOCOL_PACKET_DAT, 0x40, 64);
+         UPDT_protocolSetFlags(frame + UPDT_PROTOCOL_HEADER_SIZE + 4, UPDT_PROTOCOL_FLAG_CRC);
+      }
+      UPDT_protocolSetCrc(frame);
+   }
+   /* a bit error turns the payload size of frame 0 from 8 into 16 */
+   source[3] ^= 0x03;
+   source_size = 4 * frame_size;
+   source_pos = 0;
+   burst = 2 * frame_size;
+
+   UPDT_timeSetSource(test_UPDT_timeFake);
+   fake_time = 0xFFFFFF00;
+   burst_time = fake_time + 90;
+   transport.send = test_UPDT_ITransportSendCount;
+   transport.sendv = NULL;
+   transport.recv_acquire = NULL;
+   transport.recv_until = test_UPDT_ITransportRecvUntilBursts;
+
+   UPDT_protocolSessionInit(&session, &transport, NULL, 0, 1, 0);
+   UPDT_protocolSessionSetTimeout(&session, 100);
+   UPDT_protocolSessionSetStats(&session, &stats);
+
+   /* the bad frame swallows the start of frame 1 and its payload is taken
+    * for the header of a frame too long for the buffer. The wait for that
+    * frame ends before the frames are sent again, so they are read from
+    * their start */
+   TEST_ASSERT_TRUE (UPDT_protocolSessionRecv(&session, frame_header, payload, sizeof(payload)) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (UPDT_protocolGetSequenceNumber(frame_header) == 0 && payload[0] == 0x30);
+   TEST_ASSERT_TRUE (UPDT_protocolSessionRecv(&session, frame_header, payload, sizeof(payload)) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (UPDT_protocolGetSequenceNumber(frame_header) == 1 && payload[0] == 0x31);
+   TEST_ASSERT_TRUE (stats.corrupted == 2);
+   TEST_ASSERT_TRUE (stats.timeouts == 1);
+
+   UPDT_protocolSessionSetStats(&session, NULL);
+   transport.recv_until = NULL;
+   UPDT_timeSetSource(NULL);
+}
+
+void test_UPDT_protocolStats()
+{
+   UPDT_protocolStatsType stats;
+   UPDT_protocolStatsType decoded;
+   uint8_t payload[UPDT_PROTOCOL_PACKET_STA_PAYLOAD_SIZE];
+
+   TEST_ASSERT_TRUE (sizeof(stats) <= UPDT_PROTOCOL_PACKET_STA_PAYLOAD_SIZE);
+   memset(&stats, 0, sizeof(stats));
+   stats.frames_sent[UPDT_PROTOCOL_PACKET_DAT] = 0x12345678;
+   stats.discarded = 3;
+   stats.programs_saved = 0x0A0B0C0D;
+   stats.transport.send_time = 0xFFFFFFFF;
+   UPDT_protocolSetStats(payload, &stats);
+   /* little endian words in the order of the fields */
+   TEST_ASSERT_TRUE (payload[4] == 0x78 && payload[7] == 0x12);
+   /* the flash counters follow the six session counters */
+   TEST_ASSERT_TRUE (payload[4 * (4 * UPDT_PROTOCOL_PACKET_TYPES + 6 + 3)] == 0x0D);
+   UPDT_protocolGetStats(payload, &decoded);
+   TEST_ASSERT_TRUE (memcmp(&stats, &decoded, sizeof(stats)) == 0);
+}
+
+void test_UPDT_protocolSessionStats()
+{
+   UPDT_protocolStatsType stats;
+   UPDT_protocolStatsType remote;
+   UPDT_protocolStatsType copy;
+   uint8_t frame_header[UPDT_PROTOCOL_HEADER_SIZE];
+   uint8_t payload[8] = {0};
+   uint8_t *answer;
+
+   /* the peer acknowledges the request and answers it */
+   memset(source, 0, sizeof(source));
+   UPDT_protocolSetHeader(source, UPDT_PROTOCOL_PACKET_ACK, 1, 0);
+   answer = source + UPDT_protocolGetFrameSize(source);
+   memset(&remote, 0, sizeof(remote));
+   remote.retransmissions = 7;
+   remote.transport.partial_reads = 3;
+   UPDT_protocolSetHeader(answer, UPDT_PROTOCOL_PACKET_STA, 1, UPDT_PROTOCOL_PACKET_STA_PAYLOAD_SIZE);
+   UPDT_protocolSetStats(answer + UPDT_PROTOCOL_HEADER_SIZE, &remote);
+
+   UPDT_protocolSessionInit(&session, &transport, frames[0], sizeof(frames[0]), 2, 0);
+   transport.send = test_UPDT_ITransportSendCount;
+   transport.sendv = NULL;
+   transport.recv = test_UPDT_ITransportRecvSource;
+   transport.recv_acquire = NULL;
+   transport.recv_until = NULL;
+   UPDT_protocolSessionSetStats(&session, &stats);
+   source_pos = 0;
+   send_calls = 0;
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSend(&session, UPDT_PROTOCOL_PACKET_DAT, payload, 8) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (UPDT_protocolSessionQueryStats(&session, &copy) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (memcmp(&copy, &remote, sizeof(remote)) == 0);
+   TEST_ASSERT_TRUE (session.base == session.next);
+
+   UPDT_protocolSessionGetStats(&session, &copy);
+   TEST_ASSERT_TRUE (copy.frames_sent[UPDT_PROTOCOL_PACKET_DAT] == 1);
+   TEST_ASSERT_TRUE (copy.bytes_sent[UPDT_PROTOCOL_PACKET_DAT] == UPDT_PROTOCOL_HEADER_SIZE + 8);
+   TEST_ASSERT_TRUE (copy.frames_sent[UPDT_PROTOCOL_PACKET_STA] == 1);
+   TEST_ASSERT_TRUE (copy.frames_received[UPDT_PROTOCOL_PACKET_ACK] == 1);
+   TEST_ASSERT_TRUE (copy.frames_received[UPDT_PROTOCOL_PACKET_STA] == 1);
+   TEST_ASSERT_TRUE (copy.transport.writes == send_calls);
+   TEST_ASSERT_TRUE (copy.transport.bytes_received == source_pos);
+   /* the transport returns at most 5 bytes per read */
+   TEST_ASSERT_TRUE (0 < copy.transport.partial_reads);
+
+   /* the receiver answers a request with its own statistics */
+   memset(source, 0, sizeof(source));
+   UPDT_protocolSetHeader(source, UPDT_PROTOCOL_PACKET_STA, 0, 0);
+   UPDT_protocolSessionInit(&session, &transport, NULL, 0, 1, 0);
+   UPDT_protocolSessionSetStats(&session, &stats);
+   source_pos = 0;
+   send_calls = 0;
+   TEST_ASSERT_TRUE (UPDT_protocolSessionRecv(&session, frame_header, payload, sizeof(payload)) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (UPDT_protocolGetPacketType(frame_header) == UPDT_PROTOCOL_PACKET_STA);
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSendStats(&session) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (stats.frames_received[UPDT_PROTOCOL_PACKET_STA] == 1);
+   TEST_ASSERT_TRUE (stats.frames_sent[UPDT_PROTOCOL_PACKET_ACK] == 1);
+   TEST_ASSERT_TRUE (stats.frames_sent[UPDT_PROTOCOL_PACKET_STA] == 1);
+
+   /* without statistics the session uses the transport as it is */
+   UPDT_protocolSessionSetStats(&session, NULL);
+   TEST_ASSERT_TRUE (session.transport == &transport);
+}
+
+void test_UPDT_protocolSessionCipher()
+{
+   uint8_t frame_header[UPDT_PROTOCOL_HEADER_SIZE];
+   uint8_t payload[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+   uint8_t received[32];
+
+   /* the sender encrypts the DAT payload inside its window slot */
+   transport.send = test_UPDT_ITransportSend;
+   transport.sendv = NULL;
+   transport.recv = test_UPDT_ITransportRecvAck;
+   UPDT_protocolSessionInit(&session, &transport, frames[0], UPDT_PROTOCOL_PACKET_MAX_SIZE, 2, 0);
+   session.flags = UPDT_PROTOCOL_FLAG_CRC;
+   UPDT_protocolSessionSetCipher(&session, test_UPDT_protocolCipherSeal, NULL);
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSend(&session, UPDT_PROTOCOL_PACKET_DAT, payload, 8) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (UPDT_protocolGetPacketType(frames[0]) == UPDT_PROTOCOL_PACKET_DAT);
+   TEST_ASSERT_TRUE (UPDT_protocolGetFlags(frames[0]) == (UPDT_PROTOCOL_FLAG_CRC | UPDT_PROTOCOL_FLAG_ENCRYPTED));
+   TEST_ASSERT_TRUE (UPDT_protocolGetPayloadSize(frames[0]) == 8 + UPDT_PROTOCOL_TAG_SIZE);
+   TEST_ASSERT_TRUE (frames[0][UPDT_PROTOCOL_HEADER_SIZE] == (1 ^ 0x5A));
+   TEST_ASSERT_TRUE (UPDT_protocolCheckCrc(frames[0]) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (session.ciphered == 1);
+   /* the image CRC covers the plain image */
+   TEST_ASSERT_TRUE (session.image_crc == UPDT_crc32cUpdate(0, payload, 8));
+
+   /* the receiver gets it back plain */
+   memset(source, 0, sizeof(source));
+   memcpy(source, frames[0], UPDT_protocolGetFrameSize(frames[0]));
+   UPDT_protocolSessionInit(&session, &transport, NULL, 0, 1, 0);
+   UPDT_protocolSessionSetCipher(&session, test_UPDT_protocolCipherOpen, NULL);
+   transport.send = test_UPDT_ITransportSendCount;
+   transport.recv = test_UPDT_ITransportRecvSource;
+   transport.recv_acquire = NULL;
+   transport.recv_until = NULL;
+   source_pos = 0;
+   send_calls = 0;
+   TEST_ASSERT_TRUE (UPDT_protocolSessionRecv(&session, frame_header, received, sizeof(received)) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (UPDT_protocolGetPayloadSize(frame_header) == 8);
+   TEST_ASSERT_TRUE (UPDT_protocolGetFlags(frame_header) == UPDT_PROTOCOL_FLAG_CRC);
+   TEST_ASSERT_TRUE (memcmp(received, payload, 8) == 0);
+   TEST_ASSERT_TRUE (session.image_crc == UPDT_crc32cUpdate(0, payload, 8));
+   TEST_ASSERT_TRUE (session.expected == 1);
+   TEST_ASSERT_TRUE (0 < send_calls);
+
+   /* a replayed frame and a plain one are neither accepted nor acknowledged */
+   UPDT_protocolSetHeader(source, UPDT_PROTOCOL_PACKET_DAT, 1, 8 + UPDT_PROTOCOL_TAG_SIZE);
+   UPDT_protocolSetCrc(source);
+   source_pos = 0;
+   send_calls = 0;
+   TEST_ASSERT_TRUE (UPDT_protocolSessionRecv(&session, frame_header, received, sizeof(received)) == UPDT_PROTOCOL_ERROR_DENIED);
+   memset(source, 0, sizeof(source));
+   UPDT_protocolSetHeader(source, UPDT_PROTOCOL_PACKET_DAT, 1, 24);
+   source_pos = 0;
+   TEST_ASSERT_TRUE (UPDT_protocolSessionRecv(&session, frame_header, received, sizeof(received)) == UPDT_PROTOCOL_ERROR_DENIED);
+   TEST_ASSERT_TRUE (0 == send_calls);
+   TEST_ASSERT_TRUE (session.expected == 1);
+   TEST_ASSERT_TRUE (session.ciphered == 1);
+}
+
+void test_UPDT_protocolSessionFec()
+{
+   static uint8_t fec_frames[3][UPDT_PROTOCOL_FRAME_SIZE(32)];
+   static uint8_t blocks[UPDT_FEC_BUFFER_SIZE(3, 2, 32)];
+   UPDT_protocolCapabilitiesType agreed = {32, 3, UPDT_PROTOCOL_CAPABILITY_CRC | UPDT_PROTOCOL_CAPABILITY_FEC, 0};
+   UPDT_protocolStatsType stats;
+   UPDT_fecType fec;
+   uint8_t frame_header[UPDT_PROTOCOL_HEADER_SIZE];
+   uint8_t payload[24];
+   uint8_t received[32];
+   size_t offsets[6];
+   size_t i;
+
+   for(i = 0; i < sizeof(payload); i++)
+   {
+      payload[i] = (uint8_t) (i * 7 + 1);
+   }
+
+   /* three DAT frames and the two PAR frames of their group */
+   transport.send = test_UPDT_ITransportSendWire;
+   transport.sendv = NULL;
+   transport.recv = test_UPDT_ITransportRecvAck;
+   wire_size = 0;
+   UPDT_protocolSessionInit(&session, &transport, fec_frames[0], sizeof(fec_frames[0]), 3, 0);
+   UPDT_protocolSessionSetCapabilities(&session, &agreed);
+   UPDT_fecInit(&fec, blocks, sizeof(blocks), 4, 2, 32);
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSetFec(&session, &fec) == UPDT_PROTOCOL_ERROR_PACKET);
+   UPDT_fecInit(&fec, blocks, sizeof(blocks), 3, 2, 32);
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSetFec(&session, &fec) == UPDT_PROTOCOL_ERROR_NONE);
+   for(i = 0; i < 3; i++)
+   {
+      offsets[i] = wire_size;
+      TEST_ASSERT_TRUE (UPDT_protocolSessionSend(&session, UPDT_PROTOCOL_PACKET_DAT, payload, 24 - 8 * i) == UPDT_PROTOCOL_ERROR_NONE);
+      TEST_ASSERT_TRUE (wire[offsets[i] + 1] == i);
+   }
+   for(i = 3; i < 5; i++)
+   {
+      offsets[i] = offsets[i - 1] + UPDT_protocolGetFrameSize(wire + offsets[i - 1]);
+      TEST_ASSERT_TRUE (UPDT_protocolGetPacketType(wire + offsets[i]) == UPDT_PROTOCOL_PACKET_PAR);
+      TEST_ASSERT_TRUE (UPDT_protocolGetSequenceNumber(wire + offsets[i]) == 0);
+      TEST_ASSERT_TRUE (UPDT_protocolGetPayloadSize(wire + offsets[i]) == 32);
+      TEST_ASSERT_TRUE (wire[offsets[i] + 1] == (((i - 3) << 4) | 2));
+      TEST_ASSERT_TRUE (UPDT_protocolCheckCrc(wire + offsets[i]) == UPDT_PROTOCOL_ERROR_NONE);
+   }
+   offsets[5] = wire_size;
+   TEST_ASSERT_TRUE (offsets[4] + UPDT_protocolGetFrameSize(wire + offsets[4]) == wire_size);
+
+   /* the flush closes a shorter group */
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSend(&session, UPDT_PROTOCOL_PACKET_DAT, payload, 8) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (UPDT_protocolSessionFlush(&session) == UPDT_PROTOCOL_ERROR_NONE);
+   TEST_ASSERT_TRUE (UPDT_protocolGetPacketType(wire + offsets[5] + 16) == UPDT_PROTOCOL_PACKET_PAR);
+   TEST_ASSERT_TRUE (UPDT_protocolGetSequenceNumber(wire + offsets[5] + 16) == 3);
+   TEST_ASSERT_TRUE (wire[offsets[5] + 16 + 1] == 0);
+
+   /* the first and the last DAT frames are lost, the PAR frames rebuild them */
+   memset(source, 0, sizeof(source));
+   source_size = 0;
+   memcpy(source, wire + offsets[1], offsets[2] - offsets[1]);
+   source_size += offsets[2] - offsets[1];
+   memcpy(source + source_size, wire + offsets[3], offsets[5] - offsets[3]);
+   source_size += offsets[5] - offsets[3];
+   UPDT_protocolSessionInit(&session, &transport, NULL, 0, 1, 0);
+   UPDT_protocolSessionSetCapabilities(&session, &agreed);
+   UPDT_protocolSessionSetStats(&session, &stats);
+   UPDT_fecInit(&fec, blocks, sizeof(blocks), 3, 2, 32);
+   TEST_ASSERT_TRUE (UPDT_protocolSessionSetFec(&session, &fec) == UPDT_PROTOCOL_ERROR_NONE);
+   transport.send = test_UPDT_ITransportSendCount;
+   transport.recv = test_UPDT_ITransportRecvSource;
+   transport.recv_acquire = NULL;
+   transport.recv_until = NULL;
+   source_pos = 0;
+   send_calls = 0;
+   for(i = 0; i < 3; i++)
+   {
+      TEST_ASSERT_TRUE (UPDT_protocolSessionRecv(&session, frame_header, received, sizeof(received)) == UPDT_PROTOCOL_ERROR_NONE);
+      TEST_ASSERT_TRUE (UPDT_protocolGetPacketType(frame_header) == UPDT_PROTOCOL_PACKET_DAT);
+      TEST_ASSERT_TRUE (UPDT_protocolGetSequenceNumber(frame_header) == i);
+      TEST_ASSERT_TRUE (UPDT_protocolGetPayloadSize(frame_header) == 24 - 8 * i);
+      TEST_ASSERT_TRUE (memcmp(received, payload, 24 - 8 * i) == 0);
+   }
+   TEST_ASSERT_TRUE (source_pos == source_size);
+   TEST_ASSERT_TRUE (session.image_crc == UPDT_crc32cUpdate(UPDT_crc32cUpdate(UPDT_crc32cUpdate(0, payload, 24), payload, 16), payload, 8));
+   /* only the delivered frames were acknowledged */
+   TEST_ASSERT_TRUE (send_calls == 3);
+   TEST_ASSERT_TRUE (stats.kept == 1);
+   TEST_ASSERT_TRUE (stats.rebuilt == 2);
+   TEST_ASSERT_TRUE (stats.frames_received[UPDT_PROTOCOL_PACKET_PAR] == 2);
+
+   /* three lost frames are too many, the receiver goes back to the first one */
+   memset(source, 0, sizeof(source));
+   source_size = offsets[5] - offsets[3];
+   memcpy(source, wire + offsets[3], source_size);
+   memcpy(source + source_size, wire, offsets[3]);
+   source_size += offsets[3];
+   UPDT_protocolSessionInit(&session, &transport, NULL, 0, 1, 0);
+   UPDT_protocolSessionSetCapabilities(&session, &agreed);
+   UPDT_fecInit(&fec, blocks, sizeof(blocks), 3, 2, 32);
+   UPDT_protocolSessionSetFec(&session, &fec);
+   source_pos = 0;
+   send_calls = 0;
+   for(i = 0; i < 3; i++)
+   {
+      TEST_ASSERT_TRUE (UPDT_protocolSessionRecv(&session, frame_header, received, sizeof(received)) == UPDT_PROTOCOL_ERROR_NONE);
+      TEST_ASSERT_TRUE (UPDT_protocolGetSequenceNumber(frame_header) == i);
+      TEST_ASSERT_TRUE (memcmp(received, payload, 24 - 8 * i) == 0);
+   }
+   TEST_ASSERT_TRUE (source_pos == source_size);
+   TEST_ASSERT_TRUE (send_calls == 2 + 3);
+}
 
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
@@ -0,0 +1,262 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief this file implements the unit tests for the functions of the file UPDT_resume
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup update Implementation
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "UPDT_resume.h"
+#include <string.h>
+
+/*==================[macros and definitions]=================================*/
+#define IMAGE_SIZE      5000
+#define IMAGE_ID        0x1D1D1D1Du
+#define PAYLOAD_SIZE    UPDT_PROTOCOL_PACKET_DAT_PAYLOAD_SIZE
+#define FRAME_SIZE      (UPDT_PROTOCOL_HEADER_SIZE + PAYLOAD_SIZE)
+#define FRAMES          ((IMAGE_SIZE + PAYLOAD_SIZE - 1) / PAYLOAD_SIZE)
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static uint8_t image[IMAGE_SIZE];
+static uint8_t flash[IMAGE_SIZE];
+/* the record survives the reset of the slave */
+static uint8_t store[UPDT_RESUME_RECORD_SIZE];
+static uint32_t saves;
+static uint8_t wire[(FRAMES + 1) * FRAME_SIZE];
+static size_t wire_size;
+static size_t wire_pos;
+static UPDT_ITransportType transport;
+static UPDT_resumeType resume;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static ssize_t test_UPDT_ITransportSendWire (UPDT_ITransportType* transport, const void* data, size_t size){
+   TEST_ASSERT_TRUE (wire_size + size <= sizeof(wire));
+   memcpy(wire + wire_size, data, size);
+   wire_size += size;
+   return size;
+}
+
+static ssize_t test_UPDT_ITransportRecvWire (UPDT_ITransportType* transport, void* data, size_t size){
+   if(size > wire_size - wire_pos)
+   {
+      size = wire_size - wire_pos;
+   }
+   memcpy(data, wire + wire_pos, size);
+   wire_pos += size;
+   return size;
+}
+
+static int32_t test_UPDT_resumeLoad (void *context, uint8_t *record){
+   memcpy(record, store, UPDT_RESUME_RECORD_SIZE);
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+static int32_t test_UPDT_resumeSave (void *context, const uint8_t *record){
+   memcpy(store, record, UPDT_RESUME_RECORD_SIZE);
+   saves++;
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+static int32_t test_UPDT_resumeFlash (void *context, size_t offset, const uint8_t *data, size_t size){
+   TEST_ASSERT_TRUE (offset + size <= sizeof(flash));
+   memcpy(flash + offset, data, size);
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/* master: sends the image from offset, returns the number of frames */
+static uint32_t test_UPDT_resumeSend (uint32_t offset){
+   uint8_t frame[FRAME_SIZE];
+   uint32_t frames = 0;
+   size_t chunk;
+
+   for(; offset < IMAGE_SIZE; offset += chunk)
+   {
+      chunk = IMAGE_SIZE - offset < PAYLOAD_SIZE ? IMAGE_SIZE - offset : PAYLOAD_SIZE;
+      memset(frame, 0, sizeof(frame));
+      memcpy(frame + UPDT_PROTOCOL_HEADER_SIZE, image + offset, chunk);
+      UPDT_protocolSetHeader(frame, UPDT_PROTOCOL_PACKET_DAT, frames, (chunk + 7) & ~7u);
+      TEST_ASSERT_TRUE (UPDT_protocolSend(&transport, frame, UPDT_PROTOCOL_HEADER_SIZE + ((chunk + 7) & ~7u)) == UPDT_PROTOCOL_ERROR_NONE);
+      frames++;
+   }
+   return frames;
+}
+
+/* slave: writes frames until the wire goes silent */
+static void test_UPDT_resumeRecv (void){
+   uint8_t header[UPDT_PROTOCOL_HEADER_SIZE];
+
+   while(UPDT_protocolRecv(&transport, header, sizeof(header)) == UPDT_PROTOCOL_ERROR_NONE)
+   {
+      if(UPDT_protocolRecvConsume(&transport, UPDT_protocolGetPayloadSize(header),
+         UPDT_resumeConsume, &resume) != UPDT_PROTOCOL_ERROR_NONE)
+      {
+         break;
+      }
+      TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_resumeCommit(&resume, UPDT_protocolGetPayloadSize(header)));
+   }
+}
+
+/* slave reset: a new tracker on the same store */
+static uint32_t test_UPDT_resumeReset (uint32_t period){
+   UPDT_resumeInit(&resume, test_UPDT_resumeLoad, test_UPDT_resumeSave, NULL,
+      period, test_UPDT_resumeFlash, NULL);
+   return UPDT_resumeStart(&resume, IMAGE_ID, IMAGE_SIZE);
+}
+
+/*==================[external functions definition]==========================*/
+void setUp(void)
+{
+   size_t i;
+
+   for(i = 0; i < sizeof(image); i++)
+   {
+      image[i] = (uint8_t) (i * 13 + i / 251);
+   }
+   memset(flash, 0, sizeof(flash));
+   memset(store, 0xFF, sizeof(store));
+   saves = 0;
+   wire_size = 0;
+   wire_pos = 0;
+   memset(&transport, 0, sizeof(transport));
+   transport.send = test_UPDT_ITransportSendWire;
+   transport.recv = test_UPDT_ITransportRecvWire;
+}
+
+void tearDown(void)
+{
+}
+
+void test_UPDT_resumeKilledTransfer()
+{
+   uint8_t alw[UPDT_PROTOCOL_PACKET_ALW_PAYLOAD_SIZE];
+   uint32_t offset;
+   uint32_t image_crc;
+
+   /* nothing stored, the first transfer starts from the beginning */
+   TEST_ASSERT_EQUAL (0, test_UPDT_resumeReset(2 * PAYLOAD_SIZE));
+   TEST_ASSERT_EQUAL (FRAMES, test_UPDT_resumeSend(0));
+
+   /* the link dies in the middle of the 18th frame */
+   wire_size = 17 * FRAME_SIZE + 100;
+   test_UPDT_resumeRecv();
+   TEST_ASSERT_EQUAL (17 * PAYLOAD_SIZE, resume.offset);
+
+   /* after the reset the slave reports the last checkpoint */
+   offset = test_UPDT_resumeReset(2 * PAYLOAD_SIZE);
+   TEST_ASSERT_EQUAL (16 * PAYLOAD_SIZE, offset);
+   UPDT_protocolSetResume(alw + UPDT_PROTOCOL_ALW_RESUME_OFFSET, resume.offset, resume.image_crc);
+
+   /* and the master only sends the tail */
+   offset = UPDT_protocolGetResume(alw + UPDT_PROTOCOL_ALW_RESUME_OFFSET, image, IMAGE_SIZE, &image_crc);
+   TEST_ASSERT_EQUAL (16 * PAYLOAD_SIZE, offset);
+   TEST_ASSERT_EQUAL_HEX32 (UPDT_crc32cUpdate(0, image, offset), image_crc);
+   wire_size = 0;
+   wire_pos = 0;
+   TEST_ASSERT_EQUAL (FRAMES - 16, test_UPDT_resumeSend(offset));
+   test_UPDT_resumeRecv();
+
+   TEST_ASSERT_EQUAL (IMAGE_SIZE, resume.offset);
+   TEST_ASSERT_EQUAL_HEX32 (UPDT_crc32cUpdate(0, image, IMAGE_SIZE), resume.image_crc);
+   TEST_ASSERT_EQUAL_MEMORY (image, flash, IMAGE_SIZE);
+}
+
+void test_UPDT_resumeOtherImage()
+{
+   test_UPDT_resumeReset(0);
+   test_UPDT_resumeSend(0);
+   wire_size = 3 * FRAME_SIZE;
+   test_UPDT_resumeRecv();
+   TEST_ASSERT_EQUAL (3, saves);
+
+   /* a checkpoint of another update is ignored */
+   UPDT_resumeInit(&resume, test_UPDT_resumeLoad, test_UPDT_resumeSave, NULL,
+      0, test_UPDT_resumeFlash, NULL);
+   TEST_ASSERT_EQUAL (0, UPDT_resumeStart(&resume, IMAGE_ID + 1, IMAGE_SIZE));
+
+   /* so is a torn one */
+   store[9] ^= 0x01;
+   TEST_ASSERT_EQUAL (0, test_UPDT_resumeReset(0));
+}
+
+void test_UPDT_resumeStaleImage()
+{
+   uint8_t alw[UPDT_PROTOCOL_RESUME_SIZE];
+   uint32_t image_crc;
+
+   /* the master image changed, the slave must start again */
+   UPDT_protocolSetResume(alw, 2 * PAYLOAD_SIZE, UPDT_crc32cUpdate(0, image, 2 * PAYLOAD_SIZE));
+   image[10]++;
+   TEST_ASSERT_EQUAL (0, UPDT_protocolGetResume(alw, image, IMAGE_SIZE, &image_crc));
+   TEST_ASSERT_EQUAL (0, image_crc);
+}
+
+void test_UPDT_resumeClear()
+{
+   test_UPDT_resumeReset(0);
+   test_UPDT_resumeSend(0);
+   test_UPDT_resumeRecv();
+   TEST_ASSERT_EQUAL (IMAGE_SIZE, resume.offset);
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_resumeClear(&resume));
+   TEST_ASSERT_EQUAL (0, test_UPDT_resumeReset(0));
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,217 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/** \brief this file implements the unit tests for the functions of the file UPDT_signature
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup update Implementation
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "UPDT_signature.h"
+#include <string.h>
+
+/*==================[macros and definitions]=================================*/
+#define IMAGE_SIZE   1000
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+/* RFC 8032 section 7.1, tests 1 and 2 */
+static const uint8_t seed1[UPDT_SIGNATURE_SEED_SIZE] =
+{
+   0x9d, 0x61, 0xb1, 0x9d, 0xef, 0xfd, 0x5a, 0x60, 0xba, 0x84, 0x4a, 0xf4, 0x92, 0xec, 0x2c, 0xc4,
+   0x44, 0x49, 0xc5, 0x69, 0x7b, 0x32, 0x69, 0x19, 0x70, 0x3b, 0xac, 0x03, 0x1c, 0xae, 0x7f, 0x60,
+};
+static const uint8_t key1[UPDT_SIGNATURE_KEY_SIZE] =
+{
+   0xd7, 0x5a, 0x98, 0x01, 0x82, 0xb1, 0x0a, 0xb7, 0xd5, 0x4b, 0xfe, 0xd3, 0xc9, 0x64, 0x07, 0x3a,
+   0x0e, 0xe1, 0x72, 0xf3, 0xda, 0xa6, 0x23, 0x25, 0xaf, 0x02, 0x1a, 0x68, 0xf7, 0x07, 0x51, 0x1a,
+};
+static const uint8_t signature1[UPDT_SIGNATURE_SIZE] =
+{
+   0xe5, 0x56, 0x43, 0x00, 0xc3, 0x60, 0xac, 0x72, 0x90, 0x86, 0xe2, 0xcc, 0x80, 0x6e, 0x82, 0x8a,
+   0x84, 0x87, 0x7f, 0x1e, 0xb8, 0xe5, 0xd9, 0x74, 0xd8, 0x73, 0xe0, 0x65, 0x22, 0x49, 0x01, 0x55,
+   0x5f, 0xb8, 0x82, 0x15, 0x90, 0xa3, 0x3b, 0xac, 0xc6, 0x1e, 0x39, 0x70, 0x1c, 0xf9, 0xb4, 0x6b,
+   0xd2, 0x5b, 0xf5, 0xf0, 0x59, 0x5b, 0xbe, 0x24, 0x65, 0x51, 0x41, 0x43, 0x8e, 0x7a, 0x10, 0x0b,
+};
+static const uint8_t key2[UPDT_SIGNATURE_KEY_SIZE] =
+{
+   0x3d, 0x40, 0x17, 0xc3, 0xe8, 0x43, 0x89, 0x5a, 0x92, 0xb7, 0x0a, 0xa7, 0x4d, 0x1b, 0x7e, 0xbc,
+   0x9c, 0x98, 0x2c, 0xcf, 0x2e, 0xc4, 0x96, 0x8c, 0xc0, 0xcd, 0x55, 0xf1, 0x2a, 0xf4, 0x66, 0x0c,
+};
+static const uint8_t signature2[UPDT_SIGNATURE_SIZE] =
+{
+   0x92, 0xa0, 0x09, 0xa9, 0xf0, 0xd4, 0xca, 0xb8, 0x72, 0x0e, 0x82, 0x0b, 0x5f, 0x64, 0x25, 0x40,
+   0xa2, 0xb2, 0x7b, 0x54, 0x16, 0x50, 0x3f, 0x8f, 0xb3, 0x76, 0x22, 0x23, 0xeb, 0xdb, 0x69, 0xda,
+   0x08, 0x5a, 0xc1, 0xe4, 0x3e, 0x15, 0x99, 0x6e, 0x45, 0x8f, 0x36, 0x13, 0xd0, 0xf1, 0x1d, 0x8c,
+   0x38, 0x7b, 0x2e, 0xae, 0xb4, 0x30, 0x2a, 0xee, 0xb0, 0x0d, 0x29, 0x16, 0x12, 0xbb, 0x0c, 0x00,
+};
+
+static uint8_t image[IMAGE_SIZE + 8];
+static uint8_t output[IMAGE_SIZE + 8];
+static size_t output_size;
+static UPDT_signatureVerifierType verifier;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static int32_t sink(void *context, size_t offset, const uint8_t *piece, size_t size)
+{
+   (void) context;
+   (void) offset;
+   TEST_ASSERT_TRUE (output_size + size <= sizeof(output));
+   memcpy(output + output_size, piece, size);
+   output_size += size;
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Signs the image the way a master does. */
+static void sign_image(uint8_t *signature)
+{
+   UPDT_sha256Type sha;
+   uint8_t digest[UPDT_SHA256_SIZE];
+
+   UPDT_sha256Init(&sha);
+   UPDT_sha256Update(&sha, image, IMAGE_SIZE);
+   UPDT_sha256Final(&sha, digest);
+   UPDT_signatureSign(seed1, digest, sizeof(digest), signature);
+}
+
+/*==================[external functions definition]==========================*/
+void setUp(void)
+{
+   size_t i;
+
+   for(i = 0; i < sizeof(image); i++)
+   {
+      image[i] = (uint8_t) (i * 7 + i / 251);
+   }
+   /* the padding of the last frame */
+   memset(image + IMAGE_SIZE, 0xFF, sizeof(image) - IMAGE_SIZE);
+   output_size = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test_UPDT_signatureVectors()
+{
+   static const uint8_t message2 = 0x72;
+   uint8_t key[UPDT_SIGNATURE_KEY_SIZE];
+   uint8_t signature[UPDT_SIGNATURE_SIZE];
+
+   UPDT_signaturePublicKey(seed1, key);
+   TEST_ASSERT_EQUAL_MEMORY (key1, key, sizeof(key));
+   UPDT_signatureSign(seed1, NULL, 0, signature);
+   TEST_ASSERT_EQUAL_MEMORY (signature1, signature, sizeof(signature));
+
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_signatureVerify(key1, NULL, 0, signature1));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_signatureVerify(key2, &message2, 1, signature2));
+
+   /* another message, another key or a changed signature */
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_DENIED, UPDT_signatureVerify(key1, &message2, 1, signature1));
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_DENIED, UPDT_signatureVerify(key2, &message2, 1, signature1));
+   memcpy(signature, signature2, sizeof(signature));
+   signature[0] ^= 0x01;
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_DENIED, UPDT_signatureVerify(key2, &message2, 1, signature));
+
+   /* S + L is the same point but is not accepted */
+   memcpy(signature, signature2, sizeof(signature));
+   signature[63] |= 0x10;
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_DENIED, UPDT_signatureVerify(key2, &message2, 1, signature));
+}
+
+void test_UPDT_signatureVerifier()
+{
+   uint8_t signature[UPDT_SIGNATURE_SIZE];
+   size_t offset;
+   size_t size;
+
+   sign_image(signature);
+
+   /* DAT payloads of 224 bytes, the last one padded to 8 bytes */
+   UPDT_signatureVerifierInit(&verifier, key1, IMAGE_SIZE, sink, NULL);
+   for(offset = 0; offset < sizeof(image); offset += size)
+   {
+      size = sizeof(image) - offset < 224 ? sizeof(image) - offset : 224;
+      TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_signatureVerifierConsume(&verifier, 0, image + offset, size));
+   }
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_NONE, UPDT_signatureVerifierCheck(&verifier, signature));
+   TEST_ASSERT_EQUAL (sizeof(image), output_size);
+   TEST_ASSERT_EQUAL_MEMORY (image, output, sizeof(image));
+}
+
+void test_UPDT_signatureVerifierDenied()
+{
+   uint8_t signature[UPDT_SIGNATURE_SIZE];
+
+   sign_image(signature);
+
+   /* an incomplete image */
+   UPDT_signatureVerifierInit(&verifier, key1, IMAGE_SIZE, NULL, NULL);
+   UPDT_signatureVerifierConsume(&verifier, 0, image, IMAGE_SIZE - 1);
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_DENIED, UPDT_signatureVerifierCheck(&verifier, signature));
+
+   /* a changed byte */
+   image[500] ^= 0x80;
+   UPDT_signatureVerifierInit(&verifier, key1, IMAGE_SIZE, NULL, NULL);
+   UPDT_signatureVerifierConsume(&verifier, 0, image, IMAGE_SIZE);
+   TEST_ASSERT_EQUAL (UPDT_PROTOCOL_ERROR_DENIED, UPDT_signatureVerifierCheck(&verifier, signature));
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,149 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief this file implements the unit tests for the functions of the file UPDT_trace
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup update Implementation
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.1  AG  first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include "unity.h"
+#include "UPDT_trace.h"
+
+/*==================[macros and definitions]=================================*/
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+static UPDT_traceRecordType records[4];
+
+static uint8_t buffer[UPDT_TRACE_HEADER_SIZE + 8 * UPDT_TRACE_RECORD_SIZE];
+
+static uint32_t fake_time;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static uint32_t test_UPDT_traceClock (void){
+   return fake_time++;
+}
+
+static uint8_t test_UPDT_traceTrack (void){
+   return 3;
+}
+
+/*==================[external functions definition]==========================*/
+void setUp(void)
+{
+   fake_time = 100;
+   UPDT_traceSetClock(test_UPDT_traceClock);
+   UPDT_traceSetTrackSource(NULL);
+   UPDT_traceInit(records, 4);
+}
+
+void tearDown(void)
+{
+   UPDT_traceInit(NULL, 0);
+   UPDT_traceSetClock(NULL);
+}
+
+void test_UPDT_traceDump()
+{
+   UPDT_traceSetTrackSource(test_UPDT_traceTrack);
+   UPDT_traceRecord(UPDT_TRACE_EVENT_CRC, UPDT_TRACE_PHASE_BEGIN, 0x12345678);
+   UPDT_traceRecord(UPDT_TRACE_EVENT_CRC, UPDT_TRACE_PHASE_END, 8);
+
+   TEST_ASSERT_EQUAL (UPDT_TRACE_HEADER_SIZE + 2 * UPDT_TRACE_RECORD_SIZE, UPDT_traceDump(buffer, sizeof(buffer)));
+   TEST_ASSERT_EQUAL_MEMORY ("UTRC\0\0\0\0", buffer, UPDT_TRACE_HEADER_SIZE);
+   /* time, arg, event, phase, track, little endian */
+   TEST_ASSERT_EQUAL_HEX8 (100, buffer[8]);
+   TEST_ASSERT_EQUAL_HEX8 (0x78, buffer[12]);
+   TEST_ASSERT_EQUAL_HEX8 (0x12, buffer[15]);
+   TEST_ASSERT_EQUAL_HEX8 (UPDT_TRACE_EVENT_CRC, buffer[16]);
+   TEST_ASSERT_EQUAL_HEX8 (UPDT_TRACE_PHASE_BEGIN, buffer[17]);
+   TEST_ASSERT_EQUAL_HEX8 (3, buffer[18]);
+   TEST_ASSERT_EQUAL_HEX8 (101, buffer[20]);
+   TEST_ASSERT_EQUAL_HEX8 (UPDT_TRACE_PHASE_END, buffer[29]);
+}
+
+void test_UPDT_traceWrap()
+{
+   uint32_t i;
+
+   for(i = 0; i < 6; i++)
+   {
+      UPDT_traceRecord(UPDT_TRACE_EVENT_RECV, UPDT_TRACE_PHASE_INSTANT, i);
+   }
+   /* the newest records, the first two were lost */
+   TEST_ASSERT_EQUAL (UPDT_TRACE_HEADER_SIZE + 4 * UPDT_TRACE_RECORD_SIZE, UPDT_traceDump(buffer, sizeof(buffer)));
+   TEST_ASSERT_EQUAL_HEX8 (2, buffer[4]);
+   TEST_ASSERT_EQUAL_HEX8 (2, buffer[UPDT_TRACE_HEADER_SIZE + 4]);
+   TEST_ASSERT_EQUAL_HEX8 (5, buffer[UPDT_TRACE_HEADER_SIZE + 3 * UPDT_TRACE_RECORD_SIZE + 4]);
+
+   /* only what fits in the buffer */
+   TEST_ASSERT_EQUAL (UPDT_TRACE_HEADER_SIZE + UPDT_TRACE_RECORD_SIZE,
+      UPDT_traceDump(buffer, UPDT_TRACE_HEADER_SIZE + UPDT_TRACE_RECORD_SIZE + 1));
+   TEST_ASSERT_EQUAL_HEX8 (5, buffer[4]);
+   TEST_ASSERT_EQUAL_HEX8 (5, buffer[UPDT_TRACE_HEADER_SIZE + 4]);
+}
+
+void test_UPDT_traceStopped()
+{
+   UPDT_traceInit(NULL, 0);
+   UPDT_traceRecord(UPDT_TRACE_EVENT_SEND, UPDT_TRACE_PHASE_BEGIN, 1);
+   TEST_ASSERT_EQUAL (UPDT_TRACE_HEADER_SIZE, UPDT_traceDump(buffer, sizeof(buffer)));
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# Copyright 2026, agent
+#
+# This file is part of CIAA Firmware.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+#    this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+# 3. Neither the name of the copyright holder nor the names of its
+#    contributors may be used to endorse or promote products derived from this
+#    software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+"""Compares two runs of the update module benchmarks.
+
+Reads the CSV lines printed by btest, one file per run, and matches the cases
+by benchmark, case and size. A case whose ns_per_iteration grew more than
+the threshold is a regression, then the exit status is 1. Lines which are not
+results, like the ones of the OS, are ignored.
+
+    btest_compare.py baseline.csv current.csv --threshold 10
+    btest_compare.py baseline.csv current.csv --json > compare.json
+"""
+
+import argparse
+import csv
+import json
+import sys
+
+HEADER = ("benchmark", "case", "size", "iterations", "bytes",
+          "ns_per_iteration", "bytes_per_second")
+
+
+def load(path):
+    """Returns the results of a run keyed by (benchmark, case, size)."""
+    results = {}
+    with open(path, newline="") as source:
+        for row in csv.reader(source):
+            if len(row) != len(HEADER) or row[0] == HEADER[0]:
+                continue
+            try:
+                values = [int(value) for value in row[2:]]
+            except ValueError:
+                continue
+            result = dict(zip(HEADER, row[:2] + values))
+            results[(result["benchmark"], result["case"], result["size"])] = result
+    return results
+
+
+def compare(baseline, current, threshold):
+    """Returns one entry per case present in both runs."""
+    entries = []
+    for key in sorted(set(baseline) & set(current)):
+        before = baseline[key]["ns_per_iteration"]
+        after = current[key]["ns_per_iteration"]
+        change = 100.0 * (after - before) / before if before else 0.0
+        entries.append({
+            "benchmark": key[0],
+            "case": key[1],
+            "size": key[2],
+            "baseline_ns": before,
+            "current_ns": after,
+            "change_percent": round(change, 1),
+            "regression": change > threshold,
+        })
+    return entries
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="slowdown in percent taken as a regression")
+    parser.add_argument("--json", action="store_true", help="prints JSON instead of a table")
+    args = parser.parse_args()
+
+    entries = compare(load(args.baseline), load(args.current), args.threshold)
+    if args.json:
+        json.dump(entries, sys.stdout, indent=2)
+        sys.stdout.write("\n")
+    else:
+        for entry in entries:
+            print("%-10s %-16s %6d %12d %12d %+7.1f%%%s" % (
+                entry["benchmark"], entry["case"], entry["size"], entry["baseline_ns"],
+                entry["current_ns"], entry["change_percent"],
+                "  REGRESSION" if entry["regression"] else ""))
+    sys.exit(1 if any(entry["regression"] for entry in entries) else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,920 @@
+/* Copyright 2026, agent
+ *
+ * This file is part of CIAA Firmware.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \brief Multi-target update server source file
+ **
+ ** Linux update master which sends one image to many targets at once, each
+ ** one on its own serial port. A single thread drives every target from an
+ ** epoll loop with the non-blocking protocol stream: the handshake is an INF
+ ** frame answered with ALW, then the image goes in DAT frames through a
+ ** go-back-N window per target, like the one of a protocol session. The image
+ ** is mapped once and shared by all the targets, only the frames of each
+ ** window are copied. It may be a raw binary or an ELF, S-record or Intel HEX
+ ** file, see UPDT_packer.h: the targets receive its segments from the first
+ ** to the last address, the gaps filled and padded to whole pages.
+ **
+ ** While it runs it prints the progress every second, and when a target
+ ** finishes its time. At the end it prints a CSV line per target and one with
+ ** the totals:
+ **
+ **    target,device,bytes,seconds,kbytes_per_second,retransmissions,status
+ **
+ **    updt_server [options] image device...
+ **    updt_server -l 64 image
+ **
+ ** Options:
+ **    -p size      DAT payload size offered
+ **    -w frames    window size offered
+ **    -c           turns the CRC on
+ **    -t ms        timeout of the acknowledgements
+ **    -b baud      baud rate of the serial ports
+ **    -l count     loopback: adds count pty pairs, each one with a slave
+ **                 thread which checks the image it receives
+ **    -g bytes     page size the image is padded to
+ **    -q           prints only the CSV lines
+ **/
+
+/** \addtogroup CIAA_Firmware CIAA Firmware
+ ** @{ */
+/** \addtogroup Update CIAA Update Server
+ ** @{ */
+
+/*
+ * Initials     Name
+ * ---------------------------
+ * DC           Daniel Cohen
+ * EV           Esteban Volentini
+ * MG           Matias Giori
+ * FS           Franco Salinas
+ * AG           agent
+ */
+
+/*
+ * modification history (new versions first)
+ * -----------------------------------------------------------
+ * 20261017 v0.0.3   AG   clear the optional transport entries with UPDT_ITransportInit
+ * 20261017 v0.0.2   AG   read ELF, S-record and Intel HEX images
+ * 20261017 v0.0.1   AG   first initial version
+ */
+
+/*==================[inclusions]=============================================*/
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ciaaPOSIX_stdio.h"
+#include "UPDT_packer.h"
+#include "UPDT_protocol.h"
+#include "UPDT_time.h"
+
+/*==================[macros and definitions]=================================*/
+/** maximum number of targets */
+#define SERVER_TARGETS_MAX       256u
+/** default DAT payload size */
+#define SERVER_PAYLOAD_SIZE      1024u
+/** default window size */
+#define SERVER_WINDOW_SIZE       8u
+/** default timeout of the acknowledgements, in milliseconds */
+#define SERVER_TIMEOUT           1000u
+/** sequence number of the first DAT frame */
+#define SERVER_SEQUENCE_NUMBER   1u
+/** period of the progress lines, in milliseconds */
+#define SERVER_PROGRESS_PERIOD   1000u
+/** size of the frames received by the master: ACK, ALW or DNY */
+#define SERVER_RX_SIZE           UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PACKET_ALW_PAYLOAD_SIZE)
+/** value of the bytes which pad the last frame, the one of erased flash */
+#define SERVER_PADDING           UPDT_PACKER_FILL
+/** default page size the image is padded to */
+#define SERVER_PAGE_SIZE         512u
+/** maximum number of segments of the image */
+#define SERVER_SEGMENTS_MAX      64u
+
+/* target states */
+#define SERVER_STATE_HELLO       0
+#define SERVER_STATE_DATA        1
+#define SERVER_STATE_DONE        2
+#define SERVER_STATE_FAILED      3
+
+/** \brief Options of the server */
+typedef struct
+{
+   uint16_t payload_size;
+   uint8_t window_size;
+   uint8_t crc;
+   uint32_t timeout;
+   uint32_t baud_rate;
+   uint32_t loopback;
+   uint32_t page_size;
+   uint8_t quiet;
+} server_optionsType;
+
+/** \brief Target type */
+typedef struct
+{
+   /** Transport over the file descriptor. It must be the first field */
+   UPDT_ITransportType transport;
+   /** Non-blocking file descriptor */
+   int fd;
+   /** Device name */
+   char device[64];
+   /** Framing of the frames received and sent */
+   UPDT_protocolStreamType stream;
+   /** Frame being received */
+   uint8_t rx[SERVER_RX_SIZE];
+   /** Source of the payloads, a copy of server_packer */
+   UPDT_packerType packer;
+   /** INF frame of the handshake */
+   uint8_t hello[UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PACKET_INF_PAYLOAD_SIZE)];
+   /** Frames of the window, slot i % window_size holds the frame i */
+   uint8_t *frames;
+   /** Size of each frame slot */
+   size_t frame_size;
+   /** Agreed DAT payload size */
+   uint16_t payload_size;
+   /** Agreed window size */
+   uint8_t window_size;
+   /** Flags of the frames sent */
+   uint8_t flags;
+   /** A SERVER_STATE value */
+   uint8_t state;
+   /** Non-zero while the descriptor is watched for writing */
+   uint8_t writing;
+   /** Non-zero while a go-back-N retransmission is being recovered */
+   uint8_t recovering;
+   /** Frames of the image */
+   uint32_t total;
+   /** Oldest unacknowledged frame */
+   uint32_t base;
+   /** Next frame to send, below built when going back */
+   uint32_t cursor;
+   /** Frames stored in the window so far */
+   uint32_t built;
+   /** Frames before this one are being retransmitted */
+   uint32_t recover;
+   /** Time the acknowledgement wait expires, a UPDT_timeNow value */
+   uint32_t deadline;
+   /** Consecutive timeouts */
+   uint32_t retries;
+   /** Frames sent again */
+   uint32_t retransmissions;
+   /** Error of a failed target */
+   int32_t error;
+   /** Times the transfer started and ended, in nanoseconds */
+   uint64_t start;
+   uint64_t end;
+} server_targetType;
+
+/** \brief Loopback slave type */
+typedef struct
+{
+   /** Transport over the file descriptor. It must be the first field */
+   UPDT_ITransportType transport;
+   /** Blocking file descriptor */
+   int fd;
+   /** Slave thread */
+   pthread_t thread;
+   /** Non-zero if the image was received unchanged */
+   uint8_t ok;
+} server_slaveType;
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+static int32_t server_frame(void *context, const uint8_t *frame, int32_t error);
+
+/*==================[internal data definition]===============================*/
+static server_optionsType server_options =
+{
+   SERVER_PAYLOAD_SIZE, SERVER_WINDOW_SIZE, 0, SERVER_TIMEOUT, 0, 0, SERVER_PAGE_SIZE, 0,
+};
+/** capabilities offered by the master, and by the loopback slaves */
+static UPDT_protocolCapabilitiesType server_capabilities;
+/** image shared by every target, each one reads it through a copy of the
+ ** packer */
+static UPDT_packerType server_packer;
+static UPDT_packerSegmentType server_segments[SERVER_SEGMENTS_MAX];
+static uint32_t server_imageSize;
+
+static server_targetType *server_targets;
+static uint32_t server_count;
+static server_slaveType *server_slaves;
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+/** \brief Returns the time of CLOCK_MONOTONIC in nanoseconds. */
+static uint64_t server_now(void)
+{
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (uint64_t) now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+/** \brief Receives from a file descriptor, 0 if nothing is available. */
+static ssize_t server_fdRecv(UPDT_ITransportType *transport, void *data, size_t size)
+{
+   ssize_t ret = read(((server_targetType *) transport)->fd, data, size);
+
+   if(ret < 0 && (EAGAIN == errno || EINTR == errno))
+   {
+      return 0;
+   }
+   /* end of file: the other end hung up */
+   return 0 == ret && 0 < size ? -1 : ret;
+}
+
+/** \brief Sends to a file descriptor, 0 if nothing can be sent. */
+static ssize_t server_fdSend(UPDT_ITransportType *transport, const void *data, size_t size)
+{
+   ssize_t ret = write(((server_targetType *) transport)->fd, data, size);
+
+   if(ret < 0 && (EAGAIN == errno || EINTR == errno))
+   {
+      return 0;
+   }
+   return ret;
+}
+
+/** \brief Receives from the file descriptor of a loopback slave. */
+static ssize_t server_slaveRecv(UPDT_ITransportType *transport, void *data, size_t size)
+{
+   ssize_t ret = read(((server_slaveType *) transport)->fd, data, size);
+
+   return 0 == ret && 0 < size ? -1 : ret;
+}
+
+/** \brief Sends to the file descriptor of a loopback slave. */
+static ssize_t server_slaveSend(UPDT_ITransportType *transport, const void *data, size_t size)
+{
+   return write(((server_slaveType *) transport)->fd, data, size);
+}
+
+/** \brief Puts a terminal in raw mode.
+ **
+ ** \param baud_rate Baud rate, 0 keeps the current one.
+ ** \return 0 on success.
+ **/
+static int32_t server_raw(int fd, uint32_t baud_rate)
+{
+   struct termios options;
+
+   if(0 != tcgetattr(fd, &options))
+   {
+      return -1;
+   }
+   cfmakeraw(&options);
+   options.c_cc[VMIN] = 1;
+   options.c_cc[VTIME] = 0;
+   if(0 != baud_rate && 0 != cfsetspeed(&options, baud_rate))
+   {
+      return -1;
+   }
+   return tcsetattr(fd, TCSANOW, &options);
+}
+
+/** \brief Parses the options.
+ **
+ ** \return Index of the first non-option argument, -1 on error.
+ **/
+static int32_t server_parse(int argc, char *argv[])
+{
+   int option;
+
+   while(-1 != (option = getopt(argc, argv, "p:w:ct:b:l:g:q")))
+   {
+      switch(option)
+      {
+         case 'p':
+            server_options.payload_size = strtoul(optarg, NULL, 0);
+            break;
+         case 'w':
+            server_options.window_size = strtoul(optarg, NULL, 0);
+            break;
+         case 'c':
+            server_options.crc = 1;
+            break;
+         case 't':
+            server_options.timeout = strtoul(optarg, NULL, 0);
+            break;
+         case 'b':
+            server_options.baud_rate = strtoul(optarg, NULL, 0);
+            break;
+         case 'l':
+            server_options.loopback = strtoul(optarg, NULL, 0);
+            break;
+         case 'g':
+            server_options.page_size = strtoul(optarg, NULL, 0);
+            break;
+         case 'q':
+            server_options.quiet = 1;
+            break;
+         default:
+            return -1;
+      }
+   }
+   if(server_options.payload_size < 8 || server_options.payload_size > UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE ||
+      0 == server_options.window_size || server_options.window_size > UPDT_PROTOCOL_WINDOW_MAX_SIZE ||
+      0 == server_options.timeout || 0 == server_options.page_size || optind >= argc ||
+      argc - optind - 1 + server_options.loopback > SERVER_TARGETS_MAX ||
+      argc - optind - 1 + server_options.loopback == 0)
+   {
+      return -1;
+   }
+   server_capabilities.payload_size = server_options.payload_size & ~7u;
+   server_capabilities.window_size = server_options.window_size;
+   server_capabilities.flags = server_options.crc ? UPDT_PROTOCOL_CAPABILITY_CRC : 0;
+   server_capabilities.baud_rate = UPDT_PROTOCOL_BAUD_KEEP;
+   return optind;
+}
+
+/** \brief Maps the image and finds its segments.
+ **
+ ** \return 0 on success, errno is EINVAL if the image is malformed.
+ **/
+static int32_t server_map(const char *path)
+{
+   struct stat status;
+   void *image;
+   int fd;
+
+   fd = open(path, O_RDONLY);
+   if(fd < 0 || 0 != fstat(fd, &status) || 0 == status.st_size || status.st_size > UINT32_MAX)
+   {
+      return -1;
+   }
+   image = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+   if(MAP_FAILED == image)
+   {
+      return -1;
+   }
+   if(UPDT_PROTOCOL_ERROR_NONE != UPDT_packerInit(&server_packer, image, status.st_size,
+      UPDT_PACKER_FORMAT_AUTO, 0, server_options.page_size, server_segments, SERVER_SEGMENTS_MAX))
+   {
+      errno = EINVAL;
+      return -1;
+   }
+   server_imageSize = UPDT_packerGetSize(&server_packer);
+   return 0;
+}
+
+/** \brief Loopback slave: answers the handshake and checks the image. */
+static void *server_slaveRun(void *arg)
+{
+   server_slaveType *slave = (server_slaveType *) arg;
+   uint8_t frame[UPDT_PROTOCOL_FRAME_SIZE(UPDT_PROTOCOL_PACKET_INF_PAYLOAD_SIZE)] = {0};
+   uint8_t payload[UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE];
+   uint8_t expected[UPDT_PROTOCOL_PAYLOAD_LIMIT_SIZE];
+   uint8_t header[UPDT_PROTOCOL_HEADER_SIZE];
+   UPDT_packerType packer = server_packer;
+   const uint8_t *image;
+   UPDT_protocolCapabilitiesType remote;
+   UPDT_protocolCapabilitiesType agreed;
+   UPDT_protocolSessionType session;
+   uint32_t data_size;
+   uint32_t offset = 0;
+   uint32_t size;
+   uint8_t ok = 1;
+
+   if(UPDT_PROTOCOL_ERROR_NONE != UPDT_protocolRecv(&slave->transport, frame, UPDT_PROTOCOL_HEADER_SIZE) ||
+      UPDT_PROTOCOL_PACKET_INF != UPDT_protocolGetPacketType(frame) ||
+      UPDT_PROTOCOL_ERROR_NONE != UPDT_protocolRecv(&slave->transport, frame + UPDT_PROTOCOL_HEADER_SIZE,
+         UPDT_protocolGetFrameSize(frame) - UPDT_PROTOCOL_HEADER_SIZE))
+   {
+      return NULL;
+   }
+   data_size = UPDT_crc32cGet(frame + UPDT_PROTOCOL_HEADER_SIZE + UPDT_PROTOCOL_INF_DATA_SIZE_OFFSET);
+   UPDT_protocolGetCapabilities(frame + UPDT_PROTOCOL_HEADER_SIZE + UPDT_PROTOCOL_INF_CAPABILITIES_OFFSET,
+      &remote);
+   UPDT_protocolNegotiate(&server_capabilities, &remote, &agreed);
+
+   ciaaPOSIX_memset(frame, 0, sizeof(frame));
+   UPDT_protocolSetHeader(frame, UPDT_PROTOCOL_PACKET_ALW, 0, UPDT_PROTOCOL_PACKET_ALW_PAYLOAD_SIZE);
+   UPDT_protocolSetCapabilities(frame + UPDT_PROTOCOL_HEADER_SIZE + UPDT_PROTOCOL_ALW_CAPABILITIES_OFFSET,
+      &agreed);
+   if(UPDT_PROTOCOL_ERROR_NONE != UPDT_protocolSend(&slave->transport, frame, UPDT_protocolGetFrameSize(frame)))
+   {
+      return NULL;
+   }
+
+   UPDT_protocolSessionInit(&session, &slave->transport, NULL, 0, 1, SERVER_SEQUENCE_NUMBER);
+   UPDT_protocolSessionSetCapabilities(&session, &agreed);
+   while(offset < data_size)
+   {
+      if(UPDT_PROTOCOL_ERROR_NONE != UPDT_protocolSessionRecv(&session, header, payload, sizeof(payload)))
+      {
+         return NULL;
+      }
+      if(UPDT_PROTOCOL_PACKET_DAT == UPDT_protocolGetPacketType(header))
+      {
+         size = UPDT_protocolGetPayloadSize(header);
+         if(size > data_size - offset)
+         {
+            size = data_size - offset;
+         }
+         UPDT_packerGet(&packer, expected, size, &image);
+         ok = ok && 0 == memcmp(payload, image, size);
+         offset += size;
+      }
+   }
+   slave->ok = ok;
+   return NULL;
+}
+
+/** \brief Adds a target.
+ **
+ ** \param fd Descriptor of the device, it is made non-blocking.
+ ** \param device Name of the device.
+ ** \return 0 on success.
+ **/
+static int32_t server_add(int fd, const char *device)
+{
+   server_targetType *target = &server_targets[server_count];
+   uint8_t *payload = target->hello + UPDT_PROTOCOL_HEADER_SIZE;
+
+   if(0 != fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK))
+   {
+      return -1;
+   }
+   ciaaPOSIX_memset(target, 0, sizeof(*target));
+   target->packer = server_packer;
+   UPDT_ITransportInit(&target->transport, server_fdRecv, server_fdSend);
+   target->fd = fd;
+   snprintf(target->device, sizeof(target->device), "%s", device);
+   target->frame_size = UPDT_PROTOCOL_FRAME_SIZE(server_capabilities.payload_size);
+   target->frames = malloc(server_capabilities.window_size * target->frame_size);
+   if(NULL == target->frames)
+   {
+      return -1;
+   }
+   UPDT_protocolStreamInit(&target->stream, &target->transport, target->rx, sizeof(target->rx),
+      server_frame, target);
+
+   UPDT_protocolSetHeader(target->hello, UPDT_PROTOCOL_PACKET_INF, 0, UPDT_PROTOCOL_PACKET_INF_PAYLOAD_SIZE);
+   UPDT_crc32cSet(payload + UPDT_PROTOCOL_INF_DATA_SIZE_OFFSET, server_imageSize);
+   UPDT_protocolSetCapabilities(payload + UPDT_PROTOCOL_INF_CAPABILITIES_OFFSET, &server_capabilities);
+   server_count++;
+   return 0;
+}
+
+/** \brief Adds a pty pair and its loopback slave.
+ **
+ ** \return 0 on success.
+ **/
+static int32_t server_addLoopback(server_slaveType *slave)
+{
+   int master_fd;
+
+   master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+   if(master_fd < 0 || 0 != grantpt(master_fd) || 0 != unlockpt(master_fd) ||
+      (slave->fd = open(ptsname(master_fd), O_RDWR | O_NOCTTY)) < 0 ||
+      0 != server_raw(master_fd, 0) || 0 != server_raw(slave->fd, 0))
+   {
+      return -1;
+   }
+   UPDT_ITransportInit(&slave->transport, server_slaveRecv, server_slaveSend);
+   return server_add(master_fd, ptsname(master_fd));
+}
+
+/** \brief Ends the transfer of a target. */
+static void server_finish(server_targetType *target, uint8_t state, int32_t error)
+{
+   target->state = state;
+   target->error = error;
+   target->end = server_now();
+   if(!server_options.quiet)
+   {
+      fprintf(stderr, "%s: %s in %.3f s\n", target->device,
+         SERVER_STATE_DONE == state ? "done" : "failed",
+         (target->end - target->start) / 1e9);
+   }
+}
+
+/** \brief Goes back to the oldest unacknowledged frame. */
+static void server_goBack(server_targetType *target)
+{
+   target->retransmissions += target->cursor - target->base;
+   target->cursor = target->base;
+   target->recover = target->built;
+   target->recovering = 1;
+}
+
+/** \brief Frame callback: handles the answers of a target. */
+static int32_t server_frame(void *context, const uint8_t *frame, int32_t error)
+{
+   server_targetType *target = (server_targetType *) context;
+   UPDT_protocolCapabilitiesType agreed;
+   uint8_t base_sequence;
+   uint8_t acked;
+
+   if(UPDT_PROTOCOL_ERROR_NONE != error)
+   {
+      /* as good as a lost one, the timeout recovers it */
+      return UPDT_PROTOCOL_ERROR_NONE;
+   }
+   switch(UPDT_protocolGetPacketType(frame))
+   {
+      case UPDT_PROTOCOL_PACKET_DNY:
+         server_finish(target, SERVER_STATE_FAILED, UPDT_PROTOCOL_ERROR_DENIED);
+         break;
+      case UPDT_PROTOCOL_PACKET_ALW:
+         if(SERVER_STATE_HELLO != target->state)
+         {
+            break;
+         }
+         UPDT_protocolGetCapabilities(frame + UPDT_PROTOCOL_HEADER_SIZE + UPDT_PROTOCOL_ALW_CAPABILITIES_OFFSET,
+            &agreed);
+         target->payload_size = agreed.payload_size < server_capabilities.payload_size ?
+            agreed.payload_size : server_capabilities.payload_size;
+         target->window_size = agreed.window_size < server_capabilities.window_size ?
+            agreed.window_size : server_capabilities.window_size;
+         target->flags = (agreed.flags & UPDT_PROTOCOL_CAPABILITY_CRC) ? UPDT_PROTOCOL_FLAG_CRC : 0;
+         target->total = (server_imageSize + target->payload_size - 1) / target->payload_size;
+         target->state = SERVER_STATE_DATA;
+         target->retries = 0;
+         break;
+      case UPDT_PROTOCOL_PACKET_ACK:
+         if(SERVER_STATE_DATA != target->state)
+         {
+            break;
+         }
+         base_sequence = (uint8_t) (SERVER_SEQUENCE_NUMBER + target->base);
+         acked = UPDT_PROTOCOL_SEQUENCE_DISTANCE(UPDT_protocolGetSequenceNumber(frame) + 1, base_sequence);
+         if(0 != acked && acked <= target->built - target->base)
+         {
+            target->base += acked;
+            if(target->cursor < target->base)
+            {
+               target->cursor = target->base;
+            }
+            if(target->recovering && target->recover <= target->base)
+            {
+               target->recovering = 0;
+            }
+            target->retries = 0;
+            target->deadline = UPDT_timeNow() + server_options.timeout;
+            if(target->base == target->total)
+            {
+               server_finish(target, SERVER_STATE_DONE, UPDT_PROTOCOL_ERROR_NONE);
+            }
+         }
+         else if(1 == UPDT_PROTOCOL_SEQUENCE_DISTANCE(base_sequence, UPDT_protocolGetSequenceNumber(frame)) &&
+            target->base != target->built && !target->recovering)
+         {
+            /* the frame at the base of the window was lost */
+            server_goBack(target);
+         }
+         break;
+      default:
+         break;
+   }
+   return UPDT_PROTOCOL_ERROR_NONE;
+}
+
+/** \brief Stores the frame i of the image in its window slot. */
+static void server_build(server_targetType *target, uint32_t i)
+{
+   uint8_t *frame = target->frames + (i % target->window_size) * target->frame_size;
+   uint32_t offset = i * target->payload_size;
+   uint32_t size = server_imageSize - offset;
+   const uint8_t *data;
+   uint16_t payload_size;
+
+   if(size > target->payload_size)
+   {
+      size = target->payload_size;
+   }
+   /* the last frame is padded to a multiple of 8 bytes */
+   payload_size = (size + 7u) & ~7u;
+   frame[0] = target->flags;
+   UPDT_protocolSetHeader(frame, UPDT_PROTOCOL_PACKET_DAT, (uint8_t) (SERVER_SEQUENCE_NUMBER + i), payload_size);
+   /* the frames are built in order, so the seek does not move the packer */
+   UPDT_packerSeek(&target->packer, offset);
+   UPDT_packerGet(&target->packer, frame + UPDT_PROTOCOL_HEADER_SIZE, size, &data);
+   if(data != frame + UPDT_PROTOCOL_HEADER_SIZE)
+   {
+      ciaaPOSIX_memcpy(frame + UPDT_PROTOCOL_HEADER_SIZE, data, size);
+   }
+   ciaaPOSIX_memset(frame + UPDT_PROTOCOL_HEADER_SIZE + size, SERVER_PADDING, payload_size - size);
+   if(target->flags & UPDT_PROTOCOL_FLAG_CRC)
+   {
+      UPDT_protocolSetCrc(frame);
+   }
+}
+
+/** \brief Sends the frames the window and the descriptor allow. */
+static void server_pump(server_targetType *target)
+{
+   const uint8_t *frame;
+   int32_t ret;
+
+   while(SERVER_STATE_DATA == target->state && 0 == UPDT_protocolStreamPending(&target->stream) &&
+      target->cursor < target->total && target->cursor - target->base < target->window_size)
+   {
+      if(target->cursor == target->built)
+      {
+         server_build(target, target->built++);
+      }
+      frame = target->frames + (target->cursor % target->window_size) * target->frame_size;
+      target->cursor++;
+      target->deadline = UPDT_timeNow() + server_options.timeout;
+      ret = UPDT_protocolStreamSend(&target->stream, frame, UPDT_protocolGetFrameSize(frame));
+      if(UPDT_PROTOCOL_ERROR_TRANSPORT == ret)
+      {
+         server_finish(target, SERVER_STATE_FAILED, ret);
+      }
+   }
+}
+
+/** \brief Handles the expiration of the wait of a target. */
+static void server_expire(server_targetType *target)
+{
+   if(++target->retries > UPDT_PROTOCOL_RETRIES_MAX)
+   {
+      server_finish(target, SERVER_STATE_FAILED, UPDT_PROTOCOL_ERROR_TIMEOUT);
+      return;
+   }
+   target->deadline = UPDT_timeNow() + server_options.timeout;
+   if(SERVER_STATE_HELLO == target->state)
+   {
+      if(0 == UPDT_protocolStreamPending(&target->stream))
+      {
+         UPDT_protocolStreamSend(&target->stream, target->hello, UPDT_protocolGetFrameSize(target->hello));
+      }
+   }
+   else if(target->base != target->built)
+   {
+      /* the frames or their acknowledgements were lost */
+      server_goBack(target);
+   }
+}
+
+/** \brief Moves the bytes of a target and updates what epoll watches. */
+static void server_service(int epoll_fd, server_targetType *target)
+{
+   struct epoll_event event;
+   uint8_t writing;
+   int32_t ret;
+
+   do
+   {
+      ret = UPDT_protocolPoll(&target->stream);
+   } while(UPDT_PROTOCOL_ERROR_NONE == ret && SERVER_STATE_DONE > target->state);
+   if(UPDT_PROTOCOL_ERROR_TRANSPORT == ret && SERVER_STATE_DONE > target->state)
+   {
+      server_finish(target, SERVER_STATE_FAILED, ret);
+   }
+   server_pump(target);
+
+   if(SERVER_STATE_DONE <= target->state)
+   {
+      epoll_ctl(epoll_fd, EPOLL_CTL_DEL, target->fd, NULL);
+      return;
+   }
+   writing = 0 < UPDT_protocolStreamPending(&target->stream);
+   if(writing != target->writing)
+   {
+      event.events = EPOLLIN | (writing ? EPOLLOUT : 0);
+      event.data.ptr = target;
+      epoll_ctl(epoll_fd, EPOLL_CTL_MOD, target->fd, &event);
+      target->writing = writing;
+   }
+}
+
+/** \brief Prints the progress of every target and the aggregate
+ ** throughput. */
+static void server_progress(uint64_t start)
+{
+   uint64_t bytes = 0;
+   uint32_t done = 0;
+   uint32_t failed = 0;
+   uint32_t sent;
+   uint32_t i;
+   double seconds = (server_now() - start) / 1e9;
+
+   fprintf(stderr, "%7.1f s |", seconds);
+   for(i = 0; i < server_count; i++)
+   {
+      sent = server_targets[i].base * server_targets[i].payload_size;
+      sent = sent < server_imageSize ? sent : server_imageSize;
+      bytes += sent;
+      done += SERVER_STATE_DONE == server_targets[i].state;
+      failed += SERVER_STATE_FAILED == server_targets[i].state;
+      fprintf(stderr, " %3u", (unsigned) ((uint64_t) sent * 100u / server_imageSize));
+   }
+   fprintf(stderr, " | %u done %u failed %.3f MB/s\n", (unsigned) done, (unsigned) failed,
+      0 < seconds ? bytes / seconds / 1e6 : 0.0);
+}
+
+/** \brief Runs the transfers until every target is done or failed. */
+static void server_run(void)
+{
+   struct epoll_event events[SERVER_TARGETS_MAX];
+   struct epoll_event event;
+   server_targetType *target;
+   uint64_t start = server_now();
+   uint32_t progress = UPDT_timeNow() + SERVER_PROGRESS_PERIOD;
+   uint32_t wait;
+   uint32_t active;
+   uint32_t i;
+   int epoll_fd;
+   int count;
+
+   epoll_fd = epoll_create1(0);
+   for(i = 0; i < server_count; i++)
+   {
+      target = &server_targets[i];
+      target->start = start;
+      target->deadline = UPDT_timeNow() + server_options.timeout;
+      event.events = EPOLLIN;
+      event.data.ptr = target;
+      if(epoll_fd < 0 || 0 != epoll_ctl(epoll_fd, EPOLL_CTL_ADD, target->fd, &event))
+      {
+         server_finish(target, SERVER_STATE_FAILED, UPDT_PROTOCOL_ERROR_TRANSPORT);
+         continue;
+      }
+      UPDT_protocolStreamSend(&target->stream, target->hello, UPDT_protocolGetFrameSize(target->hello));
+      server_service(epoll_fd, target);
+   }
+
+   do
+   {
+      /* sleeps until the first deadline at most */
+      wait = UPDT_timeRemaining(progress);
+      for(i = 0; i < server_count; i++)
+      {
+         if(SERVER_STATE_DONE > server_targets[i].state &&
+            UPDT_timeRemaining(server_targets[i].deadline) < wait)
+         {
+            wait = UPDT_timeRemaining(server_targets[i].deadline);
+         }
+      }
+      count = epoll_wait(epoll_fd, events, SERVER_TARGETS_MAX, wait);
+      for(i = 0; i < (uint32_t) (count > 0 ? count : 0); i++)
+      {
+         server_service(epoll_fd, (server_targetType *) events[i].data.ptr);
+      }
+
+      active = 0;
+      for(i = 0; i < server_count; i++)
+      {
+         target = &server_targets[i];
+         if(SERVER_STATE_DONE > target->state && 0 == UPDT_timeRemaining(target->deadline))
+         {
+            server_expire(target);
+            server_service(epoll_fd, target);
+         }
+         active += SERVER_STATE_DONE > target->state;
+      }
+      if(0 == UPDT_timeRemaining(progress))
+      {
+         progress += SERVER_PROGRESS_PERIOD;
+         if(!server_options.quiet)
+         {
+            server_progress(start);
+         }
+      }
+   } while(0 < active);
+
+   if(epoll_fd >= 0)
+   {
+      close(epoll_fd);
+   }
+}
+
+/*==================[external functions definition]==========================*/
+/** \brief Main function
+ *
+ * \return 0 if every target received the image.
+ */
+int main(int argc, char *argv[])
+{
+   server_targetType *target;
+   uint64_t first = UINT64_MAX;
+   uint64_t last = 0;
+   uint64_t bytes = 0;
+   uint32_t retransmissions = 0;
+   uint32_t ok = 0;
+   uint32_t i;
+   int32_t index;
+   double seconds;
+   uint8_t good;
+   int fd;
+
+   index = server_parse(argc, argv);
+   if(index < 0)
+   {
+      fprintf(stderr, "usage: %s [-p payload_size] [-w window_size] [-c] [-t timeout_ms] "
+         "[-b baud_rate] [-l loopback_count] [-g page_size] [-q] image [device...]\n", argv[0]);
+      return 2;
+   }
+   if(0 != server_map(argv[index]))
+   {
+      perror(argv[index]);
+      return 2;
+   }
+   server_targets = calloc(SERVER_TARGETS_MAX, sizeof(server_targetType));
+   server_slaves = calloc(server_options.loopback + 1, sizeof(server_slaveType));
+   if(NULL == server_targets || NULL == server_slaves)
+   {
+      return 2;
+   }
+   for(i = index + 1; i < (uint32_t) argc; i++)
+   {
+      fd = open(argv[i], O_RDWR | O_NOCTTY);
+      if(fd < 0 || 0 != server_raw(fd, server_options.baud_rate) || 0 != server_add(fd, argv[i]))
+      {
+         perror(argv[i]);
+         return 2;
+      }
+   }
+   for(i = 0; i < server_options.loopback; i++)
+   {
+      if(0 != server_addLoopback(&server_slaves[i]) ||
+         0 != pthread_create(&server_slaves[i].thread, NULL, server_slaveRun, &server_slaves[i]))
+      {
+         perror("loopback");
+         return 2;
+      }
+   }
+
+   server_run();
+
+   /* the hang up stops the loopback slaves which did not finish */
+   for(i = 0; i < server_count; i++)
+   {
+      close(server_targets[i].fd);
+   }
+   for(i = 0; i < server_options.loopback; i++)
+   {
+      pthread_join(server_slaves[i].thread, NULL);
+      close(server_slaves[i].fd);
+   }
+
+   ciaaPOSIX_printf("target,device,bytes,seconds,kbytes_per_second,retransmissions,status\n");
+   for(i = 0; i < server_count; i++)
+   {
+      target = &server_targets[i];
+      /* the loopback targets come last */
+      good = SERVER_STATE_DONE == target->state &&
+         (i < server_count - server_options.loopback ||
+          server_slaves[i - (server_count - server_options.loopback)].ok);
+      seconds = (target->end - target->start) / 1e9;
+      ciaaPOSIX_printf("%lu,%s,%lu,%.3f,%.1f,%lu,%s\n", (unsigned long) i, target->device,
+         (unsigned long) server_imageSize, seconds, 0 < seconds ? server_imageSize / seconds / 1e3 : 0.0,
+         (unsigned long) target->retransmissions,
+         good ? "ok" : SERVER_STATE_DONE == target->state ? "corrupted" : "failed");
+      first = target->start < first ? target->start : first;
+      last = target->end > last ? target->end : last;
+      bytes += good ? server_imageSize : 0;
+      retransmissions += target->retransmissions;
+      ok += good;
+   }
+   seconds = (last - first) / 1e9;
+   ciaaPOSIX_printf("total,%lu,%llu,%.3f,%.1f,%lu,%lu/%lu\n", (unsigned long) server_count,
+      (unsigned long long) bytes, seconds, 0 < seconds ? bytes / seconds / 1e3 : 0.0,
+      (unsigned long) retransmissions, (unsigned long) ok, (unsigned long) server_count);
+   return ok == server_count ? 0 : 1;
+}
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/*==================[end of file]============================================*/
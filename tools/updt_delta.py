@@ -0,0 +1,225 @@
+#!/usr/bin/env python3
+# Copyright 2026, agent
+#
+# This file is part of CIAA Firmware.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+#    this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+# 3. Neither the name of the copyright holder nor the names of its
+#    contributors may be used to endorse or promote products derived from this
+#    software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+
+"""Host side delta patch generator for the update protocol.
+
+Writes the bsdiff style patches applied by UPDT_deltaPatcherConsume (see
+inc/UPDT_delta.h). A patch starts with a header, little endian:
+
+    magic "UDP1", source size, source CRC32C, target size, target CRC32C
+
+followed by records of a diff size, an extra size and a signed source seek,
+each one followed by its diff and extra bytes. The seek moves the source
+position, the diff bytes are added to the source bytes found there and the
+extra bytes are copied as they are.
+
+Matches are found with a hash of BLOCK_SIZE byte blocks of the installed
+image and extended allowing some mismatches, so code that moved and had
+its addresses relocated still becomes mostly zero diff bytes. Compress the
+patch with --lzss to take advantage of that.
+
+    updt_delta.py diff old.bin new.bin update.patch [--lzss]
+    updt_delta.py apply old.bin update.patch new.bin
+"""
+
+import argparse
+import struct
+import sys
+
+import updt_lzss
+
+MAGIC = b"UDP1"
+HEADER = struct.Struct("<4sIIII")
+RECORD = struct.Struct("<IIi")
+BLOCK_SIZE = 16
+# a match ends when its score has not improved for this many bytes
+EXTEND_SLACK = 64
+
+
+def _crc32c_table():
+    table = []
+    for byte in range(256):
+        crc = byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ (0x82F63B78 if crc & 1 else 0)
+        table.append(crc)
+    return table
+
+
+_CRC32C_TABLE = _crc32c_table()
+
+
+def crc32c(data, crc=0):
+    """Returns the CRC32C of data, the one of UPDT_crc32cUpdate."""
+    crc ^= 0xFFFFFFFF
+    for byte in data:
+        crc = _CRC32C_TABLE[(crc ^ byte) & 0xFF] ^ (crc >> 8)
+    return crc ^ 0xFFFFFFFF
+
+
+def _extend(source, source_at, target, target_at):
+    """Returns the length of the approximate match, bsdiff style: the prefix
+    with the most matching bytes over mismatching ones."""
+    limit = min(len(source) - source_at, len(target) - target_at)
+    score = 0
+    best_score = 0
+    best = 0
+    i = 0
+    while i < limit and i - best < EXTEND_SLACK:
+        score += 1 if source[source_at + i] == target[target_at + i] else -1
+        i += 1
+        if score > best_score:
+            best_score = score
+            best = i
+    return best
+
+
+def _matches(source, target):
+    """Yields (target position, source position, length) in target order."""
+    index = {}
+    for at in range(len(source) - BLOCK_SIZE, -1, -1):
+        index[source[at:at + BLOCK_SIZE]] = at
+    target_at = 0
+    end = 0
+    offset = None
+    while target_at + BLOCK_SIZE <= len(target):
+        source_at = None
+        # keep the alignment of the previous match when it still fits
+        if offset is not None:
+            guess = target_at + offset
+            if 0 <= guess <= len(source) - BLOCK_SIZE and \
+                    source[guess:guess + BLOCK_SIZE] == target[target_at:target_at + BLOCK_SIZE]:
+                source_at = guess
+        if source_at is None:
+            source_at = index.get(target[target_at:target_at + BLOCK_SIZE])
+        if source_at is None:
+            target_at += 1
+            continue
+        # grow it back into the bytes which would be extra
+        while target_at > end and source_at > 0 and \
+                target[target_at - 1] == source[source_at - 1]:
+            target_at -= 1
+            source_at -= 1
+        length = _extend(source, source_at, target, target_at)
+        yield target_at, source_at, length
+        offset = source_at - target_at
+        target_at += length
+        end = target_at
+
+
+def diff(source, target):
+    """Returns the patch rebuilding target from source."""
+    out = bytearray(HEADER.pack(MAGIC, len(source), crc32c(source),
+                                len(target), crc32c(target)))
+    matches = list(_matches(source, target))
+    first = matches[0][0] if matches else len(target)
+    out += RECORD.pack(0, first, 0)
+    out += target[:first]
+    position = 0
+    for number, (target_at, source_at, length) in enumerate(matches):
+        extra_end = matches[number + 1][0] if number + 1 < len(matches) else len(target)
+        extra = target[target_at + length:extra_end]
+        out += RECORD.pack(length, len(extra), source_at - position)
+        out += bytes((target[target_at + i] - source[source_at + i]) & 0xFF
+                     for i in range(length))
+        out += extra
+        position = source_at + length
+    return bytes(out)
+
+
+def apply(source, patch):
+    """Returns the image rebuilt from source and patch, checking both CRCs."""
+    magic, source_size, source_crc, target_size, target_crc = HEADER.unpack_from(patch)
+    if magic != MAGIC:
+        raise ValueError("not a delta patch")
+    if source_size != len(source) or source_crc != crc32c(source):
+        raise ValueError("the patch was made for another image")
+    out = bytearray()
+    index = HEADER.size
+    position = 0
+    while len(out) < target_size:
+        diff_size, extra_size, seek = RECORD.unpack_from(patch, index)
+        index += RECORD.size
+        position += seek
+        out += bytes((patch[index + i] + source[position + i]) & 0xFF
+                     for i in range(diff_size))
+        index += diff_size
+        position += diff_size
+        out += patch[index:index + extra_size]
+        index += extra_size
+    if len(out) != target_size or crc32c(out) != target_crc:
+        raise ValueError("the rebuilt image does not match the patch")
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    commands = parser.add_subparsers(dest="command", required=True)
+    command = commands.add_parser("diff", help="make a patch")
+    command.add_argument("source")
+    command.add_argument("target")
+    command.add_argument("patch")
+    command.add_argument("--lzss", action="store_true",
+                         help="compress the patch, send it with UPDT_PROTOCOL_FLAG_COMPRESSED")
+    command = commands.add_parser("apply", help="rebuild an image")
+    command.add_argument("source")
+    command.add_argument("patch")
+    command.add_argument("target")
+    command.add_argument("--lzss", action="store_true", help="the patch is compressed")
+    args = parser.parse_args()
+
+    with open(args.source, "rb") as source:
+        old = source.read()
+    if args.command == "diff":
+        with open(args.target, "rb") as target:
+            new = target.read()
+        patch = diff(old, new)
+        if apply(old, patch) != new:
+            sys.exit("updt_delta: internal error, the patch does not rebuild the image")
+        sys.stderr.write("%d -> %d bytes patch" % (len(new), len(patch)))
+        if args.lzss:
+            patch = updt_lzss.compress(patch)
+            sys.stderr.write(", %d compressed" % len(patch))
+        sys.stderr.write("\n")
+        with open(args.patch, "wb") as output:
+            output.write(patch)
+    else:
+        with open(args.patch, "rb") as patch:
+            data = patch.read()
+        if args.lzss:
+            data = updt_lzss.decompress(data)
+        with open(args.target, "wb") as output:
+            output.write(apply(old, data))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+# Copyright 2026, agent
+#
+# This file is part of CIAA Firmware.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+#    this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+# 3. Neither the name of the copyright holder nor the names of its
+#    contributors may be used to endorse or promote products derived from this
+#    software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+"""Host side LZSS compressor for the update protocol.
+
+Writes the stream format decoded by UPDT_lzssDecoderConsume (see
+inc/UPDT_lzss.h): groups of a flag byte, least significant bit first, and up
+to 8 items. A set bit is a literal byte, a clear bit a 2 bytes big endian
+match of ((distance - 1) << 6) | (length - 3). The output is byte for byte the
+one of UPDT_lzssEncode, found with hash chains instead of a full search.
+
+    updt_lzss.py compress image.bin image.lzss
+    updt_lzss.py decompress image.lzss image.bin --size 16384
+"""
+
+import argparse
+import sys
+
+DISTANCE_BITS = 10
+LENGTH_BITS = 6
+WINDOW_SIZE = 1 << DISTANCE_BITS
+MATCH_MIN = 3
+MATCH_MAX = MATCH_MIN + (1 << LENGTH_BITS) - 1
+
+
+def compress(data):
+    """Returns the LZSS stream of data."""
+    out = bytearray()
+    chains = {}
+    flags_at = 0
+    items = 8
+    position = 0
+    size = len(data)
+
+    def insert(at):
+        if at + MATCH_MIN <= size:
+            chains.setdefault(bytes(data[at:at + MATCH_MIN]), []).append(at)
+
+    while position < size:
+        if items == 8:
+            flags_at = len(out)
+            out.append(0)
+            items = 0
+
+        # the nearest of the longest matches, like the target encoder
+        best_length = 0
+        best_distance = 0
+        limit = min(MATCH_MAX, size - position)
+        chain = chains.get(bytes(data[position:position + MATCH_MIN]), [])
+        for candidate in reversed(chain):
+            distance = position - candidate
+            if distance > WINDOW_SIZE:
+                break
+            length = MATCH_MIN
+            while length < limit and data[position + length] == data[candidate + length]:
+                length += 1
+            if length > best_length:
+                best_length = length
+                best_distance = distance
+                if length == limit:
+                    break
+        if len(chain) > 4 * WINDOW_SIZE:
+            del chain[:len(chain) - WINDOW_SIZE]
+
+        if best_length >= MATCH_MIN:
+            token = ((best_distance - 1) << LENGTH_BITS) | (best_length - MATCH_MIN)
+            out += bytes((token >> 8, token & 0xFF))
+            for at in range(position, position + best_length):
+                insert(at)
+            position += best_length
+        else:
+            out[flags_at] |= 1 << items
+            out.append(data[position])
+            insert(position)
+            position += 1
+        items += 1
+    return bytes(out)
+
+
+def decompress(stream, size=None):
+    """Returns the data of an LZSS stream, stopping after size bytes."""
+    out = bytearray()
+    index = 0
+    while index < len(stream) and (size is None or len(out) < size):
+        flags = stream[index]
+        index += 1
+        for item in range(8):
+            if index >= len(stream) or (size is not None and len(out) >= size):
+                break
+            if flags & (1 << item):
+                out.append(stream[index])
+                index += 1
+                continue
+            if index + 2 > len(stream):
+                raise ValueError("truncated match at %d" % index)
+            token = (stream[index] << 8) | stream[index + 1]
+            index += 2
+            distance = (token >> LENGTH_BITS) + 1
+            length = (token & ((1 << LENGTH_BITS) - 1)) + MATCH_MIN
+            if distance > len(out):
+                raise ValueError("match before the start at %d" % index)
+            for _ in range(length):
+                out.append(out[-distance])
+    return bytes(out[:size] if size is not None else out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("mode", choices=("compress", "decompress"))
+    parser.add_argument("input")
+    parser.add_argument("output")
+    parser.add_argument("--size", type=int, help="decompressed size, drops the frame padding")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as source:
+        data = source.read()
+    if args.mode == "compress":
+        result = compress(data)
+        if decompress(result) != data:
+            sys.exit("updt_lzss: internal error, the stream does not round trip")
+        sys.stderr.write("%d -> %d bytes (%.1f%%)\n" % (
+            len(data), len(result), 100.0 * len(result) / max(len(data), 1)))
+    else:
+        result = decompress(data, args.size)
+    with open(args.output, "wb") as sink:
+        sink.write(result)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+# Copyright 2026, agent
+#
+# This file is part of CIAA Firmware.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+#    this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+# 3. Neither the name of the copyright holder nor the names of its
+#    contributors may be used to endorse or promote products derived from this
+#    software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+"""Converts an update module trace into a Chrome / Perfetto JSON timeline.
+
+Reads the output of UPDT_traceDump (see inc/UPDT_trace.h): the magic "UTRC",
+the number of records lost before the first one as a 32 bit little endian
+word, then records of 12 bytes: time in microseconds, argument, event,
+phase, track and a reserved byte. Each begin record is paired with the next
+end record of the same event on the same track into a complete event, so
+a ring which lost the begin of an event only loses that event. The result
+opens in chrome://tracing or ui.perfetto.dev.
+
+    updt_trace.py trace.bin trace.json --tracks master,slave
+    updt_trace.py trace.bin --summary
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b"UTRC"
+HEADER_SIZE = 8
+RECORD = struct.Struct("<IIBBBB")
+
+EVENTS = {
+    1: "recv",
+    2: "send",
+    3: "transport recv",
+    4: "transport send",
+    5: "crc",
+    6: "flash erase",
+    7: "flash program",
+    8: "cipher",
+}
+
+PHASE_BEGIN = 0
+PHASE_END = 1
+PHASE_INSTANT = 2
+
+
+def load(path):
+    """Returns the lost records count and the records, with the time
+    unwrapped to 64 bits."""
+    with open(path, "rb") as source:
+        data = source.read()
+    if len(data) < HEADER_SIZE or data[:4] != MAGIC:
+        raise ValueError("%s: not an update trace" % path)
+    lost = struct.unpack_from("<I", data, 4)[0]
+    records = []
+    offset = 0
+    previous = None
+    for time, arg, event, phase, track, _ in RECORD.iter_unpack(
+            data[HEADER_SIZE:len(data) - (len(data) - HEADER_SIZE) % RECORD.size]):
+        if previous is not None:
+            # the recorders may race, only a large backwards step is a wrap
+            if time < previous and previous - time > 1 << 31:
+                offset += 1 << 32
+        previous = time
+        records.append((time + offset, arg, event, phase, track))
+    return lost, records
+
+
+def timeline(records, tracks):
+    """Returns the Chrome trace events of the records, tracks names the
+    tracks in order."""
+    events = []
+    pending = {}
+    start = min((record[0] for record in records), default=0)
+    for time, arg, event, phase, track in records:
+        name = EVENTS.get(event, "event %d" % event)
+        if phase == PHASE_BEGIN:
+            pending.setdefault((track, event), []).append((time, arg))
+        elif phase == PHASE_END:
+            stack = pending.get((track, event))
+            if not stack:
+                continue
+            begin, begin_arg = stack.pop()
+            events.append({"name": name, "ph": "X", "pid": 1, "tid": track,
+                           "ts": begin - start, "dur": time - begin,
+                           "args": {"begin": begin_arg, "end": arg}})
+        elif phase == PHASE_INSTANT:
+            events.append({"name": name, "ph": "i", "s": "t", "pid": 1, "tid": track,
+                           "ts": time - start, "args": {"arg": arg}})
+    for track in sorted({record[4] for record in records}):
+        events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": track,
+                       "args": {"name": track_name(tracks, track)}})
+    return events
+
+
+def track_name(tracks, track):
+    """Returns the name of a track."""
+    return tracks[track] if track < len(tracks) else "track %d" % track
+
+
+def summary(events):
+    """Returns the count and total time of the complete events by track and
+    name."""
+    totals = {}
+    for event in events:
+        if event["ph"] == "X":
+            total = totals.setdefault((event["tid"], event["name"]), [0, 0])
+            total[0] += 1
+            total[1] += event["dur"]
+    return totals
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("trace")
+    parser.add_argument("output", nargs="?", help="JSON file, standard output by default")
+    parser.add_argument("--tracks", default="",
+                        help="comma separated names of the tracks, ptest uses master,slave")
+    parser.add_argument("--summary", action="store_true",
+                        help="prints the time spent by event instead of the timeline")
+    args = parser.parse_args()
+
+    try:
+        lost, records = load(args.trace)
+    except (OSError, ValueError) as error:
+        sys.exit(str(error))
+    tracks = [name for name in args.tracks.split(",") if name]
+    events = timeline(records, tracks)
+    if args.summary:
+        print("%-8s %-16s %10s %12s" % ("track", "event", "count", "total_us"))
+        for (track, name), (count, total) in sorted(summary(events).items()):
+            print("%-8s %-16s %10d %12d" % (track_name(tracks, track), name, count, total))
+        if lost:
+            print("%d older records were lost" % lost)
+        return
+    document = {"traceEvents": events, "displayTimeUnit": "ms",
+                "otherData": {"lost_records": lost}}
+    if args.output:
+        with open(args.output, "w") as output:
+            json.dump(document, output)
+    else:
+        json.dump(document, sys.stdout)
+        sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()